@@ -6,6 +6,11 @@
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #include <Compressonator/version.h>
 #include <Compressonator/compressonator.h>
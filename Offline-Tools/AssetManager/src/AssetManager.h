@@ -9,20 +9,28 @@ using u32 = unsigned int;
 
 using i32 = int;
 
+// Assets are baked on several threads, a line is only ever printed whole
+std::mutex g_printMutex;
+
 void FatalError(const std::string& msg)
 {
-	std::cerr << "\x1b[4;31m" << "Error: " << msg << "\x1b[0m" << std::endl;
+	{
+		std::scoped_lock lock(g_printMutex);
+		std::cerr << "\x1b[4;31m" << "Error: " << msg << "\x1b[0m" << std::endl;
+	}
 	exit(-1);
 }
 
 void StartSequence(const std::string& msg, const std::filesystem::path& filePath = "")
 {
-	std::cout << "\x1b[33m" << msg << ": " << filePath << "\x1b[0m";
+	std::scoped_lock lock(g_printMutex);
+	std::cout << "\x1b[33m" << msg << ": " << filePath << "\x1b[0m\n";
 }
 
 void EndSequence(const std::string& msg, const std::filesystem::path& filePath = "")
 {
-	std::cout << "\x1b[100D" << "\x1b[32m" << msg << ": " << filePath << "\x1b[0m\n";
+	std::scoped_lock lock(g_printMutex);
+	std::cout << "\x1b[32m" << msg << ": " << filePath << "\x1b[0m\n";
 }
 
 struct AssetMetaData
@@ -48,24 +56,63 @@ std::map<std::string, AssetType> extensionMap = {
 	{".png", AssetType::Texture},
 };
 
-AssetMetaData GenerateMetaData(const std::filesystem::path& path, const std::string& outExt)
+// Bump when the baked output changes for the same source, every asset is rebaked
+constexpr u64 BAKE_VERSION = 2;
+
+struct BakeSource
+{
+	std::filesystem::path file;
+	// Path relative to the asset root with the output extension, "Models/P2/Red/textures/Image_0.dog".
+	// Sources in different folders often share a file name, so this is the name in the meta file and the engine looks textures up by it.
+	std::string outName;
+};
+
+// Sources with a recognized extension anywhere below path, sorted by name so the ids in the meta file are the same on every machine.
+// Other files are skipped, the asset root also holds models, audio and the baked output itself.
+std::vector<BakeSource> GatherSources(const std::filesystem::path& path, const std::filesystem::path& outPath, const std::string& outExt)
 {
 	if (!std::filesystem::is_directory(path))
 	{
 		FatalError("Provided path is not a directory");
 	}
 
+	const auto outDirectory = std::filesystem::weakly_canonical(outPath);
+	std::vector<BakeSource> sources;
+	u32 ignored = 0;
+	for (auto it = std::filesystem::recursive_directory_iterator(path); it != std::filesystem::recursive_directory_iterator(); ++it)
+	{
+		if (it->is_directory() && std::filesystem::weakly_canonical(it->path()) == outDirectory)
+		{
+			it.disable_recursion_pending();
+			continue;
+		}
+		if (!it->is_regular_file())
+			continue;
+
+		if (!extensionMap.contains(it->path().extension().string()))
+		{
+			++ignored;
+			continue;
+		}
+		sources.push_back({ it->path(), it->path().lexically_relative(path).replace_extension(outExt).generic_string() });
+	}
+	std::sort(sources.begin(), sources.end(), [](auto& a, auto& b) { return a.outName < b.outName; });
+
+	std::cout << "Found " << sources.size() << " sources, " << ignored << " files with other extensions ignored\n";
+	return sources;
+}
+
+AssetMetaData GenerateMetaData(const std::vector<BakeSource>& sources)
+{
 	AssetMetaData out = {};
 
 	// Map each texture to its unique id
-	for (auto& filePath : std::filesystem::directory_iterator(path))
+	for (auto& source : sources)
 	{
-		auto ext = filePath.path().extension();
-
-		switch (extensionMap[ext.string()])
+		switch (extensionMap.at(source.file.extension().string()))
 		{
 		case AssetType::Texture:
-			out.textureMap[filePath.path().filename().replace_extension().string() + outExt] = out.trivial.countTextures++;
+			out.textureMap[source.outName] = static_cast<u16>(out.trivial.countTextures++);
 			break;
 		default:
 			break;
@@ -75,45 +122,156 @@ AssetMetaData GenerateMetaData(const std::filesystem::path& path, const std::str
 	return out;
 }
 
-void WriteTexture(const std::filesystem::path& in, std::ofstream* out);
+// FNV-1a of the source bytes
+u64 HashFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		FatalError(std::string("Failed to read: ") + path.string());
+	}
+
+	u64 hash = 14695981039346656037ull ^ BAKE_VERSION;
+	char buffer[64 * 1024];
+	while (file)
+	{
+		file.read(buffer, sizeof(buffer));
+		for (std::streamsize i = 0; i < file.gcount(); ++i)
+		{
+			hash ^= static_cast<u8>(buffer[i]);
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+// The manifest holds the hash of the source each output was baked from, one "<hash> <output>" per line.
+// The name goes last since paths can have spaces in them.
+using BakeManifest = std::map<std::string, u64>;
+
+BakeManifest ReadManifest(const std::filesystem::path& path)
+{
+	BakeManifest manifest;
+	std::ifstream file(path);
+	std::string name;
+	u64 hash;
+	while (file >> std::hex >> hash && std::getline(file >> std::ws, name))
+	{
+		manifest[name] = hash;
+	}
+	return manifest;
+}
+
+// Writes next to the target and renames over it, a crash mid write never leaves a truncated file behind
+template<typename WriteFunc>
+void WriteFileAtomic(const std::filesystem::path& path, WriteFunc&& write)
+{
+	auto tempPath = path;
+	tempPath += ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary);
+		if (!file)
+		{
+			FatalError(std::string("Failed to open for writing: ") + tempPath.string());
+		}
+		write(file);
+		if (!file)
+		{
+			FatalError(std::string("Failed to write: ") + tempPath.string());
+		}
+	}
+	std::filesystem::rename(tempPath, path);
+}
+
+void WriteTexture(const std::filesystem::path& in, std::ofstream* out, u32 compressionThreads);
 
 void WriteAssetFiles(const std::filesystem::path& assetPath, const std::filesystem::path& outPath, const std::string& ext = ".dog")
 {
-	AssetMetaData metaData = GenerateMetaData(assetPath, ext);
+	auto sources = GatherSources(assetPath, outPath, ext);
+	AssetMetaData metaData = GenerateMetaData(sources);
 
 	if (!std::filesystem::is_directory(outPath))
 	{
 		std::filesystem::create_directory(outPath);
 	}
 
-	auto& texMap = metaData.textureMap;
+	const auto manifestPath = outPath / "assets.manifest";
+	const BakeManifest oldManifest = ReadManifest(manifestPath);
+	BakeManifest newManifest;
+	std::mutex manifestMutex;
 
-	for (auto& filePath : std::filesystem::directory_iterator(assetPath))
-	{
-		std::ofstream ofile(outPath.string() + std::string("/") + filePath.path().filename().replace_extension().string() + ext, std::ios::binary);
+	// One source per worker at a time, Compressonator gets the cores that are left over
+	const u32 coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+	const u32 workerCount = std::clamp(static_cast<u32>(sources.size()), 1u, coreCount);
+	const u32 compressionThreads = std::max(coreCount / workerCount, 1u);
 
-		auto extension = filePath.path().extension();
-		switch (extensionMap[extension.string()])
+	std::atomic<u32> nextSource = 0;
+	std::atomic<u32> skipped = 0;
+	auto worker = [&]()
+	{
+		for (u32 i = nextSource++; i < sources.size(); i = nextSource++)
 		{
-		case AssetType::Texture:
-			WriteTexture(filePath, &ofile);
-			break;
-		default:
-			FatalError(std::string("Extension not recognized: ") + extension.string());
-			break;
+			const auto& filePath = sources[i].file;
+			const std::string& outName = sources[i].outName;
+			const auto outFile = outPath / outName;
+			const u64 hash = HashFile(filePath);
+
+			auto it = oldManifest.find(outName);
+			if (it != oldManifest.end() && it->second == hash && std::filesystem::exists(outFile))
+			{
+				++skipped;
+			}
+			else
+			{
+				switch (extensionMap.at(filePath.extension().string()))
+				{
+				case AssetType::Texture:
+					std::filesystem::create_directories(outFile.parent_path());
+					WriteFileAtomic(outFile, [&](std::ofstream& file) { WriteTexture(filePath, &file, compressionThreads); });
+					break;
+				default:
+					break;
+				}
+			}
+
+			std::scoped_lock lock(manifestMutex);
+			newManifest[outName] = hash;
 		}
-	}
+	};
 
-	std::ofstream metaFile(outPath.string() + std::string("/") + "assets.meta", std::ios::binary);
-	metaFile.write((char*)&metaData.trivial, sizeof(metaData.trivial));
-	for (auto& item: metaData.textureMap)
+	std::vector<std::thread> workers;
+	for (u32 i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(worker);
+	}
+	for (auto& thread : workers)
 	{
-		metaFile.write((char*)(&item.second), sizeof(item.second));
-		metaFile << item.first << '\0';
+		thread.join();
 	}
+
+	// The index and manifest are only replaced once every asset is baked
+	WriteFileAtomic(outPath / "assets.meta", [&](std::ofstream& metaFile)
+		{
+			metaFile.write((char*)&metaData.trivial, sizeof(metaData.trivial));
+			for (auto& item : metaData.textureMap)
+			{
+				metaFile.write((char*)(&item.second), sizeof(item.second));
+				metaFile << item.first << '\0';
+			}
+		});
+
+	WriteFileAtomic(manifestPath, [&](std::ofstream& manifestFile)
+		{
+			for (auto& [name, hash] : newManifest)
+			{
+				manifestFile << std::hex << hash << ' ' << name << '\n';
+			}
+		});
+
+	std::cout << "Baked " << sources.size() - skipped << " assets, " << skipped << " unchanged\n";
 }
 
-void WriteTexture(const std::filesystem::path& in, std::ofstream* out)
+void WriteTexture(const std::filesystem::path& in, std::ofstream* out, u32 compressionThreads)
 {
 	StartSequence("Loading", in);
 
@@ -136,7 +294,7 @@ void WriteTexture(const std::filesystem::path& in, std::ofstream* out)
 	KernelOptions opts = {
 		.fquality = 0.f,
 		.format = CMP_FORMAT_BC7,
-		.threads = 8,
+		.threads = static_cast<CMP_INT>(compressionThreads),
 	};
 
 	CMP_MipSet outMipset = {};
@@ -4,7 +4,11 @@ int main(int argc, char** argv)
 {
 	CMP_InitFramework();
 
-	WriteAssetFiles("../../assets", "../../asset_output");
+	// AssetManager <asset root> <output directory>, the game reads Assets/Baked with the textures named relative to Assets
+	if (argc >= 3)
+		WriteAssetFiles(argv[1], argv[2]);
+	else
+		WriteAssetFiles("../../assets", "../../asset_output");
 
 	return 0;
 }
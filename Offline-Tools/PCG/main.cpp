@@ -1,7 +1,11 @@
 #include "WFC.h"
 
-int main()
+int main(int argc, char* argv[])
 {
+    //The level is decided by the seed, pass one to regenerate a level.
+    uint64_t seed = argc > 1 ? std::stoull(argv[1]) : (static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()();
+    std::cout << "Seed: " << seed << std::endl;
+
     //Dimensions for the whole level.
     uint32_t w = 30;
     uint32_t h = 7;
@@ -25,7 +29,7 @@ int main()
 
     //The generation has a certain amount of chances to succeed.
     unsigned chances = 100;
-    while (!wfc->GenerateLevel(nrOfRooms, maxWidth, maxHeight, maxDepth) && chances > 0)
+    while (!wfc->GenerateLevel(nrOfRooms, maxWidth, maxHeight, maxDepth, DeriveSeed(seed, 100 - chances)) && chances > 0)
     {
         chances--;
         std::cout << chances << std::endl;
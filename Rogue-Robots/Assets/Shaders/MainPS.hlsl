@@ -453,9 +453,8 @@ PS_OUT main(VS_OUT input)
         }
         
         // Lighting falloff by distance
-        //float SPOTLIGHT_DISTANCE = 100.f;
-        float SPOTLIGHT_DISTANCE = 70.f;
-        float distanceFallOffFactor = (1.f - clamp(length(lightToPos), 0.f, SPOTLIGHT_DISTANCE) / SPOTLIGHT_DISTANCE);
+        float range = perSpotlightData.spotlightArray[k].range;
+        float distanceFallOffFactor = (1.f - clamp(length(lightToPos), 0.f, range) / range);
         distanceFallOffFactor *= distanceFallOffFactor; // quadratic falloff ( just like real light :) )
         contrib *= distanceFallOffFactor;
             
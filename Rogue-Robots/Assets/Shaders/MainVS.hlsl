@@ -17,6 +17,8 @@ struct PerDrawData
     uint submeshID;
     uint materialID;
     uint jointsDescriptor;
+    uint instanceDescriptor; // 0xFFFFFFFF when not instanced
+    uint firstInstance;
 };
 
 struct JointsData
@@ -63,7 +65,7 @@ ConstantBuffer<PerDrawData> perDrawData : register(b1, space0);
 
 
 
-VS_OUT main(uint vertexID : SV_VertexID)
+VS_OUT main(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
 {
     VS_OUT output = (VS_OUT) 0;
     
@@ -105,11 +107,18 @@ VS_OUT main(uint vertexID : SV_VertexID)
     
     ConstantBuffer<PerLightData> perLightData = ResourceDescriptorHeap[constants.spotlightArrayStructureIndex];
     
-    output.wsPos = mul(perDrawData.world, float4(pos, 1.f)).xyz;
+    matrix world = perDrawData.world;
+    if (perDrawData.instanceDescriptor != 0xFFFFFFFF)
+    {
+        StructuredBuffer<matrix> instanceWorlds = ResourceDescriptorHeap[perDrawData.instanceDescriptor];
+        world = instanceWorlds[perDrawData.firstInstance + instanceID];
+    }
+    
+    output.wsPos = mul(world, float4(pos, 1.f)).xyz;
     output.pos = mul(pfData.projMatrix, mul(pfData.viewMatrix, float4(output.wsPos, 1.f)));
     
-    output.nor = mul(perDrawData.world, float4(nor, 0.f)).xyz;
-    output.tan = mul(perDrawData.world, float4(tan, 0.f)).xyz;
+    output.nor = mul(world, float4(nor, 0.f)).xyz;
+    output.tan = mul(world, float4(tan, 0.f)).xyz;
     output.bitan = normalize(cross(output.tan, output.nor));
     output.uv = uv;
  
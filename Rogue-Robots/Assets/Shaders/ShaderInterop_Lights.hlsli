@@ -47,7 +47,7 @@ struct ShaderInterop_SpotLight
     float cutoffAngle;
     float3 direction;
     float strength;
-    uint id;
+    float range;
 };
 
 struct ShaderInterop_AreaLight
@@ -66,5 +66,6 @@ struct SpotlightData
     float strength;
     bool isShadowCaster;
     uint isPlayer; 
-    float2 padding;
+    float range;
+    float padding;
 };
\ No newline at end of file
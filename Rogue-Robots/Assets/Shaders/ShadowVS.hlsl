@@ -26,6 +26,8 @@ struct PerDrawData
     uint submeshID;
     uint materialID;
     uint jointsDescriptor;
+    uint instanceDescriptor; // 0xFFFFFFFF when not instanced
+    uint firstInstance;
 };
 
 struct JointsData
@@ -94,7 +96,14 @@ VS_OUT main(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
         pos = (float3) mul(float4(pos, 1.0f), mat);
     }
     
-    float3 wsPos = mul(perDrawData.world, float4(pos, 1.f)).xyz;
+    matrix world = perDrawData.world;
+    if (perDrawData.instanceDescriptor != 0xFFFFFFFF)
+    {
+        StructuredBuffer<matrix> instanceWorlds = ResourceDescriptorHeap[perDrawData.instanceDescriptor];
+        world = instanceWorlds[perDrawData.firstInstance + instanceID];
+    }
+    
+    float3 wsPos = mul(world, float4(pos, 1.f)).xyz;
     output.pos = mul(perLightData.proj, mul(perLightData.view, float4(wsPos, 1.f)));
     output.targetSlice = constants.smIdx;
     
@@ -12,6 +12,8 @@ struct PerDrawData
     uint submeshID;
     uint materialID;
     uint jointsDescriptor;
+    uint instanceDescriptor; // 0xFFFFFFFF when not instanced
+    uint firstInstance;
 };
 
 struct JointsData
@@ -73,7 +75,14 @@ VS_OUT main(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
         pos = (float3) mul(float4(pos, 1.0f), mat);
     }
     
-    float3 worldPos = mul(perDrawData.world, float4(pos, 1.f)).xyz;
+    matrix world = perDrawData.world;
+    if (perDrawData.instanceDescriptor != 0xFFFFFFFF)
+    {
+        StructuredBuffer<matrix> instanceWorlds = ResourceDescriptorHeap[perDrawData.instanceDescriptor];
+        world = instanceWorlds[perDrawData.firstInstance + instanceID];
+    }
+    
+    float3 worldPos = mul(world, float4(pos, 1.f)).xyz;
     output.pos = mul(pfData.projMatrix, mul(pfData.viewMatrix, float4(worldPos, 1.f)));
  
     return output;
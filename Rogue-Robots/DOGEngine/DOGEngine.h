@@ -33,6 +33,7 @@
 
 #include "src/Graphics/Rendering/UI.h"
 #include "src/Graphics/Rendering/PostProcess.h"
+#include "src/Graphics/Rendering/TiledLightCuller.h"
 
 #include "vendor/includes/ImGUI/imgui.h"
 
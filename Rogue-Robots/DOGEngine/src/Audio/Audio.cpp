@@ -2,7 +2,7 @@
 
 using namespace DOG;
 
-AudioDevice::AudioDevice() : m_audioThread([](AudioDevice* self) { self->AudioThreadRoutine(); }, this)
+XAudio2Device::XAudio2Device() : m_audioThread([](XAudio2Device* self) { self->AudioThreadRoutine(); }, this)
 {
 	try
 	{
@@ -20,15 +20,17 @@ AudioDevice::AudioDevice() : m_audioThread([](AudioDevice* self) { self->AudioTh
 	catch (HRError& e)
 	{
 		m_threadShouldDie = true;
-		m_audioThread.detach();
+		m_threadSignal.Notify();
+		m_audioThread.join();
 		throw e;
 	}
 }
 
-AudioDevice::~AudioDevice()
+XAudio2Device::~XAudio2Device()
 {
 	m_threadShouldDie = true;
-	m_audioThread.detach();
+	m_threadSignal.Notify();
+	m_audioThread.join();
 
 	for (auto& source : m_sources)
 	{
@@ -41,7 +43,7 @@ AudioDevice::~AudioDevice()
 	m_xaudio->Release();
 }
 
-void AudioDevice::HandleComponent(AudioComponent& comp, entity e)
+void XAudio2Device::HandleComponent(AudioComponent& comp, entity e)
 {
 	if (comp.shouldPlay)
 	{
@@ -57,7 +59,7 @@ void AudioDevice::HandleComponent(AudioComponent& comp, entity e)
 		auto freeVoice = (u32)GetFreeVoice(wfx);
 		auto& source = m_sources[freeVoice];
 
-		source = std::make_unique<SourceVoice>(m_xaudio, wfx);
+		source = std::make_unique<SourceVoice>(m_xaudio, wfx, &m_threadSignal);
 		comp.source = freeVoice;
 
 		if (asset->async)
@@ -65,6 +67,13 @@ void AudioDevice::HandleComponent(AudioComponent& comp, entity e)
 			source->SetFileReader(WAVFileReader(asset->filePath));
 			source->PlayAsync();
 		}
+		else if (asset->compressed)
+		{
+			source->Play(m_sampleCache.GetOrDecode(comp.assetID, [asset]()
+				{
+					return IMAADPCM::Decode(asset->audioData, asset->encodedProperties.nChannels, asset->encodedProperties.nBlockAlign);
+				}));
+		}
 		else
 		{
 			source->Play(asset->audioData);
@@ -137,20 +146,37 @@ void AudioDevice::HandleComponent(AudioComponent& comp, entity e)
 	source->SetVolume(source->GetVolume() * comp.volume);
 }
 
-void AudioDevice::Commit()
+void XAudio2Device::Commit()
 {
 	m_xaudio->CommitChanges(XAUDIO2_COMMIT_NOW);
 }
 
-void AudioDevice::AudioThreadRoutine()
+void XAudio2Device::AudioThreadRoutine()
 {
+	MiniProfiler::SetThreadName("Audio streaming");
 	while (!m_threadShouldDie)
 	{
+		bool notified = false;
+		{
+			std::unique_lock<std::mutex> lock(m_threadSignal.mutex);
+			notified = m_threadSignal.condition.wait_for(lock, AUDIO_THREAD_WAKE_INTERVAL, [this]() { return m_threadSignal.pending || m_threadShouldDie; });
+			m_threadSignal.pending = false;
+		}
+
+		if (m_threadShouldDie)
+			break;
+
+		MINIPROFILE_NAMED("AudioStreamingRefill");
 		for (auto& source: m_sources)
 		{
 			if (!source || source->Stopped())
 				continue;
 
+			// On a buffer-end wake only the voices that consumed a buffer are refilled,
+			// a timed out wait tops up every playing voice (covers freshly started and seeked voices)
+			if (!source->m_needsRefill.exchange(false) && notified)
+				continue;
+
 			std::scoped_lock<std::mutex> lock(source->m_loopMutex);
 
 			if (!source || !source->m_source) 
@@ -165,7 +191,7 @@ void AudioDevice::AudioThreadRoutine()
 	}
 }
 
-u64 AudioDevice::GetFreeVoice(const WAVEFORMATEX& m_wfx)
+u64 XAudio2Device::GetFreeVoice(const WAVEFORMATEX& m_wfx)
 {
 	// Find voice with matching WFX
 	for (int i = 0; i < m_sources.size(); ++i)
@@ -210,11 +236,15 @@ u64 AudioDevice::GetFreeVoice(const WAVEFORMATEX& m_wfx)
 	return u64(-1);
 }
 
-void AudioDevice::Handle3DComponent(SourceVoice* source, entity e)
+void XAudio2Device::Handle3DComponent(SourceVoice* source, entity e)
 {
-	std::vector<f32> azimuths(source->m_wfx.nChannels);
-	std::iota(azimuths.begin(), azimuths.end(), 0.f);
-	std::transform(azimuths.begin(), azimuths.end(), azimuths.begin(), [](auto angle) { return (angle + 0.5f) * X3DAUDIO_PI; });
+	// Stack storage, this runs for every 3D component every frame
+	std::array<f32, XAUDIO2_MAX_AUDIO_CHANNELS> azimuths;
+	std::array<f32, XAUDIO2_MAX_AUDIO_CHANNELS * 8> matrix;
+	assert(source->m_wfx.nChannels * m_masterDetails.InputChannels <= matrix.size());
+
+	for (u32 i = 0; i < source->m_wfx.nChannels; ++i)
+		azimuths[i] = (i + 0.5f) * X3DAUDIO_PI;
 
 	auto playPos = EntityManager::Get().GetComponent<TransformComponent>(e).GetPosition();
 
@@ -237,7 +267,6 @@ void AudioDevice::Handle3DComponent(SourceVoice* source, entity e)
 		.Do([&](AudioListenerComponent& /*listener*/, TransformComponent& transform)
 			{
 				listenersExist = true;
-				std::vector<f32> matrix(dspSettings.DstChannelCount * dspSettings.SrcChannelCount);
 				X3DAUDIO_LISTENER ls = {
 					.OrientFront = transform.GetForward(),
 					.OrientTop = transform.GetUp(),
@@ -248,7 +277,7 @@ void AudioDevice::Handle3DComponent(SourceVoice* source, entity e)
 
 				dspSettings.pMatrixCoefficients = matrix.data();
 				X3DAudioCalculate(m_x3daudio, &ls, &es, X3DAUDIO_CALCULATE_MATRIX, &dspSettings);
-				source->SetOutputMatrix(matrix, m_master);
+				source->SetOutputMatrix(std::span<const f32>(matrix.data(), dspSettings.DstChannelCount * dspSettings.SrcChannelCount), m_master);
 			});
 	if (!listenersExist)
 	{
@@ -256,19 +285,42 @@ void AudioDevice::Handle3DComponent(SourceVoice* source, entity e)
 	}
 }
 
+void AudioThreadSignal::Notify()
+{
+	// No lock so the XAudio2 callback never waits on the audio thread, a wake that races the wait is caught by its timeout
+	pending = true;
+	condition.notify_one();
+}
+
 // ------- SOURCE VOICE ----------
 
-SourceVoice::SourceVoice(IXAudio2* audioDevice, WAVEFORMATEX wfx) : m_wfx(std::move(wfx))
+void SourceVoice::VoiceCallback::OnBufferEnd(void*)
 {
-	HRESULT hr = audioDevice->CreateSourceVoice(&m_source, &m_wfx);
+	// Runs on the XAudio2 processing thread, must not block
+	m_owner->m_needsRefill = true;
+	m_signal->Notify();
+}
+
+SourceVoice::SourceVoice(IXAudio2* audioDevice, WAVEFORMATEX wfx, AudioThreadSignal* signal) : m_wfx(std::move(wfx)), m_callback(this, signal)
+{
+	m_bufferRing.resize(CHUNK_SIZE * RING_SIZE);
+
+	HRESULT hr = audioDevice->CreateSourceVoice(&m_source, &m_wfx, 0, XAUDIO2_DEFAULT_FREQ_RATIO, &m_callback);
 	if (FAILED(hr)) { throw false; }
 }
 
-void SourceVoice::Play(std::span<u8> data)
+void SourceVoice::Play(std::shared_ptr<const std::vector<u8>> samples)
+{
+	m_cachedSamples = std::move(samples);
+	Play(std::span<const u8>(*m_cachedSamples));
+}
+
+void SourceVoice::Play(std::span<const u8> data)
 {
 	m_externalBuffer = data;
 	m_idx = 0;
 	m_stopped = false;
+	m_endOfData = false;
 
 	QueueNext();
 
@@ -280,6 +332,7 @@ void SourceVoice::PlayAsync()
 {
 	m_async = true;
 	m_stopped = false;
+	m_endOfData = false;
 
 	QueueNextAsync();
 
@@ -310,7 +363,7 @@ f32 DOG::SourceVoice::GetVolume()
 	return volume;
 }
 
-void SourceVoice::SetOutputMatrix(const std::vector<f32>& matrix, IXAudio2Voice* dest)
+void SourceVoice::SetOutputMatrix(std::span<const f32> matrix, IXAudio2Voice* dest)
 {
 	auto destChannels = matrix.size()/m_wfx.nChannels;
 	HR hr = m_source->SetOutputMatrix(dest, m_wfx.nChannels, (u32)destChannels, matrix.data());
@@ -321,6 +374,7 @@ void SourceVoice::SeekTo(f32 seconds)
 {
 	u32 loopStartSample = static_cast<u32>(seconds * m_wfx.nSamplesPerSec);
 	m_asyncWFR.SeekToSample(loopStartSample);
+	m_endOfData = false;
 
 	m_samplesPlayed = loopStartSample;
 	m_lastSeek = m_samplesPlayed;
@@ -344,7 +398,6 @@ bool SourceVoice::HasFinished()
 	{
 		std::scoped_lock lk(m_stopMutex);
 		Stop();
-		for (auto& buf: m_bufferRing) buf.resize(0);
 	}
 
 	return state.BuffersQueued == 0;
@@ -378,38 +431,34 @@ void SourceVoice::QueueNext()
 	XAUDIO2_VOICE_STATE state;
 	m_source->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
 
-	while (state.BuffersQueued < m_bufferRing.size() && !m_stopped)
+	while (state.BuffersQueued < RING_SIZE && !m_stopped && !m_endOfData)
 	{
 		std::scoped_lock lk(m_stopMutex);
 		auto it = m_externalBuffer.begin() + m_idx;
 
-		auto& curBuffer = m_bufferRing[m_ringIdx++];
+		auto curBuffer = RingSlot(m_ringIdx++);
 
 		u64 newSize = std::min(CHUNK_SIZE, m_externalBuffer.size()-m_idx);
 
-		if (curBuffer.size() == 0)
-		{
-			curBuffer.resize(newSize);
-		}
-
 		std::copy(it, it + newSize, curBuffer.begin());
 
 		XAUDIO2_BUFFER buf = {
-			.AudioBytes = (u32)curBuffer.size(),
+			.AudioBytes = (u32)newSize,
 			.pAudioData = curBuffer.data(),
 		};
 
 		HR hr = m_source->SubmitSourceBuffer(&buf);
 		hr.try_fail("Failed to submit source buffer");
 
-		m_ringIdx %= m_bufferRing.size();
+		m_ringIdx %= RING_SIZE;
 
 		m_idx += CHUNK_SIZE;
 
+		// Stop() would flush the buffers still queued, HasFinished stops the voice once they have played
 		if (m_idx >= m_externalBuffer.size())
 		{
 			m_idx = m_externalBuffer.size();
-			Stop();
+			m_endOfData = true;
 			break;
 		}
 
@@ -421,29 +470,32 @@ void SourceVoice::QueueNextAsync()
 {
 	XAUDIO2_VOICE_STATE state;
 	m_source->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
-	const auto bufferRingSize = m_bufferRing.size();
 
-	while (state.BuffersQueued < bufferRingSize && !m_stopped)
+	while (state.BuffersQueued < RING_SIZE && !m_stopped && !m_endOfData)
 	{
 		std::scoped_lock lk(m_stopMutex);
-		auto& curBuffer = m_bufferRing[m_ringIdx++];
+		auto curBuffer = RingSlot(m_ringIdx++);
 
-		curBuffer = m_asyncWFR.ReadDataChunk(CHUNK_SIZE);
-		if (curBuffer.size() < CHUNK_SIZE)
+		u32 bytesRead = m_asyncWFR.ReadDataChunk(curBuffer);
+		if (bytesRead > 0)
 		{
-			Stop();
-			break;
-		}
+			XAUDIO2_BUFFER buf = {
+				.AudioBytes = bytesRead,
+				.pAudioData = curBuffer.data(),
+			};
 
-		XAUDIO2_BUFFER buf = {
-			.AudioBytes = (u32)curBuffer.size(),
-			.pAudioData = curBuffer.data(),
-		};
+			HR hr = m_source->SubmitSourceBuffer(&buf);
+			hr.try_fail("Failed to submit source buffer");
+		}
 
-		HR hr = m_source->SubmitSourceBuffer(&buf);
-		hr.try_fail("Failed to submit source buffer");
+		m_ringIdx %= RING_SIZE;
 
-		m_ringIdx %= m_bufferRing.size();
+		// The last chunk is short, let the queued buffers play out instead of flushing them with Stop()
+		if (bytesRead < CHUNK_SIZE)
+		{
+			m_endOfData = true;
+			break;
+		}
 
 		m_source->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
 	}
@@ -1,28 +1,66 @@
 #pragma once
 #include "AudioFileReader.h"
+#include "AudioSampleCache.h"
 #include "../Core/AssetManager.h"
 #include "../ECS/EntityManager.h"
 
 namespace DOG
 {
-	class AudioDevice;
+	class XAudio2Device;
+
+	// Wakes the audio streaming thread when a voice has consumed a buffer
+	struct AudioThreadSignal
+	{
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::atomic_bool pending = false;
+
+		void Notify();
+	};
 
 	class SourceVoice
 	{
-		friend class AudioDevice;
+		friend class XAudio2Device;
 	public:
 
 	private:
+		class VoiceCallback : public IXAudio2VoiceCallback
+		{
+		public:
+			VoiceCallback(SourceVoice* owner, AudioThreadSignal* signal) : m_owner(owner), m_signal(signal) {}
+
+			void __stdcall OnBufferEnd(void*) override;
+			void __stdcall OnStreamEnd() override {}
+			void __stdcall OnVoiceProcessingPassStart(UINT32) override {}
+			void __stdcall OnVoiceProcessingPassEnd() override {}
+			void __stdcall OnBufferStart(void*) override {}
+			void __stdcall OnLoopEnd(void*) override {}
+			void __stdcall OnVoiceError(void*, HRESULT) override {}
+
+		private:
+			SourceVoice* m_owner;
+			AudioThreadSignal* m_signal;
+		};
+
+	private:
+		static constexpr u64 CHUNK_SIZE = 4096;
+		static constexpr u64 RING_SIZE = 16;
+
 		WAVEFORMATEX m_wfx;
 		IXAudio2SourceVoice* m_source = nullptr;
+		VoiceCallback m_callback;
 		std::atomic_bool m_stopped = true;
 		std::atomic_bool m_async = false;
+		std::atomic_bool m_needsRefill = false;
+		std::atomic_bool m_endOfData = false; // Everything has been submitted, the queued buffers still play out
 
 		u64 m_idx = 0;
-		std::span<u8> m_externalBuffer;
+		std::span<const u8> m_externalBuffer;
+		std::shared_ptr<const std::vector<u8>> m_cachedSamples; // Keeps decoded samples alive if they get evicted while playing
 
+		// Preallocated once per voice, chunks are read straight into their ring slot
 		u64 m_ringIdx = 0;
-		std::array<std::vector<u8>, 16> m_bufferRing;
+		std::vector<u8> m_bufferRing;
 		DOG::WAVFileReader m_asyncWFR;
 
 		u64 m_lastSeek = 0;
@@ -32,12 +70,11 @@ namespace DOG
 		std::mutex m_loopMutex;
 		std::mutex m_stopMutex;
 
-		static constexpr u64 CHUNK_SIZE = 1024;
 		static constexpr f32 BASE_VOLUME = 2.0f;
 
 	public:
 		SourceVoice() = delete;
-		SourceVoice(IXAudio2* audioDevice, WAVEFORMATEX wfx);
+		SourceVoice(IXAudio2* audioDevice, WAVEFORMATEX wfx, AudioThreadSignal* signal);
 		~SourceVoice() {
 			std::scoped_lock<std::mutex> lock(m_loopMutex);
 			if (m_source)
@@ -48,13 +85,14 @@ namespace DOG
 		}
 
 	public:
-		void Play(std::span<u8> data);
+		void Play(std::span<const u8> data);
+		void Play(std::shared_ptr<const std::vector<u8>> samples);
 		void PlayAsync();
 		void Stop();
 		void SetVolume(f32 volume);
 		f32 GetVolume();
 
-		void SetOutputMatrix(const std::vector<f32>& matrix, IXAudio2Voice* dest);
+		void SetOutputMatrix(std::span<const f32> matrix, IXAudio2Voice* dest);
 		void SeekTo(f32 seconds);
 
 		bool HasFinished();
@@ -65,12 +103,25 @@ namespace DOG
 		void SetFileReader(DOG::WAVFileReader&& wfr) { this->m_asyncWFR = std::move(wfr); }
 		void QueueNext();
 		void QueueNextAsync();
+
+	private:
+		std::span<u8> RingSlot(u64 idx) { return std::span<u8>(m_bufferRing).subspan(idx * CHUNK_SIZE, CHUNK_SIZE); }
 	};
 
 
 
 	class AudioDevice
 	{
+	public:
+		virtual ~AudioDevice() = default;
+
+		virtual void HandleComponent(AudioComponent& comp, entity e) = 0;
+		virtual void Commit() = 0;
+		virtual void SetMasterVolume(f32 volume) noexcept = 0;
+	};
+
+	class XAudio2Device : public AudioDevice
+	{
 	private:
 		IXAudio2* m_xaudio = nullptr;
 		IXAudio2MasteringVoice* m_master = nullptr;
@@ -80,16 +131,24 @@ namespace DOG
 
 		std::array<std::unique_ptr<SourceVoice>, 128> m_sources = { nullptr };
 
+		// Decoded PCM of compressed in-memory assets
+		static constexpr u64 SAMPLE_CACHE_BUDGET = 32 * 1024 * 1024;
+		AudioSampleCache<u8> m_sampleCache{ SAMPLE_CACHE_BUDGET };
+
+		// Upper bound on how long the streaming thread sleeps without a buffer-end notification
+		static constexpr std::chrono::milliseconds AUDIO_THREAD_WAKE_INTERVAL{ 10 };
+
+		AudioThreadSignal m_threadSignal;
 		std::atomic_bool m_threadShouldDie = false;
 		std::thread m_audioThread;
 
 	public:
-		AudioDevice();
-		~AudioDevice();
+		XAudio2Device();
+		~XAudio2Device();
 
-		void HandleComponent(AudioComponent& comp, entity e);
-		void Commit();
-		void SetMasterVolume(f32 volume) noexcept { m_master->SetVolume(volume); };
+		void HandleComponent(AudioComponent& comp, entity e) override;
+		void Commit() override;
+		void SetMasterVolume(f32 volume) noexcept override { m_master->SetVolume(volume); };
 
 	private:
 		void AudioThreadRoutine();
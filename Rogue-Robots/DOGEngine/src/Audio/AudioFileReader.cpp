@@ -1,16 +1,118 @@
 #include "AudioFileReader.h"
+#include "../Core/AssetFileSystem.h"
 
 using namespace DOG;
 
-WAVFileReader::WAVFileReader(const std::filesystem::path& path) : m_file(path, std::ios::binary)
+namespace
 {
-	m_fileSize = std::filesystem::file_size(path);
+	constexpr i32 IMA_STEP_TABLE[89] = {
+		7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+		50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+		337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+		2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+		15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+	};
+
+	constexpr i32 IMA_INDEX_TABLE[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+	struct IMAChannelState
+	{
+		i32 predictor = 0;
+		i32 stepIndex = 0;
+
+		i16 Decode(u8 nibble)
+		{
+			const i32 step = IMA_STEP_TABLE[stepIndex];
+			i32 diff = step >> 3;
+			if (nibble & 1) diff += step >> 2;
+			if (nibble & 2) diff += step >> 1;
+			if (nibble & 4) diff += step;
+			if (nibble & 8) diff = -diff;
+
+			predictor = std::clamp(predictor + diff, -32768, 32767);
+			stepIndex = std::clamp(stepIndex + IMA_INDEX_TABLE[nibble & 7], 0, 88);
+			return static_cast<i16>(predictor);
+		}
+	};
+}
+
+u32 IMAADPCM::SamplesPerBlock(u32 blockAlign, u32 channels)
+{
+	return FramesInBlock(blockAlign, channels);
+}
+
+u32 IMAADPCM::FramesInBlock(u32 blockBytes, u32 channels)
+{
+	const u32 headerBytes = 4 * channels;
+	if (blockBytes < headerBytes)
+		return 0;
+
+	// The header holds the first sample, then every channel contributes 4 bytes (8 samples) per group
+	return 1 + ((blockBytes - headerBytes) / headerBytes) * 8;
+}
+
+u32 IMAADPCM::DecodeBlock(std::span<const u8> block, u32 channels, i16* out)
+{
+	const u32 frames = FramesInBlock(static_cast<u32>(block.size()), channels);
+	if (frames == 0)
+		return 0;
+
+	std::array<IMAChannelState, 2> states;
+	assert(channels <= states.size());
+
+	const u8* p = block.data();
+	for (u32 c = 0; c < channels; ++c)
+	{
+		states[c].predictor = static_cast<i16>(p[0] | (p[1] << 8));
+		states[c].stepIndex = std::clamp<i32>(p[2], 0, 88);
+		out[c] = static_cast<i16>(states[c].predictor);
+		p += 4;
+	}
+
+	const u32 groups = (frames - 1) / 8;
+	for (u32 g = 0; g < groups; ++g)
+	{
+		for (u32 c = 0; c < channels; ++c)
+		{
+			i16* dst = out + (1 + g * 8) * channels + c;
+			for (u32 b = 0; b < 4; ++b)
+			{
+				const u8 byte = *p++;
+				dst[(b * 2) * channels] = states[c].Decode(byte & 0xF);
+				dst[(b * 2 + 1) * channels] = states[c].Decode(byte >> 4);
+			}
+		}
+	}
+
+	return frames;
+}
+
+std::vector<u8> IMAADPCM::Decode(std::span<const u8> data, u32 channels, u32 blockAlign)
+{
+	const u64 fullBlocks = data.size() / blockAlign;
+	const u64 frames = fullBlocks * SamplesPerBlock(blockAlign, channels) + FramesInBlock(static_cast<u32>(data.size() % blockAlign), channels);
+
+	std::vector<u8> outData(frames * channels * sizeof(i16));
+	i16* out = reinterpret_cast<i16*>(outData.data());
+
+	for (u64 offset = 0; offset < data.size(); offset += blockAlign)
+	{
+		const u64 blockBytes = std::min<u64>(blockAlign, data.size() - offset);
+		out += DecodeBlock(data.subspan(offset, blockBytes), channels, out) * channels;
+	}
+
+	return outData;
+}
+
+WAVFileReader::WAVFileReader(const std::filesystem::path& path) : m_file(AssetFileSystem::OpenStream(path))
+{
+	m_fileSize = AssetFileSystem::FileSize(path).value_or(0);
 }
 
 WAVEFORMATEX WAVFileReader::ReadWFXProperties()
 {
-	i64 curPos = m_file.tellg();
-	m_file.seekg(0, std::ios_base::beg);
+	i64 curPos = m_file->tellg();
+	m_file->seekg(0, std::ios_base::beg);
 	ChunkType chunkType = ChunkType::RIFF;
 
 	while ((chunkType = ReadNextChunkType()) != ChunkType::Format)
@@ -19,11 +121,57 @@ WAVEFORMATEX WAVFileReader::ReadWFXProperties()
 		SkipChunk(chunkType);
 	}
 	ReadFormat();
-	m_file.seekg(curPos, std::ios_base::beg);
+	m_file->seekg(curPos, std::ios_base::beg);
 	return m_wfx;
 }
 
 std::vector<u8> WAVFileReader::ReadDataChunk(u32 chunkSize)
+{
+	std::vector<u8> outData(chunkSize);
+	outData.resize(ReadDataChunk(std::span<u8>(outData)));
+	return outData;
+}
+
+u32 WAVFileReader::ReadDataChunk(std::span<u8> dest)
+{
+	if (m_wfx.wFormatTag == 0)
+	{
+		ReadWFXProperties();
+	}
+
+	if (!m_compressed)
+	{
+		return ReadRawDataChunk(dest);
+	}
+
+	if (m_dataStart == 0)
+	{
+		ReadRawDataChunk(std::span<u8>()); // Locate the data chunk
+	}
+
+	// Hand out decoded PCM, decoding one block at a time into the preallocated block buffer
+	u32 written = 0;
+	while (written < dest.size())
+	{
+		if (m_decodedOffset == m_decodedBytes)
+		{
+			u32 blockBytes = ReadRawDataChunk(m_encodedBlock);
+			u32 frames = IMAADPCM::DecodeBlock(std::span<const u8>(m_encodedBlock.data(), blockBytes), m_encodedWfx.nChannels, m_decodedBlock.data());
+			m_decodedOffset = 0;
+			m_decodedBytes = frames * m_wfx.nBlockAlign;
+			if (frames == 0)
+				break;
+		}
+
+		u32 count = std::min(static_cast<u32>(dest.size()) - written, m_decodedBytes - m_decodedOffset);
+		std::memcpy(dest.data() + written, reinterpret_cast<const u8*>(m_decodedBlock.data()) + m_decodedOffset, count);
+		m_decodedOffset += count;
+		written += count;
+	}
+	return written;
+}
+
+u32 WAVFileReader::ReadRawDataChunk(std::span<u8> dest)
 {
 	if (m_dataChunkBytesLeft == 0)
 	{
@@ -33,27 +181,40 @@ std::vector<u8> WAVFileReader::ReadDataChunk(u32 chunkSize)
 			SkipChunk(chunkType);
 		}
 
-		if (chunkType == ChunkType::EndOfFile) return {};
+		if (chunkType == ChunkType::EndOfFile) return 0;
 
-		m_file.read((char*)&m_dataChunkBytesLeft, sizeof(u32));
+		m_file->read((char*)&m_dataChunkBytesLeft, sizeof(u32));
 		m_dataSize = m_dataChunkBytesLeft;
 
 		if (m_dataStart == 0)
 		{
-			m_dataStart = m_file.tellg();
+			m_dataStart = m_file->tellg();
 			m_dataStart -= 4;
 		}
 	}
-	chunkSize = std::min(m_dataChunkBytesLeft, chunkSize);
+	u32 chunkSize = std::min(m_dataChunkBytesLeft, static_cast<u32>(dest.size()));
 
-	std::vector<u8> outData(chunkSize);
-	m_file.read((char*)outData.data(), chunkSize);
+	m_file->read((char*)dest.data(), chunkSize);
 
 	m_dataChunkBytesLeft -= chunkSize;
-	return outData;
+	return chunkSize;
 }
 
 std::vector<u8> WAVFileReader::ReadFull()
+{
+	if (m_wfx.wFormatTag == 0)
+	{
+		ReadWFXProperties();
+	}
+
+	if (m_compressed)
+	{
+		return IMAADPCM::Decode(ReadEncodedFull(), m_encodedWfx.nChannels, m_encodedWfx.nBlockAlign);
+	}
+	return ReadEncodedFull();
+}
+
+std::vector<u8> WAVFileReader::ReadEncodedFull()
 {
 	std::vector<u8> outData;
 	ChunkType chunkType = ChunkType::RIFF;
@@ -67,10 +228,10 @@ std::vector<u8> WAVFileReader::ReadFull()
 		if (chunkType == ChunkType::EndOfFile) break;
 
 		u32 chunkSize;
-		m_file.read((char*)&chunkSize, sizeof(u32));
+		m_file->read((char*)&chunkSize, sizeof(u32));
 
 		std::vector<u8> chunkData(chunkSize);
-		m_file.read((char*)chunkData.data(), chunkSize);
+		m_file->read((char*)chunkData.data(), chunkSize);
 
 		std::copy(chunkData.begin(), chunkData.end(), std::back_inserter(outData));
 	}
@@ -80,6 +241,12 @@ std::vector<u8> WAVFileReader::ReadFull()
 
 u32 WAVFileReader::DataSize()
 {
+	if (m_dataSize && m_compressed)
+	{
+		const u32 blockAlign = m_encodedWfx.nBlockAlign;
+		const u32 frames = (m_dataSize / blockAlign) * m_samplesPerBlock + IMAADPCM::FramesInBlock(m_dataSize % blockAlign, m_encodedWfx.nChannels);
+		return frames * m_wfx.nBlockAlign;
+	}
 	if (m_dataSize)
 	{
 		return m_dataSize;
@@ -99,13 +266,25 @@ void WAVFileReader::SeekToSample(u32 sample)
 		ReadDataChunk(0); // Dummy read to find data chunk
 	}
 
-	auto sampleSize = m_wfx.nBlockAlign;
-	m_file.seekg(m_dataStart);
-	m_file.read((char*)&m_dataChunkBytesLeft, sizeof(u32));
+	// Compressed files seek to the start of the block holding the sample and skip the leading decoded frames
+	const u32 block = m_compressed ? sample / m_samplesPerBlock : 0;
+	const u32 rawOffset = m_compressed ? block * m_encodedWfx.nBlockAlign : sample * m_wfx.nBlockAlign;
 
-	m_file.seekg(sample*sampleSize, std::ios_base::cur);
+	m_file->clear(); // Seeking back after reaching the end of the file
+	m_file->seekg(m_dataStart);
+	m_file->read((char*)&m_dataChunkBytesLeft, sizeof(u32));
 
-	m_dataChunkBytesLeft -= sample;
+	m_file->seekg(rawOffset, std::ios_base::cur);
+
+	m_dataChunkBytesLeft -= std::min(m_dataChunkBytesLeft, rawOffset);
+
+	if (m_compressed)
+	{
+		u32 blockBytes = ReadRawDataChunk(m_encodedBlock);
+		u32 frames = IMAADPCM::DecodeBlock(std::span<const u8>(m_encodedBlock.data(), blockBytes), m_encodedWfx.nChannels, m_decodedBlock.data());
+		m_decodedBytes = frames * m_wfx.nBlockAlign;
+		m_decodedOffset = std::min(m_decodedBytes, (sample - block * m_samplesPerBlock) * m_wfx.nBlockAlign);
+	}
 }
 
 void WAVFileReader::SkipChunk(ChunkType type)
@@ -120,16 +299,16 @@ void WAVFileReader::SkipChunk(ChunkType type)
 	}
 	else if (type == ChunkType{ -1 })
 	{
-		m_file.read((char*)&skip, sizeof(u32));
+		m_file->read((char*)&skip, sizeof(u32));
 		//std::cout << "Skipping unknown chunk: " << skip << " bytes" << std::endl;
 	}
 	else
 	{
-		m_file.read((char*)&skip, sizeof(u32));
+		m_file->read((char*)&skip, sizeof(u32));
 	}
 	skip += (skip % 2);
-	m_file.seekg((i32)skip, std::ios_base::cur);
-	auto tellg = m_file.tellg();
+	m_file->seekg((i32)skip, std::ios_base::cur);
+	auto tellg = m_file->tellg();
 	//std::cout << "Skipping " << skip << " bytes" << std::endl;
 }
 
@@ -140,21 +319,53 @@ void WAVFileReader::ReadFormat()
 
 	constexpr u64 FORMAT_CHUNK_SIZE = 24;
 	u32 chunkSize = 0;
-	m_file.read((char*)&chunkSize, sizeof(u32));
+	m_file->read((char*)&chunkSize, sizeof(u32));
+
+	WAVEFORMATEX wfx = {};
+	m_file->read((char*)&wfx, FORMAT_CHUNK_SIZE - 8);
+
+	if (wfx.wFormatTag != IMAADPCM::FORMAT_TAG)
+	{
+		m_wfx = wfx;
+		return;
+	}
+
+	// IMA ADPCM extends the format with cbSize and the number of samples per block
+	u16 extension[2] = {};
+	if (chunkSize >= FORMAT_CHUNK_SIZE - 8 + sizeof(extension))
+	{
+		m_file->read((char*)extension, sizeof(extension));
+	}
+
+	assert(wfx.nChannels <= 2 && "IMA ADPCM is only supported for mono and stereo");
+	m_compressed = true;
+	m_encodedWfx = wfx;
+	m_samplesPerBlock = extension[1] ? extension[1] : IMAADPCM::SamplesPerBlock(wfx.nBlockAlign, wfx.nChannels);
+
+	m_wfx = {
+		.wFormatTag = WAVE_FORMAT_PCM,
+		.nChannels = wfx.nChannels,
+		.nSamplesPerSec = wfx.nSamplesPerSec,
+		.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nChannels * static_cast<u32>(sizeof(i16)),
+		.nBlockAlign = static_cast<u16>(wfx.nChannels * sizeof(i16)),
+		.wBitsPerSample = 16,
+		.cbSize = 0,
+	};
 
-	m_file.read((char*)&m_wfx, FORMAT_CHUNK_SIZE - 8);
+	m_encodedBlock.resize(wfx.nBlockAlign);
+	m_decodedBlock.resize(static_cast<u64>(m_samplesPerBlock) * wfx.nChannels);
 }
 
 WAVFileReader::ChunkType WAVFileReader::ReadNextChunkType()
 {
-	auto tellg = m_file.tellg();
-	if (m_file.tellg() == static_cast<std::streampos>(m_fileSize))
+	auto tellg = m_file->tellg();
+	if (m_file->tellg() == static_cast<std::streampos>(m_fileSize))
 	{
 		return ChunkType::EndOfFile;
 	}
 
 	i32 type = 0x0;
-	m_file.read((char*)&type, sizeof(i32));
+	m_file->read((char*)&type, sizeof(i32));
 
 	// Compare to little-endian int representation of chunk types
 	if (type == 0x46464952)
@@ -2,7 +2,22 @@
 
 namespace DOG
 {
+	// IMA ADPCM as stored in WAV files, 4 bits per sample in blocks that each start with a per-channel predictor header
+	class IMAADPCM
+	{
+	public:
+		static constexpr u16 FORMAT_TAG = 0x0011;
 
+		static u32 SamplesPerBlock(u32 blockAlign, u32 channels);
+		static u32 FramesInBlock(u32 blockBytes, u32 channels);
+
+		// Decodes one (possibly truncated) block into interleaved 16-bit PCM, returns the number of frames written
+		static u32 DecodeBlock(std::span<const u8> block, u32 channels, i16* out);
+		static std::vector<u8> Decode(std::span<const u8> data, u32 channels, u32 blockAlign);
+	};
+
+	// Reads RIFF/WAV files. IMA ADPCM files are decoded block by block, so every read returns 16-bit PCM
+	// and ReadWFXProperties describes the decoded format.
 	class WAVFileReader
 	{
 	public:
@@ -10,12 +25,19 @@ namespace DOG
 		WAVFileReader(const std::filesystem::path& path);
 		WAVEFORMATEX ReadWFXProperties();
 		std::vector<u8> ReadDataChunk(u32 chunkSize);
+		// Reads up to dest.size() bytes into caller owned memory, returns the number of bytes read
+		u32 ReadDataChunk(std::span<u8> dest);
 		std::vector<u8> ReadFull();
+		// The data chunk as stored in the file, without decoding
+		std::vector<u8> ReadEncodedFull();
 
 		u32 DataSize();
 
 		void SeekToSample(u32 sample);
 
+		bool IsCompressed() const noexcept { return m_compressed; }
+		const WAVEFORMATEX& EncodedWFXProperties() const noexcept { return m_encodedWfx; }
+
 	private:
 		enum class ChunkType
 		{
@@ -31,7 +53,7 @@ namespace DOG
 		};
 
 	private:
-		std::ifstream m_file;
+		std::unique_ptr<std::istream> m_file;	// From AssetFileSystem, either a loose file or an archive entry
 		u64 m_fileSize = 0;
 		
 		WAVEFORMATEX m_wfx = {};
@@ -41,7 +63,17 @@ namespace DOG
 
 		std::streampos m_dataStart = 0;
 
+		// Compressed files keep the file format here while m_wfx describes the decoded PCM
+		bool m_compressed = false;
+		WAVEFORMATEX m_encodedWfx = {};
+		u32 m_samplesPerBlock = 0;
+		std::vector<u8> m_encodedBlock;
+		std::vector<i16> m_decodedBlock;
+		u32 m_decodedOffset = 0;
+		u32 m_decodedBytes = 0;
+
 	private:
+		u32 ReadRawDataChunk(std::span<u8> dest);
 		void SkipChunk(ChunkType type);
 		void ReadFormat();
 		ChunkType ReadNextChunkType();
@@ -1,13 +1,25 @@
 #include "AudioManager.h"
+#include "AudioMixer.h"
 #include "../ECS/EntityManager.h"
 
 using namespace DOG;
 
-void AudioManager::Initialize()
+void AudioManager::Initialize(AudioBackend backend)
 {
 	try
 	{
-		s_device = std::make_unique<AudioDevice>();
+		switch (backend)
+		{
+		case AudioBackend::Mixer:
+			s_device = std::make_unique<MixerAudioDevice>(std::make_unique<XAudio2AudioOutput>(MixerAudioDevice::SAMPLE_RATE, MixerAudioDevice::BLOCK_FRAMES));
+			break;
+		case AudioBackend::Null:
+			s_device = std::make_unique<MixerAudioDevice>(std::make_unique<NullAudioOutput>(MixerAudioDevice::SAMPLE_RATE, AudioMixer::OUTPUT_CHANNELS, MixerAudioDevice::BLOCK_FRAMES, true));
+			break;
+		default:
+			s_device = std::make_unique<XAudio2Device>();
+			break;
+		}
 		s_deviceInitialized = true;
 	}
 	catch (DOG::HRError& e)
@@ -44,7 +56,5 @@ void AudioManager::StopAudioOnDeferredEntities()
 			ac.shouldStop = true;
 		});
 
-	AudioSystem(); // Stop entities that have shouldStop applied
-
-	s_device->Commit();
+	AudioSystem(); // Stop entities that have shouldStop applied, this also commits
 }
@@ -6,7 +6,7 @@ namespace DOG
 	class AudioManager
 	{
 	public:
-		static void Initialize();
+		static void Initialize(AudioBackend backend = AudioBackend::XAudio2);
 		static void Destroy();
 
 		static void AudioSystem();
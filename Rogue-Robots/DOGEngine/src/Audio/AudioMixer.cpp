@@ -0,0 +1,795 @@
+#include "AudioMixer.h"
+
+using namespace DOG;
+using namespace DirectX;
+
+AudioMixer::AudioMixer(u32 sampleRate) : m_sampleRate(sampleRate)
+{
+	m_voices.resize(MAX_VOICES);
+	m_activeVoices.reserve(MAX_VOICES);
+
+	// Hand out low indices first
+	m_freeVoices.resize(MAX_VOICES);
+	std::iota(m_freeVoices.rbegin(), m_freeVoices.rend(), 0u);
+
+	m_voiceScratch.resize(MAX_BLOCK_FRAMES * OUTPUT_CHANNELS);
+
+	// Padded so the batch loop can always process four voices at a time
+	constexpr u32 batchCapacity = MAX_VOICES + 3;
+	m_batchVoices.reserve(MAX_VOICES);
+	m_batchX.resize(batchCapacity);
+	m_batchY.resize(batchCapacity);
+	m_batchZ.resize(batchCapacity);
+	m_batchVolume.resize(batchCapacity);
+	m_batchGainL.resize(batchCapacity);
+	m_batchGainR.resize(batchCapacity);
+}
+
+u32 AudioMixer::PlayMemory(u32 assetID, const AudioAsset& asset)
+{
+	const WAVEFORMATEX& wfx = asset.properties;
+	const SampleFormat format = GetSampleFormat(wfx);
+	if (format == SampleFormat::Unsupported || wfx.nBlockAlign == 0)
+	{
+		std::cout << "AudioMixer: unsupported sample format " << wfx.wFormatTag << " with " << wfx.wBitsPerSample << " bits per sample" << std::endl;
+		return INVALID_VOICE;
+	}
+
+	const u32 channels = std::min<u32>(wfx.nChannels, OUTPUT_CHANNELS);
+
+	// Decoded outside the mixer lock so the mixer thread is not stalled on a cache miss
+	auto decoded = m_sampleCache.GetOrDecode(assetID, [&]()
+		{
+			std::vector<u8> pcm;
+			std::span<const u8> data = asset.audioData;
+			if (asset.compressed)
+			{
+				pcm = IMAADPCM::Decode(asset.audioData, asset.encodedProperties.nChannels, asset.encodedProperties.nBlockAlign);
+				data = pcm;
+			}
+
+			const u64 frames = data.size() / wfx.nBlockAlign;
+			std::vector<f32> samples(frames * channels);
+			DecodeFrames(data.data(), frames, wfx.nChannels, format, samples.data(), channels);
+			return samples;
+		});
+
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	u32 idx = AllocateVoice(wfx);
+	if (idx == INVALID_VOICE)
+		return INVALID_VOICE;
+
+	auto& voice = m_voices[idx];
+	voice.decoded = std::move(decoded);
+	voice.frameCount = voice.decoded->size() / voice.channels;
+	return idx;
+}
+
+u32 AudioMixer::PlayStream(const WAVEFORMATEX& wfx, const std::filesystem::path& path)
+{
+	const SampleFormat format = GetSampleFormat(wfx);
+	if (format == SampleFormat::Unsupported || wfx.nBlockAlign == 0)
+	{
+		std::cout << "AudioMixer: unsupported sample format " << wfx.wFormatTag << " with " << wfx.wBitsPerSample << " bits per sample" << std::endl;
+		return INVALID_VOICE;
+	}
+
+	// File setup and the first read happen before taking the mixer lock
+	auto stream = std::make_shared<StreamState>();
+	stream->format = format;
+	stream->sourceChannels = wfx.nChannels;
+	stream->sourceBlockAlign = wfx.nBlockAlign;
+	stream->channels = std::min<u32>(wfx.nChannels, OUTPUT_CHANNELS);
+	stream->window.resize(STREAM_WINDOW_FRAMES * stream->channels);
+
+	stream->reader = WAVFileReader(path);
+	stream->reader.ReadWFXProperties();
+	stream->reader.ReadDataChunk(std::span<u8>()); // Locate the data chunk
+	RefillStream(*stream, { nullptr, STREAM_WINDOW_FRAMES });
+
+	const u64 frameCount = stream->reader.DataSize() / wfx.nBlockAlign;
+
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	u32 idx = AllocateVoice(wfx);
+	if (idx == INVALID_VOICE)
+		return INVALID_VOICE;
+
+	auto& voice = m_voices[idx];
+	voice.stream = std::move(stream);
+	voice.frameCount = frameCount;
+	return idx;
+}
+
+void AudioMixer::Release(u32 voice)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	auto& v = m_voices[voice];
+	if (!v.active)
+		return;
+
+	// Swap-remove from the active list
+	u32 lastIdx = m_activeVoices.back();
+	m_activeVoices[v.activeSlot] = lastIdx;
+	m_voices[lastIdx].activeSlot = v.activeSlot;
+	m_activeVoices.pop_back();
+
+	v = Voice{};
+	m_freeVoices.push_back(voice);
+}
+
+bool AudioMixer::HasFinished(u32 voice)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	return m_voices[voice].finished;
+}
+
+void AudioMixer::SetVolume(u32 voice, f32 volume)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	m_voices[voice].volume = volume;
+}
+
+void AudioMixer::SetLoop(u32 voice, f32 loopStart, f32 loopEnd)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	auto& v = m_voices[voice];
+	v.loopStart = std::max(0.0, static_cast<f64>(loopStart) * v.sampleRate);
+	v.loopEnd = std::min(static_cast<f64>(v.frameCount), static_cast<f64>(loopEnd) * v.sampleRate);
+	v.loop = v.loopEnd > v.loopStart;
+}
+
+void AudioMixer::SetEmitter(u32 voice, const SimpleMath::Vector3& position)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	m_voices[voice].is3D = true;
+	m_voices[voice].emitter = position;
+}
+
+f32 AudioMixer::SecondsPlayed(u32 voice)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	auto& v = m_voices[voice];
+	return static_cast<f32>(v.position / v.sampleRate);
+}
+
+f32 AudioMixer::LengthInSeconds(u32 voice)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	auto& v = m_voices[voice];
+	return static_cast<f32>(static_cast<f64>(v.frameCount) / v.sampleRate);
+}
+
+void AudioMixer::SetListener(const std::optional<Listener>& listener)
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	m_listener = listener;
+}
+
+u32 AudioMixer::ActiveVoiceCount()
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+	return static_cast<u32>(m_activeVoices.size());
+}
+
+void AudioMixer::Spatialize()
+{
+	std::scoped_lock<std::mutex> lock(m_mutex);
+
+	m_batchVoices.clear();
+	for (u32 idx : m_activeVoices)
+	{
+		auto& v = m_voices[idx];
+		if (!v.is3D)
+		{
+			v.gainL = v.volume;
+			v.gainR = v.volume;
+			continue;
+		}
+
+		u32 k = static_cast<u32>(m_batchVoices.size());
+		m_batchVoices.push_back(idx);
+		m_batchX[k] = v.emitter.x;
+		m_batchY[k] = v.emitter.y;
+		m_batchZ[k] = v.emitter.z;
+		m_batchVolume[k] = v.volume;
+	}
+
+	const u32 count = static_cast<u32>(m_batchVoices.size());
+	if (count == 0)
+		return;
+
+	if (!m_listener)
+	{
+		// Same as the XAudio2 path, 3D sounds are silent without a listener
+		for (u32 idx : m_batchVoices)
+		{
+			m_voices[idx].gainL = 0.0f;
+			m_voices[idx].gainR = 0.0f;
+		}
+		return;
+	}
+
+	const SimpleMath::Vector3 listenerPos = m_listener->position;
+	SimpleMath::Vector3 right = m_listener->up.Cross(m_listener->forward); // Left-handed, like X3DAudio
+	right.Normalize();
+
+	// Pad the tail with the listener position so the last group of four stays well defined
+	for (u32 k = count; k < ((count + 3) & ~3u); ++k)
+	{
+		m_batchX[k] = listenerPos.x;
+		m_batchY[k] = listenerPos.y;
+		m_batchZ[k] = listenerPos.z;
+		m_batchVolume[k] = 0.0f;
+	}
+
+	const XMVECTOR lx = XMVectorReplicate(listenerPos.x);
+	const XMVECTOR ly = XMVectorReplicate(listenerPos.y);
+	const XMVECTOR lz = XMVectorReplicate(listenerPos.z);
+	const XMVECTOR rx = XMVectorReplicate(right.x);
+	const XMVECTOR ry = XMVectorReplicate(right.y);
+	const XMVECTOR rz = XMVectorReplicate(right.z);
+	const XMVECTOR half = XMVectorReplicate(0.5f);
+	const XMVECTOR one = XMVectorReplicate(1.0f);
+	const XMVECTOR minDistance = XMVectorReplicate(1e-4f);
+	const XMVECTOR curveScaler = XMVectorReplicate(CURVE_DISTANCE_SCALER);
+
+	for (u32 k = 0; k < count; k += 4)
+	{
+		const XMVECTOR dx = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_batchX[k])), lx);
+		const XMVECTOR dy = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_batchY[k])), ly);
+		const XMVECTOR dz = XMVectorSubtract(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_batchZ[k])), lz);
+
+		XMVECTOR distSq = XMVectorMultiply(dx, dx);
+		distSq = XMVectorMultiplyAdd(dy, dy, distSq);
+		distSq = XMVectorMultiplyAdd(dz, dz, distSq);
+		const XMVECTOR invDist = XMVectorReciprocal(XMVectorMax(XMVectorSqrt(distSq), minDistance));
+
+		// -1 is fully left, 1 is fully right
+		XMVECTOR pan = XMVectorMultiply(dx, rx);
+		pan = XMVectorMultiplyAdd(dy, ry, pan);
+		pan = XMVectorMultiplyAdd(dz, rz, pan);
+		pan = XMVectorClamp(XMVectorMultiply(pan, invDist), XMVectorNegate(one), one);
+
+		// Inverse distance rolloff and equal power panning
+		const XMVECTOR attenuation = XMVectorMultiply(XMVectorMin(one, XMVectorMultiply(curveScaler, invDist)), XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_batchVolume[k])));
+		const XMVECTOR gainL = XMVectorMultiply(attenuation, XMVectorSqrt(XMVectorMultiply(half, XMVectorSubtract(one, pan))));
+		const XMVECTOR gainR = XMVectorMultiply(attenuation, XMVectorSqrt(XMVectorMultiply(half, XMVectorAdd(one, pan))));
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&m_batchGainL[k]), gainL);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&m_batchGainR[k]), gainR);
+	}
+
+	for (u32 k = 0; k < count; ++k)
+	{
+		auto& v = m_voices[m_batchVoices[k]];
+		v.gainL = m_batchGainL[k];
+		v.gainR = m_batchGainR[k];
+	}
+}
+
+void AudioMixer::Mix(std::span<f32> out)
+{
+	assert(out.size() % OUTPUT_CHANNELS == 0);
+	std::fill(out.begin(), out.end(), 0.0f);
+
+	const u32 totalFrames = static_cast<u32>(out.size() / OUTPUT_CHANNELS);
+
+	// Disk reads and seeks happen here without m_mutex, rendering below only copies decoded frames
+	{
+		std::scoped_lock<std::mutex> lock(m_mutex);
+		for (u32 idx : m_activeVoices)
+		{
+			auto& v = m_voices[idx];
+			if (v.stream && !v.finished)
+			{
+				const u64 frames = std::max(STREAM_WINDOW_FRAMES, static_cast<u64>(totalFrames * v.step) + 4);
+				m_streamRefills.push_back({ v.stream, frames, v.loop, static_cast<u64>(v.loopStart) });
+			}
+		}
+	}
+	for (auto& refill : m_streamRefills)
+	{
+		RefillStream(*refill.stream, refill);
+	}
+	m_streamRefills.clear(); // Streams released meanwhile are closed here, still outside the lock
+
+	std::scoped_lock<std::mutex> lock(m_mutex);
+
+	for (u32 offset = 0; offset < totalFrames; offset += MAX_BLOCK_FRAMES)
+	{
+		const u32 frames = std::min(MAX_BLOCK_FRAMES, totalFrames - offset);
+		f32* dst = out.data() + offset * OUTPUT_CHANNELS;
+
+		for (u32 idx : m_activeVoices)
+		{
+			auto& v = m_voices[idx];
+			if (v.finished)
+				continue;
+
+			u32 rendered = RenderVoice(v, frames);
+			if (rendered > 0)
+			{
+				// Ramp from last block's gains to avoid zipper noise when sources move
+				AccumulateScaled(dst, m_voiceScratch.data(), rendered, v.lastGainL, v.lastGainR, v.gainL, v.gainR);
+			}
+			v.lastGainL = v.gainL;
+			v.lastGainR = v.gainR;
+
+			if (rendered < frames)
+				v.finished = true;
+		}
+	}
+
+	const XMVECTOR master = XMVectorReplicate(m_masterVolume);
+	const XMVECTOR one = XMVectorReplicate(1.0f);
+	const XMVECTOR minusOne = XMVectorReplicate(-1.0f);
+
+	size_t i = 0;
+	for (; i + 4 <= out.size(); i += 4)
+	{
+		XMFLOAT4* p = reinterpret_cast<XMFLOAT4*>(out.data() + i);
+		XMStoreFloat4(p, XMVectorClamp(XMVectorMultiply(XMLoadFloat4(p), master), minusOne, one));
+	}
+	for (; i < out.size(); ++i)
+	{
+		out[i] = std::clamp(out[i] * m_masterVolume, -1.0f, 1.0f);
+	}
+}
+
+u32 AudioMixer::AllocateVoice(const WAVEFORMATEX& wfx)
+{
+	if (m_freeVoices.empty())
+	{
+		std::cout << "AudioMixer: all " << MAX_VOICES << " voices are in use" << std::endl;
+		return INVALID_VOICE;
+	}
+
+	u32 idx = m_freeVoices.back();
+	m_freeVoices.pop_back();
+
+	auto& v = m_voices[idx];
+	v = Voice{};
+	v.active = true;
+	v.format = GetSampleFormat(wfx);
+	v.sourceChannels = wfx.nChannels;
+	v.sourceBlockAlign = wfx.nBlockAlign;
+	v.channels = std::min<u32>(wfx.nChannels, OUTPUT_CHANNELS);
+	v.sampleRate = wfx.nSamplesPerSec;
+	v.step = std::min(MAX_STEP, static_cast<f64>(wfx.nSamplesPerSec) / m_sampleRate);
+
+	v.activeSlot = static_cast<u32>(m_activeVoices.size());
+	m_activeVoices.push_back(idx);
+	return idx;
+}
+
+u32 AudioMixer::RenderVoice(Voice& v, u32 frames)
+{
+	f32* scratch = m_voiceScratch.data();
+	u32 written = 0;
+
+	while (written < frames)
+	{
+		if (v.loop && v.position >= v.loopEnd)
+		{
+			v.position = v.loopStart + std::fmod(v.position - v.loopEnd, v.loopEnd - v.loopStart);
+			if (v.stream)
+				SeekStream(v, static_cast<u64>(v.position));
+		}
+
+		u32 segment = frames - written;
+		if (v.loop)
+		{
+			f64 untilLoopEnd = std::ceil((v.loopEnd - v.position) / v.step);
+			segment = static_cast<u32>(std::clamp(untilLoopEnd, 1.0, static_cast<f64>(segment)));
+		}
+
+		const u64 first = static_cast<u64>(v.position);
+		const u64 needed = static_cast<u64>(v.position + segment * v.step) - first + 2;
+
+		const f32* src = nullptr;
+		u64 available = 0;
+		bool drained = true;
+		if (v.stream)
+		{
+			drained = FillStreamWindow(v, first, needed);
+			auto& s = *v.stream;
+			src = s.window.data() + (first - s.windowStart) * v.channels;
+			available = s.windowStart + s.windowFrames - first;
+		}
+		else
+		{
+			src = v.decoded->data() + std::min(first, v.frameCount) * v.channels;
+			available = v.frameCount > first ? v.frameCount - first : 0;
+		}
+
+		// Linear interpolation resampler, 3D voices are folded to mono before panning
+		u32 i = 0;
+		for (; i < segment; ++i)
+		{
+			const f64 local = v.position - first;
+			const u64 idx = static_cast<u64>(local);
+			if (idx >= available)
+				break;
+
+			const u64 next = idx + 1 < available ? idx + 1 : idx;
+			const f32 t = static_cast<f32>(local - idx);
+
+			f32* out = scratch + (written + i) * OUTPUT_CHANNELS;
+			if (v.channels == 1)
+			{
+				f32 s = src[idx] + (src[next] - src[idx]) * t;
+				out[0] = s;
+				out[1] = s;
+			}
+			else
+			{
+				f32 l = src[idx * 2] + (src[next * 2] - src[idx * 2]) * t;
+				f32 r = src[idx * 2 + 1] + (src[next * 2 + 1] - src[idx * 2 + 1]) * t;
+				if (v.is3D)
+				{
+					l = r = 0.5f * (l + r);
+				}
+				out[0] = l;
+				out[1] = r;
+			}
+
+			v.position += v.step;
+		}
+
+		written += i;
+		if (i < segment)
+		{
+			// The stream fell behind, play silence and keep the voice alive until the next refill
+			if (!drained)
+			{
+				std::fill(scratch + written * OUTPUT_CHANNELS, scratch + frames * OUTPUT_CHANNELS, 0.0f);
+				written = frames;
+			}
+			break; // Out of source data
+		}
+	}
+
+	return written;
+}
+
+bool AudioMixer::FillStreamWindow(Voice& v, u64 firstFrame, u64 frameCount)
+{
+	auto& s = *v.stream;
+	assert(firstFrame >= s.windowStart);
+
+	// Drop frames that have been played, keep the rest at the front of the window.
+	// After the stream fell behind the position may already be past the window.
+	if (firstFrame > s.windowStart)
+	{
+		const u64 drop = std::min(firstFrame - s.windowStart, s.windowFrames);
+		std::copy(s.window.begin() + drop * v.channels, s.window.begin() + s.windowFrames * v.channels, s.window.begin());
+		s.windowFrames -= drop;
+		s.windowStart = firstFrame;
+	}
+
+	const u64 capacity = s.window.size() / v.channels;
+	frameCount = std::min(frameCount, capacity);
+
+	// Only copies frames RefillStream decoded earlier, the reader is never touched under m_mutex
+	std::scoped_lock<std::mutex> streamLock(s.mutex);
+	while (s.windowFrames < frameCount)
+	{
+		const u64 next = s.windowStart + s.windowFrames;
+		const u64 wantedFrames = frameCount - s.windowFrames;
+		f32* dst = s.window.data() + s.windowFrames * v.channels;
+
+		if (s.hasLoopHead && next >= s.loopHeadStart && next < s.loopHeadStart + s.loopHeadFrames)
+		{
+			const u64 count = std::min(wantedFrames, s.loopHeadStart + s.loopHeadFrames - next);
+			const f32* src = s.loopHead.data() + (next - s.loopHeadStart) * v.channels;
+			std::copy(src, src + count * v.channels, dst);
+			s.windowFrames += count;
+
+			// Staged frames the loop head stood in for are not needed anymore, make room for the refill
+			if (!s.seekRequest && s.stagedStart < next + count)
+			{
+				const u64 drop = std::min(next + count - s.stagedStart, s.stagedFrames);
+				s.stagedStart += drop;
+				s.stagedOffset += drop;
+				s.stagedFrames -= drop;
+			}
+		}
+		else if (!s.seekRequest && next >= s.stagedStart && next < s.stagedStart + s.stagedFrames)
+		{
+			// Staged frames before next were covered by the loop head
+			const u64 skip = next - s.stagedStart;
+			const u64 count = std::min(wantedFrames, s.stagedFrames - skip);
+			const f32* src = s.staged.data() + (s.stagedOffset + skip) * v.channels;
+			std::copy(src, src + count * v.channels, dst);
+			s.windowFrames += count;
+
+			s.stagedStart += skip + count;
+			s.stagedOffset += skip + count;
+			s.stagedFrames -= skip + count;
+		}
+		else
+		{
+			return !s.seekRequest && s.endOfFile && next >= s.stagedStart + s.stagedFrames;
+		}
+	}
+	return false;
+}
+
+void AudioMixer::SeekStream(Voice& v, u64 frame)
+{
+	auto& s = *v.stream;
+	s.windowStart = frame;
+	s.windowFrames = 0;
+
+	std::scoped_lock<std::mutex> streamLock(s.mutex);
+	if (!s.seekRequest && frame >= s.stagedStart && frame < s.stagedStart + s.stagedFrames)
+		return;
+
+	// The next refill seeks the reader, past the loop head when it covers the frame
+	const bool inLoopHead = s.hasLoopHead && frame >= s.loopHeadStart && frame < s.loopHeadStart + s.loopHeadFrames;
+	s.seekRequest = inLoopHead ? s.loopHeadStart + s.loopHeadFrames : frame;
+	s.stagedStart = *s.seekRequest;
+	s.stagedFrames = 0;
+	s.stagedOffset = 0;
+	s.endOfFile = false;
+}
+
+void AudioMixer::RefillStream(StreamState& s, const StreamRefill& refill)
+{
+	std::scoped_lock<std::mutex> streamLock(s.mutex);
+
+	const u64 capacity = refill.frames;
+	if (s.staged.size() < capacity * s.channels)
+	{
+		s.staged.resize(capacity * s.channels);
+		s.bytes.resize(capacity * s.sourceBlockAlign);
+	}
+
+	if (refill.loop && (!s.hasLoopHead || s.loopHeadStart != refill.loopStart))
+	{
+		s.loopHead.resize(capacity * s.channels);
+		s.reader.SeekToSample(static_cast<u32>(refill.loopStart));
+		s.loopHeadStart = refill.loopStart;
+		s.loopHeadFrames = ReadStreamFrames(s, s.loopHead.data(), capacity);
+		s.hasLoopHead = true;
+
+		// Put the reader back where the staged frames end
+		if (!s.seekRequest)
+			s.reader.SeekToSample(static_cast<u32>(s.stagedStart + s.stagedFrames));
+	}
+
+	if (s.seekRequest)
+	{
+		s.reader.SeekToSample(static_cast<u32>(*s.seekRequest));
+		s.seekRequest.reset();
+	}
+
+	// Keep the unplayed frames at the front, then top up from the reader
+	if (s.stagedOffset > 0)
+	{
+		std::copy(s.staged.begin() + s.stagedOffset * s.channels, s.staged.begin() + (s.stagedOffset + s.stagedFrames) * s.channels, s.staged.begin());
+		s.stagedOffset = 0;
+	}
+
+	while (s.stagedFrames < capacity && !s.endOfFile)
+	{
+		u64 framesRead = ReadStreamFrames(s, s.staged.data() + s.stagedFrames * s.channels, capacity - s.stagedFrames);
+		if (framesRead == 0)
+		{
+			s.endOfFile = true;
+			break;
+		}
+		s.stagedFrames += framesRead;
+	}
+}
+
+u64 AudioMixer::ReadStreamFrames(StreamState& s, f32* dst, u64 frames)
+{
+	u32 bytesRead = s.reader.ReadDataChunk(std::span<u8>(s.bytes.data(), frames * s.sourceBlockAlign));
+	u64 framesRead = bytesRead / s.sourceBlockAlign;
+	DecodeFrames(s.bytes.data(), framesRead, s.sourceChannels, s.format, dst, s.channels);
+	return framesRead;
+}
+
+AudioMixer::SampleFormat AudioMixer::GetSampleFormat(const WAVEFORMATEX& wfx)
+{
+	// WAVE_FORMAT_EXTENSIBLE is told apart by bit depth since the reader only keeps the base header
+	const bool pcm = wfx.wFormatTag == WAVE_FORMAT_PCM || wfx.wFormatTag == WAVE_FORMAT_EXTENSIBLE;
+	const bool flt = wfx.wFormatTag == WAVE_FORMAT_IEEE_FLOAT || wfx.wFormatTag == WAVE_FORMAT_EXTENSIBLE;
+
+	if (pcm && wfx.wBitsPerSample == 8) return SampleFormat::PCM8;
+	if (pcm && wfx.wBitsPerSample == 16) return SampleFormat::PCM16;
+	if (pcm && wfx.wBitsPerSample == 24) return SampleFormat::PCM24;
+	if (flt && wfx.wBitsPerSample == 32) return SampleFormat::Float32;
+	return SampleFormat::Unsupported;
+}
+
+void AudioMixer::DecodeFrames(const u8* src, u64 frames, u32 srcChannels, SampleFormat format, f32* dst, u32 dstChannels)
+{
+	auto decode = [&](auto&& readSample, u32 bytesPerSample)
+	{
+		for (u64 f = 0; f < frames; ++f)
+		{
+			const u8* frame = src + f * srcChannels * bytesPerSample;
+			for (u32 c = 0; c < dstChannels; ++c)
+			{
+				dst[f * dstChannels + c] = readSample(frame + c * bytesPerSample);
+			}
+		}
+	};
+
+	switch (format)
+	{
+	case SampleFormat::PCM8:
+		decode([](const u8* p) { return (static_cast<f32>(*p) - 128.0f) / 128.0f; }, 1);
+		break;
+	case SampleFormat::PCM16:
+		decode([](const u8* p) { i16 s; std::memcpy(&s, p, sizeof(s)); return s / 32768.0f; }, 2);
+		break;
+	case SampleFormat::PCM24:
+		decode([](const u8* p) { i32 s = static_cast<i32>((u32(p[0]) << 8) | (u32(p[1]) << 16) | (u32(p[2]) << 24)); return (s >> 8) / 8388608.0f; }, 3);
+		break;
+	case SampleFormat::Float32:
+		decode([](const u8* p) { f32 s; std::memcpy(&s, p, sizeof(s)); return s; }, 4);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+void AudioMixer::AccumulateScaled(f32* dst, const f32* src, u32 frames, f32 gainL0, f32 gainR0, f32 gainL1, f32 gainR1)
+{
+	static_assert(OUTPUT_CHANNELS == 2, "AccumulateScaled processes two stereo frames per vector");
+
+	const f32 invFrames = 1.0f / frames;
+	const f32 dL = (gainL1 - gainL0) * invFrames;
+	const f32 dR = (gainR1 - gainR0) * invFrames;
+
+	XMVECTOR gain = XMVectorSet(gainL0, gainR0, gainL0 + dL, gainR0 + dR);
+	const XMVECTOR gainStep = XMVectorSet(2.0f * dL, 2.0f * dR, 2.0f * dL, 2.0f * dR);
+
+	const u32 samples = frames * OUTPUT_CHANNELS;
+	u32 i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		const XMVECTOR s = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(src + i));
+		XMFLOAT4* d = reinterpret_cast<XMFLOAT4*>(dst + i);
+		XMStoreFloat4(d, XMVectorMultiplyAdd(s, gain, XMLoadFloat4(d)));
+		gain = XMVectorAdd(gain, gainStep);
+	}
+	if (i < samples)
+	{
+		dst[i] += src[i] * XMVectorGetX(gain);
+		dst[i + 1] += src[i + 1] * XMVectorGetY(gain);
+	}
+}
+
+// ------- MIXER DEVICE ----------
+
+MixerAudioDevice::MixerAudioDevice(std::unique_ptr<AudioOutput> output) : m_output(std::move(output)), m_mixer(m_output->SampleRate())
+{
+	assert(m_output->ChannelCount() == AudioMixer::OUTPUT_CHANNELS);
+	m_ownedVoices.reserve(AudioMixer::MAX_VOICES);
+	m_mixerThread = std::thread([](MixerAudioDevice* self) { self->MixerThreadRoutine(); }, this);
+}
+
+MixerAudioDevice::~MixerAudioDevice()
+{
+	m_threadShouldDie = true;
+	m_mixerThread.join();
+}
+
+void MixerAudioDevice::HandleComponent(AudioComponent& comp, entity e)
+{
+	if (comp.shouldPlay)
+	{
+		if (comp.source != AudioMixer::INVALID_VOICE)
+		{
+			ReleaseVoice(comp.source);
+			comp.source = AudioMixer::INVALID_VOICE;
+		}
+
+		AudioAsset* asset = AssetManager::Get().GetAsset<AudioAsset>(comp.assetID);
+		u32 voice = asset->async
+			? m_mixer.PlayStream(asset->properties, asset->filePath)
+			: m_mixer.PlayMemory(comp.assetID, *asset);
+
+		if (voice != AudioMixer::INVALID_VOICE)
+			m_ownedVoices.push_back(voice);
+
+		comp.source = voice;
+		comp.shouldPlay = false;
+		comp.playing = voice != AudioMixer::INVALID_VOICE;
+	}
+
+	// Return early if the component has no voice assigned
+	if (comp.source == AudioMixer::INVALID_VOICE)
+	{
+		return;
+	}
+
+	const u32 voice = comp.source;
+	m_touched.set(voice);
+
+	if (comp.shouldStop || m_mixer.HasFinished(voice))
+	{
+		ReleaseVoice(voice);
+		comp.source = AudioMixer::INVALID_VOICE;
+		comp.playing = false;
+		comp.shouldStop = false;
+		return;
+	}
+
+	if (comp.loop)
+	{
+		if (comp.loopEnd <= comp.loopStart)
+		{
+			comp.loopEnd = m_mixer.LengthInSeconds(voice) - 0.1f;
+		}
+		m_mixer.SetLoop(voice, comp.loopStart, comp.loopEnd);
+	}
+
+	if (comp.is3D)
+	{
+		m_mixer.SetEmitter(voice, EntityManager::Get().GetComponent<TransformComponent>(e).GetPosition());
+	}
+
+	m_mixer.SetVolume(voice, AudioMixer::BASE_VOLUME * comp.volume);
+}
+
+void MixerAudioDevice::Commit()
+{
+	// Release voices of entities that no longer have an AudioComponent
+	for (u32 i = 0; i < m_ownedVoices.size();)
+	{
+		u32 voice = m_ownedVoices[i];
+		if (!m_touched.test(voice))
+		{
+			m_mixer.Release(voice);
+			m_ownedVoices[i] = m_ownedVoices.back();
+			m_ownedVoices.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
+	m_touched.reset();
+
+	std::optional<AudioMixer::Listener> listener;
+	EntityManager::Get().Collect<AudioListenerComponent, TransformComponent>()
+		.Do([&](AudioListenerComponent& /*listener*/, TransformComponent& transform)
+			{
+				listener = AudioMixer::Listener{ transform.GetPosition(), transform.GetForward(), transform.GetUp() };
+			});
+
+	m_mixer.SetListener(listener);
+	m_mixer.Spatialize();
+}
+
+void MixerAudioDevice::MixerThreadRoutine()
+{
+	MiniProfiler::SetThreadName("Audio mixer");
+	std::vector<f32> block(BLOCK_FRAMES * AudioMixer::OUTPUT_CHANNELS);
+
+	while (!m_threadShouldDie)
+	{
+		if (!m_output->WaitForSpace(MIXER_THREAD_WAIT))
+			continue;
+
+		MINIPROFILE_NAMED("AudioMixerBlock");
+		m_mixer.Mix(block);
+		m_output->Submit(block);
+	}
+}
+
+void MixerAudioDevice::ReleaseVoice(u32 voice)
+{
+	m_mixer.Release(voice);
+	auto it = std::find(m_ownedVoices.begin(), m_ownedVoices.end(), voice);
+	if (it != m_ownedVoices.end())
+	{
+		*it = m_ownedVoices.back();
+		m_ownedVoices.pop_back();
+	}
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include "Audio.h"
+#include "AudioOutput.h"
+#include "AudioSampleCache.h"
+
+namespace DOG
+{
+	// Engine-owned software mixer. Every voice is resampled to the output rate and mixed into an
+	// interleaved stereo f32 bus, the result is handed to whatever AudioOutput is plugged in.
+	// Does not depend on a device, so it can be driven directly for benchmarks and headless runs.
+	class AudioMixer
+	{
+	public:
+		static constexpr u32 MAX_VOICES = 512;
+		static constexpr u32 INVALID_VOICE = u32(-1);
+		static constexpr u32 OUTPUT_CHANNELS = 2;
+		static constexpr u32 MAX_BLOCK_FRAMES = 1024;
+		static constexpr f32 BASE_VOLUME = 2.0f; // Matches the loudness of the XAudio2 path
+		static constexpr f32 CURVE_DISTANCE_SCALER = 1.0f;
+		static constexpr u64 SAMPLE_CACHE_BUDGET = 64 * 1024 * 1024;
+
+		struct Listener
+		{
+			DirectX::SimpleMath::Vector3 position;
+			DirectX::SimpleMath::Vector3 forward;
+			DirectX::SimpleMath::Vector3 up;
+		};
+
+	public:
+		explicit AudioMixer(u32 sampleRate);
+		DELETE_COPY_MOVE_CONSTRUCTOR(AudioMixer);
+
+		// Returns INVALID_VOICE if every voice is in use or the format is not supported
+		u32 PlayMemory(u32 assetID, const AudioAsset& asset);
+		u32 PlayStream(const WAVEFORMATEX& wfx, const std::filesystem::path& path);
+		void Release(u32 voice);
+
+		bool HasFinished(u32 voice);
+		void SetVolume(u32 voice, f32 volume);
+		void SetLoop(u32 voice, f32 loopStart, f32 loopEnd);
+		void SetEmitter(u32 voice, const DirectX::SimpleMath::Vector3& position);
+		f32 SecondsPlayed(u32 voice);
+		f32 LengthInSeconds(u32 voice);
+
+		void SetListener(const std::optional<Listener>& listener);
+		void SetMasterVolume(f32 volume) noexcept { m_masterVolume = volume; }
+
+		// Computes panning and attenuation for all active voices in one batch
+		void Spatialize();
+
+		// Mixes every active voice into out, which holds interleaved OUTPUT_CHANNELS frames.
+		// Called from one thread at a time, streams are read from disk before the voices are locked.
+		void Mix(std::span<f32> out);
+
+		u32 SampleRate() const noexcept { return m_sampleRate; }
+		u32 ActiveVoiceCount();
+
+	private:
+		enum class SampleFormat
+		{
+			Unsupported,
+			PCM8,
+			PCM16,
+			PCM24,
+			Float32,
+		};
+
+		struct StreamState
+		{
+			SampleFormat format = SampleFormat::Unsupported;
+			u32 sourceChannels = 0;
+			u32 sourceBlockAlign = 0;
+			u32 channels = 0;
+
+			// Decoded frames [windowStart, windowStart + windowFrames) of the source, read by the voice under m_mutex
+			std::vector<f32> window;
+			u64 windowStart = 0;
+			u64 windowFrames = 0;
+
+			// Everything below is guarded by mutex instead, the reader is only used by RefillStream outside m_mutex
+			std::mutex mutex;
+			WAVFileReader reader;
+			std::vector<u8> bytes;
+
+			// Decoded frames [stagedStart, stagedStart + stagedFrames) that continue where the reader stopped,
+			// kept at stagedOffset frames into staged
+			std::vector<f32> staged;
+			u64 stagedStart = 0;
+			u64 stagedFrames = 0;
+			u64 stagedOffset = 0;
+			bool endOfFile = false;
+			std::optional<u64> seekRequest;
+
+			// Decoded frames from the loop start so wrapping around never waits for a seek
+			std::vector<f32> loopHead;
+			u64 loopHeadStart = 0;
+			u64 loopHeadFrames = 0;
+			bool hasLoopHead = false;
+		};
+
+		struct StreamRefill
+		{
+			std::shared_ptr<StreamState> stream;
+			u64 frames = 0; // Decoded frames to have ready for the next Mix
+			bool loop = false;
+			u64 loopStart = 0;
+		};
+
+		struct Voice
+		{
+			bool active = false;
+			bool finished = false;
+			bool is3D = false;
+			bool loop = false;
+
+			SampleFormat format = SampleFormat::Unsupported;
+			u32 sourceChannels = 0;
+			u32 sourceBlockAlign = 0;
+			u32 channels = 0; // Channels kept after decoding, 1 or 2
+			u32 sampleRate = 0;
+			u32 activeSlot = 0;
+
+			f64 position = 0.0; // In source frames
+			f64 step = 1.0;
+			u64 frameCount = 0;
+			f64 loopStart = 0.0;
+			f64 loopEnd = 0.0;
+
+			f32 volume = BASE_VOLUME;
+			f32 gainL = 0.0f, gainR = 0.0f;
+			f32 lastGainL = 0.0f, lastGainR = 0.0f;
+
+			DirectX::SimpleMath::Vector3 emitter;
+
+			std::shared_ptr<const std::vector<f32>> decoded;
+			std::shared_ptr<StreamState> stream;
+		};
+
+	private:
+		u32 AllocateVoice(const WAVEFORMATEX& wfx);
+		u32 RenderVoice(Voice& voice, u32 frames);
+		// Returns false while the stream has frames past the window that have not been read yet
+		bool FillStreamWindow(Voice& voice, u64 firstFrame, u64 frameCount);
+		void SeekStream(Voice& voice, u64 frame);
+
+		static void RefillStream(StreamState& stream, const StreamRefill& refill);
+		static u64 ReadStreamFrames(StreamState& stream, f32* dst, u64 frames);
+
+		static SampleFormat GetSampleFormat(const WAVEFORMATEX& wfx);
+		static void DecodeFrames(const u8* src, u64 frames, u32 srcChannels, SampleFormat format, f32* dst, u32 dstChannels);
+		static void AccumulateScaled(f32* dst, const f32* src, u32 frames, f32 gainL0, f32 gainR0, f32 gainL1, f32 gainR1);
+
+	private:
+		static constexpr f64 MAX_STEP = 4.0;
+		static constexpr u64 STREAM_WINDOW_FRAMES = static_cast<u64>(MAX_BLOCK_FRAMES * MAX_STEP) + 4;
+
+		u32 m_sampleRate;
+		std::atomic<f32> m_masterVolume = 1.0f;
+
+		std::mutex m_mutex;
+		std::vector<Voice> m_voices;
+		std::vector<u32> m_freeVoices;
+		std::vector<u32> m_activeVoices;
+		std::optional<Listener> m_listener;
+
+		std::vector<f32> m_voiceScratch;
+
+		// Streams to read from disk before the next Mix takes m_mutex, only touched by Mix
+		std::vector<StreamRefill> m_streamRefills;
+
+		// Packed SoA arrays for the batched spatialization pass
+		std::vector<u32> m_batchVoices;
+		std::vector<f32> m_batchX, m_batchY, m_batchZ, m_batchVolume;
+		std::vector<f32> m_batchGainL, m_batchGainR;
+
+		// Decoded in-memory assets, shared with the voices playing them
+		AudioSampleCache<f32> m_sampleCache{ SAMPLE_CACHE_BUDGET };
+	};
+
+	class MixerAudioDevice : public AudioDevice
+	{
+	public:
+		static constexpr u32 SAMPLE_RATE = 48000;
+		static constexpr u32 BLOCK_FRAMES = 480; // 10ms
+
+	public:
+		MixerAudioDevice(std::unique_ptr<AudioOutput> output);
+		~MixerAudioDevice();
+
+		void HandleComponent(AudioComponent& comp, entity e) override;
+		void Commit() override;
+		void SetMasterVolume(f32 volume) noexcept override { m_mixer.SetMasterVolume(volume); }
+
+	private:
+		void MixerThreadRoutine();
+		void ReleaseVoice(u32 voice);
+
+	private:
+		static constexpr std::chrono::milliseconds MIXER_THREAD_WAIT{ 20 };
+
+		std::unique_ptr<AudioOutput> m_output;
+		AudioMixer m_mixer;
+
+		// Voices whose component was not handled since the last commit belonged to destroyed entities
+		std::vector<u32> m_ownedVoices;
+		std::bitset<AudioMixer::MAX_VOICES> m_touched;
+
+		std::atomic_bool m_threadShouldDie = false;
+		std::thread m_mixerThread;
+	};
+}
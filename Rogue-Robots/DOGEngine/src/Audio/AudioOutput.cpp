@@ -0,0 +1,177 @@
+#include "AudioOutput.h"
+
+using namespace DOG;
+
+// ------- XAUDIO2 OUTPUT ----------
+
+XAudio2AudioOutput::XAudio2AudioOutput(u32 sampleRate, u32 blockFrames) : m_callback(this), m_blockFrames(blockFrames)
+{
+	m_wfx = {
+		.wFormatTag = WAVE_FORMAT_IEEE_FLOAT,
+		.nChannels = 2,
+		.nSamplesPerSec = sampleRate,
+		.nAvgBytesPerSec = sampleRate * 2 * sizeof(f32),
+		.nBlockAlign = 2 * sizeof(f32),
+		.wBitsPerSample = 8 * sizeof(f32),
+		.cbSize = 0,
+	};
+
+	m_bufferRing.resize(RING_SIZE * m_blockFrames * m_wfx.nChannels);
+
+	HR hr = XAudio2Create(&m_xaudio, 0, XAUDIO2_DEFAULT_PROCESSOR);
+	hr.try_throw("Failed to initialize xaudio2 device");
+
+	hr = m_xaudio->CreateMasteringVoice(&m_master, m_wfx.nChannels, sampleRate);
+	hr.try_throw("Failed to create xaudio2 mastering voice");
+
+	hr = m_xaudio->CreateSourceVoice(&m_source, &m_wfx, 0, XAUDIO2_DEFAULT_FREQ_RATIO, &m_callback);
+	hr.try_throw("Failed to create mixer output voice");
+
+	m_source->Start(0, 0);
+}
+
+XAudio2AudioOutput::~XAudio2AudioOutput()
+{
+	if (m_source)
+		m_source->DestroyVoice();
+	if (m_master)
+		m_master->DestroyVoice();
+	if (m_xaudio)
+		m_xaudio->Release();
+}
+
+bool XAudio2AudioOutput::WaitForSpace(std::chrono::milliseconds timeout)
+{
+	auto hasSpace = [this]()
+	{
+		XAUDIO2_VOICE_STATE state;
+		m_source->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+		return state.BuffersQueued < RING_SIZE;
+	};
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_bufferEnded.wait_for(lock, timeout, hasSpace);
+}
+
+void XAudio2AudioOutput::Submit(std::span<const f32> interleaved)
+{
+	assert(interleaved.size() == m_blockFrames * m_wfx.nChannels);
+
+	// The slot being overwritten has been consumed since WaitForSpace saw fewer than RING_SIZE queued buffers
+	f32* slot = m_bufferRing.data() + m_ringIdx * m_blockFrames * m_wfx.nChannels;
+	std::copy(interleaved.begin(), interleaved.end(), slot);
+	m_ringIdx = (m_ringIdx + 1) % RING_SIZE;
+
+	XAUDIO2_BUFFER buf = {
+		.AudioBytes = static_cast<u32>(interleaved.size_bytes()),
+		.pAudioData = reinterpret_cast<const BYTE*>(slot),
+	};
+
+	HR hr = m_source->SubmitSourceBuffer(&buf);
+	hr.try_fail("Failed to submit mixer output buffer");
+}
+
+void XAudio2AudioOutput::VoiceCallback::OnBufferEnd(void*)
+{
+	{
+		std::scoped_lock<std::mutex> lock(m_owner->m_mutex);
+	}
+	m_owner->m_bufferEnded.notify_one();
+}
+
+// ------- NULL OUTPUT ----------
+
+NullAudioOutput::NullAudioOutput(u32 sampleRate, u32 channelCount, u32 blockFrames, bool realTime)
+	: m_sampleRate(sampleRate), m_channelCount(channelCount), m_realTime(realTime)
+{
+	m_blockDuration = std::chrono::nanoseconds(1'000'000'000ull * blockFrames / sampleRate);
+	m_nextDeadline = std::chrono::steady_clock::now();
+}
+
+bool NullAudioOutput::WaitForSpace(std::chrono::milliseconds timeout)
+{
+	if (!m_realTime)
+		return true;
+
+	auto now = std::chrono::steady_clock::now();
+	if (m_nextDeadline - now > timeout)
+	{
+		std::this_thread::sleep_for(timeout);
+		return false;
+	}
+
+	std::this_thread::sleep_until(m_nextDeadline);
+	return true;
+}
+
+void NullAudioOutput::Submit(std::span<const f32> interleaved)
+{
+	f32 peak = m_peak;
+	for (f32 sample : interleaved)
+		peak = std::max(peak, std::abs(sample));
+	m_peak = peak;
+
+	m_framesSubmitted += interleaved.size() / m_channelCount;
+
+	if (m_realTime)
+	{
+		// Do not try to catch up after a stall, just restart the pacing
+		auto now = std::chrono::steady_clock::now();
+		m_nextDeadline = std::max(m_nextDeadline, now - m_blockDuration) + m_blockDuration;
+	}
+}
+
+// ------- WAV FILE OUTPUT ----------
+
+WAVFileAudioOutput::WAVFileAudioOutput(const std::filesystem::path& path, u32 sampleRate, u32 channelCount)
+	: m_file(path, std::ios::binary), m_sampleRate(sampleRate), m_channelCount(channelCount)
+{
+	if (!m_file)
+	{
+		throw FileNotFoundError(path.string());
+	}
+	WriteHeader();
+}
+
+WAVFileAudioOutput::~WAVFileAudioOutput()
+{
+	// Patch in the final sizes
+	m_file.seekp(0, std::ios_base::beg);
+	WriteHeader();
+}
+
+void WAVFileAudioOutput::Submit(std::span<const f32> interleaved)
+{
+	m_file.write(reinterpret_cast<const char*>(interleaved.data()), interleaved.size_bytes());
+	m_dataBytes += static_cast<u32>(interleaved.size_bytes());
+}
+
+void WAVFileAudioOutput::WriteHeader()
+{
+	constexpr u32 FORMAT_CHUNK_SIZE = 16;
+	const u32 riffSize = 4 + (8 + FORMAT_CHUNK_SIZE) + (8 + m_dataBytes);
+
+	const u16 formatTag = WAVE_FORMAT_IEEE_FLOAT;
+	const u16 channels = static_cast<u16>(m_channelCount);
+	const u16 blockAlign = static_cast<u16>(m_channelCount * sizeof(f32));
+	const u32 bytesPerSec = m_sampleRate * blockAlign;
+	const u16 bitsPerSample = 8 * sizeof(f32);
+
+	auto write = [this](const auto& value) { m_file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+	m_file.write("RIFF", 4);
+	write(riffSize);
+	m_file.write("WAVE", 4);
+
+	m_file.write("fmt ", 4);
+	write(FORMAT_CHUNK_SIZE);
+	write(formatTag);
+	write(channels);
+	write(m_sampleRate);
+	write(bytesPerSec);
+	write(blockAlign);
+	write(bitsPerSample);
+
+	m_file.write("data", 4);
+	write(m_dataBytes);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+namespace DOG
+{
+	// Receives interleaved f32 blocks from the software mixer
+	class AudioOutput
+	{
+	public:
+		virtual ~AudioOutput() = default;
+
+		virtual u32 SampleRate() const noexcept = 0;
+		virtual u32 ChannelCount() const noexcept = 0;
+
+		// Blocks until another block can be submitted, returns false if it timed out
+		virtual bool WaitForSpace(std::chrono::milliseconds timeout) = 0;
+		virtual void Submit(std::span<const f32> interleaved) = 0;
+	};
+
+	// Streams the mix through a single XAudio2 float voice
+	class XAudio2AudioOutput : public AudioOutput
+	{
+	public:
+		XAudio2AudioOutput(u32 sampleRate, u32 blockFrames);
+		~XAudio2AudioOutput();
+
+		u32 SampleRate() const noexcept override { return m_wfx.nSamplesPerSec; }
+		u32 ChannelCount() const noexcept override { return m_wfx.nChannels; }
+
+		bool WaitForSpace(std::chrono::milliseconds timeout) override;
+		void Submit(std::span<const f32> interleaved) override;
+
+	private:
+		class VoiceCallback : public IXAudio2VoiceCallback
+		{
+		public:
+			VoiceCallback(XAudio2AudioOutput* owner) : m_owner(owner) {}
+
+			void __stdcall OnBufferEnd(void*) override;
+			void __stdcall OnStreamEnd() override {}
+			void __stdcall OnVoiceProcessingPassStart(UINT32) override {}
+			void __stdcall OnVoiceProcessingPassEnd() override {}
+			void __stdcall OnBufferStart(void*) override {}
+			void __stdcall OnLoopEnd(void*) override {}
+			void __stdcall OnVoiceError(void*, HRESULT) override {}
+
+		private:
+			XAudio2AudioOutput* m_owner;
+		};
+
+	private:
+		static constexpr u32 RING_SIZE = 3;
+
+		IXAudio2* m_xaudio = nullptr;
+		IXAudio2MasteringVoice* m_master = nullptr;
+		IXAudio2SourceVoice* m_source = nullptr;
+		VoiceCallback m_callback;
+		WAVEFORMATEX m_wfx = {};
+
+		u32 m_blockFrames = 0;
+		u32 m_ringIdx = 0;
+		std::vector<f32> m_bufferRing;
+
+		std::mutex m_mutex;
+		std::condition_variable m_bufferEnded;
+	};
+
+	// Discards the mix, optionally pacing itself to real time so a headless game loop behaves like it has a device
+	class NullAudioOutput : public AudioOutput
+	{
+	public:
+		NullAudioOutput(u32 sampleRate, u32 channelCount, u32 blockFrames, bool realTime);
+
+		u32 SampleRate() const noexcept override { return m_sampleRate; }
+		u32 ChannelCount() const noexcept override { return m_channelCount; }
+
+		bool WaitForSpace(std::chrono::milliseconds timeout) override;
+		void Submit(std::span<const f32> interleaved) override;
+
+		u64 FramesSubmitted() const noexcept { return m_framesSubmitted; }
+		f32 PeakSample() const noexcept { return m_peak; }
+
+	private:
+		u32 m_sampleRate;
+		u32 m_channelCount;
+		std::chrono::nanoseconds m_blockDuration;
+		bool m_realTime;
+
+		std::chrono::steady_clock::time_point m_nextDeadline;
+		std::atomic<u64> m_framesSubmitted = 0;
+		std::atomic<f32> m_peak = 0.0f;
+	};
+
+	// Writes the mix to a 32-bit float WAV file as fast as the mixer can produce it
+	class WAVFileAudioOutput : public AudioOutput
+	{
+	public:
+		WAVFileAudioOutput(const std::filesystem::path& path, u32 sampleRate, u32 channelCount);
+		~WAVFileAudioOutput();
+
+		u32 SampleRate() const noexcept override { return m_sampleRate; }
+		u32 ChannelCount() const noexcept override { return m_channelCount; }
+
+		bool WaitForSpace(std::chrono::milliseconds) override { return true; }
+		void Submit(std::span<const f32> interleaved) override;
+
+	private:
+		void WriteHeader();
+
+	private:
+		std::ofstream m_file;
+		u32 m_sampleRate;
+		u32 m_channelCount;
+		u32 m_dataBytes = 0;
+	};
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+namespace DOG
+{
+	// Decoded samples keyed by audio asset id, evicting the least recently used entries once the byte budget is exceeded.
+	// Entries are shared with the voices playing them, so evicting a sound that is still playing only drops the cache's reference.
+	template<typename T>
+	class AudioSampleCache
+	{
+	public:
+		using Samples = std::shared_ptr<const std::vector<T>>;
+
+		explicit AudioSampleCache(u64 budgetBytes) : m_budgetBytes(budgetBytes) {}
+		DELETE_COPY_MOVE_CONSTRUCTOR(AudioSampleCache);
+
+		// Returns the cached samples for id, decode() is called on a miss and must return std::vector<T>
+		template<typename DecodeFunc>
+		Samples GetOrDecode(u32 id, DecodeFunc&& decode)
+		{
+			{
+				std::scoped_lock<std::mutex> lock(m_mutex);
+				auto it = m_entries.find(id);
+				if (it != m_entries.end())
+				{
+					m_lru.splice(m_lru.begin(), m_lru, it->second.lruIt);
+					++m_hits;
+					return it->second.samples;
+				}
+				++m_misses;
+			}
+
+			// Decode without holding the lock
+			Samples samples = std::make_shared<const std::vector<T>>(decode());
+			const u64 bytes = samples->size() * sizeof(T);
+
+			std::scoped_lock<std::mutex> lock(m_mutex);
+
+			// Sounds that would take up most of the budget are handed out uncached
+			if (bytes > m_budgetBytes / 2 || m_entries.contains(id))
+				return samples;
+
+			m_lru.push_front(id);
+			m_entries.emplace(id, Entry{ samples, m_lru.begin() });
+			m_residentBytes += bytes;
+			EvictOverBudget();
+			return samples;
+		}
+
+		void Clear()
+		{
+			std::scoped_lock<std::mutex> lock(m_mutex);
+			m_entries.clear();
+			m_lru.clear();
+			m_residentBytes = 0;
+		}
+
+		u64 ResidentBytes() const noexcept { return m_residentBytes; }
+		u64 BudgetBytes() const noexcept { return m_budgetBytes; }
+		u64 Hits() const noexcept { return m_hits; }
+		u64 Misses() const noexcept { return m_misses; }
+		u64 Evictions() const noexcept { return m_evictions; }
+
+	private:
+		struct Entry
+		{
+			Samples samples;
+			std::list<u32>::iterator lruIt;
+		};
+
+		void EvictOverBudget()
+		{
+			while (m_residentBytes > m_budgetBytes && !m_lru.empty())
+			{
+				auto it = m_entries.find(m_lru.back());
+				m_residentBytes -= it->second.samples->size() * sizeof(T);
+				m_entries.erase(it);
+				m_lru.pop_back();
+				++m_evictions;
+			}
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::list<u32> m_lru; // Front is the most recently used
+		std::unordered_map<u32, Entry> m_entries;
+
+		const u64 m_budgetBytes;
+		std::atomic<u64> m_residentBytes = 0;
+		std::atomic<u64> m_hits = 0;
+		std::atomic<u64> m_misses = 0;
+		std::atomic<u64> m_evictions = 0;
+	};
+}
@@ -5,6 +5,10 @@
 #include "../Scripting//LuaMain.h"
 #include "AnimationManager.h"
 #include "AssetManager.h"
+#include "AssetFileSystem.h"
+#include "LightManager.h"
+#include "CustomMeshManager.h"
+#include "CustomMaterialManager.h"
 #include "../ECS/EntityManager.h"		// to remove
 #include "../Input/Mouse.h"
 #include "../Input/Keyboard.h"
@@ -55,7 +59,8 @@ namespace DOG
 			MiniProfiler::Update();
 			MINIPROFILE
 			Mouse::Reset();
-			Window::OnUpdate();
+			if (!m_specification.headless)
+				Window::OnUpdate();
 
 			// Early break if WM tells us to
 			if (!m_isRunning)
@@ -65,6 +70,7 @@ namespace DOG
 
 			for (auto& system : EntityManager::Get())
 			{
+				MiniProfiler systemProfiler(typeid(*system).name());
 				system->EarlyUpdate();
 			}
 
@@ -72,30 +78,39 @@ namespace DOG
 
 			AudioManager::AudioSystem();
 
-			m_frontRenderer->BeginFrameUICapture();
+			if (m_frontRenderer)
+				m_frontRenderer->BeginFrameUICapture();
 			for (auto const layer : m_layerStack)
 			{
 				layer->OnUpdate();
 				layer->OnRender();
 			}
 #if defined _DEBUG
-			for (auto const layer : m_layerStack)
+			if (!m_specification.headless)
 			{
-				layer->OnImGuiRender();
+				for (auto const layer : m_layerStack)
+				{
+					layer->OnImGuiRender();
+				}
 			}
 #endif
 			for (auto& system : EntityManager::Get())
 			{
+				MiniProfiler systemProfiler(typeid(*system).name());
 				system->Update();
 			}
 
-			m_frontRenderer->Update(Time::DeltaTime<TimeType::Seconds, f32>());
-			m_frontRenderer->BeginGPUFrame();
-			m_frontRenderer->Render(Time::DeltaTime<TimeType::Seconds, f32>());
-			m_frontRenderer->EndGPUFrame();
+			if (m_frontRenderer)
+			{
+				m_frontRenderer->Update(Time::DeltaTime<TimeType::Seconds, f32>());
+				m_frontRenderer->BeginGPUFrame();
+				m_frontRenderer->Render(Time::DeltaTime<TimeType::Seconds, f32>());
+				m_frontRenderer->EndGPUFrame();
+			}
 
 			for (auto& system : EntityManager::Get())
 			{
+				MiniProfiler systemProfiler(typeid(*system).name());
 				system->LateUpdate();
 			}
 
@@ -110,7 +125,10 @@ namespace DOG
 
 			//Deferred deletions happen here!!!
 			LuaMain::GetScriptManager()->RemoveScriptsFromDeferredEntities();
-			m_frontRenderer->PerformDeferredDeletion();
+			if (m_frontRenderer)
+				m_frontRenderer->PerformDeferredDeletion();
+			else
+				LightManager::Get().DestroyDeferredEntities();
 			PhysicsEngine::FreePhysicsFromDeferredEntities();
 			AudioManager::StopAudioOnDeferredEntities();
 			EntityManager::Get().DestroyDeferredEntities();
@@ -118,7 +136,8 @@ namespace DOG
 			Time::End();
 		}
 
-		m_renderer->Flush();
+		if (m_renderer)
+			m_renderer->Flush();
 	}
 
 	void Application::OnRestart() noexcept
@@ -248,23 +267,54 @@ namespace DOG
 	void Application::OnStartUp() noexcept
 	{
 		std::filesystem::current_path(m_specification.workingDir);
+		MiniProfiler::SetThreadName("Main");
 
 		EventBus::Get().SetMainApplication(this);
-		Window::Initialize(m_specification);
+		Time::SetFixedTimeStep(m_specification.fixedTimeStep);
+
+		if (m_specification.headless)
+		{
+			// Nothing may touch a device, sounds are still mixed so audio components behave as usual
+			m_specification.audioSettings.backend = AudioBackend::Null;
+			if (m_specification.graphicsSettings.backend == GraphicsBackend::Null)
+			{
+				// The whole frame is recorded and submitted to a device without a GPU
+				const Vector2u& dimensions = m_specification.windowDimensions;
+				m_renderer = std::make_unique<gfx::Renderer>(nullptr, dimensions.x, dimensions.y, false, m_specification.graphicsSettings);
+				m_renderer->SetGraphicsSettings(m_specification.graphicsSettings);
+				m_frontRenderer = std::make_unique<gfx::FrontRenderer>(m_renderer.get());
+			}
+			else
+			{
+				LightManager::Initialize(nullptr);
+				CustomMeshManager::Initialize(nullptr);
+				CustomMaterialManager::Initialize(nullptr);
+			}
+		}
+		else
+		{
+			Window::Initialize(m_specification);
 #ifdef _DEBUG
-		m_renderer = std::make_unique<gfx::Renderer>(Window::GetHandle(), Window::GetWidth(), Window::GetHeight(), true, m_specification.graphicsSettings);
+			m_renderer = std::make_unique<gfx::Renderer>(Window::GetHandle(), Window::GetWidth(), Window::GetHeight(), true, m_specification.graphicsSettings);
 #else
-		m_renderer = std::make_unique<gfx::Renderer>(Window::GetHandle(), Window::GetWidth(), Window::GetHeight(), false, m_specification.graphicsSettings);
+			m_renderer = std::make_unique<gfx::Renderer>(Window::GetHandle(), Window::GetWidth(), Window::GetHeight(), false, m_specification.graphicsSettings);
 #endif
-		// If SetGraphicsSettings is called from inside the Renderers constructor we get strange result.
-		m_renderer->SetGraphicsSettings(m_specification.graphicsSettings);
-		assert(m_specification.graphicsSettings.windowMode == m_renderer->GetFullscreenState());
+			// If SetGraphicsSettings is called from inside the Renderers constructor we get strange result.
+			m_renderer->SetGraphicsSettings(m_specification.graphicsSettings);
+			assert(m_specification.graphicsSettings.windowMode == m_renderer->GetFullscreenState());
+
+			Window::SetWMHook(m_renderer->GetWMCallback());
+			m_frontRenderer = std::make_unique<gfx::FrontRenderer>(m_renderer.get());
+		}
 
-		Window::SetWMHook(m_renderer->GetWMCallback());
-		m_frontRenderer = std::make_unique<gfx::FrontRenderer>(m_renderer.get());
+		// Loose files are used for everything the archive does not have
+		if (std::filesystem::exists(AssetFileSystem::DEFAULT_ARCHIVE))
+			AssetFileSystem::Mount(AssetFileSystem::DEFAULT_ARCHIVE);
 
+		// A null renderer keeps every asset CPU side
 		AssetManager::Initialize(m_renderer.get());
-		AudioManager::Initialize();
+		AssetManager::Get().SetResidencyBudget(m_specification.assetSettings);
+		AudioManager::Initialize(m_specification.audioSettings.backend);
 		SetAudioSettings(m_specification.audioSettings);
 		PhysicsEngine::Initialize();
 		LuaMain::Initialize();
@@ -278,8 +328,19 @@ namespace DOG
 		ImGuiMenuLayer::UnRegisterDebugWindow("MiniProfiler");
 		AssetManager::Destroy();
 		AudioManager::Destroy();
-		
-		::DestroyWindow(Window::GetHandle());
+		AssetFileSystem::Shutdown();
+
+		if (m_specification.headless)
+		{
+			if (!m_frontRenderer)
+			{
+				CustomMaterialManager::Destroy();
+				CustomMeshManager::Destroy();
+				LightManager::Destroy();
+			}
+		}
+		else
+			::DestroyWindow(Window::GetHandle());
 		//...
 	}
 
@@ -310,7 +371,11 @@ namespace DOG
 
 	void Application::ApplyGraphicsSettings() noexcept
 	{
-		m_renderer->VerifyAndSanitizeGraphicsSettings(m_specification.graphicsSettings, Window::GetWidth(), Window::GetHeight());
+		if (!m_renderer)
+			return;
+
+		auto [width, height] = m_specification.headless ? std::pair{ m_specification.windowDimensions.x, m_specification.windowDimensions.y } : Window::GetDimensions();
+		m_renderer->VerifyAndSanitizeGraphicsSettings(m_specification.graphicsSettings, width, height);
 
 		m_frontRenderer->ToggleShadowMapping(m_specification.graphicsSettings.shadowMapping);
 
@@ -322,7 +387,11 @@ namespace DOG
 	Vector2u Application::GetAspectRatio()  const noexcept
 	{
 		Vector2u aspectRatio;
-		if (m_renderer->GetFullscreenState() == WindowMode::Windowed)
+		if (m_specification.headless)
+		{
+			aspectRatio = m_specification.windowDimensions;
+		}
+		else if (m_renderer->GetFullscreenState() == WindowMode::Windowed)
 		{
 			std::tie(aspectRatio.x, aspectRatio.y) = Window::GetDimensions();
 		}
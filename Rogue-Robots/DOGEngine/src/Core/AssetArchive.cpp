@@ -0,0 +1,249 @@
+#include "AssetArchive.h"
+#include <compressapi.h>
+#include <unordered_set>
+
+namespace DOG
+{
+	namespace
+	{
+		std::optional<std::vector<u8>> CompressEntry(std::span<const u8> data)
+		{
+			COMPRESSOR_HANDLE compressor{ nullptr };
+			if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &compressor))
+				return std::nullopt;
+
+			// The first call only asks for the size
+			SIZE_T compressedSize = 0;
+			Compress(compressor, data.data(), data.size(), nullptr, 0, &compressedSize);
+
+			std::vector<u8> compressed(compressedSize);
+			bool compressedOk = Compress(compressor, data.data(), data.size(), compressed.data(), compressed.size(), &compressedSize);
+			CloseCompressor(compressor);
+			if (!compressedOk)
+				return std::nullopt;
+
+			compressed.resize(compressedSize);
+			return compressed;
+		}
+
+		bool DecompressEntry(std::span<const u8> compressed, std::span<u8> out)
+		{
+			DECOMPRESSOR_HANDLE decompressor{ nullptr };
+			if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &decompressor))
+				return false;
+
+			SIZE_T decompressedSize = 0;
+			bool decompressedOk = Decompress(decompressor, compressed.data(), compressed.size(), out.data(), out.size(), &decompressedSize);
+			CloseDecompressor(decompressor);
+			return decompressedOk && decompressedSize == out.size();
+		}
+
+		std::optional<std::vector<u8>> ReadWholeFile(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file)
+				return std::nullopt;
+
+			std::vector<u8> data(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), data.size());
+			if (!file)
+				return std::nullopt;
+			return data;
+		}
+	}
+
+	std::string AssetArchive::NormalizePath(const std::filesystem::path& path)
+	{
+		std::string normalized = path.lexically_normal().generic_string();
+		if (normalized.starts_with("./"))
+			normalized.erase(0, 2);
+		std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+		return normalized;
+	}
+
+	u64 AssetArchive::HashPath(std::string_view normalizedPath)
+	{
+		// FNV-1a, it is written to disk so std::hash can not be used
+		u64 hash = 14695981039346656037ull;
+		for (char c : normalizedPath)
+		{
+			hash ^= static_cast<u8>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::unique_ptr<AssetArchive> AssetArchive::Open(const std::filesystem::path& path)
+	{
+		auto file = MappedFile::Open(path);
+		if (!file)
+			return nullptr;
+
+		auto data = file->GetData();
+		Header header;
+		if (data.size() < sizeof(Header))
+			return nullptr;
+		memcpy(&header, data.data(), sizeof(Header));
+
+		const u64 tocSize = static_cast<u64>(header.entryCount) * sizeof(Entry);
+		if (header.magic != MAGIC || header.version != VERSION || header.tocOffset % alignof(Entry) != 0 ||
+			header.tocOffset > data.size() || tocSize > data.size() - header.tocOffset ||
+			header.pathsOffset < header.tocOffset + tocSize || header.pathsOffset > data.size())
+		{
+			std::cout << "AssetArchive: " << path.string() << " is not a valid archive\n";
+			return nullptr;
+		}
+
+		std::unique_ptr<AssetArchive> archive(new AssetArchive());
+		archive->m_entries = { reinterpret_cast<const Entry*>(data.data() + header.tocOffset), header.entryCount };
+		archive->m_paths = { reinterpret_cast<const char*>(data.data() + header.pathsOffset), data.size() - header.pathsOffset };
+
+		for (auto& entry : archive->m_entries)
+		{
+			if (entry.offset > data.size() || entry.storedSize > data.size() - entry.offset ||
+				static_cast<u64>(entry.pathOffset) + entry.pathLength > archive->m_paths.size())
+			{
+				std::cout << "AssetArchive: " << path.string() << " is corrupt\n";
+				return nullptr;
+			}
+		}
+
+		archive->m_file = std::move(file);
+		return archive;
+	}
+
+	const AssetArchive::Entry* AssetArchive::Find(std::string_view normalizedPath) const
+	{
+		const u64 hash = HashPath(normalizedPath);
+		auto it = std::lower_bound(m_entries.begin(), m_entries.end(), hash, [](const Entry& entry, u64 h) { return entry.pathHash < h; });
+		for (; it != m_entries.end() && it->pathHash == hash; ++it)
+		{
+			if (GetPath(*it) == normalizedPath)
+				return &*it;
+		}
+		return nullptr;
+	}
+
+	std::string_view AssetArchive::GetPath(const Entry& entry) const
+	{
+		return m_paths.substr(entry.pathOffset, entry.pathLength);
+	}
+
+	std::span<const u8> AssetArchive::GetStoredData(const Entry& entry) const
+	{
+		return m_file->GetData().subspan(entry.offset, entry.storedSize);
+	}
+
+	std::optional<FileData> AssetArchive::Read(const Entry& entry) const
+	{
+		switch (entry.compression)
+		{
+		case Compression::None:
+			return FileData{ GetStoredData(entry), m_file };
+
+		case Compression::XpressHuffman:
+		{
+			auto buffer = std::make_shared<std::vector<u8>>(entry.size);
+			if (!DecompressEntry(GetStoredData(entry), *buffer))
+			{
+				std::cout << "AssetArchive: failed to decompress " << GetPath(entry) << "\n";
+				return std::nullopt;
+			}
+			return FileData{ *buffer, buffer };
+		}
+
+		default:
+			return std::nullopt;
+		}
+	}
+
+	bool AssetArchive::Write(const std::filesystem::path& archivePath, const std::vector<Source>& sources)
+	{
+		auto tempPath = archivePath;
+		tempPath += ".tmp";
+		std::ofstream out(tempPath, std::ios::binary);
+		if (!out)
+		{
+			std::cout << "AssetArchive: could not open " << tempPath.string() << " for writing\n";
+			return false;
+		}
+
+		Header header;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+		auto pad = [&out](u64 alignment)
+		{
+			const u64 position = static_cast<u64>(out.tellp());
+			const u64 padding = (alignment - position % alignment) % alignment;
+			for (u64 i = 0; i < padding; ++i)
+				out.put('\0');
+		};
+
+		std::vector<Entry> entries;
+		std::string paths;
+		std::unordered_set<std::string> written;
+		entries.reserve(sources.size());
+		for (auto& source : sources)
+		{
+			std::string path = NormalizePath(source.path);
+			if (!written.insert(path).second)
+			{
+				std::cout << "AssetArchive: " << path << " is added twice, only the first is kept\n";
+				continue;
+			}
+
+			auto data = ReadWholeFile(source.file);
+			if (!data)
+			{
+				std::cout << "AssetArchive: could not read " << source.file.string() << "\n";
+				return false;
+			}
+
+			Entry entry;
+			entry.pathHash = HashPath(path);
+			entry.size = data->size();
+			entry.pathOffset = static_cast<u32>(paths.size());
+			entry.pathLength = static_cast<u16>(path.size());
+			paths += path;
+
+			if (source.compress && !data->empty())
+			{
+				auto compressed = CompressEntry(*data);
+				if (compressed && compressed->size() <= data->size() - data->size() / 8)
+				{
+					entry.compression = Compression::XpressHuffman;
+					*data = std::move(*compressed);
+				}
+			}
+
+			pad(ALIGNMENT);
+			entry.offset = static_cast<u64>(out.tellp());
+			entry.storedSize = data->size();
+			out.write(reinterpret_cast<const char*>(data->data()), data->size());
+			entries.push_back(entry);
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; });
+
+		pad(alignof(Entry));
+		header.entryCount = static_cast<u32>(entries.size());
+		header.tocOffset = static_cast<u64>(out.tellp());
+		out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+		header.pathsOffset = static_cast<u64>(out.tellp());
+		out.write(paths.data(), paths.size());
+
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		out.close();
+		if (!out)
+		{
+			std::cout << "AssetArchive: failed writing " << tempPath.string() << "\n";
+			return false;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, archivePath, error);
+		return !error;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "MappedFile.h"
+
+namespace DOG
+{
+	// Contents of a file, either a view into a mapped archive or a buffer of its own
+	struct FileData
+	{
+		std::span<const u8> data;
+		std::shared_ptr<const void> owner;		// Keeps data alive
+	};
+
+	// Many asset files packed into one, read through a memory mapping.
+	// Layout: Header, the entries each aligned to ALIGNMENT, the table of contents sorted by path hash and last the paths.
+	class AssetArchive
+	{
+	public:
+		static constexpr u32 MAGIC = 0x4B415044;	// "DPAK"
+		static constexpr u32 VERSION = 1;
+		static constexpr u32 ALIGNMENT = 4096;		// Page aligned so an entry never shares a page with the one before it
+
+		enum class Compression : u16
+		{
+			None,
+			XpressHuffman,		// Windows Compression API
+		};
+
+		struct Entry
+		{
+			u64 pathHash{ 0 };
+			u64 offset{ 0 };
+			u64 storedSize{ 0 };
+			u64 size{ 0 };
+			u32 pathOffset{ 0 };		// Into the paths after the table of contents
+			u16 pathLength{ 0 };
+			Compression compression{ Compression::None };
+		};
+		static_assert(sizeof(Entry) == 40);
+
+		struct Source
+		{
+			std::filesystem::path file;
+			std::string path;			// Looked up by this, normalized when written
+			bool compress{ true };
+		};
+
+	public:
+		// Returns nullptr if the file is not a valid archive
+		static std::unique_ptr<AssetArchive> Open(const std::filesystem::path& path);
+
+		// Entries are only kept compressed when that saves at least an eighth of the size
+		static bool Write(const std::filesystem::path& archivePath, const std::vector<Source>& sources);
+
+		// Lower case with forward slashes and no "./", the same file always gives the same string
+		static std::string NormalizePath(const std::filesystem::path& path);
+		static u64 HashPath(std::string_view normalizedPath);
+
+		const Entry* Find(std::string_view normalizedPath) const;
+		std::string_view GetPath(const Entry& entry) const;
+		std::span<const Entry> GetEntries() const { return m_entries; }
+
+		// Uncompressed entries are a view of the mapping, compressed ones are decompressed into a buffer
+		std::optional<FileData> Read(const Entry& entry) const;
+		std::span<const u8> GetStoredData(const Entry& entry) const;
+
+	private:
+		struct Header
+		{
+			u32 magic{ MAGIC };
+			u32 version{ VERSION };
+			u32 entryCount{ 0 };
+			u32 alignment{ ALIGNMENT };
+			u64 tocOffset{ 0 };
+			u64 pathsOffset{ 0 };
+		};
+
+	private:
+		AssetArchive() = default;
+
+	private:
+		std::shared_ptr<MappedFile> m_file;
+		std::span<const Entry> m_entries;
+		std::string_view m_paths;
+	};
+}
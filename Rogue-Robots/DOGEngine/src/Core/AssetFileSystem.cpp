@@ -0,0 +1,261 @@
+#include "AssetFileSystem.h"
+
+namespace DOG
+{
+	AssetFileSystem AssetFileSystem::s_instance;
+
+	namespace
+	{
+		// Reads a FileData through std::istream, for code that wants to seek around in a file
+		class FileDataBuffer : public std::streambuf
+		{
+		public:
+			FileDataBuffer(FileData file) : m_file(std::move(file))
+			{
+				char* begin = const_cast<char*>(reinterpret_cast<const char*>(m_file.data.data()));
+				setg(begin, begin, begin + m_file.data.size());
+			}
+
+		protected:
+			pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+			{
+				if (!(which & std::ios_base::in))
+					return pos_type(off_type(-1));
+
+				off_type base = 0;
+				if (dir == std::ios_base::cur)
+					base = gptr() - eback();
+				else if (dir == std::ios_base::end)
+					base = egptr() - eback();
+
+				const off_type position = base + offset;
+				if (position < 0 || position > egptr() - eback())
+					return pos_type(off_type(-1));
+
+				setg(eback(), eback() + position, egptr());
+				return pos_type(position);
+			}
+
+			pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+			{
+				return seekoff(off_type(position), std::ios_base::beg, which);
+			}
+
+		private:
+			FileData m_file;
+		};
+
+		class FileDataStream : public std::istream
+		{
+		public:
+			FileDataStream(FileData file) : std::istream(nullptr), m_buffer(std::move(file)) { rdbuf(&m_buffer); }
+
+		private:
+			FileDataBuffer m_buffer;
+		};
+	}
+
+	AssetFileSystem::~AssetFileSystem()
+	{
+		Shutdown();
+	}
+
+	bool AssetFileSystem::Mount(const std::filesystem::path& archivePath)
+	{
+		std::shared_ptr<AssetArchive> archive = AssetArchive::Open(archivePath);
+		if (!archive)
+			return false;
+
+		std::unique_lock lock(s_instance.m_archiveMutex);
+		s_instance.m_archives.push_back({ archivePath, std::move(archive) });
+		std::cout << "AssetFileSystem: mounted " << archivePath.string() << "\n";
+		return true;
+	}
+
+	void AssetFileSystem::Unmount(const std::filesystem::path& archivePath)
+	{
+		std::unique_lock lock(s_instance.m_archiveMutex);
+		std::erase_if(s_instance.m_archives, [&archivePath](const MountedArchive& mounted) { return mounted.path == archivePath; });
+	}
+
+	bool AssetFileSystem::HasArchives()
+	{
+		std::shared_lock lock(s_instance.m_archiveMutex);
+		return !s_instance.m_archives.empty();
+	}
+
+	void AssetFileSystem::Shutdown()
+	{
+		{
+			std::unique_lock lock(s_instance.m_queueMutex);
+			s_instance.m_stop = true;
+		}
+		s_instance.m_queueCondition.notify_one();
+		if (s_instance.m_ioThread.joinable())
+			s_instance.m_ioThread.join();
+
+		// Batches that never got read are finished empty so nobody waits on them forever
+		{
+			std::unique_lock lock(s_instance.m_queueMutex);
+			for (; !s_instance.m_queue.empty(); s_instance.m_queue.pop())
+			{
+				auto& batch = s_instance.m_queue.front();
+				batch->m_results.resize(batch->m_paths.size());
+				batch->m_done.store(true, std::memory_order_release);
+				batch->m_done.notify_all();
+			}
+		}
+
+		std::unique_lock lock(s_instance.m_archiveMutex);
+		s_instance.m_archives.clear();
+	}
+
+	AssetFileSystem::Location AssetFileSystem::Find(const std::string& normalizedPath)
+	{
+		std::shared_lock lock(s_instance.m_archiveMutex);
+		for (auto it = s_instance.m_archives.rbegin(); it != s_instance.m_archives.rend(); ++it)
+		{
+			if (auto entry = it->archive->Find(normalizedPath))
+				return { it->archive, entry };
+		}
+		return {};
+	}
+
+	bool AssetFileSystem::Exists(const std::filesystem::path& path)
+	{
+		return Find(AssetArchive::NormalizePath(path)).entry || std::filesystem::exists(path);
+	}
+
+	std::optional<u64> AssetFileSystem::FileSize(const std::filesystem::path& path)
+	{
+		if (auto location = Find(AssetArchive::NormalizePath(path)); location.entry)
+			return location.entry->size;
+
+		std::error_code error;
+		u64 size = std::filesystem::file_size(path, error);
+		if (error)
+			return std::nullopt;
+		return size;
+	}
+
+	std::optional<FileData> AssetFileSystem::ReadLooseFile(const std::filesystem::path& path)
+	{
+		if (auto file = MappedFile::Open(path))
+			return FileData{ file->GetData(), file };
+
+		// MappedFile refuses empty files
+		std::error_code error;
+		if (std::filesystem::is_regular_file(path, error))
+			return FileData{};
+		return std::nullopt;
+	}
+
+	std::optional<FileData> AssetFileSystem::ReadFile(const std::filesystem::path& path)
+	{
+		if (auto location = Find(AssetArchive::NormalizePath(path)); location.entry)
+			return location.archive->Read(*location.entry);
+		return ReadLooseFile(path);
+	}
+
+	std::unique_ptr<std::istream> AssetFileSystem::OpenStream(const std::filesystem::path& path)
+	{
+		if (auto location = Find(AssetArchive::NormalizePath(path)); location.entry)
+		{
+			if (auto file = location.archive->Read(*location.entry))
+				return std::make_unique<FileDataStream>(std::move(*file));
+		}
+		return std::make_unique<std::ifstream>(path, std::ios::binary);
+	}
+
+	std::shared_ptr<AssetFileSystem::ReadBatch> AssetFileSystem::SubmitReads(const std::vector<std::filesystem::path>& paths, ReadMode mode)
+	{
+		auto batch = std::make_shared<ReadBatch>();
+		batch->m_mode = mode;
+		batch->m_paths.reserve(paths.size());
+		for (auto& path : paths)
+			batch->m_paths.push_back(path.string());
+
+		{
+			std::unique_lock lock(s_instance.m_queueMutex);
+			if (s_instance.m_stop)
+			{
+				batch->m_results.resize(paths.size());
+				batch->m_done.store(true, std::memory_order_release);
+				return batch;
+			}
+			if (!s_instance.m_ioThread.joinable())
+				s_instance.m_ioThread = std::thread(&AssetFileSystem::IOThread, &s_instance);
+			s_instance.m_queue.push(batch);
+		}
+		s_instance.m_queueCondition.notify_one();
+		return batch;
+	}
+
+	void AssetFileSystem::IOThread()
+	{
+		while (true)
+		{
+			std::shared_ptr<ReadBatch> batch;
+			{
+				std::unique_lock lock(m_queueMutex);
+				m_queueCondition.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+				if (m_stop)
+					return;
+				batch = std::move(m_queue.front());
+				m_queue.pop();
+			}
+
+			ReadBatchNow(*batch);
+			batch->m_done.store(true, std::memory_order_release);
+			batch->m_done.notify_all();
+		}
+	}
+
+	void AssetFileSystem::ReadBatchNow(ReadBatch& batch)
+	{
+		struct Request
+		{
+			size_t index;
+			Location location;
+		};
+
+		batch.m_results.resize(batch.m_paths.size());
+		std::vector<Request> archiveReads;
+		std::vector<size_t> looseReads;
+		for (size_t i = 0; i < batch.m_paths.size(); ++i)
+		{
+			if (auto location = Find(AssetArchive::NormalizePath(batch.m_paths[i])); location.entry)
+				archiveReads.push_back({ i, std::move(location) });
+			else
+				looseReads.push_back(i);
+		}
+
+		// Walk each archive front to back and ask the OS for all the pages at once instead of faulting them in one by one
+		std::sort(archiveReads.begin(), archiveReads.end(), [](const Request& a, const Request& b)
+			{
+				if (a.location.archive != b.location.archive)
+					return a.location.archive < b.location.archive;
+				return a.location.entry->offset < b.location.entry->offset;
+			});
+
+		std::vector<WIN32_MEMORY_RANGE_ENTRY> ranges;
+		ranges.reserve(archiveReads.size());
+		for (auto& request : archiveReads)
+		{
+			auto stored = request.location.archive->GetStoredData(*request.location.entry);
+			if (!stored.empty())
+				ranges.push_back({ const_cast<u8*>(stored.data()), stored.size() });
+		}
+		if (!ranges.empty())
+			PrefetchVirtualMemory(GetCurrentProcess(), ranges.size(), ranges.data(), 0);
+
+		if (batch.m_mode == ReadMode::PageIn)
+			return;
+
+		for (auto& request : archiveReads)
+			batch.m_results[request.index] = request.location.archive->Read(*request.location.entry);
+
+		for (size_t index : looseReads)
+			batch.m_results[index] = ReadLooseFile(batch.m_paths[index]);
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "AssetArchive.h"
+#include <shared_mutex>
+
+namespace DOG
+{
+	// Finds asset files in the mounted archives first and on disk second, so loose files still work during development.
+	// Paths are the same as before packing, relative to the working directory ("Assets/Models/...").
+	class AssetFileSystem
+	{
+	public:
+		enum class ReadMode
+		{
+			Read,
+			PageIn,		// Only brings archive entries into memory for reads that come later, the results stay empty
+		};
+
+		// Results of SubmitReads, in the order the paths were given. A file that could not be read is nullopt.
+		class ReadBatch
+		{
+			friend class AssetFileSystem;
+		public:
+			bool IsDone() const { return m_done.load(std::memory_order_acquire); }
+			void Wait() const { m_done.wait(false, std::memory_order_acquire); }
+
+			// Only valid once the batch is done
+			const std::vector<std::optional<FileData>>& GetResults() const { assert(IsDone()); return m_results; }
+
+		private:
+			std::vector<std::string> m_paths;
+			ReadMode m_mode{ ReadMode::Read };
+			std::vector<std::optional<FileData>> m_results;
+			std::atomic<bool> m_done{ false };
+		};
+
+	public:
+		// Mounted at startup when it exists, built by the AssetPacker tool
+		static constexpr const char* DEFAULT_ARCHIVE = "Assets.dogpak";
+
+		// Archives mounted later are searched first, so a patch archive can override files
+		static bool Mount(const std::filesystem::path& archivePath);
+		static void Unmount(const std::filesystem::path& archivePath);
+		static bool HasArchives();
+		// Stops the I/O thread and unmounts everything, spans from archives are still valid while their FileData is alive
+		static void Shutdown();
+
+		static bool Exists(const std::filesystem::path& path);
+		static std::optional<u64> FileSize(const std::filesystem::path& path);
+
+		// Reads on the calling thread
+		static std::optional<FileData> ReadFile(const std::filesystem::path& path);
+		static std::unique_ptr<std::istream> OpenStream(const std::filesystem::path& path);
+
+		// Reads on the I/O thread. Archive reads in a batch are done in file order and their pages are prefetched together.
+		static std::shared_ptr<ReadBatch> SubmitReads(const std::vector<std::filesystem::path>& paths, ReadMode mode = ReadMode::Read);
+
+	private:
+		struct MountedArchive
+		{
+			std::filesystem::path path;
+			std::shared_ptr<AssetArchive> archive;
+		};
+
+		struct Location
+		{
+			std::shared_ptr<AssetArchive> archive;
+			const AssetArchive::Entry* entry{ nullptr };
+		};
+
+	private:
+		AssetFileSystem() = default;
+		~AssetFileSystem();
+
+		static Location Find(const std::string& normalizedPath);
+		static std::optional<FileData> ReadLooseFile(const std::filesystem::path& path);
+		static void ReadBatchNow(ReadBatch& batch);
+		void IOThread();
+
+	private:
+		static AssetFileSystem s_instance;
+
+		std::shared_mutex m_archiveMutex;
+		std::vector<MountedArchive> m_archives;
+
+		std::mutex m_queueMutex;
+		std::condition_variable m_queueCondition;
+		std::queue<std::shared_ptr<ReadBatch>> m_queue;
+		std::thread m_ioThread;
+		bool m_stop{ false };
+	};
+}
@@ -2,6 +2,8 @@
 #include "../Graphics/Rendering/Renderer.h"
 #include "../Core/TextureFileImporter.h"
 #include "ImGuiMenuLayer.h"
+#include "../ECS/EntityManager.h"
+#include "../Physics/PhysicsEngine.h"
 #include "ImGUI/imgui.h"
 
 #pragma warning(push, 0)
@@ -25,6 +27,7 @@ namespace DOG
 		assert(!s_instance);
 		s_instance = std::unique_ptr<AssetManager>(new AssetManager());
 		s_instance->m_renderer = renderer;
+		s_instance->m_bakedTextures.Open(BAKED_TEXTURE_DIRECTORY);
 		TextureFileImporter::Initialize();
 	}
 
@@ -45,6 +48,7 @@ namespace DOG
 	{
 		ImGuiMenuLayer::RegisterDebugWindow("LoadModel", [](bool& open) { AssetManager::Get().ImguiLoadModel(open); });
 		ImGuiMenuLayer::RegisterDebugWindow("AssetManager", [](bool& open) { AssetManager::Get().AssetManagerGUI(open); });
+		ImGuiMenuLayer::RegisterDebugWindow("AssetResidency", [](bool& open) { AssetManager::Get().ResidencyGUI(open); });
 	}
 
 	void AssetManager::LoadModelAssetInternal(const std::string& path, u32 id, ModelAsset* assetOut)
@@ -70,6 +74,7 @@ namespace DOG
 					model->meshAsset.vertexData = std::move(asset->mesh.vertexData);
 					model->animation = std::move(asset->animation);
 					model->submeshes = std::move(asset->submeshes);
+					model->ComputeSubmeshBounds();
 					model->lights = std::move(asset->lights);
 
 					// Add command that runs on the main thread
@@ -102,6 +107,7 @@ namespace DOG
 				assetOut->meshAsset.indices = std::move(asset->mesh.indices);
 				assetOut->meshAsset.vertexData = std::move(asset->mesh.vertexData);
 				assetOut->submeshes = std::move(asset->submeshes);
+				assetOut->ComputeSubmeshBounds();
 				assetOut->animation = std::move(asset->animation);
 				assetOut->lights = std::move(asset->lights);
 				assetOut->materialIndices = LoadMaterials(asset->materials, m_assets[id]->loadFlag);
@@ -173,6 +179,7 @@ namespace DOG
 					model->meshAsset.vertexData = std::move(asset->mesh.vertexData);
 					model->animation = std::move(asset->animation);
 					model->submeshes = std::move(asset->submeshes);
+					model->ComputeSubmeshBounds();
 
 					// Add command that runs on the main thread
 					AssetManager::AddCommand([id = id, managedModel = managedModel, model = model, importedModel = asset](AssetLoadFlag textureLoadFlag)
@@ -204,6 +211,7 @@ namespace DOG
 				assetOut->meshAsset.indices = std::move(asset->mesh.indices);
 				assetOut->meshAsset.vertexData = std::move(asset->mesh.vertexData);
 				assetOut->submeshes = std::move(asset->submeshes);
+				assetOut->ComputeSubmeshBounds();
 				assetOut->animation = std::move(asset->animation);
 				assetOut->materialIndices = LoadMaterials(asset->materials, m_assets[id]->loadFlag);
 				m_assets[id]->stateFlag |= AssetStateFlag::ExistOnCPU;
@@ -290,7 +298,8 @@ namespace DOG
 			if (!(m_assets[id]->stateFlag & AssetStateFlag::ExistOnCPU))
 			{
 				bool srgb = (AssetLoadFlag)(m_assets[id]->loadFlag & AssetLoadFlag::Srgb) == AssetLoadFlag::Srgb;
-				LoadTextureCommpresonator(path, assetOut, srgb);
+				if (!LoadTextureBaked(path, assetOut, srgb))
+					LoadTextureCommpresonator(path, assetOut, srgb);
 				m_assets[id]->stateFlag |= AssetStateFlag::ExistOnCPU;
 			}
 
@@ -335,6 +344,7 @@ namespace DOG
 	{
 		ImGuiMenuLayer::UnRegisterDebugWindow("LoadModel");
 		ImGuiMenuLayer::UnRegisterDebugWindow("AssetManager");
+		ImGuiMenuLayer::UnRegisterDebugWindow("AssetResidency");
 		for (auto& [id, asset] : m_assets)
 		{
 			assert(asset);
@@ -376,6 +386,7 @@ namespace DOG
 			LoadModelAssetInternal(path, id, p);
 		}
 		assert(id != 0);
+		m_assets[id]->lastUseFrame = m_frame;
 		return id;
 	}
 
@@ -440,12 +451,13 @@ namespace DOG
 			LoadTextureAssetInternal(path, id, p);
 		}
 		assert(id != 0);
+		m_assets[id]->lastUseFrame = m_frame;
 		return id;
 	}
 
 	u32 AssetManager::LoadAudio(const std::string& path, AssetLoadFlag flag)
 	{
-		if (!std::filesystem::exists(path))
+		if (!AssetFileSystem::Exists(path))
 		{
 			throw FileNotFoundError(path);
 		}
@@ -454,7 +466,7 @@ namespace DOG
 		if (!AssetNeedsToBeLoaded(path, flag, id))
 			return id;
 		
-		u64 fileSize = std::filesystem::file_size(path);
+		u64 fileSize = AssetFileSystem::FileSize(path).value_or(0);
 		AudioAsset* newAudio = new AudioAsset;
 		newAudio->filePath = path;
 		WAVFileReader wfr(path);
@@ -463,9 +475,16 @@ namespace DOG
 
 		if (fileSize > MAX_AUDIO_SIZE_ASYNC)
 		{
+			// Streamed, compressed files are decoded chunk by chunk while playing
 			newAudio->async = true;
 			newAudio->properties = wfr.ReadWFXProperties();
 		}
+		else if (wfr.IsCompressed())
+		{
+			newAudio->compressed = true;
+			newAudio->encodedProperties = wfr.EncodedWFXProperties();
+			newAudio->audioData = wfr.ReadEncodedFull();
+		}
 		else
 		{
 			newAudio->audioData = wfr.ReadFull();
@@ -480,6 +499,12 @@ namespace DOG
 		return id;
 	}
 
+	void AssetManager::PrefetchFiles(const std::vector<std::filesystem::path>& paths)
+	{
+		if (AssetFileSystem::HasArchives())
+			AssetFileSystem::SubmitReads(paths, AssetFileSystem::ReadMode::PageIn);
+	}
+
 	Asset* AssetManager::GetBaseAsset(u32 id) const
 	{
 		if (!m_assets.contains(id))
@@ -519,6 +544,175 @@ namespace DOG
 	void AssetManager::Update()
 	{
 		ExecuteCommands();
+
+		if (++m_frame % RESIDENCY_INTERVAL == 0)
+			UpdateResidency();
+	}
+
+	void AssetManager::SetResidencyBudget(const AssetSettings& budget)
+	{
+		m_residencyBudget = budget;
+	}
+
+	void AssetManager::CountReferences()
+	{
+		for (auto& [id, asset] : m_assets)
+			asset->refCount = 0;
+
+		auto addReference = [this](u32 id)
+		{
+			if (auto it = m_assets.find(id); it != m_assets.end())
+				++it->second->refCount;
+		};
+
+		auto& em = EntityManager::Get();
+		em.Collect<ModelComponent>().Do([&](ModelComponent& model) { addReference(model.id); });
+
+		// Cached mesh collider shapes point into the CPU data of their models, even when no component uses them anymore
+		em.Collect<MeshColliderComponent>().Do([&](MeshColliderComponent& collider) { addReference(collider.meshColliderModelID); });
+		for (auto& collider : PhysicsEngine::GetLoadedMeshColliders())
+			addReference(collider.meshModelID);
+
+		// Merged batches are drawn with the materials of their block models
+		em.Collect<StaticBatchComponent>().Do([&](StaticBatchComponent& batch)
+			{
+				for (auto& instance : batch.instances)
+					addReference(instance.modelID);
+			});
+
+		// The materials of a model on the GPU point at its textures
+		m_modelTextures.clear();
+		for (auto& [id, asset] : m_assets)
+		{
+			auto managedModel = dynamic_cast<ManagedAsset<ModelAsset>*>(asset);
+			if (!managedModel || asset->CheckIfLoadingAsync() || !managedModel->Get())
+				continue;
+
+			const bool onGPU = asset->stateFlag & AssetStateFlag::ExistOnGPU || asset->loadFlag & AssetLoadFlag::GPUMemory;
+			for (u32 matIndex : managedModel->Get()->materialIndices)
+			{
+				const Material& mat = m_materialManager.GetMaterial(matIndex);
+				for (u32 texture : { mat.albedo, mat.metallicRoughness, mat.normalMap, mat.emissive })
+				{
+					if (texture == 0)
+						continue;
+					m_modelTextures.insert(texture);
+					if (onGPU)
+						addReference(texture);
+				}
+			}
+		}
+	}
+
+	bool AssetManager::IsEvictable(u32 id) const
+	{
+		ManagedAssetBase* asset = m_assets.at(id);
+		if (asset->refCount > 0 || asset->stateFlag == AssetStateFlag::None)
+			return false;
+
+		// Still being loaded
+		if (asset->CheckIfLoadingAsync() || asset->loadFlag & AssetLoadFlag::CPUMemory || asset->loadFlag & AssetLoadFlag::GPUMemory)
+			return false;
+
+		// Code waiting for an asset polls GetAsset every frame, which keeps it here
+		return asset->lastUseFrame.load(std::memory_order_relaxed) + MIN_EVICTION_AGE <= m_frame;
+	}
+
+	void AssetManager::UpdateResidency()
+	{
+		CountReferences();
+
+		// Evicted models that a component uses again are brought back
+		for (auto it = m_evictedModels.begin(); it != m_evictedModels.end();)
+		{
+			ManagedAssetBase* asset = m_assets.at(it->first);
+			if (asset->stateFlag & AssetStateFlag::ExistOnGPU || asset->loadFlag & AssetLoadFlag::GPUMemory)
+			{
+				it = m_evictedModels.erase(it);
+			}
+			else if (asset->refCount > 0)
+			{
+				std::cout << "AssetManager: reloading evicted model " << it->second << std::endl;
+				static_cast<void>(LoadModelAsset(it->second, (AssetLoadFlag)(AssetLoadFlag::GPUMemory | AssetLoadFlag::Async)));
+				it = m_evictedModels.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		ResidencyStats stats;
+		stats.evictions = m_residencyStats.evictions;
+		std::vector<u32> candidates;
+		for (auto& [id, asset] : m_assets)
+		{
+			const bool isModel = dynamic_cast<ManagedAsset<ModelAsset>*>(asset) != nullptr;
+			const bool isTexture = !isModel && dynamic_cast<ManagedAsset<TextureAsset>*>(asset) != nullptr;
+			if (!(isModel || isTexture) || asset->CheckIfLoadingAsync())
+				continue;
+
+			stats.cpuMemory += asset->GetCPUMemory();
+			stats.gpuMemory += asset->gpuMemory;
+			if (asset->stateFlag != AssetStateFlag::None)
+				++(isModel ? stats.residentModels : stats.residentTextures);
+			if (asset->refCount > 0)
+				++stats.referencedAssets;
+
+			if ((isModel || m_modelTextures.contains(id)) && IsEvictable(id))
+				candidates.push_back(id);
+		}
+
+		const u64 cpuBudget = static_cast<u64>(m_residencyBudget.cpuBudgetMB) << 20;
+		const u64 gpuBudget = static_cast<u64>(m_residencyBudget.gpuBudgetMB) << 20;
+		if (stats.cpuMemory > cpuBudget || stats.gpuMemory > gpuBudget)
+		{
+			std::unordered_map<u32, const std::string*> pathOfAsset;
+			for (auto& [path, id] : m_pathTOAssetID)
+				pathOfAsset[id] = &path;
+
+			std::sort(candidates.begin(), candidates.end(), [this](u32 a, u32 b)
+				{
+					return m_assets.at(a)->lastUseFrame.load(std::memory_order_relaxed) < m_assets.at(b)->lastUseFrame.load(std::memory_order_relaxed);
+				});
+
+			for (u32 id : candidates)
+			{
+				if (stats.cpuMemory <= cpuBudget && stats.gpuMemory <= gpuBudget)
+					break;
+
+				ManagedAssetBase* asset = m_assets.at(id);
+				const bool isModel = dynamic_cast<ManagedAsset<ModelAsset>*>(asset) != nullptr;
+
+				// Shapes are keyed by their parameters and have no file to be reloaded from
+				auto path = pathOfAsset.find(id);
+				if (isModel && (path == pathOfAsset.end() || !std::filesystem::path(*path->second).has_extension()))
+					continue;
+
+				AssetUnLoadFlag flag = AssetUnLoadFlag::None;
+				if (stats.gpuMemory > gpuBudget && asset->stateFlag & AssetStateFlag::ExistOnGPU)
+				{
+					flag |= isModel ? AssetUnLoadFlag::MeshGPU : AssetUnLoadFlag::TextureGPU;
+					stats.gpuMemory -= asset->gpuMemory;
+					if (isModel)
+						m_evictedModels[id] = *path->second;
+				}
+				if (stats.cpuMemory > cpuBudget && asset->stateFlag & AssetStateFlag::ExistOnCPU)
+				{
+					flag |= isModel ? AssetUnLoadFlag::MeshCPU : AssetUnLoadFlag::TextureCPU;
+					stats.cpuMemory -= asset->GetCPUMemory();
+				}
+				if (flag == AssetUnLoadFlag::None)
+					continue;
+
+				UnLoadAsset(id, flag);
+				if (asset->stateFlag == AssetStateFlag::None)
+					--(isModel ? stats.residentModels : stats.residentTextures);
+				++stats.evictions;
+			}
+		}
+
+		m_residencyStats = stats;
 	}
 
 	void AssetManager::ExecuteCommands()
@@ -608,13 +802,34 @@ namespace DOG
 		assetOut->height = importedTex->dataPerMip.front().height;
 		// Constraint no longer true, we are using BC7 textures and per pixel size is no longer 4 bytes
 		//assert(static_cast<size_t>(assetOut->width) * assetOut->height * 4 == importedTex->dataPerMip.front().data.size());
-		assetOut->textureData.resize(importedTex->dataPerMip.front().data.size());
 		assetOut->format = importedTex->format;
-		memcpy(assetOut->textureData.data(), importedTex->dataPerMip.front().data.data(), importedTex->dataPerMip.front().data.size());
+		assetOut->textureData = std::move(importedTex->dataPerMip.front().data);
+	}
+
+	bool AssetManager::LoadTextureBaked(const std::string& path, TextureAsset* assetOut, bool srgb)
+	{
+		auto baked = m_bakedTextures.Find(path);
+		if (!baked)
+			return false;
+
+		assetOut->mipLevels = static_cast<u32>(baked->mips.size());
+		assetOut->width = baked->mips.front().width;
+		assetOut->height = baked->mips.front().height;
+		assetOut->format = srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+		assetOut->mappedFile = std::move(baked->file);
+		assetOut->mappedMips = std::move(baked->mips);
+		return true;
 	}
 
 	void AssetManager::MoveModelToGPU(u32 modelID)
 	{
+		if (!m_renderer)
+		{
+			// Headless, the model stays in CPU memory
+			m_assets[modelID]->loadFlag &= ~AssetLoadFlag::GPUMemory;
+			return;
+		}
+
 		gfx::GraphicsBuilder* builder = m_renderer->GetBuilder();
 
 		// Convert ModelAsset and its MeshAsset to MeshSpecification
@@ -681,6 +896,9 @@ namespace DOG
 		}
 
 		modelAsset->gfxModel = builder->LoadCustomModel(loadSpec, matSpecs);
+		m_assets[modelID]->gpuMemory = loadSpec.indices.size_bytes();
+		for (auto& [attr, data] : loadSpec.vertexDataPerAttribute)
+			m_assets[modelID]->gpuMemory += data.size_bytes();
 		m_assets[modelID]->stateFlag |= AssetStateFlag::ExistOnGPU;
 		m_assets[modelID]->loadFlag &= ~AssetLoadFlag::GPUMemory;
 
@@ -696,7 +914,12 @@ namespace DOG
 			return;
 		}
 
-		assert(m_renderer);
+		if (!m_renderer)
+		{
+			m_assets[textureID]->loadFlag &= ~AssetLoadFlag::GPUMemory;
+			return;
+		}
+
 		gfx::GraphicsBuilder* builder = m_renderer->GetBuilder();
 
 		if (m_assets[textureID]->CheckIfLoadingAsync())
@@ -713,14 +936,23 @@ namespace DOG
 
 
 
-		gfx::GraphicsBuilder::TextureSubresource subres{};
-		subres.width = asset->width;
-		subres.height = asset->height;
-		subres.data = asset->textureData;
+		if (!asset->mappedMips.empty())
+		{
+			// Straight from the mapped .dog file
+			for (auto& mip : asset->mappedMips)
+				textureSpec.dataPerMip.push_back({ mip.data, mip.width, mip.height });
+		}
+		else
+		{
+			gfx::GraphicsBuilder::TextureSubresource subres{};
+			subres.width = asset->width;
+			subres.height = asset->height;
+			subres.data = asset->textureData;
+			textureSpec.dataPerMip.push_back(subres);
+		}
 
 		textureSpec.format = asset->format;
 		textureSpec.srgb = asset->srgb;
-		textureSpec.dataPerMip.push_back(subres);
 
 		asset->textureGPU = builder->LoadTexture(textureSpec);
 
@@ -730,6 +962,9 @@ namespace DOG
 		asset->textureViewGPU = builder->CreateTextureView(asset->textureGPU, desc);
 		asset->textureViewRawHandle = builder->GetRawDescriptor(asset->textureViewGPU);
 
+		m_assets[textureID]->gpuMemory = 0;
+		for (auto& mip : textureSpec.dataPerMip)
+			m_assets[textureID]->gpuMemory += mip.data.size();
 		m_assets[textureID]->stateFlag |= AssetStateFlag::ExistOnGPU;
 		m_assets[textureID]->loadFlag &= ~AssetLoadFlag::GPUMemory;
 
@@ -748,12 +983,16 @@ namespace DOG
 		std::filesystem::path newPath{ path };
 		auto oldExtension = newPath.extension();
 
-		if (!std::filesystem::exists(path))
+		if (!AssetFileSystem::Exists(path))
 		{
 			if (oldExtension == ".jpg" || oldExtension == ".png")
 			{
-				newPath.replace_extension(".dds");
-				path = newPath.string();
+				// Without the source either the baked texture or the converted .dds has to exist
+				if (!m_bakedTextures.Contains(newPath))
+				{
+					newPath.replace_extension(".dds");
+					path = newPath.string();
+				}
 			}
 			else
 			{
@@ -867,7 +1106,7 @@ namespace DOG
 					if (ImGui::MenuItem("Sponza"))
 					{
 						constexpr std::string_view path = "Assets/Models/Temporary_Assets/Sponza_gltf/glTF/Sponza.gltf";
-						if (std::filesystem::exists(path))
+						if (AssetFileSystem::Exists(path))
 						{
 							u32 id = DOG::AssetManager::Get().LoadModelAsset(path.data());
 							std::cout << "model ID: " << id << ", path: " << path << std::endl;
@@ -876,7 +1115,7 @@ namespace DOG
 					if (ImGui::MenuItem("Suzanne"))
 					{
 						constexpr std::string_view path = "Assets/Models/Temporary_Assets/suzanne.glb";
-						if (std::filesystem::exists(path))
+						if (AssetFileSystem::Exists(path))
 						{
 							u32 id = DOG::AssetManager::Get().LoadModelAsset(path.data());
 							std::cout << "model ID: " << id << ", path: " << path << std::endl;
@@ -963,4 +1202,50 @@ namespace DOG
 			ImGui::End(); // "Asset manager"
 		}
 	}
+
+	void AssetManager::ResidencyGUI(bool& open)
+	{
+		if (ImGui::BeginMenu("View"))
+		{
+			if (ImGui::MenuItem("Asset residency"))
+			{
+				open = true;
+			}
+			ImGui::EndMenu(); // "View"
+		}
+
+		if (open)
+		{
+			if (ImGui::Begin("Asset residency", &open))
+			{
+				auto&& budgetBar = [](const char* label, u64 used, u32 budgetMB)
+				{
+					const f32 usedMB = used / (1024.f * 1024.f);
+					char overlay[64];
+					snprintf(overlay, sizeof(overlay), "%.1f / %u MiB", usedMB, budgetMB);
+					ImGui::Text("%s", label);
+					ImGui::ProgressBar(budgetMB ? std::min(usedMB / budgetMB, 1.f) : 1.f, ImVec2(-1.f, 0.f), overlay);
+				};
+
+				budgetBar("RAM", m_residencyStats.cpuMemory, m_residencyBudget.cpuBudgetMB);
+				budgetBar("VRAM", m_residencyStats.gpuMemory, m_residencyBudget.gpuBudgetMB);
+				ImGui::Separator();
+
+				ImGui::Text("Resident models: %u", m_residencyStats.residentModels);
+				ImGui::Text("Resident textures: %u", m_residencyStats.residentTextures);
+				ImGui::Text("Referenced by components: %u", m_residencyStats.referencedAssets);
+				ImGui::Text("Evicted models waiting for reuse: %u", static_cast<u32>(m_evictedModels.size()));
+				ImGui::Text("Evictions: %u", m_residencyStats.evictions);
+				ImGui::Separator();
+
+				int cpuBudget = static_cast<int>(m_residencyBudget.cpuBudgetMB);
+				if (ImGui::InputInt("RAM budget (MiB)", &cpuBudget, 64, 256))
+					m_residencyBudget.cpuBudgetMB = static_cast<u32>(std::max(cpuBudget, 0));
+				int gpuBudget = static_cast<int>(m_residencyBudget.gpuBudgetMB);
+				if (ImGui::InputInt("VRAM budget (MiB)", &gpuBudget, 64, 256))
+					m_residencyBudget.gpuBudgetMB = static_cast<u32>(std::max(gpuBudget, 0));
+			}
+			ImGui::End(); // "Asset residency"
+		}
+	}
 }
\ No newline at end of file
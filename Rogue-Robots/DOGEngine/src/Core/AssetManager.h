@@ -5,6 +5,8 @@
 #include "ManagedAssets.h"
 #include "../Audio/AudioFileReader.h"
 #include "Types/GraphicsTypes.h"
+#include "CoreUtils.h"
+#include <unordered_set>
 
 
 namespace DOG
@@ -17,6 +19,16 @@ namespace DOG
 		AssetStateFlag stateFlag;
 	};
 
+	struct ResidencyStats
+	{
+		u64 cpuMemory{ 0 };
+		u64 gpuMemory{ 0 };
+		u32 residentModels{ 0 };
+		u32 residentTextures{ 0 };
+		u32 referencedAssets{ 0 };
+		u32 evictions{ 0 };		// Since startup
+	};
+
 	namespace gfx
 	{
 		class Renderer;
@@ -24,6 +36,7 @@ namespace DOG
 	class AssetManager
 	{
 		friend ManagedAsset<TextureAsset>;
+		friend ManagedAsset<ModelAsset>;
 	public:
 		static void Initialize(gfx::Renderer* renderer);
 		static void Destroy();
@@ -36,6 +49,10 @@ namespace DOG
 		[[nodiscard]] u32 LoadTexture(const std::string& path, AssetLoadFlag flag = AssetLoadFlag::None);
 		[[nodiscard]] u32 LoadAudio(const std::string& path, AssetLoadFlag flag = AssetLoadFlag::CPUMemory);
 
+		// Pages the files in on the I/O thread in archive order, call it before loading many assets at once.
+		// Does nothing for loose files.
+		void PrefetchFiles(const std::vector<std::filesystem::path>& paths);
+
 		MaterialManager& GetMaterialManager();
 
 		void UnLoadAsset(u32 id, AssetUnLoadFlag flag);
@@ -60,6 +77,7 @@ namespace DOG
 			}
 			else
 			{
+				m_assets.at(id)->lastUseFrame.store(m_frame, std::memory_order_relaxed);
 				return static_cast<ManagedAsset<T>*>(m_assets.at(id))->Get();
 			}
 		}
@@ -68,6 +86,10 @@ namespace DOG
 
 		void Update();
 
+		// Models and textures are evicted when their memory goes over budget, see UpdateResidency
+		void SetResidencyBudget(const AssetSettings& budget);
+		const ResidencyStats& GetResidencyStats() const { return m_residencyStats; }
+
 		template<typename T, typename ...Args>
 		static void AddCommand(T&& command, Args&&... args)
 		{
@@ -93,6 +115,7 @@ namespace DOG
 		[[nodiscard]] std::vector<u32> LoadMaterials(const std::vector<ImportedMaterial>& importedMats, AssetLoadFlag flag);
 		static void LoadTextureSTBI(const std::string& path, TextureAsset* assetOut);
 		static void LoadTextureCommpresonator(const std::string& path, TextureAsset* assetOut, bool srgb = false);
+		bool LoadTextureBaked(const std::string& path, TextureAsset* assetOut, bool srgb);
 		void MoveModelToGPU(u32 modelID);
 
 		void MoveTextureToGPU(u32 textureID);
@@ -107,6 +130,13 @@ namespace DOG
 
 		void ImguiLoadModel(bool& open);
 		static void AssetManagerGUI(bool& open);
+		void ResidencyGUI(bool& open);
+
+		// Recounts the references from live components, reloads evicted models that are used again
+		// and evicts the least recently used models and textures while over budget.
+		void UpdateResidency();
+		void CountReferences();
+		bool IsEvictable(u32 id) const;
 
 		template<typename T>
 		requires std::is_base_of_v<Asset, T>
@@ -135,7 +165,20 @@ namespace DOG
 
 		MaterialManager m_materialManager;
 
+		// Baked textures are used instead of their sources when they exist
+		static constexpr const char* BAKED_TEXTURE_DIRECTORY = "Assets/Baked";
+		BakedTextureIndex m_bakedTextures;
+
 
 		gfx::Renderer* m_renderer = nullptr;
+
+		// Residency
+		static constexpr u64 RESIDENCY_INTERVAL = 30;		// Frames between residency passes
+		static constexpr u64 MIN_EVICTION_AGE = 120;		// Frames an asset has to go unused before it can be evicted
+		u64 m_frame = 0;
+		AssetSettings m_residencyBudget;
+		ResidencyStats m_residencyStats;
+		std::unordered_set<u32> m_modelTextures;			// Only textures that belong to models are evicted, others may be used through raw descriptors
+		std::unordered_map<u32, std::string> m_evictedModels;	// Path of every model evicted from the GPU, to reload it if a component uses it again
 	};
 }
\ No newline at end of file
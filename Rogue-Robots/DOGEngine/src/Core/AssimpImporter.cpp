@@ -3,10 +3,76 @@
 #include <Assimp/Importer.hpp>      // C++ importer interface
 #include <Assimp/postprocess.h>     // Post processing flags
 #include <Assimp/pbrmaterial.h>
+#include <Assimp/IOSystem.hpp>
+#include <Assimp/IOStream.hpp>
 #include <DirectXMath.h>
+#include "AssetFileSystem.h"
 
 namespace DOG
 {
+	namespace
+	{
+		// Lets Assimp read models, and the buffers they reference, out of the mounted archives
+		class AssetIOStream : public Assimp::IOStream
+		{
+		public:
+			AssetIOStream(FileData file) : m_file(std::move(file)) {}
+
+			size_t Read(void* buffer, size_t size, size_t count) override
+			{
+				if (size == 0)
+					return 0;
+				count = (std::min)(count, (m_file.data.size() - m_position) / size);
+				memcpy(buffer, m_file.data.data() + m_position, size * count);
+				m_position += size * count;
+				return count;
+			}
+
+			size_t Write(const void*, size_t, size_t) override { return 0; }
+
+			aiReturn Seek(size_t offset, aiOrigin origin) override
+			{
+				// Offsets are negative for aiOrigin_END, the unsigned wrap around gives the right position
+				size_t position = offset;
+				if (origin == aiOrigin_CUR)
+					position = m_position + offset;
+				else if (origin == aiOrigin_END)
+					position = m_file.data.size() + offset;
+
+				if (position > m_file.data.size())
+					return aiReturn_FAILURE;
+				m_position = position;
+				return aiReturn_SUCCESS;
+			}
+
+			size_t Tell() const override { return m_position; }
+			size_t FileSize() const override { return m_file.data.size(); }
+			void Flush() override {}
+
+		private:
+			FileData m_file;
+			size_t m_position{ 0 };
+		};
+
+		class AssetIOSystem : public Assimp::IOSystem
+		{
+		public:
+			bool Exists(const char* file) const override { return AssetFileSystem::Exists(file); }
+			char getOsSeparator() const override { return '/'; }
+
+			Assimp::IOStream* Open(const char* file, const char* mode) override
+			{
+				if (strchr(mode, 'w') || strchr(mode, 'a'))
+					return nullptr;
+
+				auto data = AssetFileSystem::ReadFile(file);
+				return data ? new AssetIOStream(std::move(*data)) : nullptr;
+			}
+
+			void Close(Assimp::IOStream* file) override { delete file; }
+		};
+	}
+
 	ImportedMaterial ExtractMaterial(const aiMaterial* aiMat, const std::string& directory)
 	{
 		ImportedMaterial importedMat;
@@ -309,6 +375,8 @@ namespace DOG
 	{
 		// Load assimp scene
 		Assimp::Importer importer;
+		if (AssetFileSystem::HasArchives())
+			importer.SetIOHandler(new AssetIOSystem());	// Owned by the importer
 		const aiScene* scene = importer.ReadFile(
 			path.relative_path().string().c_str(),
 			aiProcess_Triangulate |
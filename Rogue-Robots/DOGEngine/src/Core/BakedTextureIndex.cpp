@@ -0,0 +1,101 @@
+#include "BakedTextureIndex.h"
+
+namespace DOG
+{
+	bool BakedTextureIndex::Open(const std::filesystem::path& directory)
+	{
+		m_directory = directory;
+		m_rootPrefix = AssetArchive::NormalizePath(directory.lexically_normal().parent_path()) + '/';
+		m_names.clear();
+		m_indexOfName.clear();
+
+		auto meta = AssetFileSystem::ReadFile(directory / "assets.meta");
+		if (!meta)
+			return false;
+
+		// u32 texture count, u32 mesh count, then a u16 index and a null terminated name per texture
+		auto data = meta->data;
+		if (data.size() < 2 * sizeof(u32))
+			return false;
+
+		u32 textureCount = 0;
+		memcpy(&textureCount, data.data(), sizeof(u32));
+		size_t offset = 2 * sizeof(u32);
+
+		m_names.resize(textureCount);
+		m_indexOfName.reserve(textureCount);
+		while (offset + sizeof(u16) < data.size())
+		{
+			u16 index = 0;
+			memcpy(&index, data.data() + offset, sizeof(u16));
+			offset += sizeof(u16);
+
+			auto nameStart = reinterpret_cast<const char*>(data.data() + offset);
+			size_t nameLength = strnlen(nameStart, data.size() - offset);
+			if (index >= textureCount || offset + nameLength == data.size())
+			{
+				std::cout << "BakedTextureIndex: " << (directory / "assets.meta").string() << " is corrupt\n";
+				m_names.clear();
+				m_indexOfName.clear();
+				return false;
+			}
+
+			m_names[index].assign(nameStart, nameLength);
+			m_indexOfName[AssetArchive::NormalizePath(m_names[index])] = index;
+			offset += nameLength + 1;
+		}
+		return true;
+	}
+
+	std::string BakedTextureIndex::KeyOf(const std::filesystem::path& source) const
+	{
+		std::string key = AssetArchive::NormalizePath(std::filesystem::path(source).replace_extension(".dog"));
+		if (!key.starts_with(m_rootPrefix))
+			return {};
+		return key.substr(m_rootPrefix.size());
+	}
+
+	std::optional<BakedTextureIndex::Texture> BakedTextureIndex::Find(const std::filesystem::path& source) const
+	{
+		auto it = m_indexOfName.find(KeyOf(source));
+		if (it == m_indexOfName.end())
+			return std::nullopt;
+
+		auto file = AssetFileSystem::ReadFile(m_directory / m_names[it->second]);
+		if (!file)
+			return std::nullopt;
+
+		Texture texture;
+		texture.file = std::move(file->owner);
+
+		// Header, a u32 size per mip and then the BC7 mips one after another
+		auto data = file->data;
+		Header header{};
+		if (data.size() < sizeof(Header))
+			return std::nullopt;
+		memcpy(&header, data.data(), sizeof(Header));
+		if (memcmp(header.id, "TEX", 3) != 0 || header.mips == 0 || data.size() < sizeof(Header) + header.mips * sizeof(u32))
+			return std::nullopt;
+
+		size_t offset = sizeof(Header) + header.mips * sizeof(u32);
+		for (u32 mip = 0; mip < header.mips; ++mip)
+		{
+			u32 mipSize = 0;
+			memcpy(&mipSize, data.data() + sizeof(Header) + mip * sizeof(u32), sizeof(u32));
+
+			const u32 width = (std::max)(header.width >> mip, 1);
+			const u32 height = (std::max)(header.height >> mip, 1);
+			if (mipSize > data.size() - offset || mipSize != ((width + 3) / 4) * ((height + 3) / 4) * 16)
+				return std::nullopt;
+
+			// The upload works on whole 4x4 blocks, mips smaller than a block are left out
+			if (width >= 4 && height >= 4)
+				texture.mips.push_back({ data.subspan(offset, mipSize), width, height });
+			offset += mipSize;
+		}
+
+		if (texture.mips.empty())
+			return std::nullopt;
+		return texture;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "AssetFileSystem.h"
+
+namespace DOG
+{
+	// Textures baked by the offline AssetManager tool, a directory of .dog files and the assets.meta listing them.
+	// Nothing is copied, the mips are spans into the mapped .dog files or the archive holding them.
+	class BakedTextureIndex
+	{
+	public:
+		struct Mip
+		{
+			std::span<const u8> data;
+			u32 width{ 0 };
+			u32 height{ 0 };
+		};
+
+		struct Texture
+		{
+			std::shared_ptr<const void> file;		// Keeps the mips alive
+			std::vector<Mip> mips;
+		};
+
+	public:
+		// Returns false if the directory has no readable assets.meta, the index is then empty.
+		// The baked directory sits in the asset root the textures were baked from, Assets/Baked for Assets.
+		bool Open(const std::filesystem::path& directory);
+
+		// source is the path the texture is loaded by, "Assets/Models/P2/Red/textures/Image_0.png".
+		// Baked textures are named by their path relative to the asset root since many sources share a file name.
+		std::optional<Texture> Find(const std::filesystem::path& source) const;
+		bool Contains(const std::filesystem::path& source) const { return m_indexOfName.contains(KeyOf(source)); }
+
+	private:
+		// Mirrors DOG::TextureHeader of the offline tool
+		struct Header
+		{
+			char id[3];
+			u8 mips;
+			u16 width;
+			u16 height;
+		};
+		static_assert(sizeof(Header) == 8);
+
+		// The normalized baked name of a source, empty if it is not below the asset root
+		std::string KeyOf(const std::filesystem::path& source) const;
+
+	private:
+		std::filesystem::path m_directory;
+		std::string m_rootPrefix;		// Normalized asset root with a trailing slash
+		std::vector<std::string> m_names;
+		std::unordered_map<std::string, u32> m_indexOfName;		// Keyed by the normalized name, the file system is not case sensitive
+	};
+}
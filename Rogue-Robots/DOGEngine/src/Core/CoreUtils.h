@@ -7,6 +7,12 @@ namespace DOG
 	#define DEBUG_SETTING_LIGHT_CULLING 2
 	#define DEBUG_SETTING_LIGHT_CULLING_VISUALIZATION 4
 
+	enum class GraphicsBackend : uint8_t
+	{
+		DX12 = 0,
+		Null,		// Records commands without a GPU or window, for headless runs
+	};
+
 	struct GraphicsSettings
 	{
 		WindowMode windowMode = WindowMode::Windowed;
@@ -23,6 +29,7 @@ namespace DOG
 		bool lit{ true };
 		bool shadowMapping{ true };
 		u32 shadowMapCapacity{ 4 };
+		GraphicsBackend backend = GraphicsBackend::DX12; // Restart is required
 
 
 
@@ -51,9 +58,24 @@ namespace DOG
 
 	};
 
+	enum class AudioBackend : uint8_t
+	{
+		XAudio2 = 0,	// One XAudio2 source voice per playing sound
+		Mixer,			// Engine-owned software mixer streaming into a single XAudio2 voice
+		Null,			// Software mixer with a discarding output, for headless runs
+	};
+
 	struct AudioSettings
 	{
 		f32 masterVolume = 1.0f;
+		AudioBackend backend = AudioBackend::XAudio2; // Restart is required
+	};
+
+	struct AssetSettings
+	{
+		// Models and textures nothing uses are unloaded, least recently used first, when a budget is exceeded
+		u32 cpuBudgetMB = 2048;
+		u32 gpuBudgetMB = 1536;
 	};
 
 	struct ApplicationSpecification
@@ -64,6 +86,12 @@ namespace DOG
 		std::string workingDir;
 		GraphicsSettings graphicsSettings;
 		AudioSettings audioSettings;
+		AssetSettings assetSettings;
+
+		// No window or audio device. Without a null graphics backend there is no renderer either and assets only live in CPU memory
+		bool headless = false;
+		// Seconds per frame reported by Time, 0 uses the measured frame time
+		f32 fixedTimeStep = 0.0f;
 	};
 
 	enum class CursorMode
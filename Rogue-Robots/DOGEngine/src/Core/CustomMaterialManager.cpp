@@ -29,7 +29,7 @@ namespace DOG
 
 
 	CustomMaterialManager::CustomMaterialManager(gfx::Renderer* renderer) :
-		m_materialTable(renderer->GetMaterialTable())
+		m_materialTable(renderer ? renderer->GetMaterialTable() : nullptr)
 	{
 		
 	}
@@ -47,7 +47,7 @@ namespace DOG
 		spec.emissiveFactor = desc.emissiveFactor;
 		spec.metallicFactor = desc.metallicFactor;
 
-		auto ret = m_materialTable->LoadMaterial(spec);
+		auto ret = m_materialTable ? m_materialTable->LoadMaterial(spec) : MaterialHandle{ ++m_headlessMaterialCount };
 
 		m_refs[ret.handle] = 1;
 		return ret;
@@ -66,12 +66,14 @@ namespace DOG
 		spec.emissiveFactor = desc.emissiveFactor;
 		spec.metallicFactor = desc.metallicFactor;
 
-		m_materialTable->UpdateMaterial(handle, spec);
+		if (m_materialTable)
+			m_materialTable->UpdateMaterial(handle, spec);
 	}	
 
 	void CustomMaterialManager::RemoveMaterial(MaterialHandle handle)
 	{
-		m_materialTable->FreeMaterial(handle);
+		if (m_materialTable)
+			m_materialTable->FreeMaterial(handle);
 	}
 
 	void CustomMaterialManager::AddRef(MaterialHandle handle)
@@ -12,6 +12,7 @@ namespace DOG
 	class CustomMaterialManager
 	{
 	public:
+		// Without a renderer materials only get handles and reference counts
 		static void Initialize(gfx::Renderer* renderer);
 		static void Destroy();
 		static CustomMaterialManager& Get();
@@ -30,6 +31,7 @@ namespace DOG
 	private:
 		static CustomMaterialManager* s_instance;
 		gfx::MaterialTable* m_materialTable;
+		u64 m_headlessMaterialCount = 0;
 
 		// { handle, count }
 		std::unordered_map<u64, u32> m_refs;
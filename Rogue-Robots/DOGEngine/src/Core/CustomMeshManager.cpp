@@ -29,14 +29,17 @@ namespace DOG
 	}
 
 	CustomMeshManager::CustomMeshManager(gfx::Renderer* renderer) :
-		m_meshTable(renderer->GetMeshTable()),
-		m_upCtx(renderer->GetMeshUploadContext())
+		m_meshTable(renderer ? renderer->GetMeshTable() : nullptr),
+		m_upCtx(renderer ? renderer->GetMeshUploadContext() : nullptr)
 	{
 
 	}
 
 	std::pair<Mesh, u32> CustomMeshManager::AddMesh(const MeshDesc& desc)
 	{
+		if (!m_meshTable)
+			return { Mesh{}, static_cast<u32>(desc.submeshData.size()) };
+
 		gfx::MeshTable::MeshSpecification spec;
 		spec.indices = desc.indices;
 		spec.submeshData = desc.submeshData;
@@ -50,6 +53,8 @@ namespace DOG
 
 	void CustomMeshManager::RemoveMesh(Mesh handle)
 	{
+		if (!m_meshTable)
+			return;
 		m_meshTable->FreeMesh(handle);
 	}
 
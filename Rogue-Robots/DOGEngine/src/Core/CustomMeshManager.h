@@ -13,6 +13,7 @@ namespace DOG
 	class CustomMeshManager
 	{
 	public:
+		// Without a renderer meshes are accepted but never uploaded
 		static void Initialize(gfx::Renderer* renderer);
 		static void Destroy();
 		static CustomMeshManager& Get();
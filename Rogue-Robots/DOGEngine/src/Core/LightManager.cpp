@@ -29,51 +29,69 @@ namespace DOG
 
 	LightHandle LightManager::AddPointLight(const PointLightDesc& desc, LightUpdateFrequency frequency)
 	{
+		if (!m_lightTable)
+			return LightHandle{ ++m_headlessLightCount };
 		return m_lightTable->AddPointLight(desc, frequency);
 	}
 
 	LightHandle LightManager::AddSpotLight(const SpotLightDesc& desc, LightUpdateFrequency frequency)
 	{
+		if (!m_lightTable)
+			return LightHandle{ ++m_headlessLightCount };
 		return m_lightTable->AddSpotLight(desc, frequency);
 	}
 
 	LightHandle LightManager::AddAreaLight(const AreaLightDesc& desc, LightUpdateFrequency frequency)
 	{
+		if (!m_lightTable)
+			return LightHandle{ ++m_headlessLightCount };
 		return m_lightTable->AddAreaLight(desc, frequency);
 	}
 
 	void LightManager::RemoveLight(LightHandle handle)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->RemoveLight(handle);
 	}
 
 	void LightManager::EnableLight(LightHandle handle)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->EnableLight(handle);
 	}
 
 	void LightManager::DisableLight(LightHandle handle)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->DisableLight(handle);
 	}
 
 	void LightManager::UpdatePointLight(LightHandle handle, const PointLightDesc& desc)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->UpdatePointLight(handle, desc);
 	}
 
 	void LightManager::UpdateSpotLight(LightHandle handle, const SpotLightDesc& desc)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->UpdateSpotLight(handle, desc);
 	}
 
 	void LightManager::UpdateAreaLight(LightHandle handle, const AreaLightDesc& desc)
 	{
+		if (!m_lightTable)
+			return;
 		m_lightTable->UpdateAreaLight(handle, desc);
 	}
 
 	LightManager::LightManager(gfx::Renderer* renderer) :
-		m_lightTable(renderer->GetLightTable())
+		m_lightTable(renderer ? renderer->GetLightTable() : nullptr)
 	{
 		
 	}
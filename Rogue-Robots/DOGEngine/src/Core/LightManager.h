@@ -13,6 +13,7 @@ namespace DOG
 	class LightManager
 	{
 	public:
+		// A null renderer gives a LightManager that hands out handles without storing any lights
 		static void Initialize(gfx::Renderer* renderer);
 		static void Destroy();
 		static LightManager& Get();
@@ -38,7 +39,9 @@ namespace DOG
 
 	private:
 		static LightManager* s_instance;
-		gfx::LightTable* m_lightTable;
+		gfx::LightTable* m_lightTable; // Null when headless, lights then only get handles
+
+		u64 m_headlessLightCount = 0;
 
 
 	};
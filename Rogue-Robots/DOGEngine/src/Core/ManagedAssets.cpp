@@ -17,6 +17,29 @@ namespace DOG
 
 
 
+	void ModelAsset::ComputeSubmeshBounds()
+	{
+		submeshBounds.clear();
+		auto it = meshAsset.vertexData.find(VertexAttribute::Position);
+		if (it == meshAsset.vertexData.end())
+			return;
+
+		const DirectX::XMFLOAT3* positions = reinterpret_cast<const DirectX::XMFLOAT3*>(it->second.data());
+		const size_t positionCount = it->second.size() / sizeof(DirectX::XMFLOAT3);
+
+		submeshBounds.reserve(submeshes.size());
+		for (auto& submesh : submeshes)
+		{
+			DirectX::BoundingBox& bounds = submeshBounds.emplace_back();
+			const size_t start = std::min<size_t>(submesh.vertexStart, positionCount);
+			const size_t count = std::min<size_t>(submesh.vertexCount, positionCount - start);
+			if (count > 0)
+				DirectX::BoundingBox::CreateFromPoints(bounds, count, positions + start, sizeof(DirectX::XMFLOAT3));
+		}
+	}
+
+
+
 	// ManagedAsset<ModelAsset>----------------------
 
 	ManagedAsset<ModelAsset>::ManagedAsset(ModelAsset* asset) : m_asset(asset)
@@ -61,18 +84,15 @@ namespace DOG
 			stateFlag &= ~AssetStateFlag::ExistOnCPU;
 		}
 
-		if (flag & AssetUnLoadFlag::MeshGPU)
+		if (flag & AssetUnLoadFlag::MeshGPU || flag & AssetUnLoadFlag::TextureGPU)
 		{
-			// TODO
+			// The materials of the model point at its textures, so both flags release the whole model
+			if (m_asset->gfxModel)
+				AssetManager::Get().GetGraphicsBuilder().FreeResource(*m_asset->gfxModel);
 
 			stateFlag &= ~AssetStateFlag::ExistOnGPU;
 			m_asset->gfxModel = std::nullopt;
-		}
-
-		if (flag & AssetUnLoadFlag::TextureGPU)
-		{
-			stateFlag &= ~AssetStateFlag::ExistOnGPU;
-			m_asset->gfxModel = std::nullopt;
+			gpuMemory = 0;
 		}
 
 		auto& matMan = AssetManager::Get().GetMaterialManager();
@@ -88,6 +108,17 @@ namespace DOG
 		unLoadFlag &= ~flag;
 	}
 
+	u64 ManagedAsset<ModelAsset>::GetCPUMemory()
+	{
+		if (!m_asset)
+			return 0;
+
+		u64 bytes = m_asset->meshAsset.indices.size() * sizeof(u32);
+		for (auto& [attribute, data] : m_asset->meshAsset.vertexData)
+			bytes += data.size();
+		return bytes;
+	}
+
 
 
 
@@ -129,6 +160,8 @@ namespace DOG
 		{
 			m_asset->textureData.clear();
 			std::vector<u8>().swap(m_asset->textureData); // This will release the memory
+			m_asset->mappedMips.clear();
+			m_asset->mappedFile.reset();
 			stateFlag &= ~AssetStateFlag::ExistOnCPU;
 		}
 
@@ -139,7 +172,20 @@ namespace DOG
 			AssetManager::Get().GetGraphicsBuilder().FreeResource(m_asset->textureGPU);
 			m_asset->textureGPU.handle = 0;
 			stateFlag &= ~AssetStateFlag::ExistOnGPU;
+			gpuMemory = 0;
 		}
 		unLoadFlag &= ~flag;
 	}
+
+	u64 ManagedAsset<TextureAsset>::GetCPUMemory()
+	{
+		if (!m_asset)
+			return 0;
+
+		// Mapped mips count as well, their pages are resident once the texture has been uploaded
+		u64 bytes = m_asset->textureData.size();
+		for (auto& mip : m_asset->mappedMips)
+			bytes += mip.data.size();
+		return bytes;
+	}
 }
\ No newline at end of file
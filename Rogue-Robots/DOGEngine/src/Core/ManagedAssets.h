@@ -2,6 +2,7 @@
 #include "../Audio/AudioFileReader.h"
 #include "Types/GraphicsTypes.h"
 #include "../Graphics/Rendering/GraphicsBuilder.h"
+#include "BakedTextureIndex.h"
 namespace DOG
 {
 	enum class AssetLoadFlag
@@ -146,6 +147,9 @@ namespace DOG
 		uint32_t mipLevels{ 0 };
 		DXGI_FORMAT format{ DXGI_FORMAT_UNKNOWN };
 		std::vector<u8> textureData;
+		// Set instead of textureData when the texture is read from a baked .dog file, the mips point into the mapping
+		std::shared_ptr<const void> mappedFile;
+		std::vector<BakedTextureIndex::Mip> mappedMips;
 		bool srgb = true;
 		gfx::Texture textureGPU;
 		gfx::TextureView textureViewGPU;
@@ -167,14 +171,22 @@ namespace DOG
 		std::optional<gfx::StaticModel> gfxModel = std::nullopt;
 		ImportedRig animation;
 		std::vector<ImportedLight> lights;
+
+		// Local space bounds per submesh, kept when the CPU mesh data is unloaded so the model can still be culled
+		std::vector<DirectX::BoundingBox> submeshBounds;
+		void ComputeSubmeshBounds();
 	};
 
 	struct AudioAsset : public Asset
 	{
 		bool async = false;
 		std::string filePath;
-		WAVEFORMATEX properties = {};
+		WAVEFORMATEX properties = {}; // Format of the decoded PCM
 		std::vector<u8> audioData;
+
+		// Compressed assets keep their encoded data in audioData, the audio device decodes on demand into its sample cache
+		bool compressed = false;
+		WAVEFORMATEX encodedProperties = {};
 	};
 
 	class AssetManager;
@@ -186,9 +198,16 @@ namespace DOG
 		virtual Asset* GetBase() = 0;
 		bool CheckIfLoadingAsync();
 		virtual void UnloadAsset(AssetUnLoadFlag flag) = 0;
+		// Bytes of asset data held in RAM, only models and textures count towards the residency budget
+		virtual u64 GetCPUMemory() { return 0; }
 		AssetStateFlag stateFlag = AssetStateFlag::None;
 		AssetLoadFlag loadFlag = AssetLoadFlag::None;
 		AssetUnLoadFlag unLoadFlag = AssetUnLoadFlag::None;
+
+		// Residency, see AssetManager::UpdateResidency
+		std::atomic<u64> lastUseFrame{ 0 };
+		u32 refCount = 0;		// Live components using the asset, recounted every residency pass
+		u64 gpuMemory = 0;		// Bytes uploaded by MoveModelToGPU/MoveTextureToGPU
 	private:
 		std::atomic_signed_lock_free m_isLoadingConcurrent = 0;
 	};
@@ -249,6 +268,7 @@ namespace DOG
 
 		Asset* GetBase() override;
 		void UnloadAsset(AssetUnLoadFlag flag) override;
+		u64 GetCPUMemory() override;
 
 	private:
 		ModelAsset* m_asset = nullptr;
@@ -268,6 +288,7 @@ namespace DOG
 		TextureAsset* Get();
 		Asset* GetBase() override;
 		void UnloadAsset(AssetUnLoadFlag flag) override;
+		u64 GetCPUMemory() override;
 
 	private:
 		TextureAsset* m_asset = nullptr;
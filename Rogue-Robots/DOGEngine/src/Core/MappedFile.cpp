@@ -0,0 +1,38 @@
+#include "MappedFile.h"
+
+namespace DOG
+{
+	std::shared_ptr<MappedFile> MappedFile::Open(const std::filesystem::path& path)
+	{
+		std::shared_ptr<MappedFile> file(new MappedFile());
+
+		file->m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file->m_file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file->m_file, &size) || size.QuadPart == 0)
+			return nullptr;
+
+		file->m_mapping = CreateFileMappingW(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!file->m_mapping)
+			return nullptr;
+
+		file->m_data = static_cast<const u8*>(MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!file->m_data)
+			return nullptr;
+
+		file->m_size = static_cast<size_t>(size.QuadPart);
+		return file;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+	}
+}
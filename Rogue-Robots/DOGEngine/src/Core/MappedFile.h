@@ -0,0 +1,27 @@
+#pragma once
+
+namespace DOG
+{
+	// Read only view of a whole file, the OS pages the contents in when they are first touched
+	class MappedFile
+	{
+	public:
+		// Returns nullptr if the file can not be opened or is empty
+		static std::shared_ptr<MappedFile> Open(const std::filesystem::path& path);
+
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		std::span<const u8> GetData() const { return { m_data, m_size }; }
+
+	private:
+		MappedFile() = default;
+
+	private:
+		HANDLE m_file{ INVALID_HANDLE_VALUE };
+		HANDLE m_mapping{ nullptr };
+		const u8* m_data{ nullptr };
+		size_t m_size{ 0 };
+	};
+}
@@ -3,6 +3,7 @@
 
 #include <DirectXTex/DirectXTex.h>
 #include "../Graphics/RHI/DX12/D11Device.h"
+#include "AssetFileSystem.h"
 
 namespace DOG
 {
@@ -48,7 +49,7 @@ namespace DOG
 		//	std::cout << "Is not SRGB!\n";
 
 		// Generate DDS if it doesnt exist
-		if (!std::filesystem::exists(newPath))
+		if (!AssetFileSystem::Exists(newPath))
 		{
 			DirectX::TexMetadata md;
 			DirectX::ScratchImage img;
@@ -80,10 +81,13 @@ namespace DOG
 		}
 
 
-		// Load new
+		// Load new, the DDS may be packed in an archive
+		auto ddsFile = AssetFileSystem::ReadFile(newPath);
+		assert(ddsFile);
+
 		DirectX::TexMetadata md;
 		auto image = std::make_unique<DirectX::ScratchImage>();
-		hr = DirectX::LoadFromDDSFile(newPath.c_str(), DirectX::DDS_FLAGS_NONE, &md, *image);
+		hr = DirectX::LoadFromDDSMemory(ddsFile->data.data(), ddsFile->data.size(), DirectX::DDS_FLAGS_NONE, &md, *image);
 		assert(SUCCEEDED(hr));
 
 		m_result = std::make_shared<ImportedTextureFile>();
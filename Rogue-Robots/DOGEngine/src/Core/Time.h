@@ -45,6 +45,8 @@ namespace DOG
 		static inline Timer s_timer;
 		static inline u64 s_deltaTime = 0;
 		static inline f64 s_elapsedTime = 0;
+		static inline u64 s_fixedDeltaTime = 0;
+		static inline u64 s_frameTime = 0;
 
 	public:
 		template<TimeType type = TimeType::Seconds, typename T = f64>
@@ -58,6 +60,19 @@ namespace DOG
 			return s_elapsedTime;
 		}
 
+		// Wall clock duration of the last frame, equal to DeltaTime unless a fixed time step is set
+		template<TimeType type = TimeType::Seconds, typename T = f64>
+		static T FrameTime()
+		{
+			return s_frameTime / static_cast<T>(type);
+		}
+
+		// Makes DeltaTime advance by a constant step every frame, 0 goes back to the measured frame time
+		static void SetFixedTimeStep(f64 seconds)
+		{
+			s_fixedDeltaTime = static_cast<u64>(std::max(seconds, 0.0) * static_cast<f64>(TimeType::Seconds));
+		}
+
 		static void Start()
 		{
 			s_timer.Start();
@@ -65,7 +80,8 @@ namespace DOG
 
 		static void End()
 		{
-			s_deltaTime = s_timer.Stop();
+			s_frameTime = s_timer.Stop();
+			s_deltaTime = s_fixedDeltaTime ? s_fixedDeltaTime : s_frameTime;
 
 			s_elapsedTime += DeltaTime();
 		}
@@ -187,6 +187,7 @@ namespace DOG
 		float strength{ 1.f };
 		DirectX::SimpleMath::Vector3 direction{ 0.f, 0.f, 1.f };
 		float cutoffAngle{ 15.f };
+		float range{ 70.f };	// Distance at which the light has faded out
 		u32 id = (u32)- 1;
 
 		bool dirty{ true };		// If static handle, dirty bool is ignored
@@ -277,6 +278,26 @@ namespace DOG
 		bool dirty{ false };
 	};
 
+	// Models that never move, merged by the renderer into one mesh with one submesh per material once every model is loaded
+	// The instances are in world space, the entity transform is not used. The models need CPUMemory for their vertices
+	struct StaticBatchComponent
+	{
+		struct Instance
+		{
+			u32 modelID{ 0 };
+			DirectX::SimpleMath::Matrix world;
+		};
+
+		std::vector<Instance> instances;
+		bool doubleSided{ false };		// No face culling and double sided shadows, like modular blocks
+
+		// Set by the renderer when merged
+		bool merged{ false };
+		Mesh mesh;
+		std::vector<MaterialHandle> materials;
+		std::vector<DirectX::BoundingBox> submeshBounds;
+	};
+
 	struct HasEnteredCollisionComponent
 	{
 		static constexpr u32 maxCount = 10;
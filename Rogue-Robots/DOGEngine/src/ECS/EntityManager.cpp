@@ -132,6 +132,7 @@ namespace DOG
 		std::swap(m_components.at(componentPoolIndex)->sparseArray[last], m_components.at(componentPoolIndex)->sparseArray[entityID]);
 		m_components.at(componentPoolIndex)->denseArray.pop_back();
 		m_components.at(componentPoolIndex)->sparseArray[entityID] = NULL_ENTITY;
+		m_components.at(componentPoolIndex)->version = ++m_poolVersion;
 	}
 
 	void EntityManager::RegisterSystem(std::unique_ptr<ISystem>&& pSystem) noexcept
@@ -70,6 +70,7 @@ namespace DOG
 		std::vector<entity> sparseArray;
 		std::vector<entity> denseArray;
 		sti::TypeIndex bundle = nullptr;
+		u64 version = 0; // Changes whenever an entity is added to or removed from the pool
 	};
 
 	template<typename ComponentType>
@@ -152,6 +153,10 @@ namespace DOG
 		template<typename... ComponentType>
 		[[nodiscard]] BundleImpl<ComponentType...>& Bundle() noexcept;
 
+		// Cheap way to tell if the set of entities with a component changed since last checked, never repeats a value
+		template<typename ComponentType>
+		[[nodiscard]] u64 GetComponentPoolVersion() const noexcept;
+
 		void RegisterSystem(std::unique_ptr<ISystem>&& pSystem) noexcept;
 
 		[[nodiscard]] constexpr const std::vector<std::unique_ptr<ISystem>>::const_iterator begin() const { return m_systems.begin(); }
@@ -196,6 +201,7 @@ namespace DOG
 		std::unordered_map<sti::TypeIndex ,ComponentPool> m_components;
 		std::unordered_map<sti::TypeIndex, std::unique_ptr<BundleBase>> m_bundles;
 		std::vector<std::unique_ptr<ISystem>> m_systems;
+		u64 m_poolVersion = 0;
 	
 		ECS_DEBUG_EXPR(std::vector<entity> m_aliveEntities;);
 	};
@@ -240,6 +246,7 @@ namespace DOG
 
 		const size_t position = set(ComponentID)->denseArray.size();
 		set(ComponentID)->denseArray.emplace_back(entityID);
+		set(ComponentID)->version = ++m_poolVersion;
 		set(ComponentID)->components.emplace_back(ComponentType(std::forward<Args>(args)...));
 		set(ComponentID)->sparseArray[entityID] = static_cast<entity>(position);
 
@@ -270,6 +277,7 @@ namespace DOG
 
 		const size_t position = set(ComponentID)->denseArray.size();
 		set(ComponentID)->denseArray.emplace_back(entityID);
+		set(ComponentID)->version = ++m_poolVersion;
 		set(ComponentID)->components.emplace_back(ComponentType(std::forward<Args>(args)...));
 		set(ComponentID)->sparseArray[entityID] = static_cast<entity>(position);
 
@@ -301,6 +309,7 @@ namespace DOG
 
 		const size_t position = set(ComponentID)->denseArray.size();
 		set(ComponentID)->denseArray.emplace_back(entityID);
+		set(ComponentID)->version = ++m_poolVersion;
 		set(ComponentID)->components.emplace_back(ComponentType(std::forward<Args>(args)...));
 		set(ComponentID)->sparseArray[entityID] = static_cast<entity>(position);
 
@@ -335,6 +344,7 @@ namespace DOG
 		set(componentID)->denseArray.pop_back();
 		set(componentID)->components.pop_back();
 		set(componentID)->sparseArray[entityID] = NULL_ENTITY;
+		set(componentID)->version = ++m_poolVersion;
 	}
 
 	template<typename ComponentType>
@@ -358,6 +368,7 @@ namespace DOG
 			set(componentID)->denseArray.pop_back();
 			set(componentID)->components.pop_back();
 			set(componentID)->sparseArray[entityID] = NULL_ENTITY;
+			set(componentID)->version = ++m_poolVersion;
 		}
 	}
 
@@ -407,6 +418,13 @@ namespace DOG
 			);
 	}
 
+	template<typename ComponentType>
+	u64 EntityManager::GetComponentPoolVersion() const noexcept
+	{
+		static auto constexpr componentID = sti::getTypeIndex<ComponentType>();
+		return m_components.contains(componentID) ? m_components.at(componentID)->version : 0;
+	}
+
 	template<typename... ComponentType>
 	bool EntityManager::HasAllOf(const entity entityID) const noexcept
 	{
@@ -417,6 +417,7 @@ namespace DOG::gfx
 
 	BufferView RenderDevice_DX12::CreateView(Buffer buffer, const BufferViewDesc& desc)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		assert(desc.viewType != ViewType::None);
 		assert(desc.viewType != ViewType::DepthStencil);
 		assert(desc.viewType != ViewType::RenderTarget);
@@ -514,6 +515,7 @@ namespace DOG::gfx
 
 	TextureView RenderDevice_DX12::CreateView(Texture texture, const TextureViewDesc& desc2)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto desc = desc2;
 
 		assert(desc.viewType != ViewType::None);
@@ -607,20 +609,47 @@ namespace DOG::gfx
 		return handle;
 	}
 
-	std::vector<Texture> RenderDevice_DX12::CreateAliasedTextures(const std::vector<TextureDesc>& descs, MemoryPool pool)
+	ComPtr<D3D12MA::Allocation> RenderDevice_DX12::AllocatePlacementHeap(D3D12_HEAP_TYPE heapType, u64 heapSize, MemoryPool pool)
 	{
-		if (descs.size() == 1)
-			return { CreateTexture(descs[0], pool) };
+		D3D12MA::ALLOCATION_DESC allocDesc{};
+		allocDesc.HeapType = heapType;
+		if (pool.handle != 0)
+		{
+			auto poolStorage = HandleAllocator::TryGet(m_memoryPools, HandleAllocator::GetSlot(pool.handle));
+			allocDesc.CustomPool = poolStorage.pool.Get();
+			allocDesc.Flags = D3D12MA::ALLOCATION_FLAG_STRATEGY_BEST_FIT;
+			assert(allocDesc.HeapType == poolStorage.desc.heapType);
+		}
+
+		D3D12_RESOURCE_ALLOCATION_INFO allocInfo{};
+		allocInfo.SizeInBytes = heapSize;
+		allocInfo.Alignment = PLACEMENT_ALIGNMENT;
 
+		ComPtr<D3D12MA::Allocation> alloc;
+		HRESULT hr = m_dma->AllocateMemory(&allocDesc, &allocInfo, &alloc);
+		HR_VFY(hr);
+		assert(alloc != NULL && alloc->GetHeap() != NULL);
+		return alloc;
+	}
+
+	std::vector<Texture> RenderDevice_DX12::CreatePlacedTextures(const std::vector<TextureDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool)
+	{
 		assert(descs.size() > 0);
+		assert(descs.size() == offsets.size());
 
-		std::vector<D3D12_RESOURCE_DESC> internalDescs;
-		internalDescs.reserve(descs.size());
+		auto alloc = AllocatePlacementHeap(to_internal(descs[0].memType), heapSize, pool);
 
-		D3D12_RESOURCE_ALLOCATION_INFO finalAllocInfo{};
-		for (const auto& desc : descs)
+		/*
+			Create N resources using this alloc
+			Store the same alloc to all Texture_Storage, the heap lives until the last of them is freed
+		*/
+		std::vector<Texture> texturesToRet;
+		texturesToRet.reserve(descs.size());
+		for (u32 i = 0; i < descs.size(); ++i)
 		{
+			const auto& desc = descs[i];
 			assert(descs[0].memType == desc.memType);	// All resources passed must have the same memory type
+			assert(offsets[i] % PLACEMENT_ALIGNMENT == 0);
 
 			D3D12_RESOURCE_DESC rd{};
 			rd.Dimension = to_internal(desc.type);
@@ -634,76 +663,82 @@ namespace DOG::gfx
 			rd.SampleDesc.Quality = desc.sampleQuality;
 			rd.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 			rd.Flags = desc.flags;
-			internalDescs.push_back(rd);
-
-			auto allocInfo = m_device->GetResourceAllocationInfo(0, 1, &rd);
-
-			finalAllocInfo.Alignment = std::max(finalAllocInfo.Alignment, allocInfo.Alignment);
-			finalAllocInfo.SizeInBytes = std::max(finalAllocInfo.SizeInBytes, allocInfo.SizeInBytes);
-		}
-
-		D3D12MA::ALLOCATION_DESC allocDesc{};
-		allocDesc.HeapType = to_internal(descs[0].memType);
-		if (pool.handle != 0)
-		{
-			auto poolStorage = HandleAllocator::TryGet(m_memoryPools, HandleAllocator::GetSlot(pool.handle));
-			allocDesc.CustomPool = poolStorage.pool.Get();
-			allocDesc.Flags = D3D12MA::ALLOCATION_FLAG_STRATEGY_BEST_FIT;
-			//ad.Flags |= D3D12MA::ALLOCATION_FLAG_NEVER_ALLOCATE;		// If we want tighter constraints, we can enable this
-			assert(allocDesc.HeapType == poolStorage.desc.heapType);
-		}
-
-		ComPtr<D3D12MA::Allocation> alloc;
-		HRESULT hr{ S_OK };
-		hr = m_dma->AllocateMemory(&allocDesc, &finalAllocInfo, &alloc);
-		assert(SUCCEEDED(hr));
-		assert(alloc != NULL && alloc->GetHeap() != NULL);
-
-		/*
-			Create N resources using this alloc
-			Store the same alloc to all Texture_Storage
-		*/
-		std::vector<Texture> texturesToRet;
-		texturesToRet.reserve(internalDescs.size());
-		u32 i = 0;
-		for (const auto& desc : internalDescs)
-		{
-			Texture_Storage storage{};
-			storage.desc = descs[i];
+			assert(offsets[i] + m_device->GetResourceAllocationInfo(0, 1, &rd).SizeInBytes <= heapSize);
 
 			std::optional<D3D12_CLEAR_VALUE> clearVal;
-			if ((desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+			if ((rd.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
 			{
 				clearVal = D3D12_CLEAR_VALUE();
-				clearVal->Format = descs[i].format;
-				clearVal->DepthStencil.Depth = descs[i].depthClear;
-				clearVal->DepthStencil.Stencil = descs[i].stencilClear;
+				clearVal->Format = desc.format;
+				clearVal->DepthStencil.Depth = desc.depthClear;
+				clearVal->DepthStencil.Stencil = desc.stencilClear;
 			}
-			else if ((desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
+			else if ((rd.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
 			{
 				clearVal = D3D12_CLEAR_VALUE();
-				clearVal->Format = descs[i].format;
-				clearVal->Color[0] = descs[i].clearColor[0];
-				clearVal->Color[1] = descs[i].clearColor[1];
-				clearVal->Color[2] = descs[i].clearColor[2];
-				clearVal->Color[3] = descs[i].clearColor[3];
+				clearVal->Format = desc.format;
+				clearVal->Color[0] = desc.clearColor[0];
+				clearVal->Color[1] = desc.clearColor[1];
+				clearVal->Color[2] = desc.clearColor[2];
+				clearVal->Color[3] = desc.clearColor[3];
 			}
 
+			Texture_Storage storage{};
+			storage.desc = desc;
 			storage.alloc = alloc;
-			hr = m_dma->CreateAliasingResource(alloc.Get(), 0, &desc, descs[i].initState, clearVal ? &clearVal.value() : nullptr, IID_PPV_ARGS(storage.resource.GetAddressOf()));
+			HRESULT hr = m_dma->CreateAliasingResource(alloc.Get(), offsets[i], &rd, desc.initState, clearVal ? &clearVal.value() : nullptr, IID_PPV_ARGS(storage.resource.GetAddressOf()));
 			HR_VFY(hr);
 
 			auto handle = m_rhp.Allocate<Texture>();
 			HandleAllocator::TryInsertMove(m_textures, std::move(storage), HandleAllocator::GetSlot(handle.handle));
 			texturesToRet.push_back(handle);
-
-			++i;
 		}
-		
 
 		return texturesToRet;
 	}
 
+	std::vector<Buffer> RenderDevice_DX12::CreatePlacedBuffers(const std::vector<BufferDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool)
+	{
+		assert(descs.size() > 0);
+		assert(descs.size() == offsets.size());
+		assert(descs[0].memType == MemoryType::Default);	// Upload and readback buffers are never placed
+
+		auto alloc = AllocatePlacementHeap(to_internal(descs[0].memType), heapSize, pool);
+
+		std::vector<Buffer> buffersToRet;
+		buffersToRet.reserve(descs.size());
+		for (u32 i = 0; i < descs.size(); ++i)
+		{
+			const auto& desc = descs[i];
+			assert(descs[0].memType == desc.memType);
+			assert(offsets[i] % PLACEMENT_ALIGNMENT == 0);
+			assert(offsets[i] + desc.size <= heapSize);
+
+			D3D12_RESOURCE_DESC rd{};
+			rd.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+			rd.Alignment = desc.alignment;
+			rd.Width = desc.size;
+			rd.Height = rd.DepthOrArraySize = rd.MipLevels = 1;
+			rd.Format = DXGI_FORMAT_UNKNOWN;
+			rd.SampleDesc.Count = 1;
+			rd.SampleDesc.Quality = 0;
+			rd.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+			rd.Flags = desc.flags;
+
+			Buffer_Storage storage{};
+			storage.desc = desc;
+			storage.alloc = alloc;
+			HRESULT hr = m_dma->CreateAliasingResource(alloc.Get(), offsets[i], &rd, desc.initState, nullptr, IID_PPV_ARGS(storage.resource.GetAddressOf()));
+			HR_VFY(hr);
+
+			auto handle = m_rhp.Allocate<Buffer>();
+			HandleAllocator::TryInsertMove(m_buffers, std::move(storage), HandleAllocator::GetSlot(handle.handle));
+			buffersToRet.push_back(handle);
+		}
+
+		return buffersToRet;
+	}
+
 	void RenderDevice_DX12::FreeBuffer(Buffer handle)
 	{
 		HandleAllocator::FreeStorage(m_rhp, m_buffers, handle);
@@ -727,6 +762,7 @@ namespace DOG::gfx
 
 	void RenderDevice_DX12::FreeView(BufferView handle)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& res = HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(handle.handle));
 		m_descriptorMgr->free(&res.view);
 		if (res.uavClear)
@@ -736,6 +772,7 @@ namespace DOG::gfx
 
 	void RenderDevice_DX12::FreeView(TextureView handle)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& res = HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(handle.handle));
 		m_descriptorMgr->free(&res.view);
 		if (res.uavClear)
@@ -832,7 +869,8 @@ namespace DOG::gfx
 
 	std::optional<SyncReceipt> RenderDevice_DX12::SubmitCommandLists(std::span<CommandList> lists, QueueType queue, std::optional<SyncReceipt> incoming_sync, bool generate_sync)
 	{
-		ID3D12CommandList* cmdls[16];
+		// Render graph submits a list per recorded pass part
+		std::vector<ID3D12CommandList*> cmdls(lists.size());
 		for (u32 i = 0; i < lists.size(); ++i)
 		{
 			auto& storage = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(lists[i].handle));
@@ -856,7 +894,7 @@ namespace DOG::gfx
 			sync.fence.gpu_wait(*curr_queue);
 		}
 
-		curr_queue->execute_command_lists((u32)lists.size(), cmdls);
+		curr_queue->execute_command_lists((u32)lists.size(), cmdls.data());
 
 		// Generate outgoing sync
 		std::optional<SyncReceipt> syncReceipt{ std::nullopt };
@@ -939,12 +977,14 @@ namespace DOG::gfx
 
 	u32 RenderDevice_DX12::GetGlobalDescriptor(BufferView view) const
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		const auto& res = HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(view.handle));
 		return (u32)res.view.index_offset_from_base();
 	}
 
 	u32 RenderDevice_DX12::GetGlobalDescriptor(TextureView view) const
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		const auto& res = HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(view.handle));
 		return (u32)res.view.index_offset_from_base();
 	}
@@ -1073,17 +1113,18 @@ namespace DOG::gfx
 			}
 			case D3D12_RESOURCE_BARRIER_TYPE_ALIASING:
 			{
+				// A null before resource means any resource overlapping the after resource
 				if (barr.isBuffer)
 				{
-					assert(false);
+					if (barr.resource != 0)
+						barrs[i].Aliasing.pResourceBefore = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(barr.resource)).resource.Get();
+					barrs[i].Aliasing.pResourceAfter = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(barr.aliasResourceAfter)).resource.Get();
 				}
 				else
 				{
-					const auto& res1 = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(barr.resource));
-					const auto& res2 = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(barr.aliasResourceAfter));
-
-					barrs[i].Aliasing.pResourceBefore = res1.resource.Get();
-					barrs[i].Aliasing.pResourceAfter = res2.resource.Get();
+					if (barr.resource != 0)
+						barrs[i].Aliasing.pResourceBefore = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(barr.resource)).resource.Get();
+					barrs[i].Aliasing.pResourceAfter = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(barr.aliasResourceAfter)).resource.Get();
 				}
 
 				break;
@@ -1111,13 +1152,19 @@ namespace DOG::gfx
 		cmdRes.pair.list->ResourceBarrier((u32)barrs.size(), barrs.data());
 	}
 
-	void RenderDevice_DX12::Cmd_BeginRenderPass(CommandList list, RenderPass rp)
+	void RenderDevice_DX12::Cmd_BeginRenderPass(CommandList list, RenderPass rp, RenderPassSplit split)
 	{
 		auto& cmdlRes = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
 		auto& rpRes = HandleAllocator::TryGet(m_renderPasses, HandleAllocator::GetSlot(rp.handle));
 
+		D3D12_RENDER_PASS_FLAGS flags = rpRes.flags;
+		if (split == RenderPassSplit::First || split == RenderPassSplit::Middle)
+			flags |= D3D12_RENDER_PASS_FLAG_SUSPENDING_PASS;
+		if (split == RenderPassSplit::Middle || split == RenderPassSplit::Last)
+			flags |= D3D12_RENDER_PASS_FLAG_RESUMING_PASS;
+
 		cmdlRes.pair.list->BeginRenderPass((u32)rpRes.renderTargets.size(), rpRes.renderTargets.data(),
-			rpRes.depthStencil.has_value() ? &(*rpRes.depthStencil) : nullptr, rpRes.flags);
+			rpRes.depthStencil.has_value() ? &(*rpRes.depthStencil) : nullptr, flags);
 	}
 
 	void RenderDevice_DX12::Cmd_EndRenderPass(CommandList list)
@@ -1219,6 +1266,7 @@ namespace DOG::gfx
 	void RenderDevice_DX12::Cmd_ClearUnorderedAccessFLOAT(CommandList list,
 		BufferView view, std::array<f32, 4> clear, const ScissorRects& rects)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& cmdlRes = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
 		auto& viewRes = HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(view.handle));
 		auto& d12Res = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(viewRes.buf.handle));
@@ -1230,6 +1278,7 @@ namespace DOG::gfx
 	void RenderDevice_DX12::Cmd_ClearUnorderedAccessFLOAT(CommandList list,
 		TextureView view, std::array<f32, 4> clear, const ScissorRects& rects)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& cmdlRes = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
 		auto& viewRes = HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(view.handle));
 		auto& d12Res = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(viewRes.tex.handle));
@@ -1241,6 +1290,7 @@ namespace DOG::gfx
 	void RenderDevice_DX12::Cmd_ClearUnorderedAccessUINT(CommandList list, 
 		BufferView view, std::array<u32, 4> clear, const ScissorRects& rects)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& cmdlRes = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
 		auto& viewRes = HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(view.handle));
 		auto& d12Res = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(viewRes.buf.handle));
@@ -1252,6 +1302,7 @@ namespace DOG::gfx
 	void RenderDevice_DX12::Cmd_ClearUnorderedAccessUINT(CommandList list, 
 		TextureView view, std::array<u32, 4> clear, const ScissorRects& rects)
 	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
 		auto& cmdlRes = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
 		auto& viewRes = HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(view.handle));
 		auto& d12Res = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(viewRes.tex.handle));
@@ -39,8 +39,9 @@ namespace DOG::gfx
 		TextureView CreateView(Texture texture, const TextureViewDesc& desc);
 		MemoryPool CreateMemoryPool(const MemoryPoolDesc& desc);
 
-		// Aliased
-		std::vector<Texture> CreateAliasedTextures(const std::vector<TextureDesc>& descs, MemoryPool pool = {});
+		// Placed (potentially aliased)
+		std::vector<Texture> CreatePlacedTextures(const std::vector<TextureDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {});
+		std::vector<Buffer> CreatePlacedBuffers(const std::vector<BufferDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {});
 
 		// Free/recycle when appropriate! Sensitive resources that may be in-flight
 		void FreeBuffer(Buffer handle);
@@ -100,7 +101,8 @@ namespace DOG::gfx
 			std::span<GPUBarrier> barriers);
 
 		void Cmd_BeginRenderPass(CommandList list,
-			RenderPass rp);
+			RenderPass rp,
+			RenderPassSplit split = RenderPassSplit::None);
 
 		void Cmd_EndRenderPass(CommandList list);
 
@@ -300,6 +302,7 @@ namespace DOG::gfx
 		std::vector<D3D12_STATIC_SAMPLER_DESC> GrabStaticSamplers();
 		DX12Queue* GetQueue(QueueType type);
 		D3D12_COMMAND_LIST_TYPE GetListType(QueueType queue);
+		ComPtr<D3D12MA::Allocation> AllocatePlacementHeap(D3D12_HEAP_TYPE heapType, u64 heapSize, MemoryPool pool);
 
 
 	private:
@@ -319,6 +322,10 @@ namespace DOG::gfx
 
 		HandleAllocator m_rhp;
 
+		// Views are created and freed while passes record in parallel, guards the view storage and the descriptor manager.
+		// Resources, pipelines and render passes must not be created or freed during recording.
+		mutable std::mutex m_viewMutex;
+
 		std::vector<std::optional<MemoryPool_Storage>> m_memoryPools;
 		std::vector<std::optional<Buffer_Storage>> m_buffers;
 		std::vector<std::optional<Texture_Storage>> m_textures;
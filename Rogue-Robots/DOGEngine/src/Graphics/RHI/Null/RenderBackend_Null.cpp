@@ -0,0 +1,18 @@
+#include "RenderBackend_Null.h"
+#include "RenderDevice_Null.h"
+
+namespace DOG::gfx
+{
+	RenderBackend_Null::~RenderBackend_Null()
+	{
+		// Devices go down in reverse creation order
+		while (!m_renderDevices.empty())
+			m_renderDevices.pop_back();
+	}
+
+	RenderDevice* RenderBackend_Null::CreateDevice(UINT numBackBuffers)
+	{
+		m_renderDevices.push_back(std::make_unique<RenderDevice_Null>(numBackBuffers));
+		return m_renderDevices.back().get();
+	}
+}
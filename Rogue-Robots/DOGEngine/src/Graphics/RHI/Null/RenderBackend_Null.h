@@ -0,0 +1,18 @@
+#pragma once
+#include "../RenderBackend.h"
+
+namespace DOG::gfx
+{
+	// Creates devices that need no GPU, see RenderDevice_Null
+	class RenderBackend_Null final : public RenderBackend
+	{
+	public:
+		RenderBackend_Null() = default;
+		~RenderBackend_Null();
+
+		RenderDevice* CreateDevice(UINT numBackBuffers);
+
+	private:
+		std::vector<std::unique_ptr<RenderDevice>> m_renderDevices;
+	};
+}
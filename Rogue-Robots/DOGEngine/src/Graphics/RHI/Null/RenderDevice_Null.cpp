@@ -0,0 +1,612 @@
+#include "RenderDevice_Null.h"
+#include "Swapchain_Null.h"
+
+namespace DOG::gfx
+{
+	// Bytes of one mip level, block compressed formats are stored in 4x4 blocks
+	static u64 GetSurfaceSize(DXGI_FORMAT format, u32 width, u32 height)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return (u64)((width + 3) / 4) * ((height + 3) / 4) * 8;
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return (u64)((width + 3) / 4) * ((height + 3) / 4) * 16;
+		default:
+			break;
+		}
+
+		u64 bytesPerPixel = 4;
+		switch (format)
+		{
+		case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			bytesPerPixel = 16;
+			break;
+		case DXGI_FORMAT_R32G32B32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			bytesPerPixel = 12;
+			break;
+		case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_UINT:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R16G16B16A16_SINT:
+		case DXGI_FORMAT_R32G32_TYPELESS:
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+		case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+			bytesPerPixel = 8;
+			break;
+		case DXGI_FORMAT_R16G16_TYPELESS:
+		case DXGI_FORMAT_R16G16_FLOAT:
+		case DXGI_FORMAT_R16G16_UNORM:
+		case DXGI_FORMAT_R16G16_UINT:
+		case DXGI_FORMAT_R16G16_SNORM:
+		case DXGI_FORMAT_R16G16_SINT:
+			bytesPerPixel = 4;
+			break;
+		case DXGI_FORMAT_R16_TYPELESS:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_D16_UNORM:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_R16_UINT:
+		case DXGI_FORMAT_R16_SNORM:
+		case DXGI_FORMAT_R16_SINT:
+		case DXGI_FORMAT_R8G8_TYPELESS:
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_UINT:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R8G8_SINT:
+			bytesPerPixel = 2;
+			break;
+		case DXGI_FORMAT_R8_TYPELESS:
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_UINT:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_R8_SINT:
+		case DXGI_FORMAT_A8_UNORM:
+			bytesPerPixel = 1;
+			break;
+		default:
+			break;
+		}
+		return (u64)width * height * bytesPerPixel;
+	}
+
+	static u32 GetHeapIndex(MemoryType memType)
+	{
+		switch (memType)
+		{
+		case MemoryType::Upload:
+			return 1;
+		case MemoryType::Readback:
+			return 2;
+		default:
+			return 0;
+		}
+	}
+
+	RenderDevice_Null::RenderDevice_Null(UINT)
+	{
+		// 0 marked as un-used
+		m_buffers.resize(1);
+		m_textures.resize(1);
+		m_pipelines.resize(1);
+		m_renderPasses.resize(1);
+		m_syncs.resize(1);
+		m_cmdls.resize(1);
+		m_bufferViews.resize(1);
+		m_textureViews.resize(1);
+		m_memoryPools.resize(1);
+	}
+
+	RenderDevice_Null::~RenderDevice_Null()
+	{
+		// Backbuffers are freed through the device
+		m_swapchain.reset();
+	}
+
+	Monitor RenderDevice_Null::GetMonitor()
+	{
+		auto [width, height] = m_swapchain ? m_swapchain->GetSwapchainWidthAndHeight() : std::pair<u32, u32>{ 1280, 720 };
+
+		Monitor monitor{};
+		monitor.output.DesktopCoordinates = { 0, 0, (LONG)width, (LONG)height };
+		monitor.output.AttachedToDesktop = TRUE;
+
+		DXGI_MODE_DESC mode{};
+		mode.Width = width;
+		mode.Height = height;
+		mode.RefreshRate = { 60, 1 };
+		mode.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		monitor.modes.push_back(mode);
+		return monitor;
+	}
+
+	const GPUPoolMemoryInfo& RenderDevice_Null::GetPoolMemoryInfo(MemoryPool pool)
+	{
+		return HandleAllocator::TryGet(m_memoryPools, HandleAllocator::GetSlot(pool.handle)).info;
+	}
+
+	const GPUTotalMemoryInfo& RenderDevice_Null::GetTotalMemoryInfo()
+	{
+		return m_totalMemoryInfo;
+	}
+
+	u64 RenderDevice_Null::GetTotalTextureSize(const TextureDesc& desc)
+	{
+		// 0 mip levels means the full chain, like on D3D12
+		u32 mipLevels = desc.mipLevels;
+		if (mipLevels == 0)
+		{
+			u32 largest = std::max(desc.width, desc.height);
+			while (largest > 0)
+			{
+				++mipLevels;
+				largest >>= 1;
+			}
+		}
+
+		u64 size = 0;
+		u32 width = desc.width, height = desc.height;
+		for (u32 mip = 0; mip < mipLevels; ++mip)
+		{
+			size += GetSurfaceSize(desc.format, width, height);
+			width = std::max(width >> 1, 1u);
+			height = std::max(height >> 1, 1u);
+		}
+		return size * desc.depth * desc.sampleCount;
+	}
+
+	Swapchain* RenderDevice_Null::CreateSwapchain(void*, u8 numBuffers)
+	{
+		assert(!m_swapchain);
+		m_swapchain = std::make_unique<Swapchain_Null>(this, numBuffers);
+		return m_swapchain.get();
+	}
+
+	Buffer RenderDevice_Null::CreateBuffer(const BufferDesc& desc, MemoryPool pool)
+	{
+		assert(desc.size > 0);
+
+		Buffer_Storage storage{};
+		storage.desc = desc;
+		storage.pool = pool;
+		storage.memory.resize(desc.size);
+
+		auto handle = m_rhp.Allocate<Buffer>();
+		HandleAllocator::TryInsertMove(m_buffers, std::move(storage), HandleAllocator::GetSlot(handle.handle));
+
+		TrackAllocation(pool, desc.memType, desc.size, true);
+		++m_liveBuffers;
+		return handle;
+	}
+
+	Texture RenderDevice_Null::CreateTexture(const TextureDesc& desc, MemoryPool pool)
+	{
+		Texture_Storage storage{};
+		storage.desc = desc;
+		storage.pool = pool;
+		storage.size = GetTotalTextureSize(desc);
+
+		auto handle = m_rhp.Allocate<Texture>();
+		HandleAllocator::TryInsert(m_textures, storage, HandleAllocator::GetSlot(handle.handle));
+
+		TrackAllocation(pool, desc.memType, storage.size, true);
+		++m_liveTextures;
+		return handle;
+	}
+
+	Pipeline RenderDevice_Null::CreateGraphicsPipeline(const GraphicsPipelineDesc&)
+	{
+		auto handle = m_rhp.Allocate<Pipeline>();
+		HandleAllocator::TryInsert(m_pipelines, (u8)0, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	Pipeline RenderDevice_Null::CreateComputePipeline(const ComputePipelineDesc&)
+	{
+		auto handle = m_rhp.Allocate<Pipeline>();
+		HandleAllocator::TryInsert(m_pipelines, (u8)1, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	RenderPass RenderDevice_Null::CreateRenderPass(const RenderPassDesc& desc)
+	{
+		auto handle = m_rhp.Allocate<RenderPass>();
+		HandleAllocator::TryInsert(m_renderPasses, desc, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	BufferView RenderDevice_Null::CreateView(Buffer buffer, const BufferViewDesc&)
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		assert(HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(buffer.handle)).memory.size() > 0);
+
+		View_Storage storage{ buffer.handle, AllocateDescriptor() };
+		auto handle = m_rhp.Allocate<BufferView>();
+		HandleAllocator::TryInsert(m_bufferViews, storage, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	TextureView RenderDevice_Null::CreateView(Texture texture, const TextureViewDesc&)
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		assert(HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(texture.handle)).size > 0);
+
+		View_Storage storage{ texture.handle, AllocateDescriptor() };
+		auto handle = m_rhp.Allocate<TextureView>();
+		HandleAllocator::TryInsert(m_textureViews, storage, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	MemoryPool RenderDevice_Null::CreateMemoryPool(const MemoryPoolDesc& desc)
+	{
+		MemoryPool_Storage storage{};
+		storage.desc = desc;
+		storage.info.blocksAllocated = desc.minBlocks;
+		storage.info.blockBytes = desc.minBlocks * desc.size;
+
+		auto handle = m_rhp.Allocate<MemoryPool>();
+		HandleAllocator::TryInsert(m_memoryPools, storage, HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	std::vector<Texture> RenderDevice_Null::CreatePlacedTextures(const std::vector<TextureDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool)
+	{
+		assert(descs.size() == offsets.size());
+
+		std::vector<Texture> textures;
+		textures.reserve(descs.size());
+		for (u32 i = 0; i < descs.size(); ++i)
+		{
+			assert(offsets[i] % PLACEMENT_ALIGNMENT == 0);
+			assert(offsets[i] + GetTotalTextureSize(descs[i]) <= heapSize);
+			textures.push_back(CreateTexture(descs[i], pool));
+		}
+		return textures;
+	}
+
+	std::vector<Buffer> RenderDevice_Null::CreatePlacedBuffers(const std::vector<BufferDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool)
+	{
+		assert(descs.size() == offsets.size());
+
+		std::vector<Buffer> buffers;
+		buffers.reserve(descs.size());
+		for (u32 i = 0; i < descs.size(); ++i)
+		{
+			assert(offsets[i] % PLACEMENT_ALIGNMENT == 0);
+			assert(offsets[i] + descs[i].size <= heapSize);
+			buffers.push_back(CreateBuffer(descs[i], pool));
+		}
+		return buffers;
+	}
+
+	void RenderDevice_Null::FreeBuffer(Buffer handle)
+	{
+		const auto& storage = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(handle.handle));
+		TrackAllocation(storage.pool, storage.desc.memType, storage.desc.size, false);
+		HandleAllocator::FreeStorage(m_rhp, m_buffers, handle);
+		--m_liveBuffers;
+	}
+
+	void RenderDevice_Null::FreeTexture(Texture handle)
+	{
+		const auto& storage = HandleAllocator::TryGet(m_textures, HandleAllocator::GetSlot(handle.handle));
+		TrackAllocation(storage.pool, storage.desc.memType, storage.size, false);
+		HandleAllocator::FreeStorage(m_rhp, m_textures, handle);
+		--m_liveTextures;
+	}
+
+	void RenderDevice_Null::FreePipeline(Pipeline handle)
+	{
+		HandleAllocator::FreeStorage(m_rhp, m_pipelines, handle);
+	}
+
+	void RenderDevice_Null::FreeRenderPass(RenderPass handle)
+	{
+		HandleAllocator::FreeStorage(m_rhp, m_renderPasses, handle);
+	}
+
+	void RenderDevice_Null::FreeView(BufferView handle)
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		FreeDescriptor(HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(handle.handle)).globalDescriptor);
+		HandleAllocator::FreeStorage(m_rhp, m_bufferViews, handle);
+	}
+
+	void RenderDevice_Null::FreeView(TextureView handle)
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		FreeDescriptor(HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(handle.handle)).globalDescriptor);
+		HandleAllocator::FreeStorage(m_rhp, m_textureViews, handle);
+	}
+
+	void RenderDevice_Null::FreeMemoryPool(MemoryPool handle)
+	{
+		assert(HandleAllocator::TryGet(m_memoryPools, HandleAllocator::GetSlot(handle.handle)).info.numAllocations == 0);
+		HandleAllocator::FreeStorage(m_rhp, m_memoryPools, handle);
+	}
+
+	void RenderDevice_Null::RecycleSync(SyncReceipt receipt)
+	{
+		HandleAllocator::FreeStorage(m_rhp, m_syncs, receipt);
+	}
+
+	void RenderDevice_Null::RecycleCommandList(CommandList handle)
+	{
+		assert(!HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(handle.handle)).insideRenderPass);
+		HandleAllocator::FreeStorage(m_rhp, m_cmdls, handle);
+	}
+
+	CommandList RenderDevice_Null::AllocateCommandList(QueueType queue)
+	{
+		CommandList_Storage storage{};
+		storage.queue = queue;
+
+		auto handle = m_rhp.Allocate<CommandList>();
+		HandleAllocator::TryInsertMove(m_cmdls, std::move(storage), HandleAllocator::GetSlot(handle.handle));
+		return handle;
+	}
+
+	u32 RenderDevice_Null::GetGlobalDescriptor(BufferView view) const
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		return HandleAllocator::TryGet(m_bufferViews, HandleAllocator::GetSlot(view.handle)).globalDescriptor;
+	}
+
+	u32 RenderDevice_Null::GetGlobalDescriptor(TextureView view) const
+	{
+		std::lock_guard<std::mutex> lock(m_viewMutex);
+		return HandleAllocator::TryGet(m_textureViews, HandleAllocator::GetSlot(view.handle)).globalDescriptor;
+	}
+
+	void RenderDevice_Null::Flush()
+	{
+		// Submissions execute immediately, nothing is ever in flight
+	}
+
+	void RenderDevice_Null::WaitForGPU(SyncReceipt receipt)
+	{
+		RecycleSync(receipt);
+	}
+
+	u8* RenderDevice_Null::Map(Buffer handle, u32, std::pair<u32, u32>)
+	{
+		return HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(handle.handle)).memory.data();
+	}
+
+	void RenderDevice_Null::Unmap(Buffer, u32, std::pair<u32, u32>)
+	{
+	}
+
+	void RenderDevice_Null::Cmd_SetIndexBuffer(CommandList list, Buffer ib)
+	{
+		Record(list, CommandType::SetIndexBuffer, { ib.handle });
+	}
+
+	void RenderDevice_Null::Cmd_Draw(CommandList list, u32 vertsPerInstance, u32 instanceCount, u32 vertStart, u32 instanceStart)
+	{
+		Record(list, CommandType::Draw, { vertsPerInstance, instanceCount, vertStart, instanceStart });
+	}
+
+	void RenderDevice_Null::Cmd_DrawIndexed(CommandList list, u32 indicesPerInstance, u32 instanceCount, u32 indexStart, u32 vertStart, u32 instanceStart)
+	{
+		Record(list, CommandType::DrawIndexed, { indicesPerInstance, instanceCount, indexStart, vertStart, instanceStart });
+	}
+
+	void RenderDevice_Null::Cmd_Dispatch(CommandList list, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ)
+	{
+		Record(list, CommandType::Dispatch, { threadGroupCountX, threadGroupCountY, threadGroupCountZ });
+	}
+
+	void RenderDevice_Null::Cmd_SetPipeline(CommandList list, Pipeline pipeline)
+	{
+		assert(HandleAllocator::GetSlot(pipeline.handle) < m_pipelines.size());
+		Record(list, CommandType::SetPipeline, { pipeline.handle });
+	}
+
+	void RenderDevice_Null::Cmd_Barrier(CommandList list, std::span<GPUBarrier> barriers)
+	{
+		if (barriers.empty())
+			return;
+		Record(list, CommandType::Barrier, { barriers.size() });
+	}
+
+	void RenderDevice_Null::Cmd_BeginRenderPass(CommandList list, RenderPass rp, RenderPassSplit split)
+	{
+		auto& storage = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
+		assert(!storage.insideRenderPass);
+		storage.insideRenderPass = true;
+		Record(list, CommandType::BeginRenderPass, { rp.handle, (u64)split });
+	}
+
+	void RenderDevice_Null::Cmd_EndRenderPass(CommandList list)
+	{
+		auto& storage = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
+		assert(storage.insideRenderPass);
+		storage.insideRenderPass = false;
+		Record(list, CommandType::EndRenderPass);
+	}
+
+	void RenderDevice_Null::Cmd_UpdateShaderArgs(CommandList list, QueueType targetQueue, const ShaderArgs& args)
+	{
+		Record(list, CommandType::UpdateShaderArgs, { (u64)targetQueue, args.numConstants, args.mainCBV.handle, args.secondaryCBV.handle });
+	}
+
+	void RenderDevice_Null::Cmd_CopyBuffer(CommandList list, Buffer dst, u32 dstOffset, Buffer src, u32 srcOffset, u32 size)
+	{
+		Record(list, CommandType::CopyBuffer, { dst.handle, dstOffset, src.handle, srcOffset, size });
+	}
+
+	void RenderDevice_Null::Cmd_CopyBufferToImage(CommandList list, Texture dst, u32 dstSubresource, std::tuple<u32, u32, u32>,
+		Buffer src, u32 srcOffset, DXGI_FORMAT, u32, u32 srcHeight, u32 srcDepth, u32 srcRowPitch)
+	{
+		Record(list, CommandType::CopyBufferToImage, { dst.handle, dstSubresource, src.handle, srcOffset, (u64)srcRowPitch * srcHeight * srcDepth });
+	}
+
+	void RenderDevice_Null::Cmd_SetViewports(CommandList list, Viewports vps)
+	{
+		Record(list, CommandType::SetViewports, { vps.numVps });
+	}
+
+	void RenderDevice_Null::Cmd_SetScissorRects(CommandList list, ScissorRects rects)
+	{
+		Record(list, CommandType::SetScissorRects, { rects.numScissors });
+	}
+
+	void RenderDevice_Null::Cmd_ClearUnorderedAccessFLOAT(CommandList list, BufferView view, std::array<f32, 4>, const ScissorRects& rects)
+	{
+		Record(list, CommandType::ClearUnorderedAccess, { view.handle, rects.numScissors });
+	}
+
+	void RenderDevice_Null::Cmd_ClearUnorderedAccessFLOAT(CommandList list, TextureView view, std::array<f32, 4>, const ScissorRects& rects)
+	{
+		Record(list, CommandType::ClearUnorderedAccess, { view.handle, rects.numScissors });
+	}
+
+	void RenderDevice_Null::Cmd_ClearUnorderedAccessUINT(CommandList list, BufferView view, std::array<u32, 4>, const ScissorRects& rects)
+	{
+		Record(list, CommandType::ClearUnorderedAccess, { view.handle, rects.numScissors });
+	}
+
+	void RenderDevice_Null::Cmd_ClearUnorderedAccessUINT(CommandList list, TextureView view, std::array<u32, 4>, const ScissorRects& rects)
+	{
+		Record(list, CommandType::ClearUnorderedAccess, { view.handle, rects.numScissors });
+	}
+
+	std::optional<SyncReceipt> RenderDevice_Null::SubmitCommandLists(std::span<CommandList> lists, QueueType queue, std::optional<SyncReceipt> incoming_sync, bool generate_sync)
+	{
+		// Everything submitted before has already executed
+		if (incoming_sync)
+			RecycleSync(*incoming_sync);
+
+		++m_stats.submits;
+		for (auto list : lists)
+		{
+			auto& storage = HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle));
+			assert(storage.queue == queue);
+			assert(!storage.insideRenderPass);
+
+			++m_stats.commandLists;
+			for (const auto& cmd : storage.commands)
+				Execute(cmd);
+
+			if (m_logCommands)
+				m_commandLog.insert(m_commandLog.end(), storage.commands.begin(), storage.commands.end());
+			storage.commands.clear();
+		}
+
+		if (!generate_sync)
+			return std::nullopt;
+
+		auto receipt = m_rhp.Allocate<SyncReceipt>();
+		HandleAllocator::TryInsert(m_syncs, (u8)0, HandleAllocator::GetSlot(receipt.handle));
+		return receipt;
+	}
+
+	std::optional<SyncReceipt> RenderDevice_Null::SubmitCommandList(CommandList list, QueueType queue, std::optional<SyncReceipt> incoming_sync, bool generate_sync)
+	{
+		return SubmitCommandLists({ &list, 1 }, queue, incoming_sync, generate_sync);
+	}
+
+	void RenderDevice_Null::Record(CommandList list, CommandType type, std::array<u64, 5> args)
+	{
+		HandleAllocator::TryGet(m_cmdls, HandleAllocator::GetSlot(list.handle)).commands.push_back({ type, args });
+	}
+
+	void RenderDevice_Null::Execute(const RecordedCommand& cmd)
+	{
+		++m_stats.commands[(size_t)cmd.type];
+
+		switch (cmd.type)
+		{
+		case CommandType::Draw:
+		case CommandType::DrawIndexed:
+			m_stats.drawnInstances += cmd.args[1];
+			break;
+		case CommandType::Barrier:
+			m_stats.barriers += cmd.args[0];
+			break;
+		case CommandType::CopyBuffer:
+		{
+			auto& dst = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(cmd.args[0])).memory;
+			const auto& src = HandleAllocator::TryGet(m_buffers, HandleAllocator::GetSlot(cmd.args[2])).memory;
+			const u64 dstOffset = cmd.args[1], srcOffset = cmd.args[3], size = cmd.args[4];
+			assert(dstOffset + size <= dst.size());
+			assert(srcOffset + size <= src.size());
+			std::memcpy(dst.data() + dstOffset, src.data() + srcOffset, size);
+			m_stats.copiedBytes += size;
+			break;
+		}
+		case CommandType::CopyBufferToImage:
+			m_stats.copiedBytes += cmd.args[4];
+			break;
+		default:
+			break;
+		}
+	}
+
+	void RenderDevice_Null::TrackAllocation(MemoryPool pool, MemoryType memType, u64 size, bool allocate)
+	{
+		auto track = [size, allocate](GPUPoolMemoryInfo& info)
+		{
+			if (allocate)
+			{
+				++info.numAllocations;
+				info.allocationBytes += (u32)size;
+			}
+			else
+			{
+				--info.numAllocations;
+				info.allocationBytes -= (u32)size;
+			}
+		};
+
+		if (pool.handle != 0)
+			track(HandleAllocator::TryGet(m_memoryPools, HandleAllocator::GetSlot(pool.handle)).info);
+		track(m_totalMemoryInfo.heap[GetHeapIndex(memType)]);
+		track(m_totalMemoryInfo.total);
+	}
+
+	u32 RenderDevice_Null::AllocateDescriptor()
+	{
+		if (m_freeDescriptors.empty())
+			return m_nextDescriptor++;
+
+		const u32 descriptor = m_freeDescriptors.back();
+		m_freeDescriptors.pop_back();
+		return descriptor;
+	}
+
+	void RenderDevice_Null::FreeDescriptor(u32 descriptor)
+	{
+		m_freeDescriptors.push_back(descriptor);
+	}
+}
@@ -0,0 +1,280 @@
+#pragma once
+#include "../../Handles/HandleAllocator.h"
+#include "../RenderDevice.h"
+
+namespace DOG::gfx
+{
+	/*
+		Device without a GPU. Resources get handles and buffers a CPU-side shadow allocation, commands are recorded per command list
+		and executed at submission: buffer copies are carried out on the shadow memory, everything else is only counted.
+		Submission is synchronous, so syncs are always signaled and Flush/WaitForGPU return immediately.
+
+		Lets the renderer, the render graph and the GPU tables run on machines without D3D12, e.g. to benchmark CPU-side render costs.
+	*/
+	class Swapchain_Null;
+	class RenderDevice_Null final : public RenderDevice
+	{
+	public:
+		enum class CommandType : u8
+		{
+			SetIndexBuffer,
+			Draw,
+			DrawIndexed,
+			Dispatch,
+			SetPipeline,
+			Barrier,
+			BeginRenderPass,
+			EndRenderPass,
+			UpdateShaderArgs,
+			CopyBuffer,
+			CopyBufferToImage,
+			SetViewports,
+			SetScissorRects,
+			ClearUnorderedAccess,
+			COUNT
+		};
+
+		// Arguments are the handles and counts of the call in declaration order, unused ones are 0
+		struct RecordedCommand
+		{
+			CommandType type{ CommandType::COUNT };
+			std::array<u64, 5> args{};
+		};
+
+		struct SubmissionStats
+		{
+			u64 submits{ 0 };
+			u64 commandLists{ 0 };
+			std::array<u64, (size_t)CommandType::COUNT> commands{};
+			u64 drawnInstances{ 0 };
+			u64 barriers{ 0 };
+			u64 copiedBytes{ 0 };
+		};
+
+	public:
+		RenderDevice_Null(UINT numBackBuffers);
+		~RenderDevice_Null();
+
+		Monitor GetMonitor() override;
+		const GPUPoolMemoryInfo& GetPoolMemoryInfo(MemoryPool pool);
+		const GPUTotalMemoryInfo& GetTotalMemoryInfo();
+
+		u64 GetTotalTextureSize(const TextureDesc& desc);
+
+		Swapchain* CreateSwapchain(void* hwnd, u8 numBuffers);
+		Buffer CreateBuffer(const BufferDesc& desc, MemoryPool = {});
+		Texture CreateTexture(const TextureDesc& desc, MemoryPool = {});
+		Pipeline CreateGraphicsPipeline(const GraphicsPipelineDesc& desc);
+		Pipeline CreateComputePipeline(const ComputePipelineDesc& desc);
+		RenderPass CreateRenderPass(const RenderPassDesc& desc);
+		BufferView CreateView(Buffer buffer, const BufferViewDesc& desc);
+		TextureView CreateView(Texture texture, const TextureViewDesc& desc);
+		MemoryPool CreateMemoryPool(const MemoryPoolDesc& desc);
+
+		// Placed resources get their own shadow memory, aliasing is not emulated
+		std::vector<Texture> CreatePlacedTextures(const std::vector<TextureDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {});
+		std::vector<Buffer> CreatePlacedBuffers(const std::vector<BufferDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {});
+
+		void FreeBuffer(Buffer handle);
+		void FreeTexture(Texture handle);
+		void FreePipeline(Pipeline handle);
+		void FreeRenderPass(RenderPass handle);
+		void FreeView(BufferView handle);
+		void FreeView(TextureView handle);
+		void FreeMemoryPool(MemoryPool handle);
+		void RecycleSync(SyncReceipt receipt);
+		void RecycleCommandList(CommandList handle);
+
+		CommandList AllocateCommandList(QueueType queue = QueueType::Graphics);
+
+		u32 GetGlobalDescriptor(BufferView view) const;
+		u32 GetGlobalDescriptor(TextureView view) const;
+
+		void Flush();
+		void WaitForGPU(SyncReceipt receipt);
+
+		// Default memory is mappable too, so that tests can read back what copies wrote
+		u8* Map(Buffer handle, u32 subresource = 0, std::pair<u32, u32> readRange = { 0, 0 });
+		void Unmap(Buffer handle, u32 subresource = 0, std::pair<u32, u32> writtenRange = { 0, 0 });
+
+		/*
+			Sensitive commands start
+			==================================
+		*/
+		void Cmd_SetIndexBuffer(CommandList list,
+			Buffer ib);
+
+		void Cmd_Draw(CommandList list,
+			u32 vertsPerInstance,
+			u32 instanceCount,
+			u32 vertStart,
+			u32 instanceStart);
+
+		void Cmd_DrawIndexed(CommandList list,
+			u32 indicesPerInstance,
+			u32 instanceCount,
+			u32 indexStart,
+			u32 vertStart,
+			u32 instanceStart);
+
+		void Cmd_Dispatch(CommandList list,
+			u32 threadGroupCountX,
+			u32 threadGroupCountY,
+			u32 threadGroupCountZ);
+
+		void Cmd_SetPipeline(CommandList list,
+			Pipeline pipeline);
+
+		void Cmd_Barrier(CommandList list,
+			std::span<GPUBarrier> barriers);
+
+		void Cmd_BeginRenderPass(CommandList list,
+			RenderPass rp,
+			RenderPassSplit split = RenderPassSplit::None);
+
+		void Cmd_EndRenderPass(CommandList list);
+
+		void Cmd_UpdateShaderArgs(CommandList list,
+			QueueType targetQueue,
+			const ShaderArgs& args);
+
+		void Cmd_CopyBuffer(CommandList list,
+			Buffer dst,
+			u32 dstOffset,
+			Buffer src,
+			u32 srcOffset,
+			u32 size);
+
+		void Cmd_CopyBufferToImage(CommandList list,
+			Texture dst,
+			u32 dstSubresource,
+			std::tuple<u32, u32, u32> dstTopLeft,
+
+			Buffer src,
+			// Describe the data in 'src':
+			u32 srcOffset,
+			DXGI_FORMAT srcFormat,
+			u32 srcWidth,
+			u32 srcHeight,
+			u32 srcDepth,
+			u32 srcRowPitch);
+
+		void Cmd_SetViewports(CommandList list,
+			Viewports vps);
+
+		void Cmd_SetScissorRects(CommandList list,
+			ScissorRects rects);
+
+		void Cmd_ClearUnorderedAccessFLOAT(CommandList list,
+			BufferView view, std::array<f32, 4> clear, const ScissorRects& rects);
+
+		void Cmd_ClearUnorderedAccessFLOAT(CommandList list,
+			TextureView view, std::array<f32, 4> clear, const ScissorRects& rects);
+
+		void Cmd_ClearUnorderedAccessUINT(CommandList list,
+			BufferView view, std::array<u32, 4> clear, const ScissorRects& rects);
+
+		void Cmd_ClearUnorderedAccessUINT(CommandList list,
+			TextureView view, std::array<u32, 4> clear, const ScissorRects& rects);
+
+		/*
+			Sensitive commands end
+			===================================================
+		*/
+
+		std::optional<SyncReceipt> SubmitCommandLists(
+			std::span<CommandList> lists,
+			QueueType queue = QueueType::Graphics,
+			std::optional<SyncReceipt> incoming_sync = std::nullopt,
+			bool generate_sync = false);
+
+		std::optional<SyncReceipt> SubmitCommandList(
+			CommandList list,
+			QueueType queue = QueueType::Graphics,
+			std::optional<SyncReceipt> incoming_sync = std::nullopt,
+			bool generate_sync = false);
+
+		// Null specific
+	public:
+		const SubmissionStats& GetSubmissionStats() const { return m_stats; }
+		void ResetSubmissionStats() { m_stats = {}; }
+
+		// When enabled, every submitted command is appended to the log in submission order
+		void SetCommandLogging(bool enabled) { m_logCommands = enabled; }
+		const std::vector<RecordedCommand>& GetCommandLog() const { return m_commandLog; }
+		void ClearCommandLog() { m_commandLog.clear(); }
+
+		u32 GetLiveBufferCount() const { return m_liveBuffers; }
+		u32 GetLiveTextureCount() const { return m_liveTextures; }
+
+	private:
+		struct MemoryPool_Storage
+		{
+			MemoryPoolDesc desc;
+			GPUPoolMemoryInfo info;
+		};
+
+		struct Buffer_Storage
+		{
+			BufferDesc desc;
+			MemoryPool pool;
+			std::vector<u8> memory;
+		};
+
+		struct Texture_Storage
+		{
+			TextureDesc desc;
+			MemoryPool pool;
+			u64 size{ 0 };
+		};
+
+		struct View_Storage
+		{
+			u64 resource{ 0 };
+			u32 globalDescriptor{ 0 };
+		};
+
+		struct CommandList_Storage
+		{
+			QueueType queue{ QueueType::Graphics };
+			std::vector<RecordedCommand> commands;
+			bool insideRenderPass{ false };
+		};
+
+		void Record(CommandList list, CommandType type, std::array<u64, 5> args = {});
+		void Execute(const RecordedCommand& cmd);
+		void TrackAllocation(MemoryPool pool, MemoryType memType, u64 size, bool allocate);
+		u32 AllocateDescriptor();
+		void FreeDescriptor(u32 descriptor);
+
+	private:
+		HandleAllocator m_rhp;
+
+		// Views are created and freed while passes record in parallel, guards the view storage and the descriptors
+		mutable std::mutex m_viewMutex;
+
+		std::vector<std::optional<MemoryPool_Storage>> m_memoryPools;
+		std::vector<std::optional<Buffer_Storage>> m_buffers;
+		std::vector<std::optional<Texture_Storage>> m_textures;
+		std::vector<std::optional<View_Storage>> m_bufferViews;
+		std::vector<std::optional<View_Storage>> m_textureViews;
+		std::vector<std::optional<u8>> m_pipelines;
+		std::vector<std::optional<RenderPassDesc>> m_renderPasses;
+		std::vector<std::optional<CommandList_Storage>> m_cmdls;
+		std::vector<std::optional<u8>> m_syncs;
+
+		std::vector<u32> m_freeDescriptors;
+		u32 m_nextDescriptor{ 0 };
+
+		u32 m_liveBuffers{ 0 };
+		u32 m_liveTextures{ 0 };
+
+		GPUTotalMemoryInfo m_totalMemoryInfo{};
+
+		SubmissionStats m_stats;
+		std::vector<RecordedCommand> m_commandLog;
+		bool m_logCommands{ false };
+
+		std::unique_ptr<Swapchain_Null> m_swapchain;
+	};
+}
@@ -0,0 +1,93 @@
+#include "Swapchain_Null.h"
+
+#include "RenderDevice_Null.h"
+
+namespace DOG::gfx
+{
+	Swapchain_Null::Swapchain_Null(RenderDevice_Null* device, u8 numBuffers, u32 width, u32 height) :
+		m_device(device),
+		m_width(width),
+		m_height(height)
+	{
+		assert(numBuffers >= 2);
+		CreateBuffers(numBuffers);
+	}
+
+	Swapchain_Null::~Swapchain_Null()
+	{
+		FreeBuffers();
+	}
+
+	Texture Swapchain_Null::GetNextDrawSurface()
+	{
+		return m_buffers[m_currentBuffer];
+	}
+
+	u8 Swapchain_Null::GetNextDrawSurfaceIdx()
+	{
+		return m_currentBuffer;
+	}
+
+	void Swapchain_Null::SetClearColor(const std::array<float, 4>& clear_color)
+	{
+		m_clearColor = clear_color;
+	}
+
+	void Swapchain_Null::OnResize(u32 clientWidth, u32 clientHeight)
+	{
+		m_device->Flush();
+
+		const u8 numBuffers = (u8)m_buffers.size();
+		FreeBuffers();
+		m_width = clientWidth;
+		m_height = clientHeight;
+		CreateBuffers(numBuffers);
+	}
+
+	bool Swapchain_Null::GetFullscreenState() const
+	{
+		return m_isFullscreen;
+	}
+
+	bool Swapchain_Null::SetFullscreenState(bool fullscreen, DXGI_MODE_DESC mode)
+	{
+		m_isFullscreen = fullscreen;
+		if (fullscreen && mode.Width != 0 && mode.Height != 0)
+			OnResize(mode.Width, mode.Height);
+		return true;
+	}
+
+	Texture Swapchain_Null::GetBuffer(u8 idx)
+	{
+		assert(idx < m_buffers.size());
+		return m_buffers[idx];
+	}
+
+	DXGI_FORMAT Swapchain_Null::GetBufferFormat() const
+	{
+		return m_scFormat;
+	}
+
+	void Swapchain_Null::Present(bool)
+	{
+		m_currentBuffer = (u8)((m_currentBuffer + 1) % m_buffers.size());
+		++m_presentCount;
+	}
+
+	void Swapchain_Null::CreateBuffers(u8 numBuffers)
+	{
+		TextureDesc desc(MemoryType::Default, m_scFormat, m_width, m_height, 1, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+		desc.mipLevels = 1;
+
+		m_buffers.clear();
+		for (u8 i = 0; i < numBuffers; ++i)
+			m_buffers.push_back(m_device->CreateTexture(desc));
+		m_currentBuffer = 0;
+	}
+
+	void Swapchain_Null::FreeBuffers()
+	{
+		for (const auto& tex : m_buffers)
+			m_device->FreeTexture(tex);
+	}
+}
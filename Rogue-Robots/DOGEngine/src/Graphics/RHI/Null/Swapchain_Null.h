@@ -0,0 +1,50 @@
+#pragma once
+#include "../Swapchain.h"
+
+namespace DOG::gfx
+{
+	class RenderDevice_Null;
+
+	// Backbuffers are plain textures on the null device, Present only advances the buffer index
+	class Swapchain_Null : public Swapchain
+	{
+	public:
+		Swapchain_Null(RenderDevice_Null* device, u8 numBuffers, u32 width = DEFAULT_WIDTH, u32 height = DEFAULT_HEIGHT);
+		~Swapchain_Null();
+
+		// Public interface
+		Texture GetNextDrawSurface();
+		u8 GetNextDrawSurfaceIdx();
+		void SetClearColor(const std::array<float, 4>& clear_color);
+
+		void OnResize(u32 clientWidth, u32 clientHeight) override;
+		bool GetFullscreenState() const override;
+		bool SetFullscreenState(bool fullscreen, DXGI_MODE_DESC mode) override;
+
+		Texture GetBuffer(u8 idx);
+		DXGI_FORMAT GetBufferFormat() const;
+		std::pair<u32, u32> GetSwapchainWidthAndHeight() const { return { m_width, m_height }; }
+		void Present(bool vsync);
+
+		u64 GetPresentCount() const { return m_presentCount; }
+
+	private:
+		void CreateBuffers(u8 numBuffers);
+		void FreeBuffers();
+
+	private:
+		static constexpr u32 DEFAULT_WIDTH = 1280;
+		static constexpr u32 DEFAULT_HEIGHT = 720;
+
+		RenderDevice_Null* m_device{ nullptr };
+		DXGI_FORMAT m_scFormat{ DXGI_FORMAT_R8G8B8A8_UNORM };
+		std::vector<Texture> m_buffers;
+		std::array<float, 4> m_clearColor{ 0.f, 0.f, 0.f, 1.f };
+
+		u32 m_width{ 0 };
+		u32 m_height{ 0 };
+		u8 m_currentBuffer{ 0 };
+		u64 m_presentCount{ 0 };
+		bool m_isFullscreen{ false };
+	};
+}
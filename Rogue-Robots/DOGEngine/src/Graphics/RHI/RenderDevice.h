@@ -22,7 +22,11 @@ namespace DOG::gfx
 		virtual TextureView CreateView(Texture texture, const TextureViewDesc& desc) = 0;
 		virtual MemoryPool CreateMemoryPool(const MemoryPoolDesc& desc) = 0;
 
-		virtual std::vector<Texture> CreateAliasedTextures(const std::vector<TextureDesc>& descs, MemoryPool = {}) = 0;
+		// One allocation of heapSize bytes from the pool with each resource placed at its offset (aligned to PLACEMENT_ALIGNMENT).
+		// Resources with overlapping ranges alias each other and need aliasing barriers between their uses.
+		static constexpr u64 PLACEMENT_ALIGNMENT = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		virtual std::vector<Texture> CreatePlacedTextures(const std::vector<TextureDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {}) = 0;
+		virtual std::vector<Buffer> CreatePlacedBuffers(const std::vector<BufferDesc>& descs, const std::vector<u64>& offsets, u64 heapSize, MemoryPool pool = {}) = 0;
 
 
 		virtual Monitor GetMonitor() = 0;
@@ -89,7 +93,8 @@ namespace DOG::gfx
 			std::span<GPUBarrier> barriers) = 0;
 
 		virtual void Cmd_BeginRenderPass(CommandList list,
-			RenderPass rp) = 0;
+			RenderPass rp,
+			RenderPassSplit split = RenderPassSplit::None) = 0;
 
 		virtual void Cmd_EndRenderPass(CommandList list) = 0;
 
@@ -43,6 +43,7 @@ namespace DOG::gfx
 			return barrier;
 		}
 
+		// Pass a null before resource when more than one resource may have been using the memory
 		static GPUBarrier Aliasing(Texture before, Texture after)
 		{
 			GPUBarrier barrier{};
@@ -54,6 +55,17 @@ namespace DOG::gfx
 			return barrier;
 		}
 
+		static GPUBarrier Aliasing(Buffer before, Buffer after)
+		{
+			GPUBarrier barrier{};
+			barrier.type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			barrier.resource = before.handle;
+			barrier.aliasResourceAfter = after.handle;
+			barrier.isBuffer = true;
+
+			return barrier;
+		}
+
 		static GPUBarrier UAV(Texture resource)
 		{
 			GPUBarrier barrier{};
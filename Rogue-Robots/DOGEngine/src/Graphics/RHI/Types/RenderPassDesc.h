@@ -71,6 +71,16 @@ namespace DOG::gfx
 		RenderPassEndingAccessType stencilEndAccess;
 	};
 
+	// A render pass recorded over several command lists. The parts use the same RenderPass, begin accesses only apply to the first
+	// and end accesses only to the last part. All parts have to be submitted in order in the same SubmitCommandLists call.
+	enum class RenderPassSplit : u8
+	{
+		None,
+		First,
+		Middle,
+		Last,
+	};
+
 	enum class RenderPassFlag : u8
 	{
 		None,
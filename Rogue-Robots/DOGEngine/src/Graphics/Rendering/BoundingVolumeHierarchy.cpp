@@ -0,0 +1,312 @@
+#include "BoundingVolumeHierarchy.h"
+
+using namespace DirectX::SimpleMath;
+
+namespace DOG::gfx
+{
+	void StaticBVH::Build(std::vector<Item>& items)
+	{
+		Clear();
+		if (items.empty())
+			return;
+
+		m_nodes.reserve(2 * (items.size() / LEAF_SIZE + 1));
+		m_nodes.emplace_back();
+		BuildNode(0, items, 0, static_cast<u32>(items.size()));
+	}
+
+	void StaticBVH::Clear()
+	{
+		m_nodes.clear();
+		m_leafBounds.Clear();
+		m_leafIDs.clear();
+	}
+
+	void StaticBVH::BuildNode(u32 nodeIndex, std::vector<Item>& items, u32 begin, u32 end)
+	{
+		Vector3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+		Vector3 centerMin(FLT_MAX), centerMax(-FLT_MAX);
+		for (u32 i = begin; i < end; ++i)
+		{
+			const Vector3 center = items[i].bounds.Center;
+			const Vector3 extents = items[i].bounds.Extents;
+			boundsMin = Vector3::Min(boundsMin, center - extents);
+			boundsMax = Vector3::Max(boundsMax, center + extents);
+			centerMin = Vector3::Min(centerMin, center);
+			centerMax = Vector3::Max(centerMax, center);
+		}
+
+		{
+			Node& node = m_nodes[nodeIndex];
+			node.center = (boundsMin + boundsMax) * 0.5f;
+			node.extents = (boundsMax - boundsMin) * 0.5f;
+		}
+
+		const u32 count = end - begin;
+		if (count <= LEAF_SIZE)
+		{
+			Node& node = m_nodes[nodeIndex];
+			node.first = m_leafBounds.Size();
+			node.count = count;
+			for (u32 i = begin; i < end; ++i)
+			{
+				m_leafBounds.Push(items[i].bounds.Center, items[i].bounds.Extents);
+				m_leafIDs.push_back(items[i].id);
+			}
+			m_leafBounds.Resize(node.first + LEAF_SIZE);
+			m_leafIDs.resize(node.first + LEAF_SIZE, NO_ITEM);
+			return;
+		}
+
+		// Median split along the axis where the item centers are spread the most, level blocks are evenly sized so this stays close to SAH
+		const Vector3 spread = centerMax - centerMin;
+		const u32 axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+		const u32 middle = begin + count / 2;
+		std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end, [axis](const Item& a, const Item& b)
+			{
+				return (&a.bounds.Center.x)[axis] < (&b.bounds.Center.x)[axis];
+			});
+
+		const u32 firstChild = static_cast<u32>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes.emplace_back();
+		m_nodes[nodeIndex].first = firstChild;
+		m_nodes[nodeIndex].count = 0;
+
+		BuildNode(firstChild, items, begin, middle);
+		BuildNode(firstChild + 1, items, middle, end);
+	}
+
+
+
+	u32 DynamicBVH::Insert(const DirectX::BoundingBox& bounds, u32 id)
+	{
+		const u32 leaf = AllocateNode();
+		const Vector3 margin(MARGIN);
+		m_nodes[leaf].min = Vector3(bounds.Center) - Vector3(bounds.Extents) - margin;
+		m_nodes[leaf].max = Vector3(bounds.Center) + Vector3(bounds.Extents) + margin;
+		m_nodes[leaf].id = id;
+		m_nodes[leaf].height = 0;
+		InsertLeaf(leaf);
+		return leaf;
+	}
+
+	void DynamicBVH::Remove(u32 proxy)
+	{
+		assert(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+	}
+
+	bool DynamicBVH::Move(u32 proxy, const DirectX::BoundingBox& bounds)
+	{
+		assert(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+		const Vector3 boundsMin = Vector3(bounds.Center) - Vector3(bounds.Extents);
+		const Vector3 boundsMax = Vector3(bounds.Center) + Vector3(bounds.Extents);
+
+		Node& node = m_nodes[proxy];
+		if (node.min.x <= boundsMin.x && node.min.y <= boundsMin.y && node.min.z <= boundsMin.z &&
+			node.max.x >= boundsMax.x && node.max.y >= boundsMax.y && node.max.z >= boundsMax.z)
+			return false;
+
+		RemoveLeaf(proxy);
+		const Vector3 margin(MARGIN);
+		m_nodes[proxy].min = boundsMin - margin;
+		m_nodes[proxy].max = boundsMax + margin;
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicBVH::Clear()
+	{
+		m_nodes.clear();
+		m_root = NULL_NODE;
+		m_freeList = NULL_NODE;
+	}
+
+	u32 DynamicBVH::AllocateNode()
+	{
+		if (m_freeList == NULL_NODE)
+		{
+			m_nodes.emplace_back();
+			return static_cast<u32>(m_nodes.size() - 1);
+		}
+
+		const u32 node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+		m_nodes[node] = Node();
+		return node;
+	}
+
+	void DynamicBVH::FreeNode(u32 node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	void DynamicBVH::InsertLeaf(u32 leaf)
+	{
+		if (m_root == NULL_NODE)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = NULL_NODE;
+			return;
+		}
+
+		auto area = [](const Vector3& min, const Vector3& max)
+		{
+			const Vector3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		};
+
+		// Walk down to the cheapest sibling by the surface area heuristic
+		const Vector3 leafMin = m_nodes[leaf].min;
+		const Vector3 leafMax = m_nodes[leaf].max;
+		u32 index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node& node = m_nodes[index];
+			const f32 nodeArea = area(node.min, node.max);
+			const f32 combinedArea = area(Vector3::Min(node.min, leafMin), Vector3::Max(node.max, leafMax));
+
+			// Cost of making a new parent for this node and the leaf, and the cost pushed down to the children
+			const f32 cost = 2.0f * combinedArea;
+			const f32 inheritanceCost = 2.0f * (combinedArea - nodeArea);
+
+			auto childCost = [&](u32 child)
+			{
+				const Node& c = m_nodes[child];
+				const f32 merged = area(Vector3::Min(c.min, leafMin), Vector3::Max(c.max, leafMax));
+				return c.IsLeaf() ? merged + inheritanceCost : merged - area(c.min, c.max) + inheritanceCost;
+			};
+			const f32 cost1 = childCost(node.child1);
+			const f32 cost2 = childCost(node.child2);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		const u32 sibling = index;
+		const u32 oldParent = m_nodes[sibling].parent;
+		const u32 newParent = AllocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].min = Vector3::Min(m_nodes[sibling].min, leafMin);
+		m_nodes[newParent].max = Vector3::Max(m_nodes[sibling].max, leafMax);
+		m_nodes[newParent].height = m_nodes[sibling].height + 1;
+		m_nodes[newParent].child1 = sibling;
+		m_nodes[newParent].child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == NULL_NODE)
+			m_root = newParent;
+		else if (m_nodes[oldParent].child1 == sibling)
+			m_nodes[oldParent].child1 = newParent;
+		else
+			m_nodes[oldParent].child2 = newParent;
+
+		Refit(newParent);
+	}
+
+	void DynamicBVH::RemoveLeaf(u32 leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NULL_NODE;
+			return;
+		}
+
+		const u32 parent = m_nodes[leaf].parent;
+		const u32 grandParent = m_nodes[parent].parent;
+		const u32 sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		if (grandParent == NULL_NODE)
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NULL_NODE;
+			FreeNode(parent);
+			return;
+		}
+
+		if (m_nodes[grandParent].child1 == parent)
+			m_nodes[grandParent].child1 = sibling;
+		else
+			m_nodes[grandParent].child2 = sibling;
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+
+	void DynamicBVH::Refit(u32 node)
+	{
+		while (node != NULL_NODE)
+		{
+			node = Balance(node);
+
+			Node& n = m_nodes[node];
+			const Node& c1 = m_nodes[n.child1];
+			const Node& c2 = m_nodes[n.child2];
+			n.height = 1 + std::max(c1.height, c2.height);
+			n.min = Vector3::Min(c1.min, c2.min);
+			n.max = Vector3::Max(c1.max, c2.max);
+
+			node = n.parent;
+		}
+	}
+
+	u32 DynamicBVH::Balance(u32 a)
+	{
+		// Rotates the taller child up if the children differ more than one in height, returns the new root of the subtree
+		if (m_nodes[a].IsLeaf() || m_nodes[a].height < 2)
+			return a;
+
+		const u32 b = m_nodes[a].child1;
+		const u32 c = m_nodes[a].child2;
+		const i32 balance = m_nodes[c].height - m_nodes[b].height;
+		if (balance >= -1 && balance <= 1)
+			return a;
+
+		const u32 up = balance > 1 ? c : b;		// The taller child becomes the parent of a
+		const u32 stay = balance > 1 ? b : c;
+		const u32 f = m_nodes[up].child1;
+		const u32 g = m_nodes[up].child2;
+
+		// Swap a and up
+		m_nodes[up].child1 = a;
+		m_nodes[up].parent = m_nodes[a].parent;
+		m_nodes[a].parent = up;
+
+		if (m_nodes[up].parent == NULL_NODE)
+			m_root = up;
+		else if (m_nodes[m_nodes[up].parent].child1 == a)
+			m_nodes[m_nodes[up].parent].child1 = up;
+		else
+			m_nodes[m_nodes[up].parent].child2 = up;
+
+		// The taller grandchild stays under up, the other one moves down to a
+		const bool keepF = m_nodes[f].height > m_nodes[g].height;
+		const u32 keep = keepF ? f : g;
+		const u32 move = keepF ? g : f;
+		m_nodes[up].child2 = keep;
+		if (balance > 1)
+			m_nodes[a].child2 = move;
+		else
+			m_nodes[a].child1 = move;
+		m_nodes[move].parent = a;
+
+		Node& na = m_nodes[a];
+		na.min = Vector3::Min(m_nodes[stay].min, m_nodes[move].min);
+		na.max = Vector3::Max(m_nodes[stay].max, m_nodes[move].max);
+		na.height = 1 + std::max(m_nodes[stay].height, m_nodes[move].height);
+
+		Node& nu = m_nodes[up];
+		nu.min = Vector3::Min(na.min, m_nodes[keep].min);
+		nu.max = Vector3::Max(na.max, m_nodes[keep].max);
+		nu.height = 1 + std::max(na.height, m_nodes[keep].height);
+
+		return up;
+	}
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include "FrustumCuller.h"
+
+namespace DOG::gfx
+{
+	/*
+		Tree over world space boxes that never move. Built once, for example when a level has loaded,
+		after which a frustum query only visits the parts of the scene that some view can see.
+	*/
+	class StaticBVH
+	{
+	public:
+		static constexpr u32 LEAF_SIZE = FrustumCuller::GROUP_SIZE;
+		static constexpr u32 NO_ITEM = std::numeric_limits<u32>::max();
+
+		struct Item
+		{
+			DirectX::BoundingBox bounds;
+			u32 id{ NO_ITEM };
+		};
+
+		// Items are reordered
+		void Build(std::vector<Item>& items);
+		void Clear();
+		bool Empty() const { return m_nodes.empty(); }
+
+		// Calls visit(id, visibleViews) once for every item that is visible in at least one of views
+		template<typename F>
+		void Query(const FrustumCuller& culler, FrustumCuller::ViewMask views, F&& visit) const;
+
+	private:
+		// Leaves have count > 0 and their items at [first, first + LEAF_SIZE), internal nodes have their children at first and first + 1
+		struct Node
+		{
+			DirectX::XMFLOAT3 center;
+			u32 first{ 0 };
+			DirectX::XMFLOAT3 extents;
+			u32 count{ 0 };
+		};
+
+		void BuildNode(u32 nodeIndex, std::vector<Item>& items, u32 begin, u32 end);
+
+	private:
+		std::vector<Node> m_nodes;
+		FrustumCuller::Bounds m_leafBounds;		// Padded to LEAF_SIZE per leaf so a leaf is one SIMD group
+		std::vector<u32> m_leafIDs;
+	};
+
+	/*
+		Tree for boxes that move. Leaves are stored grown by a margin so an object only has to be
+		reinserted when it leaves its grown box, and the tree is kept balanced with rotations.
+	*/
+	class DynamicBVH
+	{
+	public:
+		static constexpr u32 NULL_NODE = std::numeric_limits<u32>::max();
+		static constexpr f32 MARGIN = 0.5f;
+
+		// Returns a proxy that stays valid until removed
+		u32 Insert(const DirectX::BoundingBox& bounds, u32 id);
+		void Remove(u32 proxy);
+		// Returns true if the proxy had to be reinserted
+		bool Move(u32 proxy, const DirectX::BoundingBox& bounds);
+		void Clear();
+
+		u32 GetID(u32 proxy) const { return m_nodes[proxy].id; }
+
+		// Calls visit(id, visibleViews) once for every item that is visible in at least one of views
+		template<typename F>
+		void Query(const FrustumCuller& culler, FrustumCuller::ViewMask views, F&& visit) const;
+
+	private:
+		struct Node
+		{
+			DirectX::SimpleMath::Vector3 min;
+			DirectX::SimpleMath::Vector3 max;
+			u32 id{ NULL_NODE };
+			u32 parent{ NULL_NODE };		// Next free node when not in use
+			u32 child1{ NULL_NODE };
+			u32 child2{ NULL_NODE };
+			i32 height{ 0 };				// -1 when free
+
+			bool IsLeaf() const { return child1 == NULL_NODE; }
+		};
+
+		u32 AllocateNode();
+		void FreeNode(u32 node);
+		void InsertLeaf(u32 leaf);
+		void RemoveLeaf(u32 leaf);
+		u32 Balance(u32 node);
+		void Refit(u32 node);
+
+	private:
+		std::vector<Node> m_nodes;
+		u32 m_root{ NULL_NODE };
+		u32 m_freeList{ NULL_NODE };
+	};
+
+	template<typename F>
+	void StaticBVH::Query(const FrustumCuller& culler, FrustumCuller::ViewMask views, F&& visit) const
+	{
+		if (m_nodes.empty() || !views)
+			return;
+
+		// Views a node is entirely inside of are not tested again further down
+		struct Entry
+		{
+			u32 node;
+			FrustumCuller::ViewMask partial;
+			FrustumCuller::ViewMask inside;
+		};
+		std::array<Entry, 64> stack;
+		u32 top = 0;
+		stack[top++] = { 0, views, 0 };
+
+		while (top > 0)
+		{
+			const Entry entry = stack[--top];
+			const Node& node = m_nodes[entry.node];
+
+			FrustumCuller::ViewMask inside = entry.inside;
+			FrustumCuller::ViewMask partial = 0;
+			if (entry.partial)
+			{
+				FrustumCuller::ViewMask newlyInside = 0;
+				partial = culler.TestBox(node.center, node.extents, entry.partial, newlyInside) & ~newlyInside;
+				inside |= newlyInside;
+			}
+			if (!(partial | inside))
+				continue;
+
+			if (node.count == 0)
+			{
+				// Built by median splits, the depth is about log2 of the leaf count
+				assert(top + 2 <= stack.size());
+				stack[top++] = { node.first, partial, inside };
+				stack[top++] = { node.first + 1, partial, inside };
+				continue;
+			}
+
+			std::array<FrustumCuller::ViewMask, LEAF_SIZE> visible;
+			visible.fill(inside);
+			if (partial)
+				culler.TestGroup(m_leafBounds, node.first, partial, visible.data());
+
+			for (u32 i = 0; i < node.count; ++i)
+			{
+				if (visible[i])
+					visit(m_leafIDs[node.first + i], visible[i]);
+			}
+		}
+	}
+
+	template<typename F>
+	void DynamicBVH::Query(const FrustumCuller& culler, FrustumCuller::ViewMask views, F&& visit) const
+	{
+		if (m_root == NULL_NODE || !views)
+			return;
+
+		struct Entry
+		{
+			u32 node;
+			FrustumCuller::ViewMask partial;
+			FrustumCuller::ViewMask inside;
+		};
+		// Balanced, so the depth stays far below this
+		std::array<Entry, 128> stack;
+		u32 top = 0;
+		stack[top++] = { m_root, views, 0 };
+
+		while (top > 0)
+		{
+			const Entry entry = stack[--top];
+			const Node& node = m_nodes[entry.node];
+
+			FrustumCuller::ViewMask inside = entry.inside;
+			FrustumCuller::ViewMask partial = 0;
+			if (entry.partial)
+			{
+				const DirectX::SimpleMath::Vector3 center = (node.min + node.max) * 0.5f;
+				const DirectX::SimpleMath::Vector3 extents = (node.max - node.min) * 0.5f;
+				FrustumCuller::ViewMask newlyInside = 0;
+				partial = culler.TestBox(center, extents, entry.partial, newlyInside) & ~newlyInside;
+				inside |= newlyInside;
+			}
+			if (!(partial | inside))
+				continue;
+
+			if (node.IsLeaf())
+			{
+				visit(node.id, partial | inside);
+				continue;
+			}
+			assert(top + 2 <= stack.size());
+			stack[top++] = { node.child1, partial, inside };
+			stack[top++] = { node.child2, partial, inside };
+		}
+	}
+}
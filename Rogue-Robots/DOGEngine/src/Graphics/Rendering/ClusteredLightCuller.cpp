@@ -0,0 +1,261 @@
+#include "ClusteredLightCuller.h"
+#include "LightTable.h"
+#include "../../common/ThreadPool.h"
+#include "../../common/MiniProfiler.h"
+
+namespace DOG::gfx
+{
+	ClusteredLightCuller::ClusteredLightCuller()
+	{
+		m_workers = std::make_unique<ThreadPool>(ThreadPool::DefaultWorkerCount(MAX_WORKERS), "Light clusterer");
+	}
+
+	ClusteredLightCuller::~ClusteredLightCuller() = default;
+
+	void ClusteredLightCuller::Cull(const Setup& setup, std::span<const Light> pointLights, std::span<const Light> spotLights, Result& out)
+	{
+		MINIPROFILE;
+		assert(setup.nearClip > 0.0f && setup.farClip > setup.nearClip);
+		assert(setup.depthSlices > 0 && setup.tileSize > 0);
+
+		BuildClusterBounds(setup);
+
+		// Points before spots, every cluster list keeps that order
+		m_binned.clear();
+		BinnedLight binned;
+		for (const auto& light : pointLights)
+			if (BinLight(setup, light, false, binned))
+				m_binned.push_back(binned);
+		for (const auto& light : spotLights)
+			if (BinLight(setup, light, true, binned))
+				m_binned.push_back(binned);
+
+		m_slices.resize(setup.depthSlices);
+		m_workers->ParallelFor(setup.depthSlices, [this](u32 slice) { CullSlice(slice, m_slices[slice]); });
+
+		out.clustersX = m_clustersX;
+		out.clustersY = m_clustersY;
+		out.clustersZ = setup.depthSlices;
+		out.clusters.clear();
+		out.lightIndices.clear();
+		for (const auto& slice : m_slices)
+		{
+			const u32 base = static_cast<u32>(out.lightIndices.size());
+			for (auto cluster : slice.clusters)
+			{
+				cluster.offset += base;
+				out.clusters.push_back(cluster);
+			}
+			out.lightIndices.insert(out.lightIndices.end(), slice.lightIndices.begin(), slice.lightIndices.end());
+		}
+
+		m_stats = {};
+		m_stats.clusters = static_cast<u32>(out.clusters.size());
+		m_stats.pointLights = static_cast<u32>(pointLights.size());
+		m_stats.spotLights = static_cast<u32>(spotLights.size());
+		m_stats.assignments = out.lightIndices.size();
+		for (const auto& cluster : out.clusters)
+		{
+			const u32 count = cluster.pointCount + cluster.spotCount;
+			m_stats.occupiedClusters += count > 0;
+			m_stats.maxLightsPerCluster = std::max(m_stats.maxLightsPerCluster, count);
+
+			u32 bucket = 0;
+			while (bucket < Stats::HISTOGRAM_BUCKETS - 1 && (count >> bucket) > 0)
+				++bucket;
+			++m_stats.histogram[bucket];
+		}
+	}
+
+	void ClusteredLightCuller::GatherLights(const LightTable& table, std::vector<Light>& pointLights, std::vector<Light>& spotLights)
+	{
+		pointLights.clear();
+		spotLights.clear();
+
+		const auto points = table.GetPointLights();
+		for (u32 i = 0; i < points.size(); ++i)
+		{
+			if (points[i].strength == 0.0f || points[i].radius <= 0.0f)
+				continue;
+			pointLights.push_back({ points[i].position, points[i].radius, i });
+		}
+
+		const auto spots = table.GetSpotLights();
+		for (u32 i = 0; i < spots.size(); ++i)
+		{
+			if (spots[i].strength == 0.0f || spots[i].range <= 0.0f)
+				continue;
+			const DirectX::SimpleMath::Vector3 position(spots[i].position.x, spots[i].position.y, spots[i].position.z);
+			spotLights.push_back(BoundSpotLight(position, spots[i].direction, spots[i].cutoffAngle, spots[i].range, i));
+		}
+	}
+
+	ClusteredLightCuller::Light ClusteredLightCuller::BoundSpotLight(const DirectX::SimpleMath::Vector3& position, const DirectX::SimpleMath::Vector3& direction, f32 cutoffAngle, f32 range, u32 index)
+	{
+		DirectX::SimpleMath::Vector3 dir = direction;
+		dir.Normalize();
+
+		// Narrow cones are bound by the sphere through the apex and the cap rim, wide ones by the sphere around the cap
+		const f32 angle = DirectX::XMConvertToRadians(cutoffAngle);
+		const f32 cosAngle = std::cos(angle);
+		Light light;
+		light.index = index;
+		if (cosAngle <= 0.0f)
+		{
+			light.center = position;
+			light.radius = range;
+		}
+		else if (angle > DirectX::XM_PIDIV4)
+		{
+			light.center = position + dir * range * cosAngle;
+			light.radius = range * std::sin(angle);
+		}
+		else
+		{
+			light.radius = range / (2.0f * cosAngle);
+			light.center = position + dir * light.radius;
+		}
+		return light;
+	}
+
+	u32 ClusteredLightCuller::GetDepthSlice(const Setup& setup, f32 viewDepth)
+	{
+		if (viewDepth <= setup.nearClip)
+			return 0;
+		const f32 slice = std::log(viewDepth / setup.nearClip) / std::log(setup.farClip / setup.nearClip) * setup.depthSlices;
+		return std::min(static_cast<u32>(slice), setup.depthSlices - 1);
+	}
+
+	f32 ClusteredLightCuller::GetSliceDepth(const Setup& setup, u32 slice)
+	{
+		return setup.nearClip * std::pow(setup.farClip / setup.nearClip, static_cast<f32>(slice) / setup.depthSlices);
+	}
+
+	void ClusteredLightCuller::BuildClusterBounds(const Setup& setup)
+	{
+		const bool unchanged = !m_clusterBounds.empty() &&
+			m_boundsSetup.proj == setup.proj &&
+			m_boundsSetup.width == setup.width && m_boundsSetup.height == setup.height &&
+			m_boundsSetup.tileSize == setup.tileSize && m_boundsSetup.depthSlices == setup.depthSlices &&
+			m_boundsSetup.nearClip == setup.nearClip && m_boundsSetup.farClip == setup.farClip;
+		if (unchanged)
+			return;
+
+		m_boundsSetup = setup;
+		m_clustersX = (setup.width + setup.tileSize - 1) / setup.tileSize;
+		m_clustersY = (setup.height + setup.tileSize - 1) / setup.tileSize;
+		m_clusterBounds.resize(m_clustersX * m_clustersY * setup.depthSlices);
+
+		// NDC to view space at depth z is ndc * z / p, the extremes of a tile are at its near or far depth
+		const f32 invP11 = 1.0f / setup.proj._11;
+		const f32 invP22 = 1.0f / setup.proj._22;
+		auto extremes = [](f32 ndcMin, f32 ndcMax, f32 zNear, f32 zFar, f32 invP)
+		{
+			return std::pair(std::min(ndcMin * zNear, ndcMin * zFar) * invP, std::max(ndcMax * zNear, ndcMax * zFar) * invP);
+		};
+
+		for (u32 z = 0; z < setup.depthSlices; ++z)
+		{
+			const f32 zNear = GetSliceDepth(setup, z);
+			const f32 zFar = GetSliceDepth(setup, z + 1);
+			for (u32 y = 0; y < m_clustersY; ++y)
+			{
+				const f32 ndcTop = 1.0f - 2.0f * (y * setup.tileSize) / setup.height;
+				const f32 ndcBottom = std::max(1.0f - 2.0f * ((y + 1) * setup.tileSize) / setup.height, -1.0f);
+				const auto [minY, maxY] = extremes(ndcBottom, ndcTop, zNear, zFar, invP22);
+
+				for (u32 x = 0; x < m_clustersX; ++x)
+				{
+					const f32 ndcLeft = 2.0f * (x * setup.tileSize) / setup.width - 1.0f;
+					const f32 ndcRight = std::min(2.0f * ((x + 1) * setup.tileSize) / setup.width - 1.0f, 1.0f);
+					const auto [minX, maxX] = extremes(ndcLeft, ndcRight, zNear, zFar, invP11);
+
+					auto& bounds = m_clusterBounds[x + m_clustersX * (y + m_clustersY * z)];
+					DirectX::BoundingBox::CreateFromPoints(bounds, DirectX::XMVectorSet(minX, minY, zNear, 0.0f), DirectX::XMVectorSet(maxX, maxY, zFar, 0.0f));
+				}
+			}
+		}
+	}
+
+	bool ClusteredLightCuller::BinLight(const Setup& setup, const Light& light, bool spot, BinnedLight& out) const
+	{
+		const auto center = DirectX::SimpleMath::Vector3::Transform(light.center, setup.view);
+		const f32 r = light.radius;
+		if (center.z + r < setup.nearClip || center.z - r > setup.farClip)
+			return false;
+
+		const f32 zMin = std::max(center.z - r, setup.nearClip);
+		const f32 zMax = std::min(center.z + r, setup.farClip);
+
+		// Projected extent of the view space AABB around the sphere, x / z is extreme at a corner of the box
+		auto project = [zMin, zMax](f32 lo, f32 hi, f32 p)
+		{
+			return std::pair(std::min(lo / zMin, lo / zMax) * p, std::max(hi / zMin, hi / zMax) * p);
+		};
+		const auto [ndcMinX, ndcMaxX] = project(center.x - r, center.x + r, setup.proj._11);
+		const auto [ndcMinY, ndcMaxY] = project(center.y - r, center.y + r, setup.proj._22);
+		if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f)
+			return false;
+
+		auto toTile = [&setup](f32 pixel, u32 count)
+		{
+			return static_cast<u32>(std::clamp(pixel / setup.tileSize, 0.0f, static_cast<f32>(count - 1)));
+		};
+
+		out.center = center;
+		out.radius = r;
+		out.index = light.index;
+		out.spot = spot;
+		out.minX = toTile((ndcMinX + 1.0f) * 0.5f * setup.width, m_clustersX);
+		out.maxX = toTile((ndcMaxX + 1.0f) * 0.5f * setup.width, m_clustersX);
+		out.minY = toTile((1.0f - ndcMaxY) * 0.5f * setup.height, m_clustersY);
+		out.maxY = toTile((1.0f - ndcMinY) * 0.5f * setup.height, m_clustersY);
+		out.minZ = GetDepthSlice(setup, zMin);
+		out.maxZ = GetDepthSlice(setup, zMax);
+		return true;
+	}
+
+	void ClusteredLightCuller::CullSlice(u32 slice, SliceOutput& out) const
+	{
+		const u32 clustersPerSlice = m_clustersX * m_clustersY;
+		const DirectX::BoundingBox* sliceBounds = &m_clusterBounds[clustersPerSlice * slice];
+
+		out.clusters.assign(clustersPerSlice, {});
+		out.hits.clear();
+		for (const auto& light : m_binned)
+		{
+			if (slice < light.minZ || slice > light.maxZ)
+				continue;
+
+			const DirectX::BoundingSphere sphere(light.center, light.radius);
+			for (u32 y = light.minY; y <= light.maxY; ++y)
+			{
+				for (u32 x = light.minX; x <= light.maxX; ++x)
+				{
+					const u32 cluster = x + m_clustersX * y;
+					if (!sliceBounds[cluster].Intersects(sphere))
+						continue;
+
+					out.hits.push_back({ cluster, light.index });
+					if (light.spot)
+						++out.clusters[cluster].spotCount;
+					else
+						++out.clusters[cluster].pointCount;
+				}
+			}
+		}
+
+		// Counting sort on the cluster, hits are in light order so points stay ahead of spots
+		u32 offset = 0;
+		for (auto& cluster : out.clusters)
+		{
+			cluster.offset = offset;
+			offset += cluster.pointCount + cluster.spotCount;
+		}
+
+		out.written.assign(clustersPerSlice, 0);
+		out.lightIndices.resize(offset);
+		for (const auto& [cluster, index] : out.hits)
+			out.lightIndices[out.clusters[cluster].offset + out.written[cluster]++] = index;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+namespace DOG { class ThreadPool; }
+
+namespace DOG::gfx
+{
+	class LightTable;
+
+	/*
+		Assigns point and spot lights to clusters, screen tiles split into exponentially sized view space depth slices.
+		Unlike 2D tiles a cluster only spans a small depth range, so a light in front of a wall is not assigned to the geometry behind it.
+
+		Lights are bound as spheres. Each light is projected to the range of clusters its bounds overlap, and every cluster in that range
+		is then tested against the sphere. The depth slices are spread over a thread pool. Runs on the CPU only, so it needs no device.
+	*/
+	class ClusteredLightCuller
+	{
+	public:
+		static constexpr u32 DEFAULT_TILE_SIZE = 64;
+		static constexpr u32 DEFAULT_DEPTH_SLICES = 24;
+		static constexpr u32 MAX_WORKERS = 7;
+
+		struct Setup
+		{
+			DirectX::SimpleMath::Matrix view;
+			DirectX::SimpleMath::Matrix proj;
+			u32 width{ 0 };
+			u32 height{ 0 };
+			u32 tileSize{ DEFAULT_TILE_SIZE };
+			u32 depthSlices{ DEFAULT_DEPTH_SLICES };
+			// Positive view space depths
+			f32 nearClip{ 0.1f };
+			f32 farClip{ 1000.0f };
+		};
+
+		// World space bounding sphere, index is the value written to the cluster lists
+		struct Light
+		{
+			DirectX::SimpleMath::Vector3 center;
+			f32 radius{ 0.0f };
+			u32 index{ 0 };
+		};
+
+		// The point light indices of a cluster followed by its spot light indices, starting at offset in Result::lightIndices
+		struct Cluster
+		{
+			u32 offset{ 0 };
+			u32 pointCount{ 0 };
+			u32 spotCount{ 0 };
+		};
+
+		struct Result
+		{
+			u32 clustersX{ 0 };
+			u32 clustersY{ 0 };
+			u32 clustersZ{ 0 };
+			std::vector<Cluster> clusters;
+			std::vector<u32> lightIndices;
+
+			u32 GetClusterIndex(u32 x, u32 y, u32 z) const { return x + clustersX * (y + clustersY * z); }
+		};
+
+		// Summary of the last Cull for profiling
+		struct Stats
+		{
+			static constexpr u32 HISTOGRAM_BUCKETS = 8;
+
+			u32 clusters{ 0 };
+			u32 occupiedClusters{ 0 };
+			u32 maxLightsPerCluster{ 0 };
+			u32 pointLights{ 0 };
+			u32 spotLights{ 0 };
+			u64 assignments{ 0 };
+			// Bucket b counts clusters with [2^(b-1), 2^b) lights, bucket 0 the empty ones, the last one everything above
+			std::array<u32, HISTOGRAM_BUCKETS> histogram{};
+		};
+
+	public:
+		ClusteredLightCuller();
+		~ClusteredLightCuller();
+
+		void Cull(const Setup& setup, std::span<const Light> pointLights, std::span<const Light> spotLights, Result& out);
+		const Stats& GetStats() const { return m_stats; }
+
+		// Lights of the table with a non zero strength, the index is the slot in the table
+		static void GatherLights(const LightTable& table, std::vector<Light>& pointLights, std::vector<Light>& spotLights);
+
+		// Bounding sphere of a cone, cutoffAngle is the half angle in degrees
+		static Light BoundSpotLight(const DirectX::SimpleMath::Vector3& position, const DirectX::SimpleMath::Vector3& direction, f32 cutoffAngle, f32 range, u32 index);
+
+		// Slices are spaced so that depth(slice) = near * (far / near)^(slice / slices)
+		static u32 GetDepthSlice(const Setup& setup, f32 viewDepth);
+		static f32 GetSliceDepth(const Setup& setup, u32 slice);
+
+	private:
+		// A light in view space and the clusters its bounds overlap, inclusive
+		struct BinnedLight
+		{
+			DirectX::SimpleMath::Vector3 center;
+			f32 radius;
+			u32 index;
+			bool spot;
+			u32 minX, maxX, minY, maxY, minZ, maxZ;
+		};
+
+		struct SliceOutput
+		{
+			std::vector<Cluster> clusters;
+			std::vector<u32> lightIndices;
+			std::vector<std::pair<u32, u32>> hits;		// { local cluster, light index }
+			std::vector<u32> written;
+		};
+
+		void BuildClusterBounds(const Setup& setup);
+		bool BinLight(const Setup& setup, const Light& light, bool spot, BinnedLight& out) const;
+		void CullSlice(u32 slice, SliceOutput& out) const;
+
+	private:
+		std::unique_ptr<ThreadPool> m_workers;
+
+		// View space AABB per cluster, rebuilt when the setup changes
+		Setup m_boundsSetup;
+		std::vector<DirectX::BoundingBox> m_clusterBounds;
+		u32 m_clustersX{ 0 };
+		u32 m_clustersY{ 0 };
+
+		std::vector<BinnedLight> m_binned;
+		std::vector<SliceOutput> m_slices;
+		Stats m_stats;
+	};
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <bit>
+
+namespace DOG::gfx
+{
+	/*
+		One dirty bit per element of a table or chunk.
+		Coalesce turns the set bits into the copy regions to upload, so a handful of changed elements
+		in a large chunk costs a handful of small copies instead of a copy of the whole chunk.
+	*/
+	class DirtyRanges
+	{
+	public:
+		// { first element, element count }
+		using Range = std::pair<u32, u32>;
+
+	public:
+		DirtyRanges() = default;
+		explicit DirtyRanges(u32 elementCount) { Resize(elementCount); }
+
+		// Clears every bit
+		void Resize(u32 elementCount)
+		{
+			m_size = elementCount;
+			m_bits.assign((elementCount + 63) / 64, 0);
+		}
+
+		void Mark(u32 element)
+		{
+			assert(element < m_size);
+			m_bits[element / 64] |= 1ull << (element % 64);
+		}
+
+		void Mark(u32 first, u32 count)
+		{
+			assert(first + count <= m_size);
+			for (u32 i = first; i < first + count;)
+			{
+				// Whole words at a time
+				const u32 bit = i % 64;
+				const u32 bits = std::min(64 - bit, first + count - i);
+				const u64 mask = bits == 64 ? ~0ull : ((1ull << bits) - 1) << bit;
+				m_bits[i / 64] |= mask;
+				i += bits;
+			}
+		}
+
+		void MarkAll() { Mark(0, m_size); }
+
+		void Merge(const DirtyRanges& other)
+		{
+			assert(other.m_size == m_size);
+			for (u32 i = 0; i < m_bits.size(); ++i)
+				m_bits[i] |= other.m_bits[i];
+		}
+
+		void Clear() { std::fill(m_bits.begin(), m_bits.end(), 0); }
+
+		bool Any() const
+		{
+			return std::any_of(m_bits.begin(), m_bits.end(), [](u64 word) { return word != 0; });
+		}
+
+		u32 Count() const
+		{
+			u32 count = 0;
+			for (u64 word : m_bits)
+				count += std::popcount(word);
+			return count;
+		}
+
+		u32 Size() const { return m_size; }
+
+		/*
+			Appends the dirty runs to out in ascending order.
+			Runs separated by at most maxGap clean elements are joined, re-uploading a few clean elements is cheaper than another copy.
+		*/
+		void Coalesce(std::vector<Range>& out, u32 maxGap = 0) const
+		{
+			const size_t firstOut = out.size();
+			u32 i = 0;
+			while (i < m_size)
+			{
+				const u32 start = FindNext(i, true);
+				if (start >= m_size)
+					break;
+				const u32 end = std::min(FindNext(start, false), m_size);
+
+				if (out.size() > firstOut && start - (out.back().first + out.back().second) <= maxGap)
+					out.back().second = end - out.back().first;
+				else
+					out.push_back({ start, end - start });
+				i = end;
+			}
+		}
+
+	private:
+		// First element at or after 'from' whose bit is 'set', m_size if there is none
+		u32 FindNext(u32 from, bool set) const
+		{
+			for (u32 word = from / 64; word < m_bits.size(); ++word)
+			{
+				u64 bits = set ? m_bits[word] : ~m_bits[word];
+				if (word == from / 64)
+					bits &= ~0ull << (from % 64);
+				if (bits)
+					return std::min(word * 64 + (u32)std::countr_zero(bits), m_size);
+			}
+			return m_size;
+		}
+
+	private:
+		std::vector<u64> m_bits;
+		u32 m_size{ 0 };
+	};
+}
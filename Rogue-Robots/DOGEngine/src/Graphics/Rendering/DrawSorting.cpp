@@ -0,0 +1,68 @@
+#include "DrawSorting.h"
+
+namespace DOG::gfx
+{
+	u64 DrawKey::Make(u32 pipeline, u32 globalSubmesh, u32 material, f32 viewDepth) noexcept
+	{
+		assert(pipeline < (1u << PIPELINE_BITS));
+		assert(globalSubmesh < (1u << SUBMESH_BITS));
+		assert(material < (1u << MATERIAL_BITS));
+
+		// The bit pattern of a positive float grows with its value, keep the top bits below the sign bit
+		if (!(viewDepth > 0.f))
+			viewDepth = 0.f;
+		u32 depthBits;
+		std::memcpy(&depthBits, &viewDepth, sizeof(depthBits));
+		depthBits >>= 31 - DEPTH_BITS;
+
+		u64 key = pipeline;
+		key = (key << SUBMESH_BITS) | globalSubmesh;
+		key = (key << MATERIAL_BITS) | material;
+		key = (key << DEPTH_BITS) | depthBits;
+		return key;
+	}
+
+	void RadixSort(std::vector<SortedDraw>& draws, std::vector<SortedDraw>& scratch)
+	{
+		if (draws.size() < 2)
+			return;
+
+		// Bytes that differ between any key and the first one are the only ones worth a pass
+		u64 varyingBits = 0;
+		const u64 firstKey = draws.front().key;
+		for (const auto& draw : draws)
+			varyingBits |= draw.key ^ firstKey;
+
+		scratch.resize(draws.size());
+		SortedDraw* src = draws.data();
+		SortedDraw* dst = scratch.data();
+		const size_t count = draws.size();
+
+		for (u32 shift = 0; shift < 64; shift += 8)
+		{
+			if (((varyingBits >> shift) & 0xFF) == 0)
+				continue;
+
+			std::array<u32, 256> offsets{};
+			for (size_t i = 0; i < count; ++i)
+				++offsets[(src[i].key >> shift) & 0xFF];
+
+			u32 sum = 0;
+			for (auto& offset : offsets)
+			{
+				const u32 bucketCount = offset;
+				offset = sum;
+				sum += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+				dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+			std::swap(src, dst);
+		}
+
+		// Odd number of passes leaves the result in scratch
+		if (src != draws.data())
+			draws.swap(scratch);
+	}
+}
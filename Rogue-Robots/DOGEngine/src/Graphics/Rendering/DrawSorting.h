@@ -0,0 +1,35 @@
+#pragma once
+
+namespace DOG::gfx
+{
+	/*
+		64 bit draw key, most significant field first so that sorting groups draws by pipeline, then by mesh and material and finally front to back.
+		| pipeline 4 | submesh 24 | material 16 | depth 20 |
+		The submesh field holds the global submesh index, so it identifies both the mesh and the submesh.
+	*/
+	struct DrawKey
+	{
+		static constexpr u32 DEPTH_BITS = 20;
+		static constexpr u32 MATERIAL_BITS = 16;
+		static constexpr u32 SUBMESH_BITS = 24;
+		static constexpr u32 PIPELINE_BITS = 4;
+		static_assert(DEPTH_BITS + MATERIAL_BITS + SUBMESH_BITS + PIPELINE_BITS == 64);
+
+		// Negative depths (behind the camera) are clamped to 0
+		static u64 Make(u32 pipeline, u32 globalSubmesh, u32 material, f32 viewDepth) noexcept;
+
+		// Draws with equal state only differ in depth and can be merged into one instanced draw
+		static constexpr u64 State(u64 key) noexcept { return key >> DEPTH_BITS; }
+		static constexpr u32 Pipeline(u64 key) noexcept { return static_cast<u32>(key >> (64 - PIPELINE_BITS)); }
+	};
+
+	struct SortedDraw
+	{
+		u64 key{ 0 };
+		u32 index{ 0 };
+	};
+
+	// Stable LSD radix sort on the key, 8 bits per pass. Passes over bytes that are equal in every key are skipped,
+	// so a frame where only a few fields vary costs a few linear passes. scratch is resized and reused as the ping-pong buffer.
+	void RadixSort(std::vector<SortedDraw>& draws, std::vector<SortedDraw>& scratch);
+}
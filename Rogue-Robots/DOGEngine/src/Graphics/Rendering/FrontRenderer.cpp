@@ -49,6 +49,8 @@ namespace DOG::gfx
 	{
 		MINIPROFILE;
 
+		m_culler.Clear();
+
 		UpdateLights();
 		GatherShadowCasters();
 		SetRenderCamera();
@@ -87,6 +89,7 @@ namespace DOG::gfx
 					d.position = tr.GetPosition();
 					d.color = light.color;
 					d.cutoffAngle = light.cutoffAngle;
+					d.range = light.range;
 					d.direction = light.direction;
 					d.strength = light.strength;
 					d.id = light.id;
@@ -137,138 +140,419 @@ namespace DOG::gfx
 			});
 
 
-		// We need to bucket in a better way..
-		mgr.Bundle<TransformComponent, ModelComponent>().Do([&](entity e, TransformComponent& transformC, ModelComponent& modelC)
+		// Outlines are drawn regardless of culling
+		mgr.Collect<OutlineComponent, TransformComponent, ModelComponent>().Do([&](entity e, OutlineComponent& oc, TransformComponent& transformC, ModelComponent& modelC)
 			{
 				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(modelC);
+				if (!model || !model->gfxModel || mgr.HasComponent<ThisPlayerWeapon>(e) || mgr.HasComponent<DontDraw>(e))
+					return;
+
+				u32 jointOffset{ 0 };
+				bool animated{ false };
+				if (mgr.HasComponent<RigDataComponent>(e))
+				{
+					jointOffset = mgr.GetComponent<RigDataComponent>(e).offset;
+					animated = true;
+				}
+
+				for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
+					m_renderer->SubmitOutlinedMesh(model->gfxModel->mesh.mesh, i, oc.color, transformC, animated, jointOffset);
+			});
+
+		UpdateStaticScene();
+		UpdateDynamicScene();
+
+		// One traversal per tree answers every view, the main camera and all shadow casters
+		const FrustumCuller::ViewMask allViews = m_culler.GetAllViews();
+		m_staticScene.Query(m_culler, allViews, [&](u32 item, FrustumCuller::ViewMask views)
+			{
+				const StaticItem& staticItem = m_staticItems[item];
+				if (mgr.HasComponent<StaticBatchComponent>(staticItem.e))
+				{
+					SubmitStaticBatch(staticItem.e, mgr.GetComponent<StaticBatchComponent>(staticItem.e), staticItem.submesh, views);
+					return;
+				}
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(mgr.GetComponent<ModelComponent>(staticItem.e));
+				SubmitModel(staticItem.e, model, mgr.GetComponent<TransformComponent>(staticItem.e), staticItem.submesh, 1, views);
+			});
 
-				bool skipNormalRendering = false;
+		m_dynamicScene.Query(m_culler, allViews, [&](u32 id, FrustumCuller::ViewMask views)
+			{
+				const entity e = static_cast<entity>(id);
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(mgr.GetComponent<ModelComponent>(e));
+				if (model && model->gfxModel)
+					SubmitModel(e, model, mgr.GetComponent<TransformComponent>(e), 0, model->gfxModel->mesh.numSubmeshes, views);
+			});
 
-				// Non culled
+		for (const auto& unbounded : { &m_unboundedStatic, &m_unboundedDynamic })
+		{
+			for (entity e : *unbounded)
+			{
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(mgr.GetComponent<ModelComponent>(e));
 				if (model && model->gfxModel)
+					SubmitModel(e, model, mgr.GetComponent<TransformComponent>(e), 0, model->gfxModel->mesh.numSubmeshes, allViews);
+			}
+		}
+	}
+
+	void FrontRenderer::UpdateStaticScene()
+	{
+		auto& mgr = EntityManager::Get();
+
+		// Level blocks never move, so the tree only changes when blocks come or go or when their models finish loading
+		bool rebuild = mgr.GetComponentPoolVersion<ModularBlockComponent>() != m_staticVersion ||
+			mgr.GetComponentPoolVersion<StaticBatchComponent>() != m_staticBatchVersion;
+		for (entity e : m_pendingBatches)
+		{
+			if (mgr.Exists(e) && mgr.HasComponent<StaticBatchComponent>(e))
+				rebuild = MergeStaticBatch(mgr.GetComponent<StaticBatchComponent>(e)) || rebuild;
+		}
+		for (u32 i = 0; i < m_pendingStatic.size() && !rebuild; ++i)
+		{
+			const entity e = m_pendingStatic[i];
+			if (!mgr.Exists(e) || !mgr.HasComponent<ModelComponent>(e))
+			{
+				rebuild = true;
+				break;
+			}
+			ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(mgr.GetComponent<ModelComponent>(e));
+			rebuild = model && model->gfxModel;
+		}
+		if (!rebuild)
+			return;
+
+		MINIPROFILE_NAMED("BuildStaticBVH");
+
+		m_staticVersion = mgr.GetComponentPoolVersion<ModularBlockComponent>();
+		m_staticBatchVersion = mgr.GetComponentPoolVersion<StaticBatchComponent>();
+		m_staticItems.clear();
+		m_pendingStatic.clear();
+		m_pendingBatches.clear();
+		m_unboundedStatic.clear();
+
+		std::vector<StaticBVH::Item> items;
+		mgr.Collect<ModularBlockComponent, TransformComponent, ModelComponent>().Do([&](entity e, ModularBlockComponent&, TransformComponent& transformC, ModelComponent& modelC)
+			{
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(modelC);
+				if (!model || !model->gfxModel)
 				{
-					// Outline submission
-					if (mgr.HasComponent<OutlineComponent>(e) && !mgr.HasComponent<ThisPlayerWeapon>(e))
-					{
-						if (!mgr.HasComponent<DontDraw>(e))
-						{
-							u32 jointOffset{ 0 };
-							bool animated{ false };
-							if (mgr.HasComponent<RigDataComponent>(e))
-							{
-								jointOffset = mgr.GetComponent<RigDataComponent>(e).offset;
-								animated = true;
-							}
-
-							const auto& oc = mgr.GetComponent<OutlineComponent>(e);
-							if (oc.onlyOutline)
-								skipNormalRendering = true;
-
-							for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-								m_renderer->SubmitOutlinedMesh(model->gfxModel->mesh.mesh, i, oc.color, transformC, animated, jointOffset);
-						}
-					}
+					m_pendingStatic.push_back(e);
+					return;
+				}
+				if (model->submeshBounds.size() != model->gfxModel->mesh.numSubmeshes)
+				{
+					m_unboundedStatic.push_back(e);
+					return;
+				}
+
+				for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
+				{
+					items.push_back({ FrustumCuller::TransformBounds(model->submeshBounds[i], transformC.worldMatrix), static_cast<u32>(m_staticItems.size()) });
+					m_staticItems.push_back({ e, i });
 				}
+			});
 
-				if (skipNormalRendering)
+		mgr.Collect<StaticBatchComponent>().Do([&](entity e, StaticBatchComponent& batch)
+			{
+				if (!batch.merged && !MergeStaticBatch(batch))
+				{
+					m_pendingBatches.push_back(e);
 					return;
+				}
 
-				// Culled
-				auto&& cull = [&](const DirectX::SimpleMath::Matrix& viewMat, DirectX::SimpleMath::Vector3 p)
+				for (u32 i = 0; i < batch.submeshBounds.size(); ++i)
 				{
-					TransformComponent tc{};
-					tc.worldMatrix = viewMat.Invert();
-					auto camForward = tc.GetForward();
-					auto camPos = tc.GetPosition();
-
-					auto d = p - camPos;
-					auto lenSq = d.LengthSquared();
-					if (lenSq < 64) return false;
-					if (lenSq > 80 * 80) return true;
-					d.Normalize();
-					return camForward.Dot(d) < 0.2f;
-				};
-
-
-				bool renderToShadow = false;
-				for (const auto& pview : m_playerViews)
+					items.push_back({ batch.submeshBounds[i], static_cast<u32>(m_staticItems.size()) });
+					m_staticItems.push_back({ e, i });
+				}
+			});
+
+		m_staticScene.Build(items);
+	}
+
+	bool FrontRenderer::MergeStaticBatch(StaticBatchComponent& batch)
+	{
+		assert(!batch.merged);
+
+		// Materials come from the GPU side of the models and vertices from the CPU side, so both have to be done
+		std::vector<ModelAsset*> models;
+		models.reserve(batch.instances.size());
+		for (const auto& instance : batch.instances)
+		{
+			ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(instance.modelID);
+			if (!model || !model->gfxModel)
+				return false;
+			models.push_back(model);
+		}
+
+		MINIPROFILE_NAMED("MergeStaticBatch");
+
+		struct Group
+		{
+			std::vector<DirectX::SimpleMath::Vector3> positions, normals, tangents;
+			std::vector<DirectX::SimpleMath::Vector2> uvs;
+			std::vector<u32> indices;
+		};
+		std::vector<Group> groups;
+		std::unordered_map<u64, u32> groupOfMaterial;
+
+		batch.materials.clear();
+		for (u32 m = 0; m < models.size(); ++m)
+		{
+			ModelAsset* model = models[m];
+			auto& vertexData = model->meshAsset.vertexData;
+			if (vertexData[VertexAttribute::Position].empty())
+			{
+				assert(false && "StaticBatchComponent models need to be loaded with CPUMemory");
+				continue;
+			}
+
+			const u32 vertexCount = static_cast<u32>(vertexData[VertexAttribute::Position].size() / sizeof(DirectX::SimpleMath::Vector3));
+			const u32 indexCount = static_cast<u32>(model->meshAsset.indices.size());
+			const bool inRange = std::all_of(model->submeshes.begin(), model->submeshes.end(), [&](const SubmeshMetadata& submesh)
 				{
-					bool insideFrustum = !cull(pview, { transformC.worldMatrix(3, 0), transformC.worldMatrix(3, 1), transformC.worldMatrix(3, 2) });
-					renderToShadow |= insideFrustum;	// If inside any of players view --> Render to shadow
+					return submesh.vertexStart + submesh.vertexCount <= vertexCount && submesh.indexStart + submesh.indexCount <= indexCount;
+				});
+			if (!inRange || model->submeshes.size() > model->gfxModel->mats.size())
+			{
+				assert(false && "StaticBatchComponent model has submeshes outside of its vertex or index data");
+				continue;
+			}
+
+			// Attributes the model does not have for every vertex get defaults instead of being read out of bounds
+			auto attribute = [&](VertexAttribute attr, size_t stride) -> const u8*
+			{
+				return vertexData[attr].size() >= vertexCount * stride ? vertexData[attr].data() : nullptr;
+			};
+			const auto* positions = reinterpret_cast<const DirectX::SimpleMath::Vector3*>(vertexData[VertexAttribute::Position].data());
+			const auto* normals = reinterpret_cast<const DirectX::SimpleMath::Vector3*>(attribute(VertexAttribute::Normal, sizeof(DirectX::SimpleMath::Vector3)));
+			const auto* tangents = reinterpret_cast<const DirectX::SimpleMath::Vector3*>(attribute(VertexAttribute::Tangent, sizeof(DirectX::SimpleMath::Vector3)));
+			const auto* uvs = reinterpret_cast<const DirectX::SimpleMath::Vector2*>(attribute(VertexAttribute::UV, sizeof(DirectX::SimpleMath::Vector2)));
+			const auto& world = batch.instances[m].world;
+
+			for (u32 i = 0; i < model->submeshes.size(); ++i)
+			{
+				const MaterialHandle material = model->gfxModel->mats[i];
+				auto [it, inserted] = groupOfMaterial.try_emplace(material.handle, static_cast<u32>(groups.size()));
+				if (inserted)
+				{
+					groups.emplace_back();
+					batch.materials.push_back(material);
 				}
+				Group& group = groups[it->second];
 
-				if (model && model->gfxModel)
+				// Submesh indices are relative to the submesh vertices
+				const SubmeshMetadata& submesh = model->submeshes[i];
+				const u32 base = static_cast<u32>(group.positions.size());
+				for (u32 v = submesh.vertexStart; v < submesh.vertexStart + submesh.vertexCount; ++v)
 				{
-					// Shadow submission:
-					if (mgr.HasComponent<ShadowReceiverComponent>(e))
-					{
-						for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-						{
-							if (mgr.HasComponent<ModularBlockComponent>(e))
-								m_doubleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC, false });
-							else if (EntityManager::Get().HasComponent<RigDataComponent>(e))
-								m_doubleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC, false, true, EntityManager::Get().GetComponent<RigDataComponent>(e).offset });
-							else
-								m_singleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC });
-						}
-					}
+					group.positions.push_back(DirectX::SimpleMath::Vector3::Transform(positions[v], world));
+					auto normal = DirectX::SimpleMath::Vector3::TransformNormal(normals ? normals[v] : DirectX::SimpleMath::Vector3::UnitY, world);
+					normal.Normalize();
+					group.normals.push_back(normal);
+					auto tangent = DirectX::SimpleMath::Vector3::TransformNormal(tangents ? tangents[v] : DirectX::SimpleMath::Vector3::UnitX, world);
+					tangent.Normalize();
+					group.tangents.push_back(tangent);
+					group.uvs.push_back(uvs ? uvs[v] : DirectX::SimpleMath::Vector2::Zero);
+				}
+				for (u32 idx = submesh.indexStart; idx < submesh.indexStart + submesh.indexCount; ++idx)
+					group.indices.push_back(base + model->meshAsset.indices[idx]);
+			}
+		}
 
-					// Skip main view rendering
-					if (cull(m_viewMat, { transformC.worldMatrix(3, 0), transformC.worldMatrix(3, 1), transformC.worldMatrix(3, 2) }))
-						return;
+		// One submesh per material
+		std::vector<DirectX::SimpleMath::Vector3> positions, normals, tangents;
+		std::vector<DirectX::SimpleMath::Vector2> uvs;
+		std::vector<u32> indices;
+		MeshDesc desc;
+		batch.submeshBounds.clear();
+		for (const auto& group : groups)
+		{
+			SubmeshMetadata submesh{};
+			submesh.vertexStart = static_cast<u32>(positions.size());
+			submesh.vertexCount = static_cast<u32>(group.positions.size());
+			submesh.indexStart = static_cast<u32>(indices.size());
+			submesh.indexCount = static_cast<u32>(group.indices.size());
+			desc.submeshData.push_back(submesh);
+
+			auto& bounds = batch.submeshBounds.emplace_back();
+			DirectX::BoundingBox::CreateFromPoints(bounds, group.positions.size(), group.positions.data(), sizeof(DirectX::SimpleMath::Vector3));
+
+			positions.insert(positions.end(), group.positions.begin(), group.positions.end());
+			normals.insert(normals.end(), group.normals.begin(), group.normals.end());
+			tangents.insert(tangents.end(), group.tangents.begin(), group.tangents.end());
+			uvs.insert(uvs.end(), group.uvs.begin(), group.uvs.end());
+			indices.insert(indices.end(), group.indices.begin(), group.indices.end());
+		}
 
+		auto asBytes = [](auto& v) { return std::span<u8>(reinterpret_cast<u8*>(v.data()), v.size() * sizeof(v[0])); };
+		desc.vertexDataPerAttribute[VertexAttribute::Position] = asBytes(positions);
+		desc.vertexDataPerAttribute[VertexAttribute::Normal] = asBytes(normals);
+		desc.vertexDataPerAttribute[VertexAttribute::Tangent] = asBytes(tangents);
+		desc.vertexDataPerAttribute[VertexAttribute::UV] = asBytes(uvs);
+		desc.indices = indices;
+
+		if (!groups.empty())
+			batch.mesh = CustomMeshManager::Get().AddMesh(desc).first;
+		batch.merged = true;
+		return true;
+	}
 
-					if (mgr.HasComponent<ModularBlockComponent>(e))
-					{
-						if (mgr.HasComponent<MeshColliderComponent>(e) &&
-							mgr.GetComponent<MeshColliderComponent>(e).drawMeshColliderOverride)
-						{
-							u32 meshColliderModelID = mgr.GetComponent<MeshColliderComponent>(e).meshColliderModelID;
-							ModelAsset* meshColliderModel = AssetManager::Get().GetAsset<ModelAsset>(meshColliderModelID);
-							if (meshColliderModel && meshColliderModel->gfxModel)
-							{
-								for (u32 i = 0; i < meshColliderModel->gfxModel->mesh.numSubmeshes; ++i)
-									m_renderer->SubmitMeshWireframeNoFaceCulling(meshColliderModel->gfxModel->mesh.mesh, i, meshColliderModel->gfxModel->mats[i], transformC);
-							}
-						}
-						else
-						{
-							for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-								m_renderer->SubmitMeshNoFaceCulling(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
-						}
-					}
-					else if (mgr.HasComponent<RigDataComponent>(e))
-					{
-						auto offset = mgr.GetComponent<RigDataComponent>(e).offset;
-						if (!mgr.HasComponent<DontDraw>(e) || !mgr.GetComponent<DontDraw>(e).dontDraw)
-							for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-								m_renderer->SubmitAnimatedMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC, offset);
-					}
-					else
-					{
-						if (mgr.HasComponent<MeshColliderComponent>(e) &&
-							mgr.GetComponent<MeshColliderComponent>(e).drawMeshColliderOverride)
-						{
-							for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-								m_renderer->SubmitMeshWireframe(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
-						}
-						// Special case for weapon draws
-						else if (mgr.HasComponent<ThisPlayerWeapon>(e) && (!mgr.HasComponent<DontDraw>(e) || !mgr.GetComponent<DontDraw>(e).dontDraw))
-						{
-							for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-								m_renderer->SubmitMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC, true);
-						}
-						else
-						{
-							if (!mgr.HasComponent<DontDraw>(e) || !mgr.GetComponent<DontDraw>(e).dontDraw)
-								for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
-									m_renderer->SubmitMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
-						}
-					}
+	void FrontRenderer::UpdateDynamicScene()
+	{
+		auto& mgr = EntityManager::Get();
+		++m_frame;
+		m_unboundedDynamic.clear();
+
+		mgr.Bundle<TransformComponent, ModelComponent>().Do([&](entity e, TransformComponent& transformC, ModelComponent& modelC)
+			{
+				if (mgr.HasComponent<ModularBlockComponent>(e))
+					return;
+
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(modelC);
+				if (!model || !model->gfxModel)
+					return;
+
+				// The weapon view model is always in front of the camera
+				if (model->submeshBounds.empty() || model->submeshBounds.size() != model->gfxModel->mesh.numSubmeshes || mgr.HasComponent<ThisPlayerWeapon>(e))
+				{
+					m_unboundedDynamic.push_back(e);
+					return;
+				}
+
+				DirectX::BoundingBox bounds = model->submeshBounds[0];
+				for (auto& submeshBounds : model->submeshBounds)
+					DirectX::BoundingBox::CreateMerged(bounds, bounds, submeshBounds);
+
+				// Joints move submeshes around, so grow the bind pose box
+				if (mgr.HasComponent<RigDataComponent>(e))
+				{
+					bounds.Extents.x *= ANIMATED_BOUNDS_SCALE;
+					bounds.Extents.y *= ANIMATED_BOUNDS_SCALE;
+					bounds.Extents.z *= ANIMATED_BOUNDS_SCALE;
 				}
+				bounds = FrustumCuller::TransformBounds(bounds, transformC.worldMatrix);
+
+				auto [it, inserted] = m_dynamicProxies.try_emplace(e);
+				if (inserted)
+					it->second.proxy = m_dynamicScene.Insert(bounds, e);
+				else
+					m_dynamicScene.Move(it->second.proxy, bounds);
+				it->second.lastSeen = m_frame;
 			});
 
+		// Entities that were destroyed or lost their model
+		for (auto& [e, proxy] : m_dynamicProxies)
+		{
+			if (proxy.lastSeen != m_frame)
+			{
+				m_dynamicScene.Remove(proxy.proxy);
+				m_removedProxies.push_back(e);
+			}
+		}
+		for (entity e : m_removedProxies)
+			m_dynamicProxies.erase(e);
+		m_removedProxies.clear();
+	}
+
+	void FrontRenderer::SubmitModel(entity e, ModelAsset* model, const TransformComponent& transformC, u32 firstSubmesh, u32 submeshCount, FrustumCuller::ViewMask views)
+	{
+		auto& mgr = EntityManager::Get();
+		if (!model || !model->gfxModel)
+			return;
+
+		const u32 endSubmesh = firstSubmesh + submeshCount;
+		const bool dontDraw = mgr.HasComponent<DontDraw>(e) && mgr.GetComponent<DontDraw>(e).dontDraw;
+
+		if (mgr.HasComponent<OutlineComponent>(e) && !mgr.HasComponent<ThisPlayerWeapon>(e) && !mgr.HasComponent<DontDraw>(e) && mgr.GetComponent<OutlineComponent>(e).onlyOutline)
+			return;
+
+		// Shadow submission, only what some shadow caster can see
+		if (mgr.HasComponent<ShadowReceiverComponent>(e) && (views & m_shadowViewMask))
+		{
+			for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+			{
+				if (mgr.HasComponent<ModularBlockComponent>(e))
+					m_doubleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC, false, false, 0, views });
+				else if (mgr.HasComponent<RigDataComponent>(e))
+					m_doubleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC, false, true, mgr.GetComponent<RigDataComponent>(e).offset, views });
+				else
+					m_singleSidedShadowed.push_back({ model->gfxModel->mesh.mesh, i, transformC, true, false, 0, views });
+			}
+		}
+
+		if (!(views & (1u << m_mainView)))
+			return;
+
+		const bool drawMeshCollider = mgr.HasComponent<MeshColliderComponent>(e) && mgr.GetComponent<MeshColliderComponent>(e).drawMeshColliderOverride;
+
+		if (mgr.HasComponent<ModularBlockComponent>(e))
+		{
+			if (drawMeshCollider)
+			{
+				// The collider is drawn whole, once per entity
+				u32 meshColliderModelID = mgr.GetComponent<MeshColliderComponent>(e).meshColliderModelID;
+				ModelAsset* meshColliderModel = AssetManager::Get().GetAsset<ModelAsset>(meshColliderModelID);
+				if (firstSubmesh == 0 && meshColliderModel && meshColliderModel->gfxModel)
+				{
+					for (u32 i = 0; i < meshColliderModel->gfxModel->mesh.numSubmeshes; ++i)
+						m_renderer->SubmitMeshWireframeNoFaceCulling(meshColliderModel->gfxModel->mesh.mesh, i, meshColliderModel->gfxModel->mats[i], transformC);
+				}
+			}
+			else
+			{
+				for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+					m_renderer->SubmitMeshNoFaceCulling(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
+			}
+		}
+		else if (mgr.HasComponent<RigDataComponent>(e))
+		{
+			auto offset = mgr.GetComponent<RigDataComponent>(e).offset;
+			if (!dontDraw)
+				for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+					m_renderer->SubmitAnimatedMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC, offset);
+		}
+		else if (drawMeshCollider)
+		{
+			for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+				m_renderer->SubmitMeshWireframe(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
+		}
+		// Special case for weapon draws
+		else if (mgr.HasComponent<ThisPlayerWeapon>(e))
+		{
+			if (!dontDraw)
+				for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+					m_renderer->SubmitMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC, true);
+		}
+		else if (!dontDraw)
+		{
+			for (u32 i = firstSubmesh; i < endSubmesh; ++i)
+				m_renderer->SubmitMesh(model->gfxModel->mesh.mesh, i, model->gfxModel->mats[i], transformC);
+		}
+	}
+
+	void FrontRenderer::SubmitStaticBatch(entity e, const StaticBatchComponent& batch, u32 submesh, FrustumCuller::ViewMask views)
+	{
+		auto& mgr = EntityManager::Get();
+
+		// The batch is already in world space
+		static const TransformComponent identity{};
+
+		if (mgr.HasComponent<ShadowReceiverComponent>(e) && (views & m_shadowViewMask))
+		{
+			if (batch.doubleSided)
+				m_doubleSidedShadowed.push_back({ batch.mesh, submesh, identity, false, false, 0, views });
+			else
+				m_singleSidedShadowed.push_back({ batch.mesh, submesh, identity, true, false, 0, views });
+		}
+
+		if (!(views & (1u << m_mainView)))
+			return;
 
+		if (batch.doubleSided)
+			m_renderer->SubmitMeshNoFaceCulling(batch.mesh, submesh, batch.materials[submesh], identity);
+		else
+			m_renderer->SubmitMesh(batch.mesh, submesh, batch.materials[submesh], identity);
 	}
 
 	void FrontRenderer::SetRenderCamera()
@@ -286,13 +570,15 @@ namespace DOG::gfx
 		m_renderer->SetMainRenderCamera(cameraComponent.viewMatrix, &proj);
 
 		m_viewMat = cameraComponent.viewMatrix;
+		m_mainView = m_culler.AddView(cameraComponent.viewMatrix, cameraComponent.projMatrix);
 	}
 
 	void FrontRenderer::GatherShadowCasters()
 	{
 		// Collect this frames spotlight shadow casters
 		m_activeSpotlightShadowCasters.clear();
-		m_playerViews.clear();
+		m_shadowViews.clear();
+		m_shadowViewMask = 0;
 		const bool shadowsMapping = m_renderer->GetGraphicsSettings().shadowMapping;
 
 		EntityManager::Get().Collect</*ShadowCasterComponent, */SpotLightComponent, CameraComponent, TransformComponent>().Do([&](
@@ -305,6 +591,7 @@ namespace DOG::gfx
 				spotData.color = { slc.color.x, slc.color.y, slc.color.z, };
 				spotData.direction = slc.direction;
 				spotData.cutoffAngle = slc.cutoffAngle;
+				spotData.range = slc.range;
 				spotData.strength = slc.strength;
 				spotData.isPlayerLight = slc.isMainPlayerSpotlight;
 
@@ -312,10 +599,21 @@ namespace DOG::gfx
 				{
 					spotData.shadow = Renderer::ShadowCaster();
 					spotData.shadow->viewMat = cc.viewMatrix;
-					m_playerViews.push_back(cc.viewMatrix);
 					spotData.shadow->projMat = cc.projMatrix;
 					u32 shadowID = *m_renderer->RegisterSpotlight(spotData);
 					m_activeSpotlightShadowCasters.push_back({ spotlightEntity, shadowID });
+
+					// The last view is kept for the main camera, casters past the limit are drawn unculled
+					if (m_culler.GetViewCount() < FrustumCuller::MAX_VIEWS - 1)
+					{
+						const u32 view = m_culler.AddView(cc.viewMatrix, cc.projMatrix);
+						m_shadowViews.push_back(view);
+						m_shadowViewMask |= 1u << view;
+					}
+					else
+					{
+						m_shadowViews.push_back(UNCULLED_VIEW);
+					}
 				}
 				else
 				{
@@ -343,24 +641,21 @@ namespace DOG::gfx
 
 	void FrontRenderer::CullShadowDraws()
 	{
-		// Cull all shadowed submissions per caster
-		for (const auto& [caster, shadowID] : m_activeSpotlightShadowCasters)
+		// Visibility for every caster was resolved together with the main view
+		for (u32 caster = 0; caster < m_activeSpotlightShadowCasters.size(); ++caster)
 		{
-			auto& cc = EntityManager::Get().GetComponent<CameraComponent>(caster);
-			TransformComponent camTransform;
-			camTransform.worldMatrix = ((DirectX::SimpleMath::Matrix)cc.viewMatrix).Invert();
-			auto&& cull = [camForward = camTransform.GetForward(), camPos = camTransform.GetPosition()](DirectX::SimpleMath::Vector3 p)
+			const u32 shadowID = m_activeSpotlightShadowCasters[caster].second;
+			const u32 view = m_shadowViews[caster];
+			if (view == UNCULLED_VIEW)
 			{
-				auto d = p - camPos;
-				if (d.LengthSquared() < 64) return false;
-				if (d.LengthSquared() > 80 * 80) return true;
-				d.Normalize();
-				return camForward.Dot(d) < 0.2f;
-			};
+				SubmitUnculledShadows(shadowID);
+				continue;
+			}
+			auto&& culled = [bit = 1u << view](const ShadowSubmission& sub) { return !(sub.views & bit); };
 
 			for (const auto& sub : m_singleSidedShadowed)
 			{
-				if (cull({ sub.tc.worldMatrix(3, 0), sub.tc.worldMatrix(3, 1), sub.tc.worldMatrix(3, 2) }))
+				if (culled(sub))
 					continue;
 				if (sub.animated)
 					m_renderer->SubmitSingleSidedShadowMesh(shadowID, sub.mesh, sub.submesh, sub.tc, true, sub.jointOffset);
@@ -370,7 +665,7 @@ namespace DOG::gfx
 
 			for (const auto& sub : m_doubleSidedShadowed)
 			{
-				if (cull({ sub.tc.worldMatrix(3, 0), sub.tc.worldMatrix(3, 1), sub.tc.worldMatrix(3, 2) }))
+				if (culled(sub))
 					continue;
 				if (sub.animated)
 					m_renderer->SubmitDoubleSidedShadowMesh(shadowID, sub.mesh, sub.submesh, sub.tc, true, sub.jointOffset);
@@ -381,6 +676,43 @@ namespace DOG::gfx
 
 	}
 
+	void FrontRenderer::SubmitUnculledShadows(u32 shadowID)
+	{
+		// Same rules as the shadow submission in SubmitModel and SubmitStaticBatch, but for every receiver
+		auto& mgr = EntityManager::Get();
+		mgr.Collect<ShadowReceiverComponent, TransformComponent, ModelComponent>().Do([&](entity e, ShadowReceiverComponent&, TransformComponent& transformC, ModelComponent& modelC)
+			{
+				ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(modelC);
+				if (!model || !model->gfxModel)
+					return;
+
+				for (u32 i = 0; i < model->gfxModel->mesh.numSubmeshes; ++i)
+				{
+					if (mgr.HasComponent<ModularBlockComponent>(e))
+						m_renderer->SubmitDoubleSidedShadowMesh(shadowID, model->gfxModel->mesh.mesh, i, transformC);
+					else if (mgr.HasComponent<RigDataComponent>(e))
+						m_renderer->SubmitDoubleSidedShadowMesh(shadowID, model->gfxModel->mesh.mesh, i, transformC, true, mgr.GetComponent<RigDataComponent>(e).offset);
+					else
+						m_renderer->SubmitSingleSidedShadowMesh(shadowID, model->gfxModel->mesh.mesh, i, transformC);
+				}
+			});
+
+		static const TransformComponent identity{};
+		mgr.Collect<ShadowReceiverComponent, StaticBatchComponent>().Do([&](ShadowReceiverComponent&, StaticBatchComponent& batch)
+			{
+				if (!batch.merged || batch.mesh.handle == 0)
+					return;
+
+				for (u32 i = 0; i < batch.submeshBounds.size(); ++i)
+				{
+					if (batch.doubleSided)
+						m_renderer->SubmitDoubleSidedShadowMesh(shadowID, batch.mesh, i, identity);
+					else
+						m_renderer->SubmitSingleSidedShadowMesh(shadowID, batch.mesh, i, identity);
+				}
+			});
+	}
+
 	void FrontRenderer::Render(f32)
 	{
 		m_renderer->Render(0.f);
@@ -389,6 +721,11 @@ namespace DOG::gfx
 	void FrontRenderer::PerformDeferredDeletion()
 	{
 		LightManager::Get().DestroyDeferredEntities();
+		EntityManager::Get().Collect<StaticBatchComponent, DeferredDeletionComponent>().Do([](entity, StaticBatchComponent& batch, DeferredDeletionComponent&)
+			{
+				if (batch.merged && batch.mesh.handle != 0)
+					CustomMeshManager::Get().RemoveMesh(batch.mesh);
+			});
 		m_particleManager->DeferredDeletion();
 	}
 
@@ -1,5 +1,11 @@
 #pragma once
 #include "../../ECS/EntityManager.h"			// Grab world state
+#include "BoundingVolumeHierarchy.h"
+
+namespace DOG
+{
+	struct ModelAsset;
+}
 
 namespace DOG::gfx
 {
@@ -38,10 +44,18 @@ namespace DOG::gfx
 
 
 		void UpdateLights();
+		void UpdateStaticScene();
+		void UpdateDynamicScene();
 		void GatherDrawCalls();
+		void SubmitModel(entity e, ModelAsset* model, const TransformComponent& transformC, u32 firstSubmesh, u32 submeshCount, FrustumCuller::ViewMask views);
+		void SubmitStaticBatch(entity e, const StaticBatchComponent& batch, u32 submesh, FrustumCuller::ViewMask views);
+		// False while some model of the batch is still loading
+		bool MergeStaticBatch(StaticBatchComponent& batch);
 		void SetRenderCamera();
 		void GatherShadowCasters();
 		void CullShadowDraws();
+		// For casters that did not get a culler view
+		void SubmitUnculledShadows(u32 shadowID);
 
 	private:
 		Renderer* m_renderer{ nullptr };
@@ -52,6 +66,8 @@ namespace DOG::gfx
 		u32 m_shadowMapCapacity{ 2 };
 		std::vector<std::pair<entity, u32>> m_activeSpotlightShadowCasters;		// { entity, shadowID } 
 
+		static constexpr f32 ANIMATED_BOUNDS_SCALE = 1.5f;
+
 		struct ShadowSubmission
 		{
 			Mesh mesh;
@@ -61,11 +77,48 @@ namespace DOG::gfx
 
 			bool animated{ false };
 			u32 jointOffset{ 0 };
+
+			FrustumCuller::ViewMask views{ ~0u };
 		};
 
 		std::vector<ShadowSubmission> m_singleSidedShadowed;
 		std::vector<ShadowSubmission> m_doubleSidedShadowed;
-		std::vector<DirectX::SimpleMath::Matrix> m_playerViews;
+
+		// All views of the frame, the scene trees are queried against all of them at once
+		FrustumCuller m_culler;
+		u32 m_mainView{ 0 };
+		static constexpr u32 UNCULLED_VIEW = std::numeric_limits<u32>::max();
+		std::vector<u32> m_shadowViews;			// Culler view per active shadow caster, UNCULLED_VIEW once the culler is out of views
+		FrustumCuller::ViewMask m_shadowViewMask{ 0 };
+
+		// Level blocks and static batches, one item per submesh.
+		// Rebuilt when the set of ModularBlockComponents or StaticBatchComponents changes or a pending model or batch finishes loading
+		struct StaticItem
+		{
+			entity e{ NULL_ENTITY };
+			u32 submesh{ 0 };
+		};
+		StaticBVH m_staticScene;
+		std::vector<StaticItem> m_staticItems;
+		std::vector<entity> m_pendingStatic;
+		std::vector<entity> m_pendingBatches;
+		u64 m_staticVersion{ 0 };
+		u64 m_staticBatchVersion{ 0 };
+
+		// Everything else with a model, one leaf per entity
+		struct DynamicProxy
+		{
+			u32 proxy{ DynamicBVH::NULL_NODE };
+			u64 lastSeen{ 0 };
+		};
+		DynamicBVH m_dynamicScene;
+		std::unordered_map<entity, DynamicProxy> m_dynamicProxies;
+		std::vector<entity> m_removedProxies;
+		u64 m_frame{ 0 };
+
+		// Never culled, models without bounds and the first person weapon
+		std::vector<entity> m_unboundedStatic;
+		std::vector<entity> m_unboundedDynamic;
 
 	};
 
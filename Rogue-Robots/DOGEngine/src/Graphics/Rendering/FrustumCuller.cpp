@@ -0,0 +1,147 @@
+#include "FrustumCuller.h"
+
+namespace DOG::gfx
+{
+	void FrustumCuller::Bounds::Push(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents)
+	{
+		centerX.push_back(center.x);
+		centerY.push_back(center.y);
+		centerZ.push_back(center.z);
+		extentX.push_back(extents.x);
+		extentY.push_back(extents.y);
+		extentZ.push_back(extents.z);
+	}
+
+	void FrustumCuller::Bounds::Resize(u32 count)
+	{
+		for (auto* v : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ })
+			v->resize(count, 0.0f);
+	}
+
+	void FrustumCuller::Bounds::Clear()
+	{
+		for (auto* v : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ })
+			v->clear();
+	}
+
+	u32 FrustumCuller::AddView(const DirectX::SimpleMath::Matrix& view, const DirectX::SimpleMath::Matrix& proj)
+	{
+		assert(m_frustums.size() < MAX_VIEWS);
+
+		// Planes are taken from the columns of the view projection, clip space z is [0, 1] so reversed depth works as is
+		const DirectX::SimpleMath::Matrix m = view * proj;
+		auto column = [&m](u32 i) { return DirectX::SimpleMath::Vector4(m.m[0][i], m.m[1][i], m.m[2][i], m.m[3][i]); };
+
+		Frustum& frustum = m_frustums.emplace_back();
+		frustum.planes[0] = column(3) + column(0);
+		frustum.planes[1] = column(3) - column(0);
+		frustum.planes[2] = column(3) + column(1);
+		frustum.planes[3] = column(3) - column(1);
+		frustum.planes[4] = column(2);
+		frustum.planes[5] = column(3) - column(2);
+
+		for (auto& plane : frustum.planes)
+		{
+			const f32 length = DirectX::SimpleMath::Vector3(plane.x, plane.y, plane.z).Length();
+			if (length > 1e-6f)
+				plane /= length;
+		}
+
+		return static_cast<u32>(m_frustums.size() - 1);
+	}
+
+	FrustumCuller::ViewMask FrustumCuller::TestBox(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, ViewMask views, ViewMask& inside) const
+	{
+		ViewMask touched = 0;
+		for (u32 view = 0; view < GetViewCount(); ++view)
+		{
+			const ViewMask bit = 1u << view;
+			if (!(views & bit))
+				continue;
+
+			bool outside = false;
+			bool contained = true;
+			for (const auto& plane : m_frustums[view].planes)
+			{
+				const f32 distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+				const f32 radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+				if (distance + radius < 0.0f)
+				{
+					outside = true;
+					break;
+				}
+				contained &= distance - radius >= 0.0f;
+			}
+
+			if (outside)
+				continue;
+			touched |= bit;
+			if (contained)
+				inside |= bit;
+		}
+		return touched;
+	}
+
+	void FrustumCuller::TestGroup(const Bounds& bounds, u32 first, ViewMask views, ViewMask* out) const
+	{
+		using namespace DirectX;
+		assert(first % GROUP_SIZE == 0 && first + GROUP_SIZE <= bounds.Size());
+
+		const XMVECTOR cx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.centerX[first]));
+		const XMVECTOR cy = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.centerY[first]));
+		const XMVECTOR cz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.centerZ[first]));
+		const XMVECTOR ex = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.extentX[first]));
+		const XMVECTOR ey = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.extentY[first]));
+		const XMVECTOR ez = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&bounds.extentZ[first]));
+
+		for (u32 view = 0; view < GetViewCount(); ++view)
+		{
+			const ViewMask bit = 1u << view;
+			if (!(views & bit))
+				continue;
+
+			XMVECTOR outside = XMVectorFalseInt();
+			for (const auto& plane : m_frustums[view].planes)
+			{
+				// A box is outside if even its most positive corner is behind the plane
+				const XMVECTOR nx = XMVectorReplicate(plane.x);
+				const XMVECTOR ny = XMVectorReplicate(plane.y);
+				const XMVECTOR nz = XMVectorReplicate(plane.z);
+
+				XMVECTOR distance = XMVectorMultiplyAdd(cx, nx, XMVectorReplicate(plane.w));
+				distance = XMVectorMultiplyAdd(cy, ny, distance);
+				distance = XMVectorMultiplyAdd(cz, nz, distance);
+
+				XMVECTOR radius = XMVectorMultiply(ex, XMVectorAbs(nx));
+				radius = XMVectorMultiplyAdd(ey, XMVectorAbs(ny), radius);
+				radius = XMVectorMultiplyAdd(ez, XMVectorAbs(nz), radius);
+
+				outside = XMVectorOrInt(outside, XMVectorLess(XMVectorAdd(distance, radius), XMVectorZero()));
+			}
+
+			XMUINT4 result;
+			XMStoreUInt4(&result, outside);
+			out[0] |= result.x ? 0 : bit;
+			out[1] |= result.y ? 0 : bit;
+			out[2] |= result.z ? 0 : bit;
+			out[3] |= result.w ? 0 : bit;
+		}
+	}
+
+	DirectX::BoundingBox FrustumCuller::TransformBounds(const DirectX::BoundingBox& localBounds, const DirectX::SimpleMath::Matrix& world)
+	{
+		// The extents of the transformed box projected on each world axis
+		const DirectX::XMFLOAT3& e = localBounds.Extents;
+		DirectX::BoundingBox out;
+		out.Center = DirectX::SimpleMath::Vector3::Transform(localBounds.Center, world);
+		out.Extents.x = std::abs(world._11) * e.x + std::abs(world._21) * e.y + std::abs(world._31) * e.z;
+		out.Extents.y = std::abs(world._12) * e.x + std::abs(world._22) * e.y + std::abs(world._32) * e.z;
+		out.Extents.z = std::abs(world._13) * e.x + std::abs(world._23) * e.y + std::abs(world._33) * e.z;
+		return out;
+	}
+
+	void FrustumCuller::Clear()
+	{
+		m_frustums.clear();
+	}
+}
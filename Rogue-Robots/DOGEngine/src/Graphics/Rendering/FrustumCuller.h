@@ -0,0 +1,53 @@
+#pragma once
+
+namespace DOG::gfx
+{
+	/*
+		Holds the view frustums of a frame and tests boxes against all of them at once.
+		Groups of four boxes are tested with one SIMD instruction per plane, nothing here touches the GPU.
+	*/
+	class FrustumCuller
+	{
+	public:
+		static constexpr u32 MAX_VIEWS = 32;
+		static constexpr u32 GROUP_SIZE = 4;
+		using ViewMask = u32;
+
+		// World space boxes as SoA, tested a group at a time
+		struct Bounds
+		{
+			std::vector<f32> centerX, centerY, centerZ;
+			std::vector<f32> extentX, extentY, extentZ;
+
+			void Push(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents);
+			void Resize(u32 count);
+			void Clear();
+			u32 Size() const { return static_cast<u32>(centerX.size()); }
+		};
+
+		// Returns the view index, bit n of a ViewMask refers to view n
+		u32 AddView(const DirectX::SimpleMath::Matrix& view, const DirectX::SimpleMath::Matrix& proj);
+		u32 GetViewCount() const { return static_cast<u32>(m_frustums.size()); }
+		ViewMask GetAllViews() const { return m_frustums.size() == MAX_VIEWS ? ~0u : (1u << m_frustums.size()) - 1; }
+
+		// Returns the views the box touches, the ones it is entirely inside of are also set in inside
+		ViewMask TestBox(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, ViewMask views, ViewMask& inside) const;
+
+		// Tests bounds[first, first + GROUP_SIZE) and ORs the views each box touches into out, first must be a multiple of GROUP_SIZE
+		void TestGroup(const Bounds& bounds, u32 first, ViewMask views, ViewMask* out) const;
+
+		// Transforms local bounds to the world AABB around them
+		static DirectX::BoundingBox TransformBounds(const DirectX::BoundingBox& localBounds, const DirectX::SimpleMath::Matrix& world);
+
+		void Clear();
+
+	private:
+		// Normalized planes facing inwards, xyz = normal, w = distance
+		struct Frustum
+		{
+			std::array<DirectX::SimpleMath::Vector4, 6> planes;
+		};
+
+		std::vector<Frustum> m_frustums;
+	};
+}
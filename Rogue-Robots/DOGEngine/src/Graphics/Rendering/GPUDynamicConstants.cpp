@@ -37,6 +37,9 @@ namespace DOG::gfx
 	{
 		if (count == 0)
 			return {};
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
 		// Grab memory (base)
 		auto [mem, offset] = m_ator.AllocateWithOffset();
 		assert(mem);
@@ -56,6 +59,9 @@ namespace DOG::gfx
 		}
 		if (count > 1)
 			assert(valid);
+		if (!m_debugName.empty())
+			m_allocCount += count;
+		lock.unlock();
 
 		// Yes it is a big performance hazard
 		// Create temporary view (potential performance hazard?)
@@ -83,11 +89,25 @@ namespace DOG::gfx
 		ret.buffer = m_buffer;
 		ret.bufferOffset = (u32)offset;
 
-		if (!m_debugName.empty() && ret.memory)
-		{
-			m_allocCount += count;
-		}
 
+		return ret;
+	}
+
+	GPUDynamicConstant GPUDynamicConstants::AllocateStructured(u32 stride, u32 count)
+	{
+		// Structured views address whole elements from the start of the buffer
+		assert(stride != 0 && ELEMENTSIZE % stride == 0);
+
+		auto ret = Allocate((stride * count + ELEMENTSIZE - 1) / ELEMENTSIZE, false);
+		if (!ret.memory)
+			return ret;
+
+		auto view = m_rd->CreateView(m_buffer, BufferViewDesc(ViewType::ShaderResource, ret.bufferOffset, stride, count));
+		ret.globalDescriptor = m_rd->GetGlobalDescriptor(view);
+		m_bin->PushDeferredDeletion([this, view]()
+			{
+				m_rd->FreeView(view);
+			});
 
 		return ret;
 	}
@@ -27,9 +27,12 @@ namespace DOG::gfx
 
 		void Tick();
 
-		// Grab a 256 byte constant data
+		// Grab a 256 byte constant data, safe to call from passes recording in parallel
 		GPUDynamicConstant Allocate(u32 count, bool generateDescriptor = true);
 
+		// Grab enough constant data for count elements of stride bytes, globalDescriptor is a structured buffer view over them
+		GPUDynamicConstant AllocateStructured(u32 stride, u32 count);
+
 	private:
 		RenderDevice* m_rd{ nullptr };
 		GPUGarbageBin* m_bin{ nullptr };
@@ -37,6 +40,7 @@ namespace DOG::gfx
 		u32 m_allocCount{ 0 };
 
 		Buffer m_buffer;
+		std::mutex m_mutex;
 		RingBuffer m_ator;
 
 		u32 m_numToPop{ 0 };
@@ -21,6 +21,8 @@ namespace DOG::gfx
 
 		//m_deletes.push(storage);
 
+		// Passes recording in parallel free their temporary views through here
+		std::lock_guard<std::mutex> lock(m_pushMutex);
 		m_deletes2[m_currFrameIdx].push_back(deletionFunc);
 	}
 
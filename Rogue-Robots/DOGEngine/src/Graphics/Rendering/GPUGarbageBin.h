@@ -35,6 +35,7 @@ namespace DOG::gfx
 		//std::deque<Deletion_Storage> m_deletes;
 
 		std::vector<std::vector<std::function<void()>>> m_deletes2;
+		std::mutex m_pushMutex;
 
 	};
 }
\ No newline at end of file
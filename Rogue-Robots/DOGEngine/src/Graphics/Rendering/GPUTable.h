@@ -6,9 +6,28 @@
 #include "../RHI/RenderDevice.h"
 #include "UploadContext.h"
 #include "GPUGarbageBin.h"
+#include "DirtyRanges.h"
 
 namespace DOG::gfx
 {
+	// Copies sent by a table since its stats were last reset
+	struct GPUTableUploadStats
+	{
+		u64 bytes{ 0 };
+		u32 copies{ 0 };
+		u32 fullUploads{ 0 };
+		u32 deltaUploads{ 0 };
+
+		GPUTableUploadStats& operator+=(const GPUTableUploadStats& other)
+		{
+			bytes += other.bytes;
+			copies += other.copies;
+			fullUploads += other.fullUploads;
+			deltaUploads += other.deltaUploads;
+			return *this;
+		}
+	};
+
 	/*
 		Assumes 'Handle' type has a u64 member named "handle"
 
@@ -18,12 +37,29 @@ namespace DOG::gfx
 	class GPUTableDeviceLocal
 	{
 	private:
+		// A previous allocation of a handle which the GPU is done with, holding the data as of update 'serial'
+		struct RetiredVersion
+		{
+			GPVirtualAllocation alloc;
+			u64 serial{ 0 };
+		};
+
 		struct Storage
 		{
 			GPVirtualAllocation alloc;			// Virtual allocation to element
 			u64 elementOffset{ 0 };				// Offset in DataType strides
+
+			// Delta update bookkeeping
+			u64 handle{ 0 };
+			u64 serial{ 0 };					// Number of updates to this handle
+			std::deque<DirtyRanges> history;	// Dirty elements of the latest updates, back() belongs to 'serial'
+			std::vector<RetiredVersion> retired;
 		};
 
+	public:
+		// Runs of dirty elements closer than this are uploaded as one copy
+		static constexpr u32 COALESCE_GAP_BYTES = 256;
+
 	public:
 		GPUTableDeviceLocal() = default;
 		GPUTableDeviceLocal(RenderDevice* rd, GPUGarbageBin* bin, u32 elementSize, u32 maxElements, bool async = false) :
@@ -52,6 +88,8 @@ namespace DOG::gfx
 				if (res)
 				{
 					m_vator.Free(std::move(res->alloc));
+					for (auto& version : res->retired)
+						m_vator.Free(std::move(version.alloc));
 				}
 			}
 		}
@@ -75,13 +113,15 @@ namespace DOG::gfx
 			{
 				auto updateFunc = [this, initData, size, offset = res.alloc.offset](UploadContext& ctx)
 				{
-					ctx.PushUpload(m_buffer, (u32)offset, initData, size);
+					Upload(ctx, offset, initData, size);
+					++m_uploadStats.fullUploads;
 				};
 				m_updateRequests.push(updateFunc);
 			}
 
 			// Reserve storage
 			auto hdl = m_handleAtor.Allocate<Handle>();
+			res.handle = hdl.handle;
 			HandleAllocator::TryInsert(m_resources, res, HandleAllocator::GetSlot(hdl.handle));
 
 			return hdl;
@@ -98,6 +138,10 @@ namespace DOG::gfx
 			};
 			m_bin->PushDeferredDeletion(delFunc);
 
+			// Retired versions are no longer in use by the GPU
+			for (auto& version : res.retired)
+				m_vator.Free(std::move(version.alloc));
+
 			// Free handle immediately to invalidate further use
 			HandleAllocator::FreeStorage(m_handleAtor, m_resources, handle);
 		}
@@ -122,22 +166,104 @@ namespace DOG::gfx
 			// If safe --> Allocate new
 			if (!unsafeDirectUpload)
 			{
-				u64 oldSize = res.alloc.size;
-				auto delFunc = [this, alloc = std::move(res.alloc)]() mutable
+				const u64 size = res.alloc.size;
+				RetireCurrent(res);
+				++res.serial;
+
+				// Allocate new one, or reuse a version the GPU is done with
+				if (res.retired.empty())
+					res.alloc = m_vator.Allocate(size);
+				else
 				{
-					m_vator.Free(std::move(alloc));
-				};
-				m_bin->PushDeferredDeletion(delFunc);
-
-				// Allocate new one
-				res.alloc = m_vator.Allocate(oldSize);
+					res.alloc = std::move(res.retired.back().alloc);
+					res.retired.pop_back();
+				}
 				res.elementOffset = res.alloc.offset / m_elementSize;
 			}
+
+			// Unknown which elements changed, older versions can only be brought up to date with a full upload
+			res.history.clear();
 		
 			// Enqueue data update
 			auto updateFunc = [this, savedData = data, dataSize, offset = res.alloc.offset](UploadContext& ctx)
 			{
-				ctx.PushUpload(m_buffer, (u32)offset, savedData, dataSize);
+				Upload(ctx, offset, savedData, dataSize);
+				++m_uploadStats.fullUploads;
+			};
+			m_updateRequests.push(updateFunc);
+		}
+
+		/*
+			Like RequestUpdate, but only the elements marked in 'dirty' have changed since the previous update of the handle.
+			'data' holds every element of the handle and 'dirty' has one bit per element.
+			The same lifetime rules as RequestUpdate apply to 'data'.
+
+			The safe path rewrites an older version of the handle once the GPU is done with it, which only needs
+			the elements that changed since that version was written. Without such a version the whole handle is uploaded.
+			The first update of a handle allocated without initData must mark every element.
+		*/
+		void RequestDeltaUpdate(Handle handle, void* data, const DirtyRanges& dirty, bool unsafeDirectUpload = false)
+		{
+			auto& res = HandleAllocator::TryGet(m_resources, HandleAllocator::GetSlot(handle.handle));
+			assert((u64)dirty.Size() * m_elementSize <= res.alloc.size);
+
+			if (!dirty.Any())
+				return;
+
+			const u32 maxHistory = m_bin->GetMaxVersions() + 2;
+			std::vector<DirtyRanges::Range> regions;
+
+			if (unsafeDirectUpload)
+			{
+				// Older versions now also lack these elements
+				if (!res.history.empty())
+					res.history.back().Merge(dirty);
+				dirty.Coalesce(regions, GetCoalesceGap());
+			}
+			else
+			{
+				const u64 size = res.alloc.size;
+				RetireCurrent(res);
+				++res.serial;
+				res.history.push_back(dirty);
+				while (res.history.size() > maxHistory)
+					res.history.pop_front();
+
+				// Reuse the most recent version, only the elements changed since it was written are uploaded if the history reaches back to it
+				auto newest = std::max_element(res.retired.begin(), res.retired.end(),
+					[](const RetiredVersion& a, const RetiredVersion& b) { return a.serial < b.serial; });
+				if (newest == res.retired.end())
+				{
+					res.alloc = m_vator.Allocate(size);
+					regions.push_back({ 0, dirty.Size() });
+				}
+				else
+				{
+					if (res.serial - newest->serial <= res.history.size())
+					{
+						DirtyRanges missing(dirty.Size());
+						for (u64 i = res.history.size() - (res.serial - newest->serial); i < res.history.size(); ++i)
+							missing.Merge(res.history[i]);
+						missing.Coalesce(regions, GetCoalesceGap());
+					}
+					else
+						regions.push_back({ 0, dirty.Size() });
+
+					res.alloc = std::move(newest->alloc);
+					res.retired.erase(newest);
+				}
+				res.elementOffset = res.alloc.offset / m_elementSize;
+			}
+
+			const bool full = regions.size() == 1 && regions[0].first == 0 && regions[0].second == dirty.Size();
+			auto updateFunc = [this, savedData = (u8*)data, regions = std::move(regions), full, offset = res.alloc.offset](UploadContext& ctx)
+			{
+				for (const auto& [first, count] : regions)
+					Upload(ctx, offset + (u64)first * m_elementSize, savedData + (u64)first * m_elementSize, count * m_elementSize);
+				if (full)
+					++m_uploadStats.fullUploads;
+				else
+					++m_uploadStats.deltaUploads;
 			};
 			m_updateRequests.push(updateFunc);
 		}
@@ -170,6 +296,33 @@ namespace DOG::gfx
 		// For LIMITED use!!
 		Buffer GetBuffer() const { return m_buffer; }
 
+		const GPUTableUploadStats& GetUploadStats() const { return m_uploadStats; }
+		void ResetUploadStats() { m_uploadStats = {}; }
+
+	private:
+		void Upload(UploadContext& ctx, u64 offset, void* data, u32 size)
+		{
+			ctx.PushUpload(m_buffer, (u32)offset, data, size);
+			m_uploadStats.bytes += size;
+			++m_uploadStats.copies;
+		}
+
+		u32 GetCoalesceGap() const { return COALESCE_GAP_BYTES / m_elementSize; }
+
+		// Hands the current allocation back to the handle once the GPU is done with it, or frees it if the handle is gone by then
+		void RetireCurrent(Storage& res)
+		{
+			auto retireFunc = [this, handle = res.handle, version = RetiredVersion{ std::move(res.alloc), res.serial }]() mutable
+			{
+				auto& slot = m_resources[HandleAllocator::GetSlot(handle)];
+				if (slot && slot->handle == handle)
+					slot->retired.push_back(std::move(version));
+				else
+					m_vator.Free(std::move(version.alloc));
+			};
+			m_bin->PushDeferredDeletion(retireFunc);
+		}
+
 	private:
 		RenderDevice* m_rd{ nullptr };
 		GPUGarbageBin* m_bin{ nullptr };
@@ -178,6 +331,7 @@ namespace DOG::gfx
 		std::vector<std::optional<Storage>> m_resources;
 		HandleAllocator m_handleAtor;
 		std::queue<std::function<void(UploadContext&)>> m_updateRequests;
+		GPUTableUploadStats m_uploadStats;
 
 		Buffer m_buffer;
 		BufferView m_fullView;
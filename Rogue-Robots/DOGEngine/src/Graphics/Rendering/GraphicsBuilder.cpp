@@ -112,4 +112,11 @@ namespace DOG::gfx
 	{
 		m_garbageBin->PushDeferredDeletion([rd = m_rd, h = handle]() {rd->FreeView(h); });
 	}
+	void GraphicsBuilder::FreeResource(const StaticModel& model)
+	{
+		// Both tables already defer the GPU side until the frames using it are done
+		m_meshTable->FreeMesh(model.mesh.mesh);
+		for (auto& mat : model.mats)
+			m_matTable->FreeMaterial(mat);
+	}
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ namespace DOG::gfx
 	public:
 		struct TextureSubresource
 		{
-			std::span<u8> data;
+			std::span<const u8> data;
 			u32 width{ 0 };
 			u32 height{ 0 };
 		};
@@ -48,6 +48,8 @@ namespace DOG::gfx
 
 		void FreeResource(Texture handle);
 		void FreeResource(TextureView handle);
+		// Frees the mesh and the materials of a model from LoadCustomModel
+		void FreeResource(const StaticModel& model);
 
 	private:
 		RenderDevice* m_rd{ nullptr };
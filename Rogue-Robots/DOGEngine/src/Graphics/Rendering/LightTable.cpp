@@ -61,19 +61,19 @@ namespace DOG::gfx
 		// Allocate chunks
 		{
 		// Point lights
-		m_pointLightsMD.statics.handle = { m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxStatics), true };
-		m_pointLightsMD.dynamics.handle = { m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxDynamic), true };
-		m_pointLightsMD.infreqs.handle = { m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxSometimes), true };
+		m_pointLightsMD.statics.handle = m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxStatics);
+		m_pointLightsMD.dynamics.handle = m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxDynamic);
+		m_pointLightsMD.infreqs.handle = m_pointLightsMD.bufferGPU->Allocate(spec.pointLightSpec.maxSometimes);
 
 		// Spot lights
-		m_spotLightsMD.statics.handle = { m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxStatics), true };
-		m_spotLightsMD.dynamics.handle = { m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxDynamic), true };
-		m_spotLightsMD.infreqs.handle = { m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxSometimes), true };
+		m_spotLightsMD.statics.handle = m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxStatics);
+		m_spotLightsMD.dynamics.handle = m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxDynamic);
+		m_spotLightsMD.infreqs.handle = m_spotLightsMD.bufferGPU->Allocate(spec.spotLightSpec.maxSometimes);
 
 		// Area lights
-		m_areaLightsMD.statics.handle = { m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxStatics), true };
-		m_areaLightsMD.dynamics.handle = { m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxDynamic), true };
-		m_areaLightsMD.infreqs.handle = { m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxSometimes), true };
+		m_areaLightsMD.statics.handle = m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxStatics);
+		m_areaLightsMD.dynamics.handle = m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxDynamic);
+		m_areaLightsMD.infreqs.handle = m_areaLightsMD.bufferGPU->Allocate(spec.areaLightSpec.maxSometimes);
 		}
 	}
 
@@ -118,13 +118,13 @@ namespace DOG::gfx
 			auto retFunc = [this, freq = storage.freq, localLightID = storage.localLightID, gpuElement = m_pointLights[storage.localLightID]]()
 			{
 				std::memcpy(&m_pointLights[localLightID], &gpuElement, sizeof(gpuElement));
-				m_pointLightsMD.SetDirty(freq);
+				m_pointLightsMD.SetDirty(freq, localLightID);
 			};
 			m_returnUpdateState[handle.handle] = retFunc;
 
 			// Empty current data
 			std::memset(&m_pointLights[storage.localLightID], 0, sizeof(PointLight_GPUElement));
-			m_pointLightsMD.SetDirty(storage.freq);
+			m_pointLightsMD.SetDirty(storage.freq, storage.localLightID);
 
 			break;
 		}
@@ -133,13 +133,13 @@ namespace DOG::gfx
 			auto retFunc = [this, freq = storage.freq, localLightID = storage.localLightID, gpuElement = m_spotLights[storage.localLightID]]()
 			{
 				std::memcpy(&m_spotLights[localLightID], &gpuElement, sizeof(gpuElement));
-				m_spotLightsMD.SetDirty(freq);
+				m_spotLightsMD.SetDirty(freq, localLightID);
 
 			};
 			m_returnUpdateState[handle.handle] = retFunc;
 
 			std::memset(&m_spotLights[storage.localLightID], 0, sizeof(SpotLight_GPUElement));
-			m_spotLightsMD.SetDirty(storage.freq);
+			m_spotLightsMD.SetDirty(storage.freq, storage.localLightID);
 
 			break;
 		}
@@ -148,13 +148,13 @@ namespace DOG::gfx
 			auto retFunc = [this, freq = storage.freq, localLightID = storage.localLightID, gpuElement = m_areaLights[storage.localLightID]]()
 			{
 				std::memcpy(&m_areaLights[localLightID], &gpuElement, sizeof(gpuElement));
-				m_areaLightsMD.SetDirty(freq);
+				m_areaLightsMD.SetDirty(freq, localLightID);
 			};
 			m_returnUpdateState[handle.handle] = retFunc;
 
 
 			std::memset(&m_areaLights[storage.localLightID], 0, sizeof(AreaLight_GPUElement));
-			m_areaLightsMD.SetDirty(storage.freq);
+			m_areaLightsMD.SetDirty(storage.freq, storage.localLightID);
 			break;
 		}
 		default:
@@ -176,15 +176,7 @@ namespace DOG::gfx
 		gpu.color = desc.color;
 		gpu.strength = desc.strength;
 
-		switch (storage.freq)
-		{
-		case LightUpdateFrequency::Sometimes:
-			m_pointLightsMD.SetInfreqsChunkDirty(true);
-			break;
-		case LightUpdateFrequency::PerFrame:
-			m_pointLightsMD.SetDynamicsChunkDirty(true);
-			break;
-		}
+		m_pointLightsMD.SetDirty(storage.freq, storage.localLightID);
 	}
 
 	void LightTable::UpdateSpotLight(LightHandle handle, const SpotLightDesc& desc)
@@ -199,16 +191,9 @@ namespace DOG::gfx
 		gpu.color = desc.color;
 		gpu.direction = desc.direction;
 		gpu.strength = desc.strength;
+		gpu.range = desc.range;
 
-		switch (storage.freq)
-		{
-		case LightUpdateFrequency::Sometimes:
-			m_spotLightsMD.SetInfreqsChunkDirty(true);
-			break;
-		case LightUpdateFrequency::PerFrame:
-			m_spotLightsMD.SetDynamicsChunkDirty(true);
-			break;
-		}
+		m_spotLightsMD.SetDirty(storage.freq, storage.localLightID);
 	}
 
 	void LightTable::UpdateAreaLight(LightHandle handle, const AreaLightDesc& desc)
@@ -253,6 +238,7 @@ namespace DOG::gfx
 		gpu.direction = desc.direction;
 		gpu.strength = desc.strength;
 		gpu.cutoffAngle = desc.cutoffAngle;
+		gpu.range = desc.range;
 
 		// Store
 		const auto lightHandle = m_handleAtor.Allocate<LightHandle>();
@@ -275,45 +261,39 @@ namespace DOG::gfx
 	void LightTable::FinalizeUpdates()
 	{
 		// If dirty --> Update GPU structures
-		m_pointLightsMD.TryUpdateStatics(&m_pointLights[m_pointLightsMD.statics.range.first], sizeof(PointLight_GPUElement));
-		m_pointLightsMD.TryUpdateInfreqs(&m_pointLights[m_pointLightsMD.infreqs.range.first], sizeof(PointLight_GPUElement));
-		m_pointLightsMD.TryUpdateDynamics(&m_pointLights[m_pointLightsMD.dynamics.range.first], sizeof(PointLight_GPUElement));
-
-		m_spotLightsMD.TryUpdateStatics(&m_spotLights[m_spotLightsMD.statics.range.first], sizeof(SpotLight_GPUElement));
-		m_spotLightsMD.TryUpdateInfreqs(&m_spotLights[m_spotLightsMD.infreqs.range.first], sizeof(SpotLight_GPUElement));
-		m_spotLightsMD.TryUpdateDynamics(&m_spotLights[m_spotLightsMD.dynamics.range.first], sizeof(SpotLight_GPUElement));
-
-		m_areaLightsMD.TryUpdateStatics(&m_areaLights[m_areaLightsMD.statics.range.first], sizeof(AreaLight_GPUElement));
-		m_areaLightsMD.TryUpdateInfreqs(&m_areaLights[m_areaLightsMD.infreqs.range.first], sizeof(AreaLight_GPUElement));
-		m_areaLightsMD.TryUpdateDynamics(&m_areaLights[m_areaLightsMD.dynamics.range.first], sizeof(AreaLight_GPUElement));
+		m_pointLightsMD.TryUpdateChunks(m_pointLights.data(), sizeof(PointLight_GPUElement));
+		m_spotLightsMD.TryUpdateChunks(m_spotLights.data(), sizeof(SpotLight_GPUElement));
+		m_areaLightsMD.TryUpdateChunks(m_areaLights.data(), sizeof(AreaLight_GPUElement));
 	}
 
 	void LightTable::SendCopyRequests(UploadContext& ctx)
 	{
+		m_lightsMD->ResetUploadStats();
+		m_pointLightsMD.bufferGPU->ResetUploadStats();
+		m_spotLightsMD.bufferGPU->ResetUploadStats();
+		m_areaLightsMD.bufferGPU->ResetUploadStats();
+
 		// MD sent onces
 		m_lightsMD->SendCopyRequests(ctx);
 
-		if (m_pointLightsMD.DynamicsChunkDirty() || m_pointLightsMD.InfreqsChunkDirty() || m_pointLightsMD.StaticsChunkDirty())
+		if (m_pointLightsMD.AnyDirty())
 			m_pointLightsMD.bufferGPU->SendCopyRequests(ctx);
 
-		if (m_spotLightsMD.DynamicsChunkDirty() || m_spotLightsMD.InfreqsChunkDirty() || m_spotLightsMD.StaticsChunkDirty())
+		if (m_spotLightsMD.AnyDirty())
 			m_spotLightsMD.bufferGPU->SendCopyRequests(ctx);
 
-		if (m_areaLightsMD.DynamicsChunkDirty() || m_areaLightsMD.InfreqsChunkDirty() || m_areaLightsMD.StaticsChunkDirty())
+		if (m_areaLightsMD.AnyDirty())
 			m_areaLightsMD.bufferGPU->SendCopyRequests(ctx);
 
 		// Reset
-		m_pointLightsMD.SetDynamicsChunkDirty(false);
-		m_pointLightsMD.SetStaticsChunkDirty(false);
-		m_pointLightsMD.SetInfreqsChunkDirty(false);
-
-		m_spotLightsMD.SetDynamicsChunkDirty(false);
-		m_spotLightsMD.SetStaticsChunkDirty(false);
-		m_spotLightsMD.SetInfreqsChunkDirty(false);
-
-		m_areaLightsMD.SetDynamicsChunkDirty(false);
-		m_areaLightsMD.SetStaticsChunkDirty(false);
-		m_areaLightsMD.SetInfreqsChunkDirty(false);
+		m_pointLightsMD.ClearDirty();
+		m_spotLightsMD.ClearDirty();
+		m_areaLightsMD.ClearDirty();
+
+		m_uploadStats = m_lightsMD->GetUploadStats();
+		m_uploadStats += m_pointLightsMD.bufferGPU->GetUploadStats();
+		m_uploadStats += m_spotLightsMD.bufferGPU->GetUploadStats();
+		m_uploadStats += m_areaLightsMD.bufferGPU->GetUploadStats();
 	}
 
 	u32 LightTable::GetDescriptor(LightType type)
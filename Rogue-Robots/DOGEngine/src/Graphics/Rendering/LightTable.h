@@ -54,15 +54,12 @@ namespace DOG::gfx
 		u32 GetChunkOffset(LightType type, LightUpdateFrequency freq);
 		u32 GetMetadataDescriptor();
 
+		// Copies sent by the last SendCopyRequests
+		const GPUTableUploadStats& GetUploadStats() const { return m_uploadStats; }
 
-	private:
-		struct Light_Storage
-		{
-			LightType type{ LightType::Point };
-			LightUpdateFrequency freq{ LightUpdateFrequency::Never };
-			u32 localLightID{ UINT_MAX };
-		};
-
+		// ======== CPU copies of the light chunks, for CPU-side culling
+		// Element i is slot i of the type's table, chunks are laid out [ Statics, Infreqs, Dynamics ].
+		// Unused, removed and disabled slots are zeroed and so have a strength of 0.
 		struct PointLight_GPUElement
 		{
 			DirectX::SimpleMath::Vector3 position{ 0.f, 0.f, 0.f };
@@ -78,6 +75,19 @@ namespace DOG::gfx
 			float cutoffAngle{ 15.f };
 			DirectX::SimpleMath::Vector3 direction{ 0.f, 0.f, 1.f };
 			float strength{ 0.f };
+			float range{ 0.f };
+		};
+
+		std::span<const PointLight_GPUElement> GetPointLights() const { return m_pointLights; }
+		std::span<const SpotLight_GPUElement> GetSpotLights() const { return m_spotLights; }
+
+
+	private:
+		struct Light_Storage
+		{
+			LightType type{ LightType::Point };
+			LightUpdateFrequency freq{ LightUpdateFrequency::Never };
+			u32 localLightID{ UINT_MAX };
 		};
 
 		struct AreaLight_GPUElement
@@ -146,14 +156,21 @@ namespace DOG::gfx
 		{
 			PrivateStack<u32> freeSlots;
 			std::pair<u32, u32> range{ 0, 0 };			// { offset, count }
-			std::pair<Handle, bool> handle;				// { handle, dirty }
+			Handle handle;
+			DirtyRanges dirty;							// One bit per slot in the chunk
 
 			void FillSlots()
 			{
 				assert(range.second != 0);
 				for (i32 i = range.second - 1; i >= 0; --i)
 					freeSlots.push(range.first + i);
+
+				// Everything is uploaded once
+				dirty.Resize(range.second);
+				dirty.MarkAll();
 			}
+
+			void MarkDirty(u32 slot) { dirty.Mark(slot - range.first); }
 		};
 
 		template <typename Handle>
@@ -171,110 +188,66 @@ namespace DOG::gfx
 				dynamics.FillSlots();
 			}
 
-			u32 GetNextSlot(LightUpdateFrequency freq)
+			PerFreqMetadata<Handle>& GetChunk(LightUpdateFrequency freq)
 			{
-				u32 ret{ UINT_MAX };
 				switch (freq)
 				{
 				case LightUpdateFrequency::Never:
-					ret = statics.freeSlots.top();
-					statics.freeSlots.pop();
-					SetStaticsChunkDirty(true);
-					break;
+					return statics;
 				case LightUpdateFrequency::Sometimes:
-					ret = infreqs.freeSlots.top();
-					infreqs.freeSlots.pop();
-					SetInfreqsChunkDirty(true);			// Assuming that retrieving a new slot means that new data is to be copied in
-					break;
+					return infreqs;
 				case LightUpdateFrequency::PerFrame:
-					ret = dynamics.freeSlots.top();
-					dynamics.freeSlots.pop();
-					SetDynamicsChunkDirty(true);		// See above
-					break;
+					return dynamics;
+				default:
+					assert(false);
 				}
+				return statics;
+			}
+
+			u32 GetNextSlot(LightUpdateFrequency freq)
+			{
+				auto& chunk = GetChunk(freq);
+				const u32 ret = chunk.freeSlots.top();
+				chunk.freeSlots.pop();
+				chunk.MarkDirty(ret);		// Assuming that retrieving a new slot means that new data is to be copied in
 
 				assert(ret != UINT_MAX);
 				return ret;
 			}
 			void ReturnSlot(u32 slot, LightUpdateFrequency freq)
 			{
-				switch (freq)
-				{
-				case LightUpdateFrequency::Never:
-					SetStaticsChunkDirty(true);
-					statics.freeSlots.push(slot);
-					break;
-				case LightUpdateFrequency::Sometimes:
-					infreqs.freeSlots.push(slot);
-					SetInfreqsChunkDirty(true);	
-					break;
-				case LightUpdateFrequency::PerFrame:
-					dynamics.freeSlots.push(slot);
-					SetDynamicsChunkDirty(true);
-					break;
-				default:
-					assert(false);
-				}
+				auto& chunk = GetChunk(freq);
+				chunk.freeSlots.push(slot);
+				chunk.MarkDirty(slot);
 			}
 
-			void SetDirty(LightUpdateFrequency freq)
+			void SetDirty(LightUpdateFrequency freq, u32 slot)
 			{
-				switch (freq)
-				{
-				case LightUpdateFrequency::Never:
-					SetStaticsChunkDirty(true);
-					break;
-				case LightUpdateFrequency::Sometimes:
-					SetInfreqsChunkDirty(true);
-					break;
-				case LightUpdateFrequency::PerFrame:
-					SetDynamicsChunkDirty(true);
-					break;
-				default:
-					assert(false);
-				}
+				GetChunk(freq).MarkDirty(slot);
 			}
 
-
-			bool DynamicsChunkDirty() const { return dynamics.handle.second; }
-			bool InfreqsChunkDirty() const { return infreqs.handle.second; }
-			bool StaticsChunkDirty() const { return statics.handle.second; }
-
-			void SetDynamicsChunkDirty(bool dirty) { dynamics.handle.second = dirty; }
-			void SetInfreqsChunkDirty(bool dirty) { infreqs.handle.second = dirty; }
-			void SetStaticsChunkDirty(bool dirty) { statics.handle.second = dirty; }
-			
-			void TryUpdateDynamics(void* chunkStart, u32 elementSize)
+			bool AnyDirty() const { return statics.dirty.Any() || infreqs.dirty.Any() || dynamics.dirty.Any(); }
+			void ClearDirty()
 			{
-				if (DynamicsChunkDirty())
-				{
-					bufferGPU->RequestUpdate(
-						dynamics.handle.first,
-						chunkStart,
-						dynamics.range.second * elementSize);
-				}
+				statics.dirty.Clear();
+				infreqs.dirty.Clear();
+				dynamics.dirty.Clear();
 			}
-			void TryUpdateInfreqs(void* chunkStart, u32 elementSize)
-			{
-				if (InfreqsChunkDirty())
-				{
-					bufferGPU->RequestUpdate(
-						infreqs.handle.first,
-						chunkStart,
-						infreqs.range.second * elementSize);
-				}
-			}
-			void TryUpdateStatics(void* chunkStart, u32 elementSize)
+
+			// Only the dirty slots of each chunk are uploaded. Statics are written in place, so they must not change while frames are in flight.
+			void TryUpdateChunks(void* tableStart, u32 elementSize)
 			{
-				if (statics.handle.second)
+				auto chunkStart = [tableStart, elementSize](const PerFreqMetadata<Handle>& chunk)
 				{
-					//statics.handle.second = false;
-					bufferGPU->RequestUpdate(
-						statics.handle.first,
-						chunkStart,
-						statics.range.second * elementSize, 
-						true);
-				}
+					return (u8*)tableStart + (u64)chunk.range.first * elementSize;
+				};
+
+				if (statics.dirty.Any())
+					bufferGPU->RequestDeltaUpdate(statics.handle, chunkStart(statics), statics.dirty, true);
+				if (infreqs.dirty.Any())
+					bufferGPU->RequestDeltaUpdate(infreqs.handle, chunkStart(infreqs), infreqs.dirty);
+				if (dynamics.dirty.Any())
+					bufferGPU->RequestDeltaUpdate(dynamics.handle, chunkStart(dynamics), dynamics.dirty);
 			}
 
 			u32 GetGlobalDescriptor() const { return bufferGPU->GetGlobalDescriptor(); }
@@ -283,11 +256,11 @@ namespace DOG::gfx
 				switch (freq)
 				{
 				case LightUpdateFrequency::Never:
-					return bufferGPU->GetLocalOffset(statics.handle.first);
+					return bufferGPU->GetLocalOffset(statics.handle);
 				case LightUpdateFrequency::Sometimes:
-					return bufferGPU->GetLocalOffset(infreqs.handle.first);
+					return bufferGPU->GetLocalOffset(infreqs.handle);
 				case LightUpdateFrequency::PerFrame:
-					return bufferGPU->GetLocalOffset(dynamics.handle.first);
+					return bufferGPU->GetLocalOffset(dynamics.handle);
 				default:
 					assert(false);
 				}
@@ -324,6 +297,8 @@ namespace DOG::gfx
 
 		// Enable/disabling lights
 		std::unordered_map<u64, std::function<void()>> m_returnUpdateState;
+
+		GPUTableUploadStats m_uploadStats;
 	};
 
 
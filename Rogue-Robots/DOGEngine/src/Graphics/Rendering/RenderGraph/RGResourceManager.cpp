@@ -12,21 +12,21 @@ namespace DOG::gfx
 	{
 		{
 			MemoryPoolDesc d{};
-			d.size = 18'000'000;
+			d.size = RT_DS_POOL_BLOCK_SIZE;
 			d.heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
 			m_rtDsTextureMemPool = m_rd->CreateMemoryPool(d);
 		}
 
 		{
 			MemoryPoolDesc d{};
-			d.size = 20'000'000;
+			d.size = NON_RT_DS_POOL_BLOCK_SIZE;
 			d.heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
 			m_nonRtDsTextureMemPool = m_rd->CreateMemoryPool(d);
 		}
 
 		{
 			MemoryPoolDesc d{};
-			d.size = 10'000'000;
+			d.size = BUFFER_POOL_BLOCK_SIZE;
 			d.heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
 			m_bufferMemPool = m_rd->CreateMemoryPool(d);
 		}
@@ -37,13 +37,13 @@ namespace DOG::gfx
 
 	}
 
-	const GPUPoolMemoryInfo& RGResourceManager::GetMemoryInfo()
+	const RGResourceManager::MemoryInfo& RGResourceManager::GetMemoryInfo()
 	{
 		auto rtDsUsage = m_rd->GetPoolMemoryInfo(m_rtDsTextureMemPool);
 		auto nonRtDsUsage = m_rd->GetPoolMemoryInfo(m_nonRtDsTextureMemPool);
 		auto bufferUsage = m_rd->GetPoolMemoryInfo(m_bufferMemPool);
-		m_totalMemUsage = (rtDsUsage + nonRtDsUsage + bufferUsage);
-		return m_totalMemUsage;
+		m_memInfo.pools = (rtDsUsage + nonRtDsUsage + bufferUsage);
+		return m_memInfo;
 	}
 
 	void RGResourceManager::DeclareTexture(RGResourceID id, RGTextureDesc desc)
@@ -173,11 +173,6 @@ namespace DOG::gfx
 		}
 	}
 
-	void RGResourceManager::ResolveMemoryAliasesWrap(CommandList list)
-	{
-		if (!m_aliasingBarrierWrap.empty())
-			m_rd->Cmd_Barrier(list, m_aliasingBarrierWrap);
-	}
 
 
 
@@ -279,18 +274,13 @@ namespace DOG::gfx
 		}
 #else
 		m_aliasingBarrierPerDepLevel.clear();
-		m_aliasingBarrierWrap.clear();
-
-		struct MemoryAliasingData
-		{
-			RGResourceID id;
-			u64 size{ 0 };
-			std::pair<u32, u32> lifetime;
-			TextureDesc desc;
-		};
-
-		std::vector<MemoryAliasingData> rtDsResources, nonRtDsResources;
+		m_memInfo.transientResources = 0;
+		m_memInfo.heaps = 0;
+		m_memInfo.naiveBytes = 0;
+		m_memInfo.placedBytes = 0;
 
+		// Heap tier 1 keeps render targets, other textures and buffers in separate heaps, so each pool is packed on its own
+		std::vector<TransientPlacement> rtDsResources, nonRtDsResources, bufferResources;
 		for (auto& [id, resource] : m_resources)
 		{
 			// We are only interested in creating resources for Declared resources
@@ -298,6 +288,16 @@ namespace DOG::gfx
 				continue;
 
 			const RGResourceDeclared& decl = std::get<RGResourceDeclared>(resource.variants);
+
+			TransientPlacement placement{};
+			placement.id = id;
+			placement.type = resource.resourceType;
+
+			// Underlying lifetime, covering every alias of the resource. Never used resources live for the whole graph
+			placement.lifetime = decl.resourceLifetime;
+			if (placement.lifetime.first > placement.lifetime.second)
+				placement.lifetime = { 0, std::numeric_limits<u32>::max() };
+
 			if (resource.resourceType == RGResourceType::Texture)
 			{
 				const auto& rgDesc = std::get<RGTextureDesc>(decl.desc);
@@ -306,283 +306,194 @@ namespace DOG::gfx
 					rgDesc.flags, rgDesc.initState)
 					.SetMipLevels(rgDesc.mipLevels);
 
-				MemoryAliasingData data{};
-				data.desc = desc;
-				data.id = id;
-				data.size = m_rd->GetTotalTextureSize(desc);
-				data.lifetime = GetMutableUsageLifetime(id);
-				
-				MemoryPool chosenPool;
+				placement.desc = desc;
+				placement.size = m_rd->GetTotalTextureSize(desc);
+
 				if ((rgDesc.flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) == D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET ||
 					(rgDesc.flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) == D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
 				{
-					rtDsResources.push_back(data);
+					rtDsResources.push_back(placement);
 				}
 				else
 				{
-					nonRtDsResources.push_back(data);
+					nonRtDsResources.push_back(placement);
 				}
 			}
 			else
 			{
 				const auto& rgDesc = std::get<RGBufferDesc>(decl.desc);
 
-				BufferDesc desc(MemoryType::Default, rgDesc.size, rgDesc.flags, rgDesc.initState);
-
-				resource.resource = m_rd->CreateBuffer(desc, m_bufferMemPool).handle;
+				placement.desc = BufferDesc(MemoryType::Default, rgDesc.size, rgDesc.flags, rgDesc.initState);
+				placement.size = rgDesc.size;
+				bufferResources.push_back(placement);
 			}
 		}
 
-
-		// Sort from largest to smallest
-		std::sort(rtDsResources.begin(), rtDsResources.end(), [](const MemoryAliasingData& lh, const MemoryAliasingData& rh)
-			{
-				return lh.size > rh.size;
-			});
-		std::sort(nonRtDsResources.begin(), nonRtDsResources.end(), [](const MemoryAliasingData& lh, const MemoryAliasingData& rh)
-			{
-				return lh.size > rh.size;
-			});
-
+		RealizeTransients(rtDsResources, m_rtDsTextureMemPool, RT_DS_POOL_BLOCK_SIZE);
+		RealizeTransients(nonRtDsResources, m_nonRtDsTextureMemPool, NON_RT_DS_POOL_BLOCK_SIZE);
+		RealizeTransients(bufferResources, m_bufferMemPool, BUFFER_POOL_BLOCK_SIZE);
+#endif
 
 
-		std::set<std::string> handledRtDs, handledNonRtDs;
-		std::vector<std::pair<MemoryAliasingData, std::vector<MemoryAliasingData>>> rtDsPool, nonRtDsPool;
-		for (const auto& parent : rtDsResources)
+		// Assign underlying resource to aliased resources
+		for (auto& [_, resource] : m_resources)
 		{
-			// Skip already handled
-			if (handledRtDs.contains(parent.id.name))
+			if (resource.variantType != RGResourceVariant::Aliased)
 				continue;
 
-			rtDsPool.push_back({ parent, {} });
-
-			std::vector<std::pair<u32, u32>> lifetimes;
-			lifetimes.push_back(parent.lifetime);
-
-			for (const auto& potential : rtDsResources)
-			{
-				// Skip self and resources already handled
-				if (potential.id == parent.id || handledRtDs.contains(potential.id.name))
-					continue;
-
-				// If lifetime does not overlap with any recorded lifetimes for parent resource.. we can alias!
-				auto it = std::find_if(lifetimes.begin(), lifetimes.end(), [&](const std::pair<u32, u32>& existingLifetime)
-					{
-						if (existingLifetime.second >= potential.lifetime.first ||
-							existingLifetime.first <= potential.lifetime.second)
-							return true;
-						else
-							return false;
-					});
-
-				// If overlap, continue
-				if (it != lifetimes.cend())
-					continue;
-
-
-				// If it doesn't overlap, track..
-				lifetimes.push_back(potential.lifetime);
-				rtDsPool.back().second.push_back(potential);
-
-				// .. and mark as handled
-				handledRtDs.insert(potential.id.name);
-			}
-
-			handledRtDs.insert(parent.id.name);
+			RGResourceAliased& alias = std::get<RGResourceAliased>(resource.variants);
+			const auto& original = m_resources.find(alias.originalID)->second;
+			resource.resource = original.resource;
 		}
+	}
 
-		for (const auto& parent : nonRtDsResources)
+	std::vector<u64> RGResourceManager::PlaceTransients(std::vector<TransientPlacement>& transients, u64 heapCapacity)
+	{
+		auto alignUp = [](u64 value) { return (value + RenderDevice::PLACEMENT_ALIGNMENT - 1) & ~(RenderDevice::PLACEMENT_ALIGNMENT - 1); };
+		auto lifetimesOverlap = [](const std::pair<u32, u32>& lh, const std::pair<u32, u32>& rh)
 		{
-			// Skip already handled
-			if (handledNonRtDs.contains(parent.id.name))
-				continue;
-
-			nonRtDsPool.push_back({ parent, {} });
-
-			std::vector<std::pair<u32, u32>> lifetimes;
-			lifetimes.push_back(parent.lifetime);
+			return lh.first <= rh.second && rh.first <= lh.second;
+		};
 
-			for (const auto& potential : nonRtDsResources)
+		// Largest first, ties broken on name so the same graph always gets the same layout
+		std::sort(transients.begin(), transients.end(), [](const TransientPlacement& lh, const TransientPlacement& rh)
 			{
-				// Skip self and resources already handled
-				if (potential.id == parent.id || handledNonRtDs.contains(potential.id.name))
-					continue;
+				if (lh.size != rh.size)
+					return lh.size > rh.size;
+				return lh.id.name < rh.id.name;
+			});
 
-				// If lifetime does not overlap with any recorded lifetimes for parent resource.. we can alias!
-				auto it = std::find_if(lifetimes.begin(), lifetimes.end(), [&](const std::pair<u32, u32>& existingLifetime)
-					{
-						if (existingLifetime.second >= potential.lifetime.first &&
-							existingLifetime.first <= potential.lifetime.second)
-							return true;
-						else
-							return false;
-					});
-
-				// If overlap, continue
-				if (it != lifetimes.cend())
-					continue;
+		/*
+			Interval graph coloring over [lifetime] x [memory range]: every resource takes the lowest offset in the first heap
+			where it does not overlap the memory of a resource that is alive at the same time.
+		*/
+		std::vector<u64> heapSizes;
+		std::vector<std::pair<u64, u64>> occupied;
+		for (u32 i = 0; i < transients.size(); ++i)
+		{
+			auto& transient = transients[i];
+			const u64 size = alignUp(transient.size);
 
+			bool placed = false;
+			for (u32 heap = 0; heap < heapSizes.size() && !placed; ++heap)
+			{
+				occupied.clear();
+				for (u32 j = 0; j < i; ++j)
+				{
+					if (transients[j].heap == heap && lifetimesOverlap(transients[j].lifetime, transient.lifetime))
+						occupied.push_back({ transients[j].offset, transients[j].offset + alignUp(transients[j].size) });
+				}
+				std::sort(occupied.begin(), occupied.end());
 
-				// If it doesn't overlap, track..
-				lifetimes.push_back(potential.lifetime);
-				nonRtDsPool.back().second.push_back(potential);
+				u64 offset = 0;
+				for (const auto& [begin, end] : occupied)
+				{
+					if (offset + size <= begin)
+						break;
+					offset = (std::max)(offset, end);
+				}
 
-				// .. and mark as handled
-				handledNonRtDs.insert(potential.id.name);
+				if (offset + size <= heapCapacity)
+				{
+					transient.heap = heap;
+					transient.offset = offset;
+					heapSizes[heap] = (std::max)(heapSizes[heap], offset + size);
+					placed = true;
+				}
 			}
 
-			handledNonRtDs.insert(parent.id.name);
+			// Resources larger than the capacity get a heap of their own
+			if (!placed)
+			{
+				transient.heap = (u32)heapSizes.size();
+				transient.offset = 0;
+				heapSizes.push_back(size);
+			}
 		}
 
+		return heapSizes;
+	}
 
+	void RGResourceManager::RealizeTransients(std::vector<TransientPlacement>& transients, MemoryPool pool, u64 heapCapacity)
+	{
+		if (transients.empty())
+			return;
 
+		const auto heapSizes = PlaceTransients(transients, heapCapacity);
 
-
-		for (const auto& [parent, aliases] : rtDsPool)
+		for (u32 heap = 0; heap < heapSizes.size(); ++heap)
 		{
-			// Grab all descs, including parent
-			std::vector<TextureDesc> totalDescs;
-			std::vector<RGResourceID> totalIDs;
-			totalDescs.reserve(aliases.size());
-			totalIDs.reserve(aliases.size());
-
-			totalDescs.push_back(parent.desc);
-			totalIDs.push_back(parent.id);
-			for (const auto& aliasData : aliases)
+			std::vector<u32> indices;
+			std::vector<u64> offsets;
+			for (u32 i = 0; i < transients.size(); ++i)
 			{
-				totalDescs.push_back(aliasData.desc);
-				totalIDs.push_back(aliasData.id);
+				if (transients[i].heap != heap)
+					continue;
+				indices.push_back(i);
+				offsets.push_back(transients[i].offset);
 			}
 
-			auto textures = m_rd->CreateAliasedTextures(totalDescs, m_rtDsTextureMemPool);
-			// Identical ordering of totalDescs/totalIDs
-			u32 x = 0;
-			std::unordered_map<RGResourceID, Texture> textureMapped;
-			for (const auto& tex : textures)
+			if (transients[indices.front()].type == RGResourceType::Texture)
 			{
-				auto id = totalIDs[x++];
-				textureMapped[id] = tex;
-				SetTexture(id, tex);
-			}
+				std::vector<TextureDesc> descs;
+				for (u32 i : indices)
+					descs.push_back(std::get<TextureDesc>(transients[i].desc));
 
-			// Add to barrier tracking
-			if (aliases.size() > 0)
-			{
-				// Get chronological lifetime order
-				std::vector<std::pair<u32, RGResourceID>> lifetimeOrder;
-				lifetimeOrder.push_back({ parent.lifetime.first, parent.id });
-				for (const auto& aliasData : aliases)
-					lifetimeOrder.push_back({ aliasData.lifetime.first, aliasData.id });
-				std::sort(lifetimeOrder.begin(), lifetimeOrder.end(), [](const std::pair<u32, RGResourceID>& lh, const std::pair<u32, RGResourceID>& rh)
-					{
-						return lh.first < rh.first;
-					});
-
-				// Track pairwise transition
-				RGResourceID firstResource, lastResource;
-				for (u32 i = 0; i < lifetimeOrder.size(); i += 2)
+				auto textures = m_rd->CreatePlacedTextures(descs, offsets, heapSizes[heap], pool);
+				for (u32 i = 0; i < indices.size(); ++i)
 				{
-					if (i + 1 >= lifetimeOrder.size())
-						break;
-
-					auto oldResource = lifetimeOrder[i].second;
-					auto newResource = lifetimeOrder[i + 1].second;
-					auto depLevelToInsertAt = lifetimeOrder[i + 1].first;		// Right before newResource is used
-
-					if (i == 0)
-						firstResource = oldResource;
-
-					// Get the last newResource
-					lastResource = newResource;
-
-					auto& barrs = m_aliasingBarrierPerDepLevel[depLevelToInsertAt];
-					barrs.push_back(GPUBarrier::Aliasing(textureMapped[oldResource], textureMapped[newResource]));
+					transients[indices[i]].resource = textures[i].handle;
+					m_resources.find(transients[indices[i]].id)->second.resource = textures[i].handle;
 				}
-
-				// Track end-to-start
-				m_aliasingBarrierWrap.push_back(GPUBarrier::Aliasing(textureMapped[lastResource], textureMapped[firstResource]));
 			}
-		}
+			else
+			{
+				std::vector<BufferDesc> descs;
+				for (u32 i : indices)
+					descs.push_back(std::get<BufferDesc>(transients[i].desc));
 
+				auto buffers = m_rd->CreatePlacedBuffers(descs, offsets, heapSizes[heap], pool);
+				for (u32 i = 0; i < indices.size(); ++i)
+				{
+					transients[indices[i]].resource = buffers[i].handle;
+					m_resources.find(transients[indices[i]].id)->second.resource = buffers[i].handle;
+				}
+			}
 
+			m_memInfo.placedBytes += heapSizes[heap];
+			++m_memInfo.heaps;
+		}
 
-		for (const auto& [parent, aliases] : nonRtDsPool)
+		// Every resource sharing memory with another is activated right before the dependency level it is first used in.
+		// This also covers the first user of the memory each frame, which takes over from the last user of the previous frame.
+		for (const auto& transient : transients)
 		{
-			// Grab all descs, including parent
-			std::vector<TextureDesc> totalDescs;
-			std::vector<RGResourceID> totalIDs;
-			totalDescs.reserve(aliases.size());
-			totalIDs.reserve(aliases.size());
-
-			totalDescs.push_back(parent.desc);
-			totalIDs.push_back(parent.id);
-			for (const auto& aliasData : aliases)
-			{
-				totalDescs.push_back(aliasData.desc);
-				totalIDs.push_back(aliasData.id);
-			}
-
-			auto textures = m_rd->CreateAliasedTextures(totalDescs, m_nonRtDsTextureMemPool);
-			// Identical ordering of totalDescs/totalIDs
-			u32 x = 0;
-			std::unordered_map<RGResourceID, Texture> textureMapped;
-			for (const auto& tex : textures)
-			{
-				auto id = totalIDs[x++];
-				textureMapped[id] = tex;
-				SetTexture(id, tex);
-			}
+			m_memInfo.naiveBytes += transient.size;
+			++m_memInfo.transientResources;
 
-			// Add to barrier tracking
-			if (aliases.size() > 0)
+			const TransientPlacement* before{ nullptr };
+			u32 sharedWith = 0;
+			for (const auto& other : transients)
 			{
-				// Get chronological lifetime order
-				std::vector<std::pair<u32, RGResourceID>> lifetimeOrder;
-				lifetimeOrder.push_back({ parent.lifetime.first, parent.id });
-				for (const auto& aliasData : aliases)
-					lifetimeOrder.push_back({ aliasData.lifetime.first, aliasData.id });
-				std::sort(lifetimeOrder.begin(), lifetimeOrder.end(), [](const std::pair<u32, RGResourceID>& lh, const std::pair<u32, RGResourceID>& rh)
-					{
-						return lh.first < rh.first;
-					});
-
-				// Track pairwise transition
-				RGResourceID firstResource, lastResource;
-				for (u32 i = 0; i < lifetimeOrder.size(); i += 2)
+				if (&other == &transient || other.heap != transient.heap)
+					continue;
+				if (other.offset < transient.offset + transient.size && transient.offset < other.offset + other.size)
 				{
-					if (i + 1 >= lifetimeOrder.size())
-						break;
-
-					auto oldResource = lifetimeOrder[i].second;
-					auto newResource = lifetimeOrder[i + 1].second;
-					auto depLevelToInsertAt = lifetimeOrder[i + 1].first;		// Right before newResource is used
-
-					if (i == 0)
-						firstResource = oldResource;
-
-					// Get the last newResource
-					lastResource = newResource;
-
-					auto& barrs = m_aliasingBarrierPerDepLevel[depLevelToInsertAt];
-					barrs.push_back(GPUBarrier::Aliasing(textureMapped[oldResource], textureMapped[newResource]));
+					before = &other;
+					++sharedWith;
 				}
-
-				// Track end-to-start
-				m_aliasingBarrierWrap.push_back(GPUBarrier::Aliasing(textureMapped[lastResource], textureMapped[firstResource]));
 			}
-		}
-#endif
-
 
-		// Assign underlying resource to aliased resources
-		for (auto& [_, resource] : m_resources)
-		{
-			if (resource.variantType != RGResourceVariant::Aliased)
+			if (sharedWith == 0)
 				continue;
 
-			RGResourceAliased& alias = std::get<RGResourceAliased>(resource.variants);
-			const auto& original = m_resources.find(alias.originalID)->second;
-			resource.resource = original.resource;
+			// Unknown predecessor if several resources overlap this one
+			const u64 beforeResource = sharedWith == 1 ? before->resource : 0;
+			auto& barrs = m_aliasingBarrierPerDepLevel[transient.lifetime.first];
+			if (transient.type == RGResourceType::Texture)
+				barrs.push_back(GPUBarrier::Aliasing(Texture(beforeResource), Texture(transient.resource)));
+			else
+				barrs.push_back(GPUBarrier::Aliasing(Buffer(beforeResource), Buffer(transient.resource)));
 		}
 	}
 
@@ -715,6 +626,60 @@ namespace DOG::gfx
 
 
 
+	void RGResourceManager::DescribeDeclarations(std::string& topology) const
+	{
+		// Described in name order, the map iteration order varies with its insertion history
+		std::vector<const std::pair<const RGResourceID, RGResource>*> sorted;
+		sorted.reserve(m_resources.size());
+		for (const auto& entry : m_resources)
+			sorted.push_back(&entry);
+		std::sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->first.name < b->first.name; });
+
+		AppendTopology(topology, sorted.size());
+		for (const auto* entry : sorted)
+		{
+			const auto& [id, resource] = *entry;
+			AppendTopology(topology, id.name);
+			AppendTopology(topology, resource.resourceType);
+			AppendTopology(topology, resource.variantType);
+
+			if (resource.variantType == RGResourceVariant::Declared)
+			{
+				const auto& decl = std::get<RGResourceDeclared>(resource.variants);
+				if (resource.resourceType == RGResourceType::Texture)
+				{
+					const auto& desc = std::get<RGTextureDesc>(decl.desc);
+					AppendTopology(topology, desc.width);
+					AppendTopology(topology, desc.height);
+					AppendTopology(topology, desc.depth);
+					AppendTopology(topology, desc.mipLevels);
+					AppendTopology(topology, desc.format);
+					AppendTopology(topology, desc.type);
+					AppendTopology(topology, desc.flags);
+					AppendTopology(topology, desc.initState);
+				}
+				else
+				{
+					const auto& desc = std::get<RGBufferDesc>(decl.desc);
+					AppendTopology(topology, desc.size);
+					AppendTopology(topology, desc.flags);
+					AppendTopology(topology, desc.initState);
+				}
+			}
+			else if (resource.variantType == RGResourceVariant::Imported)
+			{
+				const auto& imported = std::get<RGResourceImported>(resource.variants);
+				AppendTopology(topology, imported.importEntryState);
+				AppendTopology(topology, imported.importExitState);
+			}
+			else if (resource.variantType == RGResourceVariant::Aliased)
+			{
+				const auto& aliased = std::get<RGResourceAliased>(resource.variants);
+				AppendTopology(topology, aliased.prevID.name);
+			}
+		}
+	}
+
 	u64 RGResourceManager::GetResource(RGResourceID id)
 	{
 		// Aliasing always goes to the original resource
@@ -1,6 +1,7 @@
 #pragma once
 #include "RGTypes.h"
 #include "../../RHI/Types/GPUInfo.h"
+#include "../../RHI/Types/ResourceDescs.h"
 #include "../../RHI/Types/BarrierDesc.h"
 #include "../../RHI/RenderResourceHandles.h"
 
@@ -16,7 +17,15 @@ namespace DOG::gfx
 		RGResourceManager(RenderDevice* rd, GPUGarbageBin* bin);
 		~RGResourceManager();
 
-		const GPUPoolMemoryInfo& GetMemoryInfo();
+		struct MemoryInfo
+		{
+			GPUPoolMemoryInfo pools;			// Summed over the graph's memory pools
+			u64 naiveBytes{ 0 };				// Transient resources with one allocation each
+			u64 placedBytes{ 0 };				// Heaps the transient resources were packed into, the peak at any point of the graph
+			u32 transientResources{ 0 };
+			u32 heaps{ 0 };
+		};
+		const MemoryInfo& GetMemoryInfo();
 
 		// Discards the resources stored safely and clears map for re-use.
 		void ClearDeclaredResources(bool immediate = false);
@@ -44,7 +53,6 @@ namespace DOG::gfx
 
 		// Interface for render graph
 		void ResolveMemoryAliases(CommandList list, u32 depLevel);
-		void ResolveMemoryAliasesWrap(CommandList list);
 
 
 	private:
@@ -85,17 +93,36 @@ namespace DOG::gfx
 
 		};
 
+		struct TransientPlacement
+		{
+			RGResourceID id;
+			RGResourceType type{ RGResourceType::Texture };
+			std::variant<TextureDesc, BufferDesc> desc;
+			u64 size{ 0 };
+			std::pair<u32, u32> lifetime;
+			u32 heap{ 0 };
+			u64 offset{ 0 };
+			u64 resource{ 0 };
+		};
+
 		// ======================
 
 	private:
 		// RealizeResources be called after resource lifetimes have been resolved
 		void RealizeResources();
 		void SanitizeAliasingLifetimes();
+
+		// Packs transients with disjoint lifetimes into shared heaps, returns the size of each heap
+		static std::vector<u64> PlaceTransients(std::vector<TransientPlacement>& transients, u64 heapCapacity);
+		void RealizeTransients(std::vector<TransientPlacement>& transients, MemoryPool pool, u64 heapCapacity);
 		void ImportedResourceExitTransition(CommandList cmdl);
 		void DeclaredResourceTransitionToInit(CommandList cmdl);
 
 		void ResolveLifetime(RGResourceID id, u32 depth);
 
+		// Appends everything the graph compiler reads from the declared and imported resources, independent of declaration order
+		void DescribeDeclarations(std::string& topology) const;
+
 		u64 GetResource(RGResourceID id);
 		RGResourceType GetResourceType(RGResourceID id) const;
 		RGResourceVariant GetResourceVariant(RGResourceID id) const;
@@ -114,6 +141,10 @@ namespace DOG::gfx
 		void SetTexture(RGResourceID id, Texture texture);
 
 	private:
+		static constexpr u32 RT_DS_POOL_BLOCK_SIZE = 18'000'000;
+		static constexpr u32 NON_RT_DS_POOL_BLOCK_SIZE = 20'000'000;
+		static constexpr u32 BUFFER_POOL_BLOCK_SIZE = 10'000'000;
+
 		RenderDevice* m_rd{ nullptr };
 		GPUGarbageBin* m_bin{ nullptr };
 		std::unordered_map<RGResourceID, RGResource> m_resources;
@@ -127,10 +158,9 @@ namespace DOG::gfx
 		MemoryPool m_nonRtDsTextureMemPool;
 		MemoryPool m_bufferMemPool;
 
-		GPUPoolMemoryInfo m_totalMemUsage;
+		MemoryInfo m_memInfo;
 
 		std::unordered_map<u32, std::vector<GPUBarrier>> m_aliasingBarrierPerDepLevel;
-		std::vector<GPUBarrier> m_aliasingBarrierWrap;
 
 	};
 }
\ No newline at end of file
@@ -164,6 +164,20 @@ namespace DOG::gfx
 		return false;
 	}
 
+	// Graph topologies are described as a byte string, the compiled graph cache is keyed by its hash and verified against the whole string
+	template<typename T>
+	static void AppendTopology(std::string& topology, const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		topology.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static void AppendTopology(std::string& topology, const std::string& name)
+	{
+		AppendTopology(topology, name.size());
+		topology.append(name);
+	}
+
 }
 
 /*
@@ -2,6 +2,7 @@
 #include "RGResourceManager.h"
 #include "../../RHI/RenderDevice.h"
 #include "../GPUGarbageBin.h"
+#include "../../../common/ThreadPool.h"
 #include <set>
 #include <fstream>
 
@@ -20,6 +21,12 @@ namespace DOG::gfx
 		m_sortedPasses.reserve(PASS_RESERVED);
 		m_dependencyLevels.reserve(DEP_LEVELS_RESERVED);
 		m_passDataAllocator = std::make_unique<BumpAllocator>(131'072);	// 128 Kb
+		m_recorders = std::make_unique<ThreadPool>(ThreadPool::DefaultWorkerCount(MAX_RECORDING_WORKERS), "RenderGraph recorder");
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		Clear();
 	}
 
 	void RenderGraph::Clear(bool immediate)
@@ -102,25 +109,33 @@ namespace DOG::gfx
 			AddProxies();
 		}
 
+		// The pass order, dependency levels and state transitions only depend on the declared passes and resources
+		m_topology.clear();
+		DescribeTopology(m_topology);
+		m_topologyHash = std::hash<std::string>()(m_topology);
+		auto compiled = m_compiledGraphs.find(m_topologyHash);
+		if (compiled != m_compiledGraphs.end() && compiled->second.topology != m_topology)
 		{
-			ZoneNamedN(RGBuildAdjacencyMap, "RG Building: Build AdjacencyMap", true);
-			BuildAdjacencyMap();
+			// Another topology with the same hash, it is recompiled in its place
+			++m_topologyCollisions;
+			m_compiledGraphs.erase(compiled);
+			compiled = m_compiledGraphs.end();
 		}
 
-		// To help the graph author see what's going on.
-		// @TODO: Expand with input/output labels on each pass
-#ifdef GENERATE_GRAPHVIZ
-		GenerateGraphviz();
-#endif
-
+		const bool compiledNow = compiled == m_compiledGraphs.end();
+		if (compiledNow)
 		{
-			ZoneNamedN(RGSortTopological, "RG Building: Topological Sort", true);
-			SortPassesTopologically();
-		}
+			if (m_compiledGraphs.size() >= MAX_COMPILED_GRAPHS)
+				m_compiledGraphs.clear();
 
+			compiled = m_compiledGraphs.emplace(m_topologyHash, CompiledGraph()).first;
+			compiled->second.topology = m_topology;
+			Compile(compiled->second);
+		}
+		else
 		{
-			ZoneNamedN(RGAssignDepLevels, "RG Building: Assign Dependency Levels", true);
-			AssignDependencyLevels();
+			ZoneNamedN(RGRestore, "RG Building: Restore Compiled Graph", true);
+			Restore(compiled->second);
 		}
 
 		{
@@ -134,6 +149,7 @@ namespace DOG::gfx
 			TrackLifetimes();
 		}
 
+		if (compiledNow)
 		{
 			ZoneNamedN(RGSanitizeAliasingLifetimes, "RG Building: Sanitize Aliasing Lifetimes", true);
 			m_resMan->SanitizeAliasingLifetimes();
@@ -153,12 +169,96 @@ namespace DOG::gfx
 
 		{
 			ZoneNamedN(RGTrackTransitions, "RG Building: Track Transitions", true);
-			TrackTransitions();
+			if (compiledNow)
+				TrackTransitions(compiled->second.transitions);
+			ApplyTransitions(compiled->second.transitions);
 		}
 
 		m_dirty = false;
 	}
 
+	void RenderGraph::DescribeTopology(std::string& topology) const
+	{
+		auto describeIO = [&topology](const PassIO& io)
+		{
+			AppendTopology(topology, io.id.name);
+			AppendTopology(topology, io.originalID.has_value());
+			if (io.originalID)
+				AppendTopology(topology, io.originalID->name);
+			AppendTopology(topology, io.type);
+			AppendTopology(topology, io.desiredState);
+			AppendTopology(topology, io.aliasWrite);
+		};
+
+		m_resMan->DescribeDeclarations(topology);
+		AppendTopology(topology, m_passes.size());
+		for (const auto& pass : m_passes)
+		{
+			AppendTopology(topology, pass->name);
+			AppendTopology(topology, pass->inputs.size());
+			for (const auto& input : pass->inputs)
+				describeIO(input);
+			AppendTopology(topology, pass->outputs.size());
+			for (const auto& output : pass->outputs)
+				describeIO(output);
+			AppendTopology(topology, pass->proxyInput.size());
+			for (const auto& id : pass->proxyInput)
+				AppendTopology(topology, id.name);
+			AppendTopology(topology, pass->proxyOutput.size());
+			for (const auto& id : pass->proxyOutput)
+				AppendTopology(topology, id.name);
+		}
+	}
+
+	void RenderGraph::Compile(CompiledGraph& compiled)
+	{
+		{
+			ZoneNamedN(RGBuildAdjacencyMap, "RG Building: Build AdjacencyMap", true);
+			BuildAdjacencyMap();
+		}
+
+		// To help the graph author see what's going on.
+		// @TODO: Expand with input/output labels on each pass
+#ifdef GENERATE_GRAPHVIZ
+		GenerateGraphviz();
+#endif
+
+		{
+			ZoneNamedN(RGSortTopological, "RG Building: Topological Sort", true);
+			SortPassesTopologically();
+		}
+
+		{
+			ZoneNamedN(RGAssignDepLevels, "RG Building: Assign Dependency Levels", true);
+			AssignDependencyLevels();
+		}
+
+		// Pass IDs are the declaration indices, which the topology hash covers
+		compiled.sortedPassIDs.reserve(m_sortedPasses.size());
+		for (const auto& pass : m_sortedPasses)
+			compiled.sortedPassIDs.push_back(pass->id);
+		compiled.passDepths.reserve(m_passes.size());
+		for (const auto& pass : m_passes)
+			compiled.passDepths.push_back(pass->depth);
+		compiled.maxDepth = m_maxDepth;
+	}
+
+	void RenderGraph::Restore(const CompiledGraph& compiled)
+	{
+		assert(compiled.passDepths.size() == m_passes.size());
+
+		for (const auto& pass : m_passes)
+		{
+			assert(m_passes[pass->id] == pass);
+			pass->depth = compiled.passDepths[pass->id];
+		}
+
+		m_sortedPasses.reserve(compiled.sortedPassIDs.size());
+		for (u32 id : compiled.sortedPassIDs)
+			m_sortedPasses.push_back(m_passes[id].get());
+		m_maxDepth = compiled.maxDepth;
+	}
+
 	std::optional<SyncReceipt> RenderGraph::Execute(std::optional<SyncReceipt> incomingSync, bool generateSync)
 	{
 		assert(!m_dirty);
@@ -221,30 +321,91 @@ namespace DOG::gfx
 
 
 
-		m_cmdl = m_rd->AllocateCommandList();
-
 		for (auto& pass : m_sortedPasses)
 		{
 			if (pass->preGraphExecute)
 				(*pass->preGraphExecute)();
 		}
 
-		u32 currDep = 0;
-		for (auto& depLevel : m_dependencyLevels)
+		// Every pass (or range of a split pass) is recorded into its own command list. Resource states are tracked while
+		// recording barriers, so those are recorded on this thread up front, in level order, into the first list of each level.
+		m_cmdls.clear();
+		m_serialJobs.clear();
+		m_parallelJobs.clear();
 		{
-			m_resMan->ResolveMemoryAliases(m_cmdl, currDep);
-			depLevel.Execute(m_rd, m_cmdl);
+			ZoneNamedN(RGPrepareRecording, "RG Exec: Record Barriers", true);
 
-			++currDep;
+			u32 currDep = 0;
+			for (auto& depLevel : m_dependencyLevels)
+			{
+				CommandList levelEntry = m_rd->AllocateCommandList();
+				m_cmdls.push_back(levelEntry);
+				m_resMan->ResolveMemoryAliases(levelEntry, currDep);
+				depLevel.RecordEntryBarriers(m_rd, levelEntry);
+
+				bool entryListTaken = false;
+				for (Pass* pass : depLevel.GetPasses())
+				{
+					u32 items = 0;
+					u32 ranges = 1;
+					if (pass->rangedExecFunc)
+					{
+						items = pass->itemCountFunc();
+						ranges = std::clamp((items + pass->minItemsPerList - 1) / pass->minItemsPerList, 1u, m_recorders->GetWorkerCount() + 1);
+					}
+
+					for (u32 range = 0; range < ranges; ++range)
+					{
+						RecordJob job{};
+						job.pass = pass;
+						job.first = items * range / ranges;
+						job.count = items * (range + 1) / ranges - job.first;
+						if (ranges > 1)
+							job.split = range == 0 ? RenderPassSplit::First : (range + 1 == ranges ? RenderPassSplit::Last : RenderPassSplit::Middle);
+
+						if (!entryListTaken)
+						{
+							job.cmdl = levelEntry;
+							entryListTaken = true;
+						}
+						else
+						{
+							job.cmdl = m_rd->AllocateCommandList();
+							m_cmdls.push_back(job.cmdl);
+						}
+
+						if (pass->parallelRecording)
+							m_parallelJobs.push_back(job);
+						else
+							m_serialJobs.push_back(job);
+					}
+				}
+
+				++currDep;
+			}
 		}
 
+		{
+			ZoneNamedN(RGRecordPasses, "RG Exec: Record Passes", true);
+
+			// The main thread takes the serial passes and then helps out with whatever parallel work is left
+			if (!m_parallelJobs.empty())
+				m_recorders->Dispatch(static_cast<u32>(m_parallelJobs.size()), [this](u32 i) { RecordPass(m_parallelJobs[i]); });
+			for (const auto& job : m_serialJobs)
+				RecordPass(job);
+			if (!m_parallelJobs.empty())
+				m_recorders->Wait();
+		}
 
-		m_resMan->ImportedResourceExitTransition(m_cmdl);
-		m_resMan->DeclaredResourceTransitionToInit(m_cmdl);
+		if (m_cmdls.empty())
+			m_cmdls.push_back(m_rd->AllocateCommandList());
+		CommandList exitList = m_cmdls.back();
 
-		m_resMan->ResolveMemoryAliasesWrap(m_cmdl);
+		m_resMan->ImportedResourceExitTransition(exitList);
+		m_resMan->DeclaredResourceTransitionToInit(exitList);
 
-		auto outgoingSync = m_rd->SubmitCommandList(m_cmdl, QueueType::Graphics, incomingSync, generateSync);
+		// Lists execute in submission order, which keeps split render passes and the barriers between levels valid
+		auto outgoingSync = m_rd->SubmitCommandLists(m_cmdls, QueueType::Graphics, incomingSync, generateSync);
 
 
 		for (auto& pass : m_sortedPasses)
@@ -253,10 +414,11 @@ namespace DOG::gfx
 				(*pass->postGraphExecute)();
 		}
 
-		// Clean up command list
-		auto delFunc = [rd = m_rd, cmdl = m_cmdl]()
+		// Clean up command lists
+		auto delFunc = [rd = m_rd, cmdls = m_cmdls]()
 		{
-			rd->RecycleCommandList(cmdl);
+			for (const auto& cmdl : cmdls)
+				rd->RecycleCommandList(cmdl);
 		};
 		m_bin->PushDeferredDeletion(delFunc);
 
@@ -406,7 +568,7 @@ namespace DOG::gfx
 		}
 	}
 
-	void RenderGraph::TrackTransitions()
+	void RenderGraph::TrackTransitions(std::vector<CompiledGraph::Transition>& transitions)
 	{
 		struct TransitionMetadata
 		{
@@ -464,46 +626,64 @@ namespace DOG::gfx
 
 			for (const auto& [rgResource, states] : resourceStates)
 			{
-				auto resource = m_resMan->GetResource(rgResource);
-
-				// https://learn.microsoft.com/en-us/windows/win32/api/d3d12/ns-d3d12-d3d12_resource_uav_barrier
-				// UAV Barrier not required if user only does read on the resource.
-				// But we will always assume a write and insert a UAV barrier to avoid potential user bugs (e.g specifying read only but actually writing to it)
-				// We cannot detect if a user writes to a resource or not (since it's on the shader side)
-				std::optional<GPUBarrier> uavBarrier;
-				GPUBarrier transitionBarrier{};
+				CompiledGraph::Transition transition{};
+				transition.depLevel = (u32)(&depLevel - m_dependencyLevels.data());
+				transition.id = rgResource;
+				transition.type = states.type;
+				transition.before = states.before;
+				transition.after = states.after;
+				transitions.push_back(transition);
 
-				if (states.type == RGResourceType::Texture)
-				{
-					transitionBarrier = GPUBarrier::Transition(
-						Texture(resource),
-						D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
-						states.before, states.after);
+				m_resMan->SetCurrentState(rgResource, states.after);
+			}
+		}
+	}
 
-					if (states.before == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
-						uavBarrier = GPUBarrier::UAV(Texture(resource));
-				}
-				else
-				{
-					transitionBarrier = GPUBarrier::Transition(
-						Buffer(resource),
-						D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
-						states.before, states.after);
+	void RenderGraph::ApplyTransitions(const std::vector<CompiledGraph::Transition>& transitions)
+	{
+		for (const auto& transition : transitions)
+		{
+			auto& depLevel = m_dependencyLevels[transition.depLevel];
+			auto resource = m_resMan->GetResource(transition.id);
 
-					if (states.before == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
-						uavBarrier = GPUBarrier::UAV(Buffer(resource));
-				}
+			// https://learn.microsoft.com/en-us/windows/win32/api/d3d12/ns-d3d12-d3d12_resource_uav_barrier
+			// UAV Barrier not required if user only does read on the resource.
+			// But we will always assume a write and insert a UAV barrier to avoid potential user bugs (e.g specifying read only but actually writing to it)
+			// We cannot detect if a user writes to a resource or not (since it's on the shader side)
+			std::optional<GPUBarrier> uavBarrier;
+			GPUBarrier transitionBarrier{};
 
-				// Assure that any acceses AFTER an unordered access always gets write results
-				if (uavBarrier)
-					depLevel.AddEntryBarrier(*uavBarrier, rgResource);
+			if (transition.type == RGResourceType::Texture)
+			{
+				transitionBarrier = GPUBarrier::Transition(
+					Texture(resource),
+					D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+					transition.before, transition.after);
 
-				// No need for state transition, return early
-				if (states.before != states.after)
-					depLevel.AddEntryBarrier(transitionBarrier, rgResource);
+				if (transition.before == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+					uavBarrier = GPUBarrier::UAV(Texture(resource));
+			}
+			else
+			{
+				transitionBarrier = GPUBarrier::Transition(
+					Buffer(resource),
+					D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+					transition.before, transition.after);
 
-				m_resMan->SetCurrentState(rgResource, states.after);
+				if (transition.before == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+					uavBarrier = GPUBarrier::UAV(Buffer(resource));
 			}
+
+			// Assure that any acceses AFTER an unordered access always gets write results
+			if (uavBarrier)
+				depLevel.AddEntryBarrier(*uavBarrier, transition.id);
+
+			// No need for state transition, return early
+			if (transition.before != transition.after)
+				depLevel.AddEntryBarrier(transitionBarrier, transition.id);
+
+			// Replayed graphs end up in the same states as when they were compiled
+			m_resMan->SetCurrentState(transition.id, transition.after);
 		}
 	}
 
@@ -1129,7 +1309,7 @@ namespace DOG::gfx
 
 
 
-	void RenderGraph::DependencyLevel::Execute(RenderDevice* rd, CommandList cmdl)
+	void RenderGraph::DependencyLevel::RecordEntryBarriers(RenderDevice* rd, CommandList cmdl)
 	{
 		// Resolve potentially changed resources
 		for (u32 i = 0; i < m_entryBarriers.size(); ++i)
@@ -1140,22 +1320,23 @@ namespace DOG::gfx
 
 		if (!m_entryBarriers.empty())
 			rd->Cmd_Barrier(cmdl, m_entryBarriers);
+	}
 
-		for (const auto& pass : m_passes)
-		{
-			ZoneTransientN(Zone1, pass->name.c_str(), true);
+	void RenderGraph::RecordPass(const RecordJob& job)
+	{
+		Pass* pass = job.pass;
+		ZoneTransientN(Zone1, pass->name.c_str(), true);
 
-			if (pass->rp)
-			{
-				rd->Cmd_BeginRenderPass(cmdl, *pass->rp);
-				pass->execFunc(rd, cmdl, pass->passResources);
-				rd->Cmd_EndRenderPass(cmdl);
-			}
-			else
-			{
-				pass->execFunc(rd, cmdl, pass->passResources);
-			}
-		}
+		if (pass->rp)
+			m_rd->Cmd_BeginRenderPass(job.cmdl, *pass->rp, job.split);
+
+		if (pass->rangedExecFunc)
+			pass->rangedExecFunc(m_rd, job.cmdl, pass->passResources, job.first, job.count);
+		else
+			pass->execFunc(m_rd, job.cmdl, pass->passResources);
+
+		if (pass->rp)
+			m_rd->Cmd_EndRenderPass(job.cmdl);
 	}
 
 
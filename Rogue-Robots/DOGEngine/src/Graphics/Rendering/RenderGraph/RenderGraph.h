@@ -9,6 +9,11 @@
 
 //#define GENERATE_GRAPHVIZ
 
+namespace DOG
+{
+	class ThreadPool;
+}
+
 namespace DOG::gfx
 {
 	class RenderDevice;
@@ -86,6 +91,13 @@ namespace DOG::gfx
 			std::optional<std::function<void()>> preGraphExecute, postGraphExecute;
 			std::function<void(RenderDevice*, CommandList, PassResources&)> execFunc;
 			PassResources passResources;
+
+			// Parallel passes are recorded on worker threads into their own command lists.
+			// Split passes record the item range [first, first + count) per list, itemCount is queried every execution.
+			bool parallelRecording{ false };
+			std::function<void(RenderDevice*, CommandList, PassResources&, u32, u32)> rangedExecFunc;
+			std::function<u32()> itemCountFunc;
+			u32 minItemsPerList{ 0 };
 			
 			// If pass writes to render target, render pass is sued
 			std::optional<RenderPass> rp;
@@ -96,7 +108,8 @@ namespace DOG::gfx
 		public:
 			DependencyLevel(RGResourceManager* resMan) : m_resMan(resMan) {}
 
-			void Execute(RenderDevice* rd, CommandList cmdl);
+			// Pass recording is driven by the graph, the level only owns the barriers into it
+			void RecordEntryBarriers(RenderDevice* rd, CommandList cmdl);
 	
 			void AddPass(Pass* pass) { m_passes.push_back(pass); }
 			void AddEntryBarrier(GPUBarrier barrier, RGResourceID id) { m_entryBarriers.push_back(barrier); m_barrierResourceIDs.push_back(id); }
@@ -130,6 +143,25 @@ namespace DOG::gfx
 			std::vector<std::pair<u32, u32>> proxies;
 		};
 
+		// Device independent result of compiling a graph topology, replayed when a graph with the same topology hash is built again
+		struct CompiledGraph
+		{
+			struct Transition
+			{
+				u32 depLevel{ 0 };
+				RGResourceID id;
+				RGResourceType type{ RGResourceType::Texture };
+				D3D12_RESOURCE_STATES before{ D3D12_RESOURCE_STATE_COMMON };
+				D3D12_RESOURCE_STATES after{ D3D12_RESOURCE_STATE_COMMON };
+			};
+
+			std::string topology;				// Hash collisions are caught by comparing the full description
+			std::vector<u32> sortedPassIDs;
+			std::vector<u32> passDepths;		// Indexed by pass ID
+			u32 maxDepth{ 0 };
+			std::vector<Transition> transitions;
+		};
+
 	public:
 		struct PassBuilder
 		{
@@ -157,6 +189,9 @@ namespace DOG::gfx
 			void CopyToResource(RGResourceID id, RGResourceType type);
 			void CopyFromResource(RGResourceID id, RGResourceType type);
 
+			// Execution only touches thread safe state (resources handed out by PassResources, dynamic constants, views),
+			// so the pass may be recorded on a worker thread at the same time as other passes in its dependency level
+			void AllowParallelRecording() { m_pass.parallelRecording = true; }
 
 		private:
 			// Auto-proxy and auto-alias helpers
@@ -177,7 +212,7 @@ namespace DOG::gfx
 
 	public:
 		RenderGraph(RenderDevice* rd, RGResourceManager* resMan, GPUGarbageBin* bin);
-		~RenderGraph() { Clear(); }
+		~RenderGraph();
 
 		template <typename PassData>
 		void AddPass(const std::string& name,
@@ -229,6 +264,46 @@ namespace DOG::gfx
 				});
 		}
 
+		// Pass over a list of independent items (e.g draw batches). Each execution the items are divided into ranges of
+		// at least minItemsPerList which are recorded in parallel, a render pass is suspended and resumed across the ranges.
+		template <typename PassData>
+		void AddSplitPass(const std::string& name,
+			const std::function<void(PassData&, PassBuilder&)>& buildFunc,
+			const std::function<u32(const PassData&)>& itemCountFunc,
+			u32 minItemsPerList,
+			const std::function<void(const PassData&, RenderDevice*, CommandList, PassResources&, u32, u32)>& rangedExecFunc)
+		{
+			assert(minItemsPerList > 0);
+			if (!m_dirty)
+				return;
+
+			Pass newPass(name, m_nextPassID++);
+			PassBuilder builder(m_passBuilderGlobalData, m_resMan, newPass);
+
+			u8* memory = m_passDataAllocator->Allocate(sizeof(PassData));
+			PassData* passData = new (memory) PassData();
+
+			buildFunc(*passData, builder);
+
+			auto pass = std::make_unique<Pass>(std::move(newPass));
+			pass->parallelRecording = true;
+			pass->minItemsPerList = minItemsPerList;
+			pass->itemCountFunc = [itemCountFunc, memory = passData]()
+			{
+				return itemCountFunc(*memory);
+			};
+			pass->rangedExecFunc = [rangedExecFunc, memory = passData](RenderDevice* rd, CommandList cmdl, PassResources& resources, u32 first, u32 count)
+			{
+				rangedExecFunc(*memory, rd, cmdl, resources, first, count);
+			};
+
+			m_passes.push_back(std::move(pass));
+			m_passDataDestructors.push_back([data = passData]()
+				{
+					data->~PassData();
+				});
+		}
+
 		void Clear(bool immediate = false);
 		void TryBuild();
 		void Build();
@@ -240,22 +315,46 @@ namespace DOG::gfx
 		*/
 		std::optional<SyncReceipt> Execute(std::optional<SyncReceipt> incomingSync = {}, bool generateSync = false);
 
+		// Hash of the passes and resources of the last build, graphs with equal hashes share their compiled result
+		u64 GetTopologyHash() const { return m_topologyHash; }
+		u32 GetCompiledGraphCount() const { return (u32)m_compiledGraphs.size(); }
+		// Builds whose topology hash matched a compiled graph with a different topology
+		u32 GetTopologyCollisionCount() const { return m_topologyCollisions; }
+
 	private:
 
 		void AddProxies();
+		void DescribeTopology(std::string& topology) const;
+		void Compile(CompiledGraph& compiled);
+		void Restore(const CompiledGraph& compiled);
+
 		void BuildAdjacencyMap();
 		void SortPassesTopologically();
 		void AssignDependencyLevels();
 		void BuildDependencyLevels();
 
 		void TrackLifetimes();
-		void TrackTransitions();
+		void TrackTransitions(std::vector<CompiledGraph::Transition>& transitions);
+		void ApplyTransitions(const std::vector<CompiledGraph::Transition>& transitions);
 
 		void RealizeViews();
 
 		void GenerateGraphviz();
 
+		// One command list worth of recording, a whole pass or one range of a split pass
+		struct RecordJob
+		{
+			Pass* pass{ nullptr };
+			CommandList cmdl;
+			u32 first{ 0 };
+			u32 count{ 0 };
+			RenderPassSplit split{ RenderPassSplit::None };
+		};
+		void RecordPass(const RecordJob& job);
+
 	private:
+		static constexpr u32 MAX_RECORDING_WORKERS = 7;
+
 		RenderDevice* m_rd{ nullptr };
 		RGResourceManager* m_resMan{ nullptr };
 		GPUGarbageBin* m_bin{ nullptr };
@@ -269,11 +368,22 @@ namespace DOG::gfx
 		u32 m_maxDepth{ 0 };
 		std::vector<DependencyLevel> m_dependencyLevels;
 
+		// Compiled topologies, a settings toggle back and forth rebuilds without recompiling
+		static constexpr u32 MAX_COMPILED_GRAPHS = 16;
+		std::unordered_map<u64, CompiledGraph> m_compiledGraphs;
+		std::string m_topology;
+		u64 m_topologyHash{ 0 };
+		u32 m_topologyCollisions{ 0 };
+
 		// Bump allocator which is reset after each graph build
 		std::unique_ptr<BumpAllocator> m_passDataAllocator;
 		std::vector<std::function<void()>> m_passDataDestructors;
 
-		CommandList m_cmdl;
+		// Submitted in order as one batch, entry barriers of a level go into the first list of that level
+		std::vector<CommandList> m_cmdls;
+		std::vector<RecordJob> m_serialJobs;
+		std::vector<RecordJob> m_parallelJobs;
+		std::unique_ptr<ThreadPool> m_recorders;
 
 		bool m_dirty{ false };
 	};
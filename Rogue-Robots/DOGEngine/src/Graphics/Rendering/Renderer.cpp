@@ -4,6 +4,7 @@
 #include "../RHI/DX12/ImGUIBackend_DX12.h"
 #include "../RHI/DX12/RenderDevice_DX12.h"
 #include "../RHI/DX12/Swapchain_DX12.h"
+#include "../RHI/Null/RenderBackend_Null.h"
 #include "../RHI/ShaderCompilerDXC.h"
 #include "../RHI/PipelineBuilder.h"
 
@@ -49,17 +50,27 @@ namespace DOG::gfx
 	Renderer::Renderer(HWND hwnd, u32 clientWidth, u32 clientHeight, bool debug, GraphicsSettings& settings)
 	{
 		m_jointMan = std::make_unique<AnimationManager>();
-		m_backend = std::make_unique<gfx::RenderBackend_DX12>(debug);
+		m_backendType = settings.backend;
+		if (m_backendType == GraphicsBackend::Null)
+			m_backend = std::make_unique<gfx::RenderBackend_Null>();
+		else
+			m_backend = std::make_unique<gfx::RenderBackend_DX12>(debug);
 		m_rd = m_backend->CreateDevice(S_NUM_BACKBUFFERS);
 		m_sc = m_rd->CreateSwapchain(hwnd, (u8)S_NUM_BACKBUFFERS);
 
+		// There is no window to size the null swapchain after
+		if (m_backendType == GraphicsBackend::Null)
+			m_sc->OnResize(clientWidth, clientHeight);
+
 		// Swapchain is created -> we can check if settings verify settings against it.
 		VerifyAndSanitizeGraphicsSettings(settings, clientWidth, clientHeight);
 		m_graphicsSettings = settings;
 		m_renderWidth = m_graphicsSettings.renderResolution.x;
 		m_renderHeight = m_graphicsSettings.renderResolution.y;
 
-		UI::Initialize(m_rd, m_sc, S_NUM_BACKBUFFERS, clientWidth, clientHeight);
+		// UI and ImGui draw through D2D and DX12 directly, the null backend runs without them
+		if (m_backendType == GraphicsBackend::DX12)
+			UI::Initialize(m_rd, m_sc, S_NUM_BACKBUFFERS, clientWidth, clientHeight);
 		PostProcess::Initialize();
 
 		m_frameSyncs.resize(S_MAX_FIF);
@@ -67,10 +78,13 @@ namespace DOG::gfx
 		m_singleSidedShadowDraws.resize(12);
 		m_doubleSidedShadowDraws.resize(12);
 
-		AddScenes();
-		UIRebuild(clientHeight, clientWidth);
+		if (m_backendType == GraphicsBackend::DX12)
+		{
+			AddScenes();
+			UIRebuild(clientHeight, clientWidth);
 
-		m_imgui = std::make_unique<gfx::ImGUIBackend_DX12>(m_rd, m_sc, S_MAX_FIF);
+			m_imgui = std::make_unique<gfx::ImGUIBackend_DX12>(m_rd, m_sc, S_MAX_FIF);
+		}
 
 		m_sclr = std::make_unique<ShaderCompilerDXC>();
 
@@ -364,7 +378,8 @@ namespace DOG::gfx
 			(i.e try defining a few passes with only read/write declarations to see if the generated graph is as expected!)
 
 		*/
-		m_imGUIEffect = std::make_unique<ImGUIEffect>(m_globalEffectData, m_imgui.get());
+		if (m_imgui)
+			m_imGUIEffect = std::make_unique<ImGUIEffect>(m_globalEffectData, m_imgui.get());
 		m_testComputeEffect = std::make_unique<TestComputeEffect>(m_globalEffectData);
 		m_bloomEffect = std::make_unique<Bloom>(m_rgResMan.get(), m_globalEffectData, m_dynConstants.get(), m_renderWidth, m_renderHeight);
 		m_tiledLightCuller = std::make_unique<TiledLightCullingEffect>(m_rgResMan.get(), m_globalEffectData, m_renderWidth, m_renderHeight);
@@ -439,7 +454,8 @@ namespace DOG::gfx
 
 	Renderer::~Renderer()
 	{
-		DOG::UI::Destroy();
+		if (m_backendType == GraphicsBackend::DX12)
+			DOG::UI::Destroy();
 		Flush();
 		m_rg->Clear();
 		m_bin->ForceClear();
@@ -453,6 +469,9 @@ namespace DOG::gfx
 
 	DXGI_MODE_DESC Renderer::GetMatchingDisplayMode(std::optional<DXGI_MODE_DESC> mode) const
 	{
+		if (m_backendType == GraphicsBackend::Null)
+			return m_rd->GetMonitor().modes.front();
+
 		if (mode)
 			return static_cast<Swapchain_DX12*>(m_sc)->GetClosestMatchingDisplayModeDesc(*mode);
 		else
@@ -512,9 +531,9 @@ namespace DOG::gfx
 		sub.isWeapon = isWeapon;
 
 		if (isWeapon)
-			m_weaponSubmission.push_back(sub);
+			m_weaponDraws.submissions.push_back(sub);
 		else
-			m_submissions.push_back(sub);
+			m_opaqueDraws.submissions.push_back(sub);
 	}
 
 	void Renderer::SubmitMeshNoFaceCulling(Mesh mesh, u32 submesh, MaterialHandle material, const DirectX::SimpleMath::Matrix& world)
@@ -524,7 +543,8 @@ namespace DOG::gfx
 		sub.submesh = submesh;
 		sub.mat = material;
 		sub.world = world;
-		m_noCullSubmissions.push_back(sub);
+		sub.pipeline = DrawPipeline::NoCull;
+		m_opaqueDraws.submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitMeshWireframe(Mesh mesh, u32 submesh, MaterialHandle material, const DirectX::SimpleMath::Matrix& world)
@@ -534,7 +554,8 @@ namespace DOG::gfx
 		sub.submesh = submesh;
 		sub.mat = material;
 		sub.world = world;
-		m_wireframeDraws.push_back(sub);
+		sub.pipeline = DrawPipeline::Wireframe;
+		m_opaqueDraws.submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitMeshWireframeNoFaceCulling(Mesh mesh, u32 submesh, MaterialHandle material, const DirectX::SimpleMath::Matrix& world)
@@ -544,7 +565,8 @@ namespace DOG::gfx
 		sub.submesh = submesh;
 		sub.mat = material;
 		sub.world = world;
-		m_noCullWireframeDraws.push_back(sub);
+		sub.pipeline = DrawPipeline::WireframeNoCull;
+		m_opaqueDraws.submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitOutlinedMesh(Mesh mesh, u32 submesh, const DirectX::SimpleMath::Vector3& color, const DirectX::SimpleMath::Matrix& world, bool animated, u32 jointOffset)
@@ -569,7 +591,7 @@ namespace DOG::gfx
 		sub.world = world;
 		sub.jointOffset = jointOffset;
 		sub.animated = true;
-		m_animatedDraws.push_back(sub);
+		m_animatedDraws.submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitSingleSidedShadowMesh(u32 shadowID, Mesh mesh, u32 submesh, const DirectX::SimpleMath::Matrix& world, bool animated, u32 jointOffset)
@@ -582,7 +604,7 @@ namespace DOG::gfx
 		sub.jointOffset = jointOffset;
 
 		const auto& caster = m_activeShadowCasters[shadowID];
-		m_singleSidedShadowDraws[caster.singleSidedBucket].push_back(sub);
+		m_singleSidedShadowDraws[caster.singleSidedBucket].submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitDoubleSidedShadowMesh(u32 shadowID, Mesh mesh, u32 submesh, const DirectX::SimpleMath::Matrix& world, bool animated, u32 jointOffset)
@@ -595,7 +617,7 @@ namespace DOG::gfx
 		sub.jointOffset = jointOffset;
 
 		const auto& caster = m_activeShadowCasters[shadowID];
-		m_doubleSidedShadowDraws[caster.doubleSidedBucket].push_back(sub);
+		m_doubleSidedShadowDraws[caster.doubleSidedBucket].submissions.push_back(sub);
 	}
 
 	void DOG::gfx::Renderer::SubmitEmitters(const std::vector<ParticleEmitter>& emitters)
@@ -669,13 +691,35 @@ namespace DOG::gfx
 
 		PostProcess::Get().SetViewMat(m_pfData.viewMatrix);
 
+		if (m_clusterLightsOnCPU)
+		{
+			if (!m_lightClusterer)
+				m_lightClusterer = std::make_unique<ClusteredLightCuller>();
+
+			// Reversed depth swaps the planes the clip distances are taken from
+			ClusteredLightCuller::Setup setup;
+			setup.view = m_viewMat;
+			setup.proj = m_projMat;
+			setup.width = m_renderWidth;
+			setup.height = m_renderHeight;
+			setup.nearClip = std::max(std::min(m_pfData.nearClip, m_pfData.farClip), 0.01f);
+			setup.farClip = std::max(std::max(m_pfData.nearClip, m_pfData.farClip), setup.nearClip * 2.0f);
+
+			ClusteredLightCuller::GatherLights(*m_globalLightTable, m_clusterPointLights, m_clusterSpotLights);
+			m_lightClusterer->Cull(setup, m_clusterPointLights, m_clusterSpotLights, m_lightClusters);
+		}
 
 
 
+
+		m_pfDataTable->ResetUploadStats();
 		m_globalLightTable->SendCopyRequests(*m_perFrameUploadCtx);
 		m_globalMaterialTable->SendCopyRequests(*m_perFrameUploadCtx);
 		m_pfDataTable->SendCopyRequests(*m_perFrameUploadCtx);
 
+		TracyPlot("Light upload bytes", (int64_t)m_globalLightTable->GetUploadStats().bytes);
+		TracyPlot("Per frame data upload bytes", (int64_t)m_pfDataTable->GetUploadStats().bytes);
+
 
 		// Resolve any per frame copies from CPU
 		{
@@ -699,6 +743,8 @@ namespace DOG::gfx
 			s_donez = true;
 		}
 
+		BuildDrawBatches();
+
 		// Change backbuffer resource for this frame
 		m_rgResMan->ChangeImportedTexture(RG_RESOURCE(Backbuffer), m_sc->GetNextDrawSurface());
 
@@ -713,6 +759,8 @@ namespace DOG::gfx
 			u32 globalSubmeshID{ UINT_MAX };
 			u32 globalMaterialID{ UINT_MAX };
 			u32 jointsDescriptor{ UINT_MAX };
+			u32 instanceDescriptor{ UINT_MAX };		// UINT_MAX reads world instead of the instance transforms
+			u32 firstInstance{ 0 };
 		};
 
 		/*Struct to be filled in and passed to shader per light*/
@@ -727,7 +775,8 @@ namespace DOG::gfx
 			float strength{ 0.f };
 			bool isShadowCaster{ false };
 			u32 isPlayer{ 0 };
-			float padding[2]{ 0,0 };
+			float range{ 0.f };
+			float padding{ 0.f };
 		};
 
 		/*Encompasses all the light datas for spotlights, which we currently limit to 12*/
@@ -754,24 +803,37 @@ namespace DOG::gfx
 		{};
 
 		/*
-			@todo:
-				Still need some way to pre-allocate per draw data prior to render pass.
-				Perhaps go through the submissions and collect data --> Upload to GPU (maybe instance it as well?)
-				and during forward pass we simply read from it
+			Draw queues are sorted and batched in BuildDrawBatches before any pass records.
+			A batch with more than one submission reads its world matrices from the frame's instance transforms.
+			The pipeline table is indexed by the submission's pipeline variant, the pipeline is only switched when the variant changes.
+			The graph is built once and its passes re-run every frame, so per frame state is read through this and never captured.
+			The draw functions are called for ranges of batches from several recording threads at once and must not keep state between calls.
 		*/
-
-
-		auto drawZPassSubmissions = [&, meshTab = m_globalMeshTable.get(), matTab = m_globalMaterialTable.get(), bonezy = m_jointMan.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimated.get()](RenderDevice* rd, CommandList cmdl, const std::vector<RenderSubmission>& submissions, bool animated = false) mutable
+		auto drawZPassSubmissions = [&, meshTab = m_globalMeshTable.get(), matTab = m_globalMaterialTable.get(), bonezy = m_jointMan.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimated.get()](RenderDevice* rd, CommandList cmdl, const DrawQueue& queue, u32 firstBatch, u32 batchCount, const PipelineTable& pipelines) mutable
 		{
-			for (const auto& sub : submissions)
+			u32 currentPipeline = UINT_MAX;
+			for (u32 b = firstBatch; b < firstBatch + batchCount; ++b)
 			{
+				const auto& batch = queue.batches[b];
+				const auto& sub = queue.submissions[queue.order[batch.first].index];
+				if ((u32)sub.pipeline != currentPipeline)
+				{
+					currentPipeline = (u32)sub.pipeline;
+					rd->Cmd_SetPipeline(cmdl, pipelines[currentPipeline]);
+				}
+
 				auto perDrawHandle = dynConstants->Allocate((u32)std::ceilf(sizeof(PerDrawData) / (float)256), false);
 				PerDrawData perDrawData{};
 				perDrawData.world = sub.world;
+				if (batch.firstInstance != UINT_MAX)
+				{
+					perDrawData.instanceDescriptor = m_instanceTransformsDescriptor;
+					perDrawData.firstInstance = batch.firstInstance;
+				}
 				perDrawData.globalSubmeshID = meshTab->GetSubmeshMD_GPU(sub.mesh, sub.submesh);
 
 				GPUDynamicConstant jointsHandle;
-				if (animated)
+				if (sub.animated)
 				{
 					JointData jointsData{};
 					// Resolve joints
@@ -794,23 +856,43 @@ namespace DOG::gfx
 				rd->Cmd_UpdateShaderArgs(cmdl, QueueType::Graphics, args);
 
 				auto sm = meshTab->GetSubmeshMD_CPU(sub.mesh, sub.submesh);
-				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, 1, sm.indexStart, 0, 0);
+				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, batch.count, sm.indexStart, 0, 0);
 			}
 		};
 
 
-		auto drawSubmissions = [&, meshTab = m_globalMeshTable.get(), matTab = m_globalMaterialTable.get(), bonezy = m_jointMan.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimated.get()](RenderDevice* rd, CommandList cmdl, const std::vector<RenderSubmission>& submissions, u32 localLightBuffers, u32 perLightHandle, u32 shadowHandle, bool animated = false, bool wireframe = false) mutable
+		auto drawSubmissions = [&, meshTab = m_globalMeshTable.get(), matTab = m_globalMaterialTable.get(), bonezy = m_jointMan.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimated.get()](RenderDevice* rd, CommandList cmdl, const DrawQueue& queue, u32 firstBatch, u32 batchCount, const PipelineTable& pipelines, u32 localLightBuffers, u32 perLightHandle, u32 shadowHandle) mutable
 		{
-			for (const auto& sub : submissions)
+			u32 renderSettingsFlag = 0;
+			if (m_graphicsSettings.lit) renderSettingsFlag |= DEBUG_SETTING_LIT;
+			if (m_graphicsSettings.lightCulling) renderSettingsFlag |= DEBUG_SETTING_LIGHT_CULLING;
+			if (m_graphicsSettings.visualizeLightCulling) renderSettingsFlag |= DEBUG_SETTING_LIGHT_CULLING_VISUALIZATION;
+
+			u32 currentPipeline = UINT_MAX;
+			for (u32 b = firstBatch; b < firstBatch + batchCount; ++b)
 			{
+				const auto& batch = queue.batches[b];
+				const auto& sub = queue.submissions[queue.order[batch.first].index];
+				if ((u32)sub.pipeline != currentPipeline)
+				{
+					currentPipeline = (u32)sub.pipeline;
+					rd->Cmd_SetPipeline(cmdl, pipelines[currentPipeline]);
+				}
+				const bool wireframe = sub.pipeline == DrawPipeline::Wireframe || sub.pipeline == DrawPipeline::WireframeNoCull;
+
 				auto perDrawHandle = dynConstants->Allocate((u32)std::ceilf(sizeof(PerDrawData) / (float)256), false);
 				PerDrawData perDrawData{};
 				perDrawData.world = sub.world;
+				if (batch.firstInstance != UINT_MAX)
+				{
+					perDrawData.instanceDescriptor = m_instanceTransformsDescriptor;
+					perDrawData.firstInstance = batch.firstInstance;
+				}
 				perDrawData.globalSubmeshID = meshTab->GetSubmeshMD_GPU(sub.mesh, sub.submesh);
 				perDrawData.globalMaterialID = matTab->GetMaterialIndex(sub.mat);
 
 				GPUDynamicConstant jointsHandle;
-				if (animated)
+				if (sub.animated)
 				{
 					JointData jointsData{};
 					// Resolve joints
@@ -822,10 +904,6 @@ namespace DOG::gfx
 				}
 
 				std::memcpy(perDrawHandle.memory, &perDrawData, sizeof(perDrawData));
-				u32 renderSettingsFlag = 0;
-				if (m_graphicsSettings.lit) renderSettingsFlag |= DEBUG_SETTING_LIT;
-				if (m_graphicsSettings.lightCulling) renderSettingsFlag |= DEBUG_SETTING_LIGHT_CULLING;
-				if (m_graphicsSettings.visualizeLightCulling) renderSettingsFlag |= DEBUG_SETTING_LIGHT_CULLING_VISUALIZATION;
 				auto args = ShaderArgs()
 					.AppendConstant(m_globalEffectData.globalDataDescriptor)
 					.AppendConstant(m_currPfDescriptor)
@@ -843,12 +921,12 @@ namespace DOG::gfx
 				rd->Cmd_UpdateShaderArgs(cmdl, QueueType::Graphics, args);
 
 				auto sm = meshTab->GetSubmeshMD_CPU(sub.mesh, sub.submesh);
-				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, 1, sm.indexStart, 0, 0);
+				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, batch.count, sm.indexStart, 0, 0);
 			}
 		};
 
 		auto shadowDrawSubmissions = [&, meshTab = m_globalMeshTable.get(), matTab = m_globalMaterialTable.get(), bonezy = m_jointMan.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimatedShadows.get()](
-			RenderDevice* rd, CommandList cmdl, const std::vector<RenderSubmission>& submissions, u32 smIdx, const ShadowCaster& caster, bool animated = false, bool wireframe = false) mutable
+			RenderDevice* rd, CommandList cmdl, const DrawQueue& queue, u32 smIdx, const ShadowCaster& caster, bool wireframe = false) mutable
 		{
 			auto perLightHandle = dynConstants->Allocate((u32)std::ceilf(sizeof(PerLightData) / (float)256));
 			PerLightData perLightData{};
@@ -856,15 +934,22 @@ namespace DOG::gfx
 			perLightData.proj = caster.projMat;
 			std::memcpy(perLightHandle.memory, &perLightData, sizeof(perLightData));
 
-			for (const auto& sub : submissions)
+			for (const auto& batch : queue.batches)
 			{
+				const auto& sub = queue.submissions[queue.order[batch.first].index];
+
 				auto perDrawHandle = dynConstants->Allocate((u32)std::ceilf(sizeof(PerDrawData) / (float)256), false);
 				PerDrawData perDrawData{};
 				perDrawData.world = sub.world;
+				if (batch.firstInstance != UINT_MAX)
+				{
+					perDrawData.instanceDescriptor = m_instanceTransformsDescriptor;
+					perDrawData.firstInstance = batch.firstInstance;
+				}
 				perDrawData.globalSubmeshID = meshTab->GetSubmeshMD_GPU(sub.mesh, sub.submesh);
 				perDrawData.globalMaterialID = 0;
 
-				if (sub.animated || animated)
+				if (sub.animated)
 				{
 					// Resolve joints
 					JointData jointsData{};
@@ -889,7 +974,7 @@ namespace DOG::gfx
 				rd->Cmd_UpdateShaderArgs(cmdl, QueueType::Graphics, args);
 
 				auto sm = meshTab->GetSubmeshMD_CPU(sub.mesh, sub.submesh);
-				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, 1, sm.indexStart, 0, 0);
+				rd->Cmd_DrawIndexed(cmdl, sm.indexCount, batch.count, sm.indexStart, 0, 0);
 			}
 		};
 
@@ -897,7 +982,7 @@ namespace DOG::gfx
 		// Forward pass to HDR
 		{
 
-			rg.AddPass<PassData>("Z PrePass",
+			rg.AddSplitPass<PassData>("Z PrePass",
 				[&](PassData&, RenderGraph::PassBuilder& builder)
 				{
 					builder.DeclareTexture(RG_RESOURCE(MainDepth), RGTextureDesc::DepthWrite2D(DepthFormat::D32, m_renderWidth, m_renderHeight));
@@ -905,26 +990,25 @@ namespace DOG::gfx
 					builder.WriteDepthStencil(RG_RESOURCE(MainDepth), RenderPassAccessType::ClearPreserve,
 						TextureViewDesc(ViewType::DepthStencil, TextureViewDimension::Texture2D, DXGI_FORMAT_D32_FLOAT));
 				},
-				[&, dynConstants = m_dynConstants.get(), dynConstantsTemp = m_dynConstantsTemp.get(), drawFunc = drawZPassSubmissions](const PassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&) mutable
+				[this](const PassData&)
+				{
+					const std::array<const DrawQueue*, 3> queues{ &m_opaqueDraws, &m_weaponDraws, &m_animatedDraws };
+					return BatchCount(queues);
+				},
+				MIN_BATCHES_PER_COMMAND_LIST,
+				[&, drawFunc = drawZPassSubmissions](const PassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&, u32 firstBatch, u32 batchCount) mutable
 				{
 					rd->Cmd_SetViewports(cmdl, m_globalEffectData.defRenderVPs);
 					rd->Cmd_SetScissorRects(cmdl, m_globalEffectData.defRenderScissors);
 
 					rd->Cmd_SetIndexBuffer(cmdl, m_globalEffectData.meshTable->GetIndexBuffer());
 
-					rd->Cmd_SetPipeline(cmdl, m_zPrePassPipe);
-					drawFunc(rd, cmdl, m_submissions);
-					drawFunc(rd, cmdl, m_weaponSubmission);
-					drawFunc(rd, cmdl, m_animatedDraws, true);
-
-					rd->Cmd_SetPipeline(cmdl, m_zPrePassPipeNoCull);
-					drawFunc(rd, cmdl, m_noCullSubmissions);
-
-					rd->Cmd_SetPipeline(cmdl, m_zPrePassPipeWirefram);
-					drawFunc(rd, cmdl, m_wireframeDraws);
-
-					rd->Cmd_SetPipeline(cmdl, m_zPrePassPipeWirefram);
-					drawFunc(rd, cmdl, m_noCullWireframeDraws);
+					const PipelineTable pipelines{ m_zPrePassPipe, m_zPrePassPipeNoCull, m_zPrePassPipeWirefram, m_zPrePassPipeWirefram };
+					const std::array<const DrawQueue*, 3> queues{ &m_opaqueDraws, &m_weaponDraws, &m_animatedDraws };
+					ForBatchRange(queues, firstBatch, batchCount, [&](const DrawQueue& queue, u32 first, u32 count)
+						{
+							drawFunc(rd, cmdl, queue, first, count, pipelines);
+						});
 				});
 
 
@@ -936,7 +1020,7 @@ namespace DOG::gfx
 					builder.WriteDepthStencil(RG_RESOURCE(ShadowDepth), RenderPassAccessType::ClearPreserve,
 						TextureViewDesc(ViewType::DepthStencil, TextureViewDimension::Texture2D_Array, DXGI_FORMAT_D32_FLOAT)
 						.SetArrayRange(0, m_shadowMapCapacity));
-
+					builder.AllowParallelRecording();
 				},
 				[&, shadowDrawFunc = shadowDrawSubmissions](const ShadowPassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&) mutable
 				{
@@ -945,7 +1029,7 @@ namespace DOG::gfx
 
 					rd->Cmd_SetIndexBuffer(cmdl, m_globalEffectData.meshTable->GetIndexBuffer());
 
-					// Fills shadowmaps chronologically
+					// Fills shadowmaps chronologically, the queues only hold the default variant
 					rd->Cmd_SetPipeline(cmdl, m_shadowPipe);
 					u32 nextMap = 0;
 					for (u32 i = 0; i < m_activeSpotlights.size(); ++i)
@@ -973,7 +1057,7 @@ namespace DOG::gfx
 			if(m_graphicsSettings.lightCulling)
 				m_tiledLightCuller->Add(rg);
 
-			rg.AddPass<PassData>("Forward Pass",
+			rg.AddSplitPass<PassData>("Forward Pass",
 				[&](PassData& p, RenderGraph::PassBuilder& builder)
 				{
 					builder.DeclareTexture(RG_RESOURCE(LitHDR), RGTextureDesc::RenderTarget2D(DXGI_FORMAT_R16G16B16A16_FLOAT, m_renderWidth, m_renderHeight)
@@ -999,9 +1083,15 @@ namespace DOG::gfx
 						p.localLightBuffer = builder.ReadResource(RG_RESOURCE(LocalLightBuf), D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, BufferViewDesc(ViewType::ShaderResource, 0, sizeof(TiledLightCullingEffect::LocalLightBufferLayout), groupCount.x * groupCount.y));
 					}
 				},
-				[&, dynConstants = m_dynConstants.get(), dynConstantsTemp = m_dynConstantsTemp.get(), drawFunc = drawSubmissions](const PassData& p, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources& resources) mutable
+				[this](const PassData&)
+				{
+					const std::array<const DrawQueue*, 3> queues{ &m_opaqueDraws, &m_animatedDraws, &m_weaponDraws };
+					return BatchCount(queues);
+				},
+				MIN_BATCHES_PER_COMMAND_LIST,
+				[&, dynConstants = m_dynConstants.get(), dynConstantsTemp = m_dynConstantsTemp.get(), drawFunc = drawSubmissions](const PassData& p, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources& resources, u32 firstBatch, u32 batchCount) mutable
 				{
-					//std::cout << "Doing forward pass with: " << passData.somethingAllocated << "\n";
+					// Every range fills its own copy of the light constants
 
 					rd->Cmd_SetViewports(cmdl, m_globalEffectData.defRenderVPs);
 					rd->Cmd_SetScissorRects(cmdl, m_globalEffectData.defRenderScissors);
@@ -1023,6 +1113,7 @@ namespace DOG::gfx
 						perLightData.perLightDatas[i].direction = data.direction;
 						perLightData.perLightDatas[i].cutoffAngle = data.cutoffAngle;
 						perLightData.perLightDatas[i].strength = data.strength;
+						perLightData.perLightDatas[i].range = data.range;
 						perLightData.perLightDatas[i].isPlayer = data.isPlayerLight ? 1 : 0;
 
 						if (data.shadow != std::nullopt)
@@ -1039,22 +1130,12 @@ namespace DOG::gfx
 					std::memcpy(shadowHandle.memory, &shadowMapArrayStruct, sizeof(shadowMapArrayStruct));
 
 					u32 localLightBufferIndex = m_graphicsSettings.lightCulling ? resources.GetView(p.localLightBuffer) : -1;
-					drawFunc(rd, cmdl, m_submissions, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
-					drawFunc(rd, cmdl, m_animatedDraws, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor, true);
-					drawFunc(rd, cmdl, m_weaponSubmission, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
-					
-
-					rd->Cmd_SetPipeline(cmdl, m_meshPipeNoCull);
-					drawFunc(rd, cmdl, m_noCullSubmissions, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
-
-					rd->Cmd_SetPipeline(cmdl, m_meshPipeWireframe);
-					drawFunc(rd, cmdl, m_wireframeDraws, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor, false, true);
-
-					rd->Cmd_SetPipeline(cmdl, m_meshPipeWireframeNoCull);
-					drawFunc(rd, cmdl, m_noCullWireframeDraws, localLightBufferIndex, false, true);
-
-					//rd->Cmd_SetPipeline(cmdl, m_weaponMeshPipe);
-					//drawFunc(rd, cmdl, m_weaponSubmission, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
+					const PipelineTable pipelines{ m_meshPipe, m_meshPipeNoCull, m_meshPipeWireframe, m_meshPipeWireframeNoCull };
+					const std::array<const DrawQueue*, 3> queues{ &m_opaqueDraws, &m_animatedDraws, &m_weaponDraws };
+					ForBatchRange(queues, firstBatch, batchCount, [&](const DrawQueue& queue, u32 first, u32 count)
+						{
+							drawFunc(rd, cmdl, queue, first, count, pipelines, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
+						});
 				});
 		}
 
@@ -1079,6 +1160,7 @@ namespace DOG::gfx
 						TextureViewDesc(ViewType::RenderTarget, TextureViewDimension::Texture2D, DXGI_FORMAT_R16G16B16A16_FLOAT));
 
 					builder.WriteDepthStencil(RG_RESOURCE(SecondaryDepth), RenderPassAccessType::ClearDiscard, TextureViewDesc(ViewType::DepthStencil, TextureViewDimension::Texture2D, DXGI_FORMAT_D32_FLOAT));
+					builder.AllowParallelRecording();
 
 					if (m_graphicsSettings.lightCulling)
 					{
@@ -1108,6 +1190,7 @@ namespace DOG::gfx
 						perLightData.perLightDatas[i].direction = data.direction;
 						perLightData.perLightDatas[i].cutoffAngle = data.cutoffAngle;
 						perLightData.perLightDatas[i].strength = data.strength;
+						perLightData.perLightDatas[i].range = data.range;
 						perLightData.perLightDatas[i].isPlayer = data.isPlayerLight ? 1 : 0;
 
 						if (data.shadow != std::nullopt)
@@ -1124,8 +1207,8 @@ namespace DOG::gfx
 					std::memcpy(shadowHandle.memory, &shadowMapArrayStruct, sizeof(shadowMapArrayStruct));
 
 					u32 localLightBufferIndex = m_graphicsSettings.lightCulling ? resources.GetView(p.localLightBuffer) : -1;
-					rd->Cmd_SetPipeline(cmdl, m_weaponMeshPipe);
-					drawFunc(rd, cmdl, m_weaponSubmission, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
+					const PipelineTable pipelines{ m_weaponMeshPipe, m_weaponMeshPipe, m_weaponMeshPipe, m_weaponMeshPipe };
+					drawFunc(rd, cmdl, m_weaponDraws, 0, (u32)m_weaponDraws.batches.size(), pipelines, localLightBufferIndex, perLightHandle.globalDescriptor, shadowHandle.globalDescriptor);
 				});
 
 		}
@@ -1308,6 +1391,7 @@ namespace DOG::gfx
 
 					builder.WriteRenderTarget(RG_RESOURCE(OutlinedMeshes), RenderPassAccessType::ClearPreserve,
 						TextureViewDesc(ViewType::RenderTarget, TextureViewDimension::Texture2D, DXGI_FORMAT_R16G16B16A16_FLOAT));
+					builder.AllowParallelRecording();
 				},
 				[&, meshTab = m_globalMeshTable.get(), dynConstants = m_dynConstants.get(), dynConstantsAnimated = m_dynConstantsAnimated.get(), bonezy = m_jointMan.get()]
 				(const PassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&)
@@ -1540,7 +1624,8 @@ namespace DOG::gfx
 		}
 
 		// Final ImGUI pass
-		m_imGUIEffect->Add(rg);
+		if (m_imGUIEffect)
+			m_imGUIEffect->Add(rg);
 
 		{
 			ZoneNamedN(RGBuildScope, "RG Building", true);
@@ -1552,22 +1637,33 @@ namespace DOG::gfx
 			ZoneNamedN(RGExecuteScope, "RG Execution", true);
 			m_frameSyncs[m_currFrameIdx] = rg.Execute(m_frameCopyReceipt, true);
 		}
-		auto instance = DOG::UI::Get();
-		instance->GetBackend()->BeginFrame();
-		instance->DrawUI();
-		instance->GetBackend()->EndFrame();
+
+		if (m_backendType == GraphicsBackend::DX12)
+		{
+			auto instance = DOG::UI::Get();
+			instance->GetBackend()->BeginFrame();
+			instance->DrawUI();
+			instance->GetBackend()->EndFrame();
+		}
 	}
 
 	void Renderer::OnResize(u32 clientWidth, u32 clientHeight)
 	{
-		auto instance = DOG::UI::Get();
-		instance->FreeResize();
 		if (clientWidth != 0 && clientHeight != 0)
 		{
 			m_globalEffectData.bbScissor = ScissorRects().Append(0, 0, clientWidth, clientHeight);
 			m_globalEffectData.bbVP = Viewports().Append(0.f, 0.f, (f32)clientWidth, (f32)clientHeight);
 		}
 
+		if (m_backendType == GraphicsBackend::Null)
+		{
+			if (clientWidth != 0 && clientHeight != 0)
+				m_sc->OnResize(clientWidth, clientHeight);
+			return;
+		}
+
+		auto instance = DOG::UI::Get();
+		instance->FreeResize();
 		m_sc->OnResize(clientWidth, clientHeight);
 		instance->Resize(clientWidth, clientHeight);
 
@@ -1641,20 +1737,17 @@ namespace DOG::gfx
 	{
 		EndGUI();
 		m_bin->EndFrame();
-		m_submissions.clear();
-		m_noCullSubmissions.clear();
-		m_animatedDraws.clear();
-		m_wireframeDraws.clear();
-		m_noCullWireframeDraws.clear();
-		m_weaponSubmission.clear();
+		m_opaqueDraws.Clear();
+		m_animatedDraws.Clear();
+		m_weaponDraws.Clear();
 		m_activeSpotlights.clear();
 		m_outlineDraws.clear();
 
 		m_activeShadowCasters.clear();
-		for (auto& v : m_singleSidedShadowDraws)
-			v.clear();
-		for (auto& v : m_doubleSidedShadowDraws)
-			v.clear();
+		for (auto& queue : m_singleSidedShadowDraws)
+			queue.Clear();
+		for (auto& queue : m_doubleSidedShadowDraws)
+			queue.Clear();
 		m_nextSingleSidedShadowBucket = m_nextDoubleSidedShadowBucket = 0;
 
 		m_sc->Present(m_graphicsSettings.vSync);
@@ -1670,12 +1763,14 @@ namespace DOG::gfx
 
 	void Renderer::BeginGUI()
 	{
-		m_imgui->BeginFrame();
+		if (m_imgui)
+			m_imgui->BeginFrame();
 	}
 
 	void Renderer::EndGUI()
 	{
-		m_imgui->EndFrame();
+		if (m_imgui)
+			m_imgui->EndFrame();
 	}
 
 
@@ -1741,12 +1836,17 @@ namespace DOG::gfx
 
 			if (ImGui::Begin("GPU Memory Statistics: Render Graph", &open))
 			{
-				auto& info = m_rgResMan->GetMemoryInfo();
+				auto& memInfo = m_rgResMan->GetMemoryInfo();
+				auto& info = memInfo.pools;
 				//auto& info = m_rd->GetTotalMemoryInfo().heap[0];
 				ImGui::Text("Used allocations: %f (Mb)", info.allocationBytes / 1048576.f);
 				ImGui::Text("Memory allocated: %f (Mb)", info.blockBytes / 1048576.f);
 				ImGui::Text("Smallest allocation: %f (Mb)", info.smallestAllocation / 1048576.f);
 				ImGui::Text("Largest allocation: %f (Mb)", info.largestAllocation / 1048576.f);
+				ImGui::Separator();
+				ImGui::Text("Transient resources: %u in %u heaps", memInfo.transientResources, memInfo.heaps);
+				ImGui::Text("Without aliasing: %f (Mb)", memInfo.naiveBytes / 1048576.f);
+				ImGui::Text("With aliasing: %f (Mb)", memInfo.placedBytes / 1048576.f);
 
 
 				if (ImGui::Button("Render Graph Rebuild"))
@@ -1755,6 +1855,38 @@ namespace DOG::gfx
 			ImGui::End();
 
 
+			if (ImGui::Begin("Clustered Light Culling", &open))
+			{
+				ImGui::Checkbox("Assign lights on the CPU", &m_clusterLightsOnCPU);
+				if (m_lightClusterer)
+				{
+					const auto& stats = m_lightClusterer->GetStats();
+					ImGui::Text("Clusters: %u x %u x %u", m_lightClusters.clustersX, m_lightClusters.clustersY, m_lightClusters.clustersZ);
+					ImGui::Text("Lights: %u point, %u spot", stats.pointLights, stats.spotLights);
+					ImGui::Text("Occupied clusters: %u / %u", stats.occupiedClusters, stats.clusters);
+					ImGui::Text("Assignments: %llu", stats.assignments);
+					ImGui::Text("Max lights per cluster: %u", stats.maxLightsPerCluster);
+					ImGui::Separator();
+					ImGui::Text("Empty: %u", stats.histogram[0]);
+					for (u32 bucket = 1; bucket < ClusteredLightCuller::Stats::HISTOGRAM_BUCKETS - 1; ++bucket)
+						ImGui::Text("[%u, %u) lights: %u", 1u << (bucket - 1), 1u << bucket, stats.histogram[bucket]);
+					ImGui::Text("%u+ lights: %u", 1u << (ClusteredLightCuller::Stats::HISTOGRAM_BUCKETS - 2), stats.histogram.back());
+				}
+			}
+			ImGui::End();
+
+			if (ImGui::Begin("GPU Table Uploads", &open))
+			{
+				auto showStats = [](const char* name, const GPUTableUploadStats& stats)
+				{
+					ImGui::Text("%s: %llu bytes in %u copies", name, stats.bytes, stats.copies);
+					ImGui::Text("    %u full, %u delta uploads", stats.fullUploads, stats.deltaUploads);
+				};
+				showStats("Lights", m_globalLightTable->GetUploadStats());
+				showStats("Per frame data", m_pfDataTable->GetUploadStats());
+			}
+			ImGui::End();
+
 			if (ImGui::Begin("Damage Disk Settings"))
 			{
 				ImGui::SliderFloat2("Direction", s_dir, -1.f, 1.f);
@@ -1781,6 +1913,113 @@ namespace DOG::gfx
 			return false;
 	}
 
+	void Renderer::DrawQueue::Clear()
+	{
+		submissions.clear();
+		order.clear();
+		batches.clear();
+	}
+
+	void Renderer::BuildDrawBatches()
+	{
+		MINIPROFILE;
+
+		m_instanceTransforms.clear();
+		m_instanceTransformsDescriptor = UINT_MAX;
+
+		SortAndBatch(m_opaqueDraws, true);
+		SortAndBatch(m_animatedDraws, true);
+		SortAndBatch(m_weaponDraws, true);
+		for (u32 i = 0; i < std::min<u32>(m_nextSingleSidedShadowBucket, (u32)m_singleSidedShadowDraws.size()); ++i)
+			SortAndBatch(m_singleSidedShadowDraws[i], false);
+		for (u32 i = 0; i < std::min<u32>(m_nextDoubleSidedShadowBucket, (u32)m_doubleSidedShadowDraws.size()); ++i)
+			SortAndBatch(m_doubleSidedShadowDraws[i], false);
+
+		if (!m_instanceTransforms.empty())
+		{
+			auto handle = m_dynConstants->AllocateStructured(sizeof(DirectX::SimpleMath::Matrix), (u32)m_instanceTransforms.size());
+			std::memcpy(handle.memory, m_instanceTransforms.data(), m_instanceTransforms.size() * sizeof(DirectX::SimpleMath::Matrix));
+			m_instanceTransformsDescriptor = handle.globalDescriptor;
+		}
+	}
+
+	void Renderer::SortAndBatch(DrawQueue& queue, bool sortByDepth)
+	{
+		queue.order.resize(queue.submissions.size());
+		for (u32 i = 0; i < queue.submissions.size(); ++i)
+		{
+			const auto& sub = queue.submissions[i];
+
+			// Shadow draws have no material and the light decides the depth, they only sort by state
+			f32 depth = 0.f;
+			u32 material = 0;
+			if (sortByDepth)
+			{
+				depth = DirectX::XMVectorGetZ(DirectX::XMVector3Transform(sub.world.Translation(), m_viewMat));
+				material = m_globalMaterialTable->GetMaterialIndex(sub.mat);
+			}
+
+			queue.order[i].key = DrawKey::Make((u32)sub.pipeline, m_globalMeshTable->GetSubmeshMD_GPU(sub.mesh, sub.submesh), material, depth);
+			queue.order[i].index = i;
+		}
+		RadixSort(queue.order, m_sortScratch);
+
+		// Animated draws carry their own joints and weapons are drawn in a special pass, those are never merged
+		auto instanceable = [&queue](const SortedDraw& draw)
+		{
+			const auto& sub = queue.submissions[draw.index];
+			return !sub.animated && !sub.isWeapon;
+		};
+
+		queue.batches.clear();
+		for (u32 first = 0; first < queue.order.size();)
+		{
+			u32 last = first + 1;
+			if (instanceable(queue.order[first]))
+			{
+				const u64 state = DrawKey::State(queue.order[first].key);
+				while (last < queue.order.size() && DrawKey::State(queue.order[last].key) == state && instanceable(queue.order[last]))
+					++last;
+			}
+
+			DrawBatch batch{};
+			batch.first = first;
+			batch.count = last - first;
+			if (batch.count > 1)
+			{
+				batch.firstInstance = (u32)m_instanceTransforms.size();
+				for (u32 i = first; i < last; ++i)
+					m_instanceTransforms.push_back(queue.submissions[queue.order[i].index].world);
+			}
+			queue.batches.push_back(batch);
+
+			first = last;
+		}
+	}
+
+	u32 Renderer::BatchCount(std::span<const DrawQueue* const> queues)
+	{
+		u32 count = 0;
+		for (const DrawQueue* queue : queues)
+			count += (u32)queue->batches.size();
+		return count;
+	}
+
+	void Renderer::ForBatchRange(std::span<const DrawQueue* const> queues, u32 first, u32 count, const std::function<void(const DrawQueue&, u32, u32)>& f)
+	{
+		const u32 end = first + count;
+		u32 queueStart = 0;
+		for (const DrawQueue* queue : queues)
+		{
+			const u32 queueEnd = queueStart + (u32)queue->batches.size();
+			const u32 rangeStart = std::max(first, queueStart);
+			const u32 rangeEnd = std::min(end, queueEnd);
+			if (rangeStart < rangeEnd)
+				f(*queue, rangeStart - queueStart, rangeEnd - rangeStart);
+			queueStart = queueEnd;
+		}
+	}
+
 	void DOG::gfx::Renderer::WaitForPrevFrame()
 	{
 		MINIPROFILE;
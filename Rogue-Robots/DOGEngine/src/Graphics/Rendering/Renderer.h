@@ -6,6 +6,8 @@
 #include "../../Core/CoreUtils.h"
 #include "UI.h"
 #include "GPUTable.h"
+#include "DrawSorting.h"
+#include "ClusteredLightCuller.h"
 
 #include "RenderEffects/RenderEffect.h"
 #include "RenderEffects/EffectData/GlobalEffectData.h"
@@ -57,6 +59,7 @@ namespace DOG::gfx
 			float cutoffAngle{ 0.f };
 			DirectX::SimpleMath::Vector3 direction;
 			float strength{ 0.f };
+			float range{ 0.f };
 
 			bool isPlayerLight{ false };
 		};
@@ -65,6 +68,7 @@ namespace DOG::gfx
 	private:
 		static constexpr u8 S_NUM_BACKBUFFERS = 2;
 		static constexpr u8 S_MAX_FIF = 2;
+		static constexpr u32 MIN_BATCHES_PER_COMMAND_LIST = 256;		// Smaller ranges cost more in list overhead than they save in recording time
 
 		static_assert(S_MAX_FIF <= S_NUM_BACKBUFFERS);
 	public:
@@ -132,6 +136,17 @@ namespace DOG::gfx
 		LRESULT WinProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
 	private:
+		// Pipeline variant of a submission, indexes the pipeline table of the pass drawing it
+		enum class DrawPipeline : u8
+		{
+			Default = 0,
+			NoCull,
+			Wireframe,
+			WireframeNoCull,
+			Count,
+		};
+		using PipelineTable = std::array<Pipeline, static_cast<size_t>(DrawPipeline::Count)>;
+
 		struct RenderSubmission
 		{
 			Mesh mesh;
@@ -145,12 +160,39 @@ namespace DOG::gfx
 			// bitflags for target passes? (i.e multipass)
 			u32 jointOffset{ 0 };
 			bool isWeapon{ false };
+			DrawPipeline pipeline{ DrawPipeline::Default };
+		};
+
+		// Consecutive sorted submissions drawn with a single call
+		struct DrawBatch
+		{
+			u32 first{ 0 };						// into DrawQueue::order
+			u32 count{ 0 };
+			u32 firstInstance{ UINT_MAX };		// into the frame's instance transforms, UINT_MAX draws with the submission's own world matrix
+		};
+
+		struct DrawQueue
+		{
+			std::vector<RenderSubmission> submissions;
+			std::vector<SortedDraw> order;
+			std::vector<DrawBatch> batches;
+
+			void Clear();
 		};
 
 		void WaitForPrevFrame();
 
+		// Sorts every queue and merges runs of the same submesh and material into instanced batches
+		void BuildDrawBatches();
+		void SortAndBatch(DrawQueue& queue, bool sortByDepth);
+
+		// The batches of the queues laid end to end, calls f(queue, firstBatch, batchCount) for the part of [first, first + count) in each queue
+		static u32 BatchCount(std::span<const DrawQueue* const> queues);
+		static void ForBatchRange(std::span<const DrawQueue* const> queues, u32 first, u32 count, const std::function<void(const DrawQueue&, u32, u32)>& f);
+
 	private:
 		std::function<LRESULT(HWND, UINT, WPARAM, LPARAM)> m_wmCallback;
+		GraphicsBackend m_backendType{ GraphicsBackend::DX12 };
 		std::unique_ptr<RenderBackend> m_backend;
 		std::unique_ptr<ImGUIBackend> m_imgui;
 		
@@ -167,18 +209,27 @@ namespace DOG::gfx
 		std::unique_ptr<MeshTable> m_globalMeshTable;
 		std::unique_ptr<LightTable> m_globalLightTable;
 
+		// CPU clustered light assignment, only runs while enabled in the debug window
+		std::unique_ptr<ClusteredLightCuller> m_lightClusterer;
+		ClusteredLightCuller::Result m_lightClusters;
+		std::vector<ClusteredLightCuller::Light> m_clusterPointLights;
+		std::vector<ClusteredLightCuller::Light> m_clusterSpotLights;
+		bool m_clusterLightsOnCPU{ false };
+
 
-		std::vector<RenderSubmission> m_submissions;				// temporary
-		std::vector<RenderSubmission> m_noCullSubmissions;			// temporary
-		std::vector<RenderSubmission> m_animatedDraws;				// temp
-		std::vector<RenderSubmission> m_wireframeDraws;				// temp
-		std::vector<RenderSubmission> m_noCullWireframeDraws;		// temp
-		std::vector<RenderSubmission> m_weaponSubmission;			// submission for weapons only
+		DrawQueue m_opaqueDraws;					// all pipeline variants, sorted by DrawKey
+		DrawQueue m_animatedDraws;					// never instanced, joints are per draw
+		DrawQueue m_weaponDraws;					// submission for weapons only
 
 		u32 m_nextSingleSidedShadowBucket{ 0 };
 		u32 m_nextDoubleSidedShadowBucket{ 0 };
-		std::vector<std::vector<RenderSubmission>> m_singleSidedShadowDraws;
-		std::vector<std::vector<RenderSubmission>> m_doubleSidedShadowDraws;
+		std::vector<DrawQueue> m_singleSidedShadowDraws;
+		std::vector<DrawQueue> m_doubleSidedShadowDraws;
+
+		// World matrices of every instanced batch this frame, uploaded once as a structured buffer
+		std::vector<DirectX::SimpleMath::Matrix> m_instanceTransforms;
+		u32 m_instanceTransformsDescriptor{ UINT_MAX };
+		std::vector<SortedDraw> m_sortScratch;
 
 		std::vector<RenderSubmission> m_outlineDraws;
 
@@ -0,0 +1,152 @@
+#include "TiledLightCuller.h"
+#include "RenderEffects/TiledLightCullingEffect.h"
+#include "../../common/ThreadPool.h"
+#include "../../common/MiniProfiler.h"
+
+namespace DOG::gfx
+{
+	static_assert(sizeof(TiledLightCuller::TileLights) == sizeof(TiledLightCullingEffect::LocalLightBufferLayout));
+	static_assert(TiledLightCuller::MAX_LIGHTS_PER_TILE == TiledLightCullingEffect::maxLightsPerTile);
+
+	void TiledLightCuller::Lights::Push(const DirectX::XMFLOAT3& center, f32 radius, u32 index)
+	{
+		// Start a new group padded with lights that are behind every plane
+		if (m_count % GROUP_SIZE == 0)
+		{
+			const u32 padded = m_count + GROUP_SIZE;
+			m_x.resize(padded, 0.0f);
+			m_y.resize(padded, 0.0f);
+			m_z.resize(padded, 0.0f);
+			m_radius.resize(padded, -std::numeric_limits<f32>::infinity());
+			m_index.resize(padded, 0);
+		}
+
+		m_x[m_count] = center.x;
+		m_y[m_count] = center.y;
+		m_z[m_count] = center.z;
+		m_radius[m_count] = radius;
+		m_index[m_count] = index;
+		++m_count;
+	}
+
+	void TiledLightCuller::Lights::Clear()
+	{
+		for (auto* v : { &m_x, &m_y, &m_z, &m_radius })
+			v->clear();
+		m_index.clear();
+		m_count = 0;
+	}
+
+	TiledLightCuller::TiledLightCuller()
+	{
+		m_workers = std::make_unique<ThreadPool>(ThreadPool::DefaultWorkerCount(MAX_WORKERS), "Light culler");
+	}
+
+	TiledLightCuller::~TiledLightCuller() = default;
+
+	Vector2u TiledLightCuller::GetTileCount(const Setup& setup)
+	{
+		assert(setup.tileSize > 0);
+		return { (setup.width + setup.tileSize - 1) / setup.tileSize, (setup.height + setup.tileSize - 1) / setup.tileSize };
+	}
+
+	std::array<DirectX::SimpleMath::Vector4, 6> TiledLightCuller::GetTilePlanes(const Setup& setup, u32 tileX, u32 tileY, f32 minDepth, f32 maxDepth)
+	{
+		using namespace DirectX::SimpleMath;
+
+		// The projection scaled and biased so that the tile covers clip space, see TiledLightCullingCS
+		const Vector2u tileCount = GetTileCount(setup);
+		const Vector2 scale((f32)tileCount.x, (f32)tileCount.y);
+		const Vector2 bias = scale - Vector2(2.0f * tileX, 2.0f * tileY) - Vector2(1.0f, 1.0f);
+
+		const Vector4 col1(setup.proj._11 * scale.x, 0.0f, bias.x, 0.0f);
+		const Vector4 col2(0.0f, -setup.proj._22 * scale.y, bias.y, 0.0f);
+		const Vector4 col4(0.0f, 0.0f, 1.0f, 0.0f);
+
+		std::array<Vector4, 6> planes;
+		planes[0] = col4 + col1;
+		planes[1] = col4 - col1;
+		planes[2] = col4 + col2;
+		planes[3] = col4 - col2;
+		planes[4] = Vector4(0.0f, 0.0f, 1.0f, -minDepth);
+		planes[5] = Vector4(0.0f, 0.0f, -1.0f, maxDepth);
+
+		for (u32 i = 0; i < 4; ++i)
+			planes[i] /= Vector3(planes[i].x, planes[i].y, planes[i].z).Length();
+
+		// Planes go to world space with the inverse transpose of the inverse view, which is the view itself
+		const Matrix viewT = setup.view.Transpose();
+		for (auto& plane : planes)
+			plane = Vector4::Transform(plane, viewT);
+		return planes;
+	}
+
+	void TiledLightCuller::Cull(const Setup& setup, const Lights& lights, std::span<const TileDepth> tileDepths, std::vector<TileLights>& out)
+	{
+		MINIPROFILE;
+
+		const Vector2u tileCount = GetTileCount(setup);
+		const u32 tiles = tileCount.x * tileCount.y;
+		assert(tileDepths.empty() || tileDepths.size() == tiles);
+
+		out.resize(tiles);
+		const u32 jobs = (tiles + TILES_PER_JOB - 1) / TILES_PER_JOB;
+		m_workers->ParallelFor(jobs, [&](u32 job)
+			{
+				const u32 first = job * TILES_PER_JOB;
+				const u32 last = std::min(first + TILES_PER_JOB, tiles);
+				for (u32 tile = first; tile < last; ++tile)
+				{
+					const f32 minDepth = tileDepths.empty() ? setup.nearClip : tileDepths[tile].minDepth;
+					const f32 maxDepth = tileDepths.empty() ? setup.farClip : tileDepths[tile].maxDepth;
+					CullTile(GetTilePlanes(setup, tile % tileCount.x, tile / tileCount.x, minDepth, maxDepth), lights, out[tile]);
+				}
+			});
+	}
+
+	void TiledLightCuller::CullTile(const std::array<DirectX::SimpleMath::Vector4, 6>& planes, const Lights& lights, TileLights& out) const
+	{
+		using namespace DirectX;
+
+		std::array<XMVECTOR, 6> nx, ny, nz, nw;
+		for (u32 i = 0; i < 6; ++i)
+		{
+			nx[i] = XMVectorReplicate(planes[i].x);
+			ny[i] = XMVectorReplicate(planes[i].y);
+			nz[i] = XMVectorReplicate(planes[i].z);
+			nw[i] = XMVectorReplicate(planes[i].w);
+		}
+
+		out.count = 0;
+		for (u32 first = 0; first < lights.m_count; first += GROUP_SIZE)
+		{
+			const XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&lights.m_x[first]));
+			const XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&lights.m_y[first]));
+			const XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&lights.m_z[first]));
+			const XMVECTOR negRadius = XMVectorNegate(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&lights.m_radius[first])));
+
+			// A sphere is culled if its center is further than its radius behind any plane
+			XMVECTOR culled = XMVectorFalseInt();
+			for (u32 i = 0; i < 6; ++i)
+			{
+				XMVECTOR distance = XMVectorMultiplyAdd(x, nx[i], nw[i]);
+				distance = XMVectorMultiplyAdd(y, ny[i], distance);
+				distance = XMVectorMultiplyAdd(z, nz[i], distance);
+				culled = XMVectorOrInt(culled, XMVectorLess(distance, negRadius));
+			}
+
+			if (XMVector4EqualInt(culled, XMVectorTrueInt()))
+				continue;
+
+			XMUINT4 result;
+			XMStoreUInt4(&result, culled);
+			const u32 lanes[GROUP_SIZE] = { result.x, result.y, result.z, result.w };
+			for (u32 lane = 0; lane < GROUP_SIZE; ++lane)
+			{
+				if (lanes[lane] || out.count == MAX_LIGHTS_PER_TILE)
+					continue;
+				out.lightIndices[out.count++] = lights.m_index[first + lane];
+			}
+		}
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+namespace DOG { class ThreadPool; }
+
+namespace DOG::gfx
+{
+	/*
+		CPU version of TiledLightCullingCS. Point lights are tested against the frustum of every screen tile, four lights per SIMD
+		instruction, with the tiles spread over a thread pool. The output has the layout of the GPU LocalLightBuf so the two can be compared
+		and so the result can be uploaded as is when there is no GPU culling.
+	*/
+	class TiledLightCuller
+	{
+	public:
+		static constexpr u32 MAX_LIGHTS_PER_TILE = 255; // TiledLightCullingEffect::maxLightsPerTile
+		static constexpr u32 GROUP_SIZE = 4;
+		static constexpr u32 DEFAULT_TILE_SIZE = 16; // TILED_GROUP_SIZE
+		static constexpr u32 MAX_WORKERS = 7;
+
+		// Same layout as TiledLightCullingEffect::LocalLightBufferLayout, lights past MAX_LIGHTS_PER_TILE are dropped
+		struct TileLights
+		{
+			u32 count;
+			u32 lightIndices[MAX_LIGHTS_PER_TILE];
+		};
+
+		// World space spheres as SoA, padded with never visible lights to a multiple of GROUP_SIZE.
+		// index is the value written to the tile lists, the global light table index on the GPU.
+		class Lights
+		{
+		public:
+			void Push(const DirectX::XMFLOAT3& center, f32 radius, u32 index);
+			void Clear();
+			u32 Size() const { return m_count; }
+
+		private:
+			friend TiledLightCuller;
+			std::vector<f32> m_x, m_y, m_z, m_radius;
+			std::vector<u32> m_index;
+			u32 m_count{ 0 };
+		};
+
+		struct Setup
+		{
+			DirectX::SimpleMath::Matrix view;
+			DirectX::SimpleMath::Matrix proj;
+			u32 width{ 0 };
+			u32 height{ 0 };
+			u32 tileSize{ DEFAULT_TILE_SIZE };
+			// View space depth range used for tiles without a depth range of their own
+			f32 nearClip{ 0.1f };
+			f32 farClip{ 1000.0f };
+		};
+
+		// View space depth bounds of the geometry in a tile, what the compute shader reduces from the depth buffer
+		struct TileDepth
+		{
+			f32 minDepth;
+			f32 maxDepth;
+		};
+
+	public:
+		TiledLightCuller();
+		~TiledLightCuller();
+
+		// Tile (x, y) is written to out[x + tileCountX * y]. tileDepths is either empty or has one entry per tile.
+		void Cull(const Setup& setup, const Lights& lights, std::span<const TileDepth> tileDepths, std::vector<TileLights>& out);
+
+		static Vector2u GetTileCount(const Setup& setup);
+
+		// Normalized world space planes facing inwards: left, right, bottom, top, near, far. Matches the compute shader.
+		static std::array<DirectX::SimpleMath::Vector4, 6> GetTilePlanes(const Setup& setup, u32 tileX, u32 tileY, f32 minDepth, f32 maxDepth);
+
+	private:
+		void CullTile(const std::array<DirectX::SimpleMath::Vector4, 6>& planes, const Lights& lights, TileLights& out) const;
+
+	private:
+		static constexpr u32 TILES_PER_JOB = 32;
+
+		std::unique_ptr<ThreadPool> m_workers;
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+namespace DOG
+{
+	enum class LogLevel : u8
+	{
+		Trace = 0,
+		Info,
+		Warning,
+		Error,
+	};
+
+	// Fixed size binary log entry. Arguments are stored raw and only formatted on the logger thread,
+	// strings are copied into the record so the caller does not have to keep them alive.
+	struct LogRecord
+	{
+		static constexpr u32 MAX_ARGUMENTS = 6;
+		static constexpr u32 TEXT_CAPACITY = 64;
+
+		struct Argument
+		{
+			enum class Type : u8 { Int, UInt, Float, Bool, Text };
+
+			Type type;
+			u8 textOffset;
+			u8 textLength;
+			union
+			{
+				i64 i;
+				u64 u;
+				f64 f;
+				bool b;
+			};
+		};
+
+		u64 timestamp;
+		const char* format; // Must have static storage, use the LOG_ macros
+		LogLevel level;
+		u8 argumentCount;
+		u8 textUsed;
+		std::array<Argument, MAX_ARGUMENTS> arguments;
+		std::array<char, TEXT_CAPACITY> text;
+
+		template<typename T>
+		void Add(const T& value) noexcept
+		{
+			if (argumentCount == MAX_ARGUMENTS)
+				return;
+
+			Argument& arg = arguments[argumentCount++];
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				arg.type = Argument::Type::Bool;
+				arg.b = value;
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				arg.type = Argument::Type::Int;
+				arg.i = static_cast<i64>(value);
+			}
+			else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+			{
+				arg.type = Argument::Type::Int;
+				arg.i = value;
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				arg.type = Argument::Type::UInt;
+				arg.u = value;
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				arg.type = Argument::Type::Float;
+				arg.f = value;
+			}
+			else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+			{
+				AddText(arg, std::string_view(value));
+			}
+			else
+			{
+				static_assert(std::is_arithmetic_v<T>, "Type can not be logged, convert it to a number or string");
+			}
+		}
+
+	private:
+		void AddText(Argument& arg, std::string_view str) noexcept
+		{
+			// Long strings are truncated rather than allocated
+			const u32 length = static_cast<u32>(std::min<size_t>(str.size(), TEXT_CAPACITY - textUsed));
+			arg.type = Argument::Type::Text;
+			arg.textOffset = textUsed;
+			arg.textLength = static_cast<u8>(length);
+			std::copy_n(str.data(), length, text.data() + textUsed);
+			textUsed = static_cast<u8>(textUsed + length);
+		}
+	};
+}
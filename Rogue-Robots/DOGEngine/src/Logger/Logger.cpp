@@ -3,14 +3,234 @@
 using namespace DOG;
 
 Logger Logger::s_instance;
+thread_local Logger::ThreadQueue* Logger::s_threadQueue = nullptr;
+thread_local bool Logger::s_threadExited = false;
 
 Logger::~Logger()
 {
+	if (m_thread.joinable())
+	{
+		m_threadShouldDie = true;
+		m_wake.notify_one();
+		m_thread.join();
+	}
+
 	for (auto& [name, log] : m_logs)
 		log.SaveLogFile(name + ".csv");
 }
 
-Log& Logger::operator[](std::string log)
+Log& Logger::operator[](std::string_view log)
+{
+	auto it = m_logs.find(log);
+	if (it == m_logs.end())
+		it = m_logs.emplace(std::string(log), Log()).first;
+	return it->second;
+}
+
+void Logger::Flush()
+{
+	{
+		std::scoped_lock<std::mutex> lock(m_queuesMutex);
+		if (!m_thread.joinable())
+			return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_flushMutex);
+	const u64 request = ++m_flushRequests;
+	m_wake.notify_one();
+	m_flushed.wait(lock, [&]() { return m_flushesDone >= request; });
+}
+
+void Logger::SetLogFile(const std::filesystem::path& path)
+{
+	std::scoped_lock<std::mutex> lock(m_fileMutex);
+	m_file = std::ofstream(path);
+	if (!m_file)
+		std::cout << "Logger: failed to open " << path.string() << " for writing" << std::endl;
+}
+
+u64 Logger::DroppedRecords() const noexcept
+{
+	std::scoped_lock<std::mutex> lock(m_queuesMutex);
+	u64 dropped = m_retiredDrops;
+	for (auto& queue : m_queues)
+		dropped += queue->dropped.load(std::memory_order_relaxed);
+	return dropped;
+}
+
+LogRecord* Logger::ThreadQueue::Reserve() noexcept
+{
+	const u64 head = m_head.load(std::memory_order_relaxed);
+	if (head - m_tail.load(std::memory_order_acquire) == CAPACITY)
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return &m_records[head & (CAPACITY - 1)];
+}
+
+void Logger::ThreadQueue::Commit() noexcept
+{
+	m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template<typename F>
+void Logger::ThreadQueue::Drain(F&& f)
+{
+	u64 tail = m_tail.load(std::memory_order_relaxed);
+	const u64 head = m_head.load(std::memory_order_acquire);
+	for (; tail != head; ++tail)
+	{
+		f(m_records[tail & (CAPACITY - 1)]);
+	}
+	m_tail.store(tail, std::memory_order_release);
+}
+
+Logger::ThreadQueue* Logger::GetThreadQueue()
+{
+	// Records logged while the thread is being torn down are dropped, the queue may already be gone
+	if (!s_threadQueue && !s_threadExited)
+	{
+		// Closes the queue when the thread exits, the logger thread frees it once it has been drained
+		struct QueueOwner
+		{
+			~QueueOwner()
+			{
+				s_threadQueue->closed.store(true, std::memory_order_release);
+				s_threadQueue = nullptr;
+				s_threadExited = true;
+			}
+		};
+
+		{
+			std::scoped_lock<std::mutex> lock(m_queuesMutex);
+			m_queues.push_back(std::make_unique<ThreadQueue>(m_nextThreadID++));
+			s_threadQueue = m_queues.back().get();
+
+			if (!m_thread.joinable())
+				m_thread = std::thread(&Logger::LoggerThreadRoutine, this);
+		}
+		thread_local QueueOwner owner;
+	}
+	return s_threadQueue;
+}
+
+void Logger::LoggerThreadRoutine()
+{
+	bool lastPass = false;
+	while (!lastPass)
+	{
+		lastPass = m_threadShouldDie;
+
+		u64 flushRequest = 0;
+		{
+			std::scoped_lock<std::mutex> lock(m_flushMutex);
+			flushRequest = m_flushRequests;
+		}
+
+		// Merge all threads by time so the output reads in order
+		{
+			std::scoped_lock<std::mutex> lock(m_queuesMutex);
+			for (auto& queue : m_queues)
+			{
+				// Read before draining, a closed queue gets no more records
+				const bool closed = queue->closed.load(std::memory_order_acquire);
+				const u32 threadID = queue->threadID;
+				queue->Drain([&](const LogRecord& record) { m_batch.emplace_back(threadID, record); });
+
+				if (closed)
+				{
+					m_retiredDrops += queue->dropped.load(std::memory_order_relaxed);
+					queue.reset();
+				}
+			}
+			std::erase(m_queues, nullptr);
+		}
+		std::stable_sort(m_batch.begin(), m_batch.end(), [](auto& a, auto& b) { return a.second.timestamp < b.second.timestamp; });
+
+		{
+			std::scoped_lock<std::mutex> lock(m_fileMutex);
+			for (auto& [threadID, record] : m_batch)
+				WriteRecord(threadID, record);
+
+			const u64 dropped = DroppedRecords();
+			if (dropped != m_reportedDrops)
+			{
+				m_line = "Logger: dropped " + std::to_string(dropped - m_reportedDrops) + " records, the queues were full\n";
+				if (m_consoleOutput)
+					std::cout << m_line;
+				if (m_file.is_open())
+					m_file << m_line;
+				m_reportedDrops = dropped;
+			}
+
+			if (m_consoleOutput)
+				std::cout.flush();
+			if (m_file.is_open())
+				m_file.flush();
+		}
+		m_batch.clear();
+
+		if (flushRequest)
+		{
+			{
+				std::scoped_lock<std::mutex> lock(m_flushMutex);
+				m_flushesDone = std::max(m_flushesDone, flushRequest);
+			}
+			m_flushed.notify_all();
+		}
+
+		if (!lastPass)
+		{
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wake.wait_for(lock, LOGGER_THREAD_WAIT);
+		}
+	}
+}
+
+void Logger::WriteRecord(u32 threadID, const LogRecord& record)
+{
+	static constexpr std::array<const char*, 4> LEVEL_NAMES = { "trace", "info", "warning", "error" };
+
+	char prefix[48];
+	const u64 ms = record.timestamp / 1'000'000;
+	std::snprintf(prefix, sizeof(prefix), "[%6llu.%03llu] [%-7s] [%2u] ", ms / 1000, ms % 1000, LEVEL_NAMES[static_cast<u8>(record.level)], threadID);
+
+	m_line.clear();
+	m_line += prefix;
+
+	// Every {} is replaced by the next argument, arguments without a placeholder are dropped
+	u32 argIdx = 0;
+	for (const char* c = record.format; *c; ++c)
+	{
+		if (c[0] == '{' && c[1] == '}' && argIdx < record.argumentCount)
+		{
+			const LogRecord::Argument& arg = record.arguments[argIdx++];
+			switch (arg.type)
+			{
+			case LogRecord::Argument::Type::Int: m_line += std::to_string(arg.i); break;
+			case LogRecord::Argument::Type::UInt: m_line += std::to_string(arg.u); break;
+			case LogRecord::Argument::Type::Float: m_line += std::to_string(arg.f); break;
+			case LogRecord::Argument::Type::Bool: m_line += arg.b ? "true" : "false"; break;
+			case LogRecord::Argument::Type::Text: m_line.append(record.text.data() + arg.textOffset, arg.textLength); break;
+			}
+			++c;
+		}
+		else
+		{
+			m_line += *c;
+		}
+	}
+	m_line += '\n';
+
+	if (m_consoleOutput)
+		std::cout << m_line;
+	if (m_file.is_open())
+		m_file << m_line;
+}
+
+u64 Logger::Now() noexcept
 {
-	return m_logs[log];
+	static const auto start = std::chrono::steady_clock::now();
+	return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
 }
@@ -1,5 +1,15 @@
 #pragma once
 #include "Log.h"
+#include "LogRecord.h"
+
+// Records below this level are compiled out, 0 = Trace, 1 = Info, 2 = Warning, 3 = Error
+#ifndef DOG_LOG_LEVEL
+#if defined _DEBUG
+#define DOG_LOG_LEVEL 0
+#else
+#define DOG_LOG_LEVEL 1
+#endif
+#endif
 
 namespace DOG
 {
@@ -7,13 +17,133 @@ namespace DOG
 	{
 	public:
 		[[nodiscard]] static constexpr Logger& Get() noexcept { return s_instance; }
-		Log& operator[](std::string log);
+
+		// Named CSV tables, saved as <name>.csv on exit
+		Log& operator[](std::string_view log);
+
+		// Copies the arguments into the calling thread's queue, formatting and output happens on the logger thread.
+		// Never blocks or allocates once the thread has logged its first record, records are dropped if the queue is full.
+		template<typename... Args>
+		void Write(LogLevel level, const char* format, const Args&... args) noexcept
+		{
+			static_assert(sizeof...(Args) <= LogRecord::MAX_ARGUMENTS, "Too many log arguments");
+
+			ThreadQueue* queue = GetThreadQueue();
+			if (!queue)
+				return;
+			LogRecord* record = queue->Reserve();
+			if (!record)
+				return;
+
+			record->timestamp = Now();
+			record->format = format;
+			record->level = level;
+			record->argumentCount = 0;
+			record->textUsed = 0;
+			(record->Add(args), ...);
+			queue->Commit();
+
+			// Errors are written right away in case the application is about to go down
+			if (level == LogLevel::Error)
+				m_wake.notify_one();
+		}
+
+		// Blocks until everything logged before the call has been written
+		void Flush();
+		void SetLogFile(const std::filesystem::path& path);
+		void SetConsoleOutput(bool enabled) noexcept { m_consoleOutput = enabled; }
+		u64 DroppedRecords() const noexcept;
 
 	private:
-		static Logger s_instance;
-		std::unordered_map<std::string, Log> m_logs;
+		// Single producer (the owning thread), single consumer (the logger thread)
+		class ThreadQueue
+		{
+		public:
+			static constexpr u64 CAPACITY = 1024;
+			static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+			ThreadQueue(u32 id) : threadID(id) {}
+
+			LogRecord* Reserve() noexcept;
+			void Commit() noexcept;
+			template<typename F>
+			void Drain(F&& f);
+
+			const u32 threadID;
+			std::atomic<u64> dropped = 0;
+			std::atomic_bool closed = false; // Set when the owning thread exits, the logger thread drains and frees the queue
 
+		private:
+			std::array<LogRecord, CAPACITY> m_records;
+			alignas(64) std::atomic<u64> m_head = 0;
+			alignas(64) std::atomic<u64> m_tail = 0;
+		};
+
+		struct StringHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+		};
+
+	private:
 		Logger() = default;
 		~Logger();
+
+		ThreadQueue* GetThreadQueue();
+		void LoggerThreadRoutine();
+		void WriteRecord(u32 threadID, const LogRecord& record);
+		static u64 Now() noexcept;
+
+	private:
+		static constexpr std::chrono::milliseconds LOGGER_THREAD_WAIT{ 10 };
+
+		static Logger s_instance;
+		static thread_local ThreadQueue* s_threadQueue;
+		static thread_local bool s_threadExited;
+
+		std::unordered_map<std::string, Log, StringHash, std::equal_to<>> m_logs;
+
+		mutable std::mutex m_queuesMutex;
+		std::vector<std::unique_ptr<ThreadQueue>> m_queues;
+		u32 m_nextThreadID = 0;
+		u64 m_retiredDrops = 0; // Dropped records of queues that have been freed
+
+		std::thread m_thread;
+		std::atomic_bool m_threadShouldDie = false;
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wake;
+
+		std::mutex m_flushMutex;
+		std::condition_variable m_flushed;
+		u64 m_flushRequests = 0;
+		u64 m_flushesDone = 0;
+
+		// Only touched by the logger thread after construction
+		std::vector<std::pair<u32, LogRecord>> m_batch;
+		std::string m_line;
+		std::ofstream m_file;
+		std::mutex m_fileMutex;
+		std::atomic_bool m_consoleOutput = true;
+		u64 m_reportedDrops = 0;
 	};
-}
\ No newline at end of file
+}
+
+#if DOG_LOG_LEVEL <= 0
+#define LOG_TRACE(format, ...) DOG::Logger::Get().Write(DOG::LogLevel::Trace, "" format, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(format, ...) ((void)0)
+#endif
+
+#if DOG_LOG_LEVEL <= 1
+#define LOG_INFO(format, ...) DOG::Logger::Get().Write(DOG::LogLevel::Info, "" format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) ((void)0)
+#endif
+
+#if DOG_LOG_LEVEL <= 2
+#define LOG_WARNING(format, ...) DOG::Logger::Get().Write(DOG::LogLevel::Warning, "" format, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(format, ...) ((void)0)
+#endif
+
+#define LOG_ERROR(format, ...) DOG::Logger::Get().Write(DOG::LogLevel::Error, "" format, ##__VA_ARGS__)
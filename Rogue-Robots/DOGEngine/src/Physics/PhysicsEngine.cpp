@@ -391,6 +391,13 @@ namespace DOG
 			MeshColliderComponent& colliderComponent = EntityManager::Get().GetComponent<MeshColliderComponent>(entity);
 			s_physicsEngine.RemoveRigidbodyFromPhysics(colliderComponent.rigidbodyHandle, false);
 		}
+		if (EntityManager::Get().HasComponent<StaticMeshColliderComponent>(entity))
+		{
+			//The shape belongs to this entity alone, unlike the shared shapes of mesh colliders
+			StaticMeshColliderComponent& colliderComponent = EntityManager::Get().GetComponent<StaticMeshColliderComponent>(entity);
+			if (!colliderComponent.meshNotLoaded)
+				s_physicsEngine.RemoveRigidbodyFromPhysics(colliderComponent.rigidbodyHandle, true);
+		}
 		if (EntityManager::Get().HasComponent<BoxTriggerComponent>(entity))
 		{
 			BoxTriggerComponent& colliderComponent = EntityManager::Get().GetComponent<BoxTriggerComponent>(entity);
@@ -608,6 +615,22 @@ namespace DOG
 				--index;
 			}
 		}
+
+		//Static mesh colliders wait until every one of their models is loaded
+		std::erase_if(m_staticMeshCollidersWaitingForModels, [](entity entity)
+			{
+				if (!EntityManager::Get().Exists(entity) || !EntityManager::Get().HasComponent<StaticMeshColliderComponent>(entity))
+					return true;
+
+				StaticMeshColliderComponent& component = EntityManager::Get().GetComponent<StaticMeshColliderComponent>(entity);
+				for (auto& instance : component.instances)
+				{
+					if (!AssetManager::Get().GetAsset<ModelAsset>(instance.modelID))
+						return false;
+				}
+				component.LoadMeshes(entity);
+				return true;
+			});
 	}
 
 	void PhysicsEngine::AddMeshColliderData(const MeshColliderData& meshColliderData)
@@ -1001,6 +1024,95 @@ namespace DOG
 		meshNotLoaded = false;
 	}
 
+	namespace
+	{
+		//A bvh shape that owns its triangles, the triangles of a static mesh collider are not shared with anything else
+		class OwningBvhTriangleMeshShape : public btBvhTriangleMeshShape
+		{
+		public:
+			OwningBvhTriangleMeshShape(btTriangleMesh* mesh) : btBvhTriangleMeshShape(mesh, true), m_mesh(mesh) {}
+			~OwningBvhTriangleMeshShape() override { delete m_mesh; }
+
+		private:
+			btTriangleMesh* m_mesh;
+		};
+	}
+
+	StaticMeshColliderComponent::StaticMeshColliderComponent(entity entity, const std::vector<Instance>& meshInstances) noexcept
+		: instances(meshInstances)
+	{
+		for (auto& instance : instances)
+		{
+			AssetFlags modelFlags = AssetManager::Get().GetAssetFlags(instance.modelID);
+			bool modelLoadingToCPU = modelFlags.loadFlag & AssetLoadFlag::CPUMemory;
+			bool modelOnCPU = modelFlags.stateFlag & AssetStateFlag::ExistOnCPU;
+			if (!(modelLoadingToCPU || modelOnCPU))
+			{
+				std::cout << "Asset does not have CPUMemory flag set!\nStaticMeshColliderComponent require the meshes to be on the cpu!\n";
+				assert(false);
+			}
+
+			if (!AssetManager::Get().GetAsset<ModelAsset>(instance.modelID))
+			{
+				PhysicsEngine::s_physicsEngine.m_staticMeshCollidersWaitingForModels.push_back(entity);
+				return;
+			}
+		}
+
+		LoadMeshes(entity);
+	}
+
+	void StaticMeshColliderComponent::LoadMeshes(entity entity)
+	{
+		MINIPROFILE_NAMED("StaticMeshCollider");
+
+		//32 bit indices, the chunks are far bigger than 16 bit allows
+		btTriangleMesh* mesh = new btTriangleMesh(true, false);
+		triangleCount = 0;
+		for (auto& instance : instances)
+		{
+			ModelAsset* model = AssetManager::Get().GetAsset<ModelAsset>(instance.modelID);
+			const std::vector<u8>& vertexData = model->meshAsset.vertexData[VertexAttribute::Position];
+			if (vertexData.empty())
+			{
+				std::cout << "StaticMeshColliderComponent skipped a model without cpu data\n";
+				continue;
+			}
+			const Vector3* positions = reinterpret_cast<const Vector3*>(vertexData.data());
+			const auto& indices = model->meshAsset.indices;
+			const u32 vertexCount = static_cast<u32>(vertexData.size() / sizeof(Vector3));
+
+			//Submesh indices are relative to the first vertex of the submesh
+			for (auto& submesh : model->submeshes)
+			{
+				if (submesh.vertexStart + submesh.vertexCount > vertexCount || submesh.indexStart + submesh.indexCount > indices.size())
+				{
+					std::cout << "StaticMeshColliderComponent skipped a submesh outside of its model's data\n";
+					continue;
+				}
+
+				i32 base = 0;
+				for (u32 v = submesh.vertexStart; v < submesh.vertexStart + submesh.vertexCount; ++v)
+				{
+					Vector3 p = Vector3::Transform(positions[v], instance.world);
+					i32 added = mesh->findOrAddVertex(btVector3(p.x, p.y, p.z), false);
+					if (v == submesh.vertexStart)
+						base = added;
+				}
+				for (u32 i = submesh.indexStart; i + 2 < submesh.indexStart + submesh.indexCount; i += 3)
+				{
+					mesh->addTriangleIndices(base + indices[i], base + indices[i + 1], base + indices[i + 2]);
+					++triangleCount;
+				}
+			}
+		}
+
+		RigidbodyColliderData rCD;
+		rCD.collisionShapeHandle = PhysicsEngine::AddCollisionShape(new OwningBvhTriangleMeshShape(mesh));
+		rigidbodyHandle = PhysicsEngine::AddRigidbody(entity, rCD, false, 0.0f);
+		meshNotLoaded = false;
+	}
+
 	BoxTriggerComponent::BoxTriggerComponent(entity entity, const Vector3& boxColliderSize) noexcept
 	{
 		GhostObjectData ghostObjectData;
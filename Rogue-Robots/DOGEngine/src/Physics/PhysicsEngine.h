@@ -97,6 +97,25 @@ namespace DOG
 		RigidbodyHandle rigidbodyHandle;
 	};
 
+	//One static collider for many instances of models, built in world space so a whole chunk of a level is a single body
+	struct StaticMeshColliderComponent
+	{
+		struct Instance
+		{
+			u32 modelID = 0;
+			DirectX::SimpleMath::Matrix world;
+		};
+
+		StaticMeshColliderComponent(entity entity, const std::vector<Instance>& meshInstances) noexcept;
+
+		void LoadMeshes(entity entity);
+
+		std::vector<Instance> instances;
+		bool meshNotLoaded = true;
+		u32 triangleCount = 0;
+		RigidbodyHandle rigidbodyHandle;
+	};
+
 	struct BoxTriggerComponent
 	{
 		BoxTriggerComponent(entity entity, const DirectX::SimpleMath::Vector3& boxColliderSize) noexcept;
@@ -137,6 +156,7 @@ namespace DOG
 		friend CapsuleColliderComponent;
 		friend RigidbodyComponent;
 		friend MeshColliderComponent;
+		friend StaticMeshColliderComponent;
 		friend BoxTriggerComponent;
 		friend SphereTriggerComponent;
 		friend PhysicsRigidbody;
@@ -164,6 +184,7 @@ namespace DOG
 
 		//Mesh colliders which are waiting for the models to be loaded in
 		std::vector<MeshWaitData> m_meshCollidersWaitingForModels;
+		std::vector<entity> m_staticMeshCollidersWaitingForModels;
 
 		//If the mesh already is an collider
 		std::vector<MeshColliderData> m_meshCollidersLoadedInMemory;
@@ -226,5 +247,7 @@ namespace DOG
 		static void FreePhysicsFromDeferredEntities();
 		static std::optional<RayCastResult> RayCast(const DirectX::SimpleMath::Vector3& origin, const DirectX::SimpleMath::Vector3& target);
 		static void SetIgnoreCollisionCheck(RigidbodyHandle handleA, RigidbodyHandle handleB, bool value);
+		//The shapes read the vertices and indices of their models directly, so those models have to stay on the CPU
+		static const std::vector<MeshColliderData>& GetLoadedMeshColliders() { return s_physicsEngine.m_meshCollidersLoadedInMemory; }
 	};
 }
\ No newline at end of file
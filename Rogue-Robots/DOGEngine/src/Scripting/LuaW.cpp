@@ -1,8 +1,62 @@
 #include "LuaW.h"
 #include "LuaTable.h"
+#include "../Core/AssetFileSystem.h"
 
 namespace DOG
 {
+	namespace
+	{
+		//Like luaL_loadfile but reads through the AssetFileSystem, so scripts can be packed in an archive
+		int LoadFile(lua_State* l, const std::string& fileName)
+		{
+			auto file = AssetFileSystem::ReadFile(fileName);
+			if (!file)
+			{
+				lua_pushfstring(l, "cannot open %s", fileName.c_str());
+				return LUA_ERRFILE;
+			}
+
+			//The @ makes lua print the file name in error messages
+			std::string chunkName = "@" + fileName;
+			return luaL_loadbufferx(l, reinterpret_cast<const char*>(file->data.data()), file->data.size(), chunkName.c_str(), nullptr);
+		}
+
+		//Searcher for require, tries every template in package.path like the default file searcher
+		int AssetFileSearcher(lua_State* l)
+		{
+			std::string moduleName = luaL_checkstring(l, 1);
+			std::replace(moduleName.begin(), moduleName.end(), '.', '/');
+
+			lua_getglobal(l, "package");
+			lua_getfield(l, -1, "path");
+			std::string paths = lua_isstring(l, -1) ? lua_tostring(l, -1) : "";
+			lua_pop(l, 2);
+
+			size_t templateStart = 0;
+			while (templateStart <= paths.size())
+			{
+				size_t templateEnd = (std::min)(paths.find(';', templateStart), paths.size());
+				std::string fileName = paths.substr(templateStart, templateEnd - templateStart);
+				templateStart = templateEnd + 1;
+
+				for (size_t mark = fileName.find('?'); mark != std::string::npos; mark = fileName.find('?', mark + moduleName.size()))
+					fileName.replace(mark, 1, moduleName);
+
+				if (fileName.empty() || !AssetFileSystem::Exists(fileName))
+					continue;
+
+				if (LoadFile(l, fileName) != LUA_OK)
+					return luaL_error(l, "error loading module '%s' from file '%s':\n\t%s", lua_tostring(l, 1), fileName.c_str(), lua_tostring(l, -1));
+
+				lua_pushstring(l, fileName.c_str());
+				return 2;
+			}
+
+			lua_pushfstring(l, "no asset file for '%s'", lua_tostring(l, 1));
+			return 1;
+		}
+	}
+
 	LuaW LuaW::s_luaW;
 
 	LuaW::LuaW(lua_State* l)
@@ -15,6 +69,18 @@ namespace DOG
 		//Create the luaState and add the libs
 		m_luaState = luaL_newstate();
 		luaL_openlibs(m_luaState);
+
+		//Put the asset searcher right after the preload searcher, before lua looks for loose files itself
+		lua_getglobal(m_luaState, "package");
+		lua_getfield(m_luaState, -1, "searchers");
+		for (lua_Integer i = luaL_len(m_luaState, -1); i >= 2; --i)
+		{
+			lua_rawgeti(m_luaState, -1, i);
+			lua_rawseti(m_luaState, -2, i + 1);
+		}
+		lua_pushcfunction(m_luaState, AssetFileSearcher);
+		lua_rawseti(m_luaState, -2, 2);
+		lua_pop(m_luaState, 2);
 	}
 
 	void LuaW::Error(const std::string& errorMessage)
@@ -30,7 +96,7 @@ namespace DOG
 		const int getErrorMessage = -1;
 
 		//Load lua file and run it
-		int error = luaL_loadfile(m_luaState, luaFileName.c_str()) || lua_pcall(m_luaState, 0, LUA_MULTRET, 0);
+		int error = LoadFile(m_luaState, luaFileName) || lua_pcall(m_luaState, 0, LUA_MULTRET, 0);
 		if (error)
 		{
 			Error(lua_tostring(m_luaState, getErrorMessage));
@@ -688,7 +754,7 @@ namespace DOG
 	{
 		const int getErrorMessage = -1;
 
-		int error = luaL_loadfile(m_luaState, luaScriptName.c_str());
+		int error = LoadFile(m_luaState, luaScriptName);
 		if (error)
 		{
 			Error(lua_tostring(m_luaState, getErrorMessage));//"Couldn't find file " + luaScriptName + "!");
@@ -704,7 +770,7 @@ namespace DOG
 		const int popAmount = 1;
 		const int getErrorMessage = -1;
 
-		int error = luaL_loadfile(m_luaState, luaScriptName.c_str());
+		int error = LoadFile(m_luaState, luaScriptName);
 		if (error)
 			Error(lua_tostring(m_luaState, getErrorMessage));
 		else
@@ -1,4 +1,5 @@
 #include "ScriptManager.h"
+#include "../Core/AssetFileSystem.h"
 
 namespace DOG
 {
@@ -241,7 +242,7 @@ namespace DOG
 
 	void ScriptManager::RunLuaFile(const std::string& luaFileName)
 	{
-		if (std::filesystem::exists(c_pathToScripts + luaFileName))
+		if (AssetFileSystem::Exists(c_pathToScripts + luaFileName))
 		{
 			m_luaW->RunScript(c_pathToScripts + luaFileName);
 		}
@@ -4,32 +4,177 @@
 
 namespace DOG
 {
-	std::unordered_map<std::string, u64> MiniProfiler::s_times;
-	std::unordered_map<std::string, u64> MiniProfiler::s_accTime;
-	std::unordered_map<std::string, MiniProfiler::RollingAvg> MiniProfiler::s_avg;
+	std::unordered_map<std::string_view, u64> MiniProfiler::s_times;
+	std::unordered_map<std::string_view, u64> MiniProfiler::s_accTime;
+	std::unordered_map<std::string_view, u64> MiniProfiler::s_lastFrame;
+	std::unordered_map<std::string_view, MiniProfiler::RollingAvg> MiniProfiler::s_avg;
 	bool MiniProfiler::s_isActive = true;
-	u64 MiniProfiler::s_frameCounter = 0;
 
-	MiniProfiler::MiniProfiler(const std::string& name) : m_name(name)
+	std::mutex MiniProfiler::s_threadsMutex;
+	std::vector<std::unique_ptr<MiniProfiler::ThreadBuffer>> MiniProfiler::s_threads;
+	thread_local MiniProfiler::ThreadBuffer* MiniProfiler::s_threadBuffer = nullptr;
+
+	u32 MiniProfiler::s_captureFramesLeft = 0;
+	std::filesystem::path MiniProfiler::s_capturePath;
+	std::vector<std::pair<u32, MiniProfiler::Event>> MiniProfiler::s_capturedEvents;
+
+	void MiniProfiler::ThreadBuffer::Push(const Event& e) noexcept
 	{
-		m_start = std::chrono::high_resolution_clock::now();
+		const u64 head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) == CAPACITY)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		m_events[head & (CAPACITY - 1)] = e;
+		m_head.store(head + 1, std::memory_order_release);
 	}
 
-	MiniProfiler::~MiniProfiler()
+	template<typename F>
+	void MiniProfiler::ThreadBuffer::Drain(F&& f)
 	{
-		u64 time = static_cast<u64>(duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - m_start).count());
-		s_accTime[m_name] += time;
+		u64 tail = m_tail.load(std::memory_order_relaxed);
+		const u64 head = m_head.load(std::memory_order_acquire);
+		for (; tail != head; ++tail)
+		{
+			f(m_events[tail & (CAPACITY - 1)]);
+		}
+		m_tail.store(tail, std::memory_order_release);
 	}
 
+	MiniProfiler::MiniProfiler(const char* name) noexcept : m_name(name)
+	{
+		if (!s_isActive)
+			return;
+
+		m_buffer = GetThreadBuffer();
+		m_depth = m_buffer->depth++;
+		m_start = Now();
+	}
+
+	MiniProfiler::~MiniProfiler()
+	{
+		if (!m_buffer)
+			return;
+
+		u64 end = Now();
+		m_buffer->depth--;
+		m_buffer->Push({ m_name, m_start, end, m_depth });
+	}
 
 	void MiniProfiler::Update()
 	{
+		{
+			std::scoped_lock<std::mutex> lock(s_threadsMutex);
+			for (auto& thread : s_threads)
+			{
+				const u32 threadID = thread->threadID;
+				thread->Drain([threadID](const Event& e)
+					{
+						s_accTime[e.name] += e.end - e.start;
+						if (s_captureFramesLeft > 0)
+							s_capturedEvents.emplace_back(threadID, e);
+					});
+			}
+		}
+
 		for (auto& [n, t] : s_accTime)
 		{
 			s_times[n] = s_avg[n](t);
-			s_frameCounter++;
 		}
+		s_lastFrame.swap(s_accTime);
 		s_accTime.clear();
+
+		if (s_captureFramesLeft > 0 && --s_captureFramesLeft == 0)
+		{
+			WriteTrace();
+		}
+	}
+
+	void MiniProfiler::CaptureTrace(u32 frameCount, const std::filesystem::path& path)
+	{
+		s_capturePath = path;
+		s_capturedEvents.clear();
+		s_captureFramesLeft = frameCount;
+	}
+
+	void MiniProfiler::SetThreadName(const char* name)
+	{
+		GetThreadBuffer()->name = name;
+	}
+
+	MiniProfiler::ThreadBuffer* MiniProfiler::GetThreadBuffer()
+	{
+		if (!s_threadBuffer)
+		{
+			// Buffers outlive their threads so Update never reads freed memory
+			std::scoped_lock<std::mutex> lock(s_threadsMutex);
+			s_threads.push_back(std::make_unique<ThreadBuffer>(static_cast<u32>(s_threads.size())));
+			s_threadBuffer = s_threads.back().get();
+		}
+		return s_threadBuffer;
+	}
+
+	u64 MiniProfiler::Now() noexcept
+	{
+		return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void MiniProfiler::WriteTrace()
+	{
+		std::ofstream out(s_capturePath);
+		if (!out)
+		{
+			std::cout << "MiniProfiler: failed to open " << s_capturePath.string() << " for writing" << std::endl;
+			s_capturedEvents.clear();
+			return;
+		}
+
+		auto writeEscaped = [&out](const char* str)
+		{
+			for (; *str; ++str)
+			{
+				if (*str == '"' || *str == '\\')
+					out << '\\';
+				out << *str;
+			}
+		};
+
+		u64 origin = UINT64_MAX;
+		for (auto& [tid, e] : s_capturedEvents)
+			origin = std::min(origin, e.start);
+
+		out << "{\"traceEvents\":[";
+		bool first = true;
+
+		{
+			std::scoped_lock<std::mutex> lock(s_threadsMutex);
+			for (auto& thread : s_threads)
+			{
+				const char* name = thread->name;
+				if (!name)
+					continue;
+				out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->threadID << ",\"args\":{\"name\":\"";
+				writeEscaped(name);
+				out << "\"}}";
+				first = false;
+			}
+		}
+
+		out << std::fixed << std::setprecision(3);
+		for (auto& [tid, e] : s_capturedEvents)
+		{
+			out << (first ? "\n" : ",\n") << "{\"name\":\"";
+			writeEscaped(e.name);
+			out << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+				<< ",\"ts\":" << (e.start - origin) * 1E-3 << ",\"dur\":" << (e.end - e.start) * 1E-3
+				<< ",\"args\":{\"depth\":" << e.depth << "}}";
+			first = false;
+		}
+		out << "\n]}\n";
+
+		std::cout << "MiniProfiler: wrote " << s_capturedEvents.size() << " events to " << s_capturePath.string() << std::endl;
+		s_capturedEvents.clear();
 	}
 
 	void MiniProfiler::DrawResultWithImGui(bool& open)
@@ -44,6 +189,8 @@ namespace DOG
 			ImGui::MenuItem("LockTopLeft", nullptr, &lockTopLeft);
 			ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.8f);
 			ImGui::SliderInt("##1", &textOpacity, 70, 255, "Opacity");
+			if (ImGui::MenuItem("Capture trace (120 frames)", nullptr, false, s_captureFramesLeft == 0))
+				CaptureTrace(120, "MiniProfilerTrace.json");
 			ImGui::EndMenu(); // "MiniProfiler"
 		}
 
@@ -61,7 +208,7 @@ namespace DOG
 			ImGui::PushStyleColor(ImGuiCol_Border, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
 			if (ImGui::Begin("MiniProfiler", &open, (allowMove ? ImGuiWindowFlags_None : ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoBackground)))
 			{
-				static std::vector<std::pair<std::string, u64>> results;
+				static std::vector<std::pair<std::string_view, u64>> results;
 				results.clear();
 				results.reserve(MiniProfiler::s_times.size());
 				for (auto& [n, t] : MiniProfiler::s_times)
@@ -84,7 +231,7 @@ namespace DOG
 
 						ImGui::TableNextRow();
 						ImGui::TableSetColumnIndex(0);
-						ImGui::Text("%s", n.c_str());
+						ImGui::Text("%.*s", static_cast<int>(n.size()), n.data());
 						
 						ImGui::TableSetColumnIndex(1);
 						ImGui::Text("%-6.2fms", milisec);
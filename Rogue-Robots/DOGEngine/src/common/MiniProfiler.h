@@ -1,17 +1,58 @@
 #pragma once
 namespace DOG
 {
+	// Scoped CPU timer. Every thread records its scopes into its own lock-free ring which Update drains once per frame.
+	// Only the name pointer is stored, so names must be string literals or otherwise have static storage.
 	class MiniProfiler
 	{
 	public:
-		MiniProfiler(const std::string& name);
+		MiniProfiler(const char* name) noexcept;
 		~MiniProfiler();
-		
+
 		static void Update();
 		static void DrawResultWithImGui(bool& open);
 
+		// Records every scope on every thread for the next frameCount frames and writes them as Chrome trace-event JSON
+		static void CaptureTrace(u32 frameCount, const std::filesystem::path& path);
+		static void SetThreadName(const char* name);
+
+		// Unaveraged nanoseconds per scope name for the frame drained by the last Update
+		static const std::unordered_map<std::string_view, u64>& GetLastFrameTimes() noexcept { return s_lastFrame; }
+
 		static bool s_isActive;
 	private:
+		struct Event
+		{
+			const char* name;
+			u64 start;
+			u64 end;
+			u32 depth;
+		};
+
+		// Single producer (the owning thread), single consumer (Update)
+		class ThreadBuffer
+		{
+		public:
+			static constexpr u64 CAPACITY = 8192;
+			static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+			ThreadBuffer(u32 id) : threadID(id) {}
+
+			void Push(const Event& e) noexcept;
+			template<typename F>
+			void Drain(F&& f);
+
+			const u32 threadID;
+			std::atomic<const char*> name = nullptr;
+			std::atomic<u64> dropped = 0;
+			u32 depth = 0; // Only touched by the owning thread
+
+		private:
+			std::array<Event, CAPACITY> m_events;
+			alignas(64) std::atomic<u64> m_head = 0;
+			alignas(64) std::atomic<u64> m_tail = 0;
+		};
+
 		class RollingAvg
 		{
 		public:
@@ -23,13 +64,29 @@ namespace DOG
 			u64 m_previousInputs[n] = {};
 		};
 
-		static u64 s_frameCounter;
-		static std::unordered_map<std::string, u64> s_times;
-		static std::unordered_map<std::string, u64> s_accTime;
-		static std::unordered_map<std::string, RollingAvg> s_avg;
-		std::chrono::time_point<std::chrono::high_resolution_clock> m_start;
-		std::string m_name;
+		static ThreadBuffer* GetThreadBuffer();
+		static u64 Now() noexcept;
+		static void WriteTrace();
+
+		static std::mutex s_threadsMutex;
+		static std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+		static thread_local ThreadBuffer* s_threadBuffer;
+
+		// Keyed by the name's content, the same literal can have a different address in every translation unit
+		static std::unordered_map<std::string_view, u64> s_times;
+		static std::unordered_map<std::string_view, u64> s_accTime;
+		static std::unordered_map<std::string_view, u64> s_lastFrame;
+		static std::unordered_map<std::string_view, RollingAvg> s_avg;
+
+		static u32 s_captureFramesLeft;
+		static std::filesystem::path s_capturePath;
+		static std::vector<std::pair<u32, Event>> s_capturedEvents;
+
+		ThreadBuffer* m_buffer = nullptr;
+		const char* m_name;
+		u64 m_start = 0;
+		u32 m_depth = 0;
 	};
 }
 #define MINIPROFILE DOG::MiniProfiler miniProfiler(__FUNCTION__);
-#define MINIPROFILE_NAMED(name) DOG::MiniProfiler miniProfiler(name);
\ No newline at end of file
+#define MINIPROFILE_NAMED(name) DOG::MiniProfiler miniProfiler("" name);
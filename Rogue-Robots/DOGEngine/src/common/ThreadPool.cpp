@@ -0,0 +1,80 @@
+#include "ThreadPool.h"
+
+namespace DOG
+{
+	ThreadPool::ThreadPool(u32 workerCount, const char* name) : m_name(name)
+	{
+		m_workers.reserve(workerCount);
+		for (u32 i = 0; i < workerCount; ++i)
+			m_workers.emplace_back(&ThreadPool::WorkerRoutine, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_threadsShouldDie = true;
+		}
+		m_wake.notify_all();
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	void ThreadPool::Dispatch(u32 count, std::function<void(u32)> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			assert(m_busyWorkers == 0 && "Previous dispatch has not been waited on");
+			m_job = std::move(job);
+			m_count = count;
+			m_next = 0;
+			m_busyWorkers = GetWorkerCount();
+			++m_generation;
+		}
+		m_wake.notify_all();
+	}
+
+	void ThreadPool::Wait()
+	{
+		RunJobs();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+		m_job = nullptr;
+	}
+
+	u32 ThreadPool::DefaultWorkerCount(u32 maxWorkers) noexcept
+	{
+		const u32 hardwareThreads = std::thread::hardware_concurrency();
+		return std::clamp(hardwareThreads > 1 ? hardwareThreads - 1 : 1u, 1u, maxWorkers);
+	}
+
+	void ThreadPool::WorkerRoutine()
+	{
+		MiniProfiler::SetThreadName(m_name);
+
+		u64 seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]() { return m_threadsShouldDie || m_generation != seenGeneration; });
+				if (m_threadsShouldDie)
+					return;
+				seenGeneration = m_generation;
+			}
+
+			RunJobs();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_busyWorkers == 0)
+				m_done.notify_all();
+		}
+	}
+
+	void ThreadPool::RunJobs()
+	{
+		for (u32 i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+			m_job(i);
+	}
+}
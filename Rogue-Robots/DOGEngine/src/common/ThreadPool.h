@@ -0,0 +1,41 @@
+#pragma once
+namespace DOG
+{
+	// Persistent worker threads for fork-join work. Dispatch hands out the indices [0, count) to the workers,
+	// Wait lets the calling thread help with what is left and returns once every index has been processed.
+	// One dispatch at a time per pool, jobs may reference the caller's stack since Wait outlives them.
+	class ThreadPool
+	{
+	public:
+		ThreadPool(u32 workerCount, const char* name);
+		~ThreadPool();
+
+		u32 GetWorkerCount() const noexcept { return static_cast<u32>(m_workers.size()); }
+
+		void Dispatch(u32 count, std::function<void(u32)> job);
+		void Wait();
+		void ParallelFor(u32 count, std::function<void(u32)> job) { Dispatch(count, std::move(job)); Wait(); }
+
+		// Workers for a pool sharing the machine with the main thread
+		static u32 DefaultWorkerCount(u32 maxWorkers) noexcept;
+
+	private:
+		void WorkerRoutine();
+		void RunJobs();
+
+	private:
+		std::vector<std::thread> m_workers;
+		const char* m_name;
+
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		u64 m_generation = 0;
+		u32 m_busyWorkers = 0;
+		bool m_threadsShouldDie = false;
+
+		std::function<void(u32)> m_job;
+		u32 m_count = 0;
+		std::atomic<u32> m_next = 0;
+	};
+}
@@ -49,6 +49,7 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <semaphore>
 #include <atomic>
 #include <future>
@@ -69,6 +70,7 @@
 #include <cstdarg>
 #include <queue>
 #include <deque>
+#include <list>
 #include <set>
 
 
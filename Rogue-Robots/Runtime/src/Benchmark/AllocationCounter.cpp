@@ -0,0 +1,91 @@
+#include "AllocationCounter.h"
+
+static std::atomic<u64> s_allocations = 0;
+static std::atomic<u64> s_frees = 0;
+static std::atomic<u64> s_bytes = 0;
+
+static void* CountedAlloc(size_t size) noexcept
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	s_bytes.fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+static void* CountedAlignedAlloc(size_t size, std::align_val_t alignment) noexcept
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	s_bytes.fetch_add(size, std::memory_order_relaxed);
+	return _aligned_malloc(size ? size : 1, static_cast<size_t>(alignment));
+}
+
+static void CountedFree(void* p) noexcept
+{
+	if (!p)
+		return;
+	s_frees.fetch_add(1, std::memory_order_relaxed);
+	std::free(p);
+}
+
+static void CountedAlignedFree(void* p) noexcept
+{
+	if (!p)
+		return;
+	s_frees.fetch_add(1, std::memory_order_relaxed);
+	_aligned_free(p);
+}
+
+AllocationCounter::Snapshot AllocationCounter::Read() noexcept
+{
+	return {
+		s_allocations.load(std::memory_order_relaxed),
+		s_frees.load(std::memory_order_relaxed),
+		s_bytes.load(std::memory_order_relaxed),
+	};
+}
+
+void* operator new(size_t size)
+{
+	if (void* p = CountedAlloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	if (void* p = CountedAlloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	if (void* p = CountedAlignedAlloc(size, alignment))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	if (void* p = CountedAlignedAlloc(size, alignment))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { CountedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { CountedAlignedFree(p); }
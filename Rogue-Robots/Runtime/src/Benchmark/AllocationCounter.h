@@ -0,0 +1,22 @@
+#pragma once
+#include <DOGEngine.h>
+
+// Counts every allocation made through the global operator new.
+// The replacement operators live in AllocationCounter.cpp, which is only compiled into the benchmark target.
+class AllocationCounter
+{
+public:
+	struct Snapshot
+	{
+		u64 allocations = 0;
+		u64 frees = 0;
+		u64 bytes = 0;
+
+		Snapshot operator-(const Snapshot& other) const noexcept
+		{
+			return { allocations - other.allocations, frees - other.frees, bytes - other.bytes };
+		}
+	};
+
+	static Snapshot Read() noexcept;
+};
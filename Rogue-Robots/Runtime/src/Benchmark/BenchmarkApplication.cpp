@@ -0,0 +1,73 @@
+#include "BenchmarkApplication.h"
+#include <EntryPoint.h>
+using namespace DOG;
+
+BenchmarkApplication::BenchmarkApplication(const DOG::ApplicationSpecification& spec, const BenchmarkSettings& settings) noexcept
+	: DOG::Application{ spec }, m_benchmarkLayer(settings)
+{
+	OnStartUp();
+}
+
+BenchmarkApplication::~BenchmarkApplication()
+{
+	OnShutDown();
+}
+
+void BenchmarkApplication::OnStartUp() noexcept
+{
+	PushLayer(&m_benchmarkLayer);
+}
+
+void BenchmarkApplication::OnShutDown() noexcept
+{
+	PopLayer(&m_benchmarkLayer);
+}
+
+// Usage: RuntimeBenchmark [--level Cave.txt] [--frames N] [--warmup N] [--players N] [--agents N] [--projectiles N] [--seed N] [--timestep seconds] [--report path] [--renderer none|null]
+static BenchmarkSettings ParseBenchmarkArguments(int argc, char** argv)
+{
+	BenchmarkSettings settings;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string_view option = argv[i];
+		const char* value = argv[i + 1];
+		try
+		{
+			if (option == "--level") settings.levelName = value;
+			else if (option == "--frames") settings.frames = std::max(1ul, std::stoul(value));
+			else if (option == "--warmup") settings.warmupFrames = std::stoul(value);
+			else if (option == "--players") settings.playerCount = std::stoul(value);
+			else if (option == "--agents") settings.agentCount = std::stoul(value);
+			else if (option == "--projectiles") settings.projectileCount = std::stoul(value);
+			else if (option == "--seed") settings.seed = std::stoul(value);
+			else if (option == "--timestep") settings.timeStep = std::stof(value);
+			else if (option == "--report") settings.reportPath = value;
+			else if (option == "--renderer")
+			{
+				if (std::string_view(value) == "null") settings.nullRenderer = true;
+				else if (std::string_view(value) == "none") settings.nullRenderer = false;
+				else std::cout << "Benchmark: unknown renderer " << value << std::endl;
+			}
+			else std::cout << "Benchmark: unknown option " << option << std::endl;
+		}
+		catch (const std::exception&)
+		{
+			std::cout << "Benchmark: invalid value " << value << " for " << option << std::endl;
+		}
+	}
+	return settings;
+}
+
+std::unique_ptr<DOG::Application> CreateApplication() noexcept
+{
+	BenchmarkSettings settings = ParseBenchmarkArguments(__argc, __argv);
+
+	ApplicationSpecification spec;
+	spec.name = "Rogue Robots benchmark";
+	spec.workingDir = PROJECT_WORKSPACE;
+	spec.headless = true;
+	if (settings.nullRenderer)
+		spec.graphicsSettings.backend = GraphicsBackend::Null;
+	spec.fixedTimeStep = settings.timeStep;
+	return std::make_unique<BenchmarkApplication>(spec, settings);
+}
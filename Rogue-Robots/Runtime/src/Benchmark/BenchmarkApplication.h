@@ -0,0 +1,15 @@
+#pragma once
+#include <DOGEngine.h>
+#include "BenchmarkLayer.h"
+
+// Headless application for the RuntimeBenchmark target, see BenchmarkLayer
+class BenchmarkApplication : public DOG::Application
+{
+public:
+	explicit BenchmarkApplication(const DOG::ApplicationSpecification& spec, const BenchmarkSettings& settings) noexcept;
+	virtual ~BenchmarkApplication() noexcept override final;
+	virtual void OnStartUp() noexcept override final;
+	virtual void OnShutDown() noexcept override final;
+private:
+	BenchmarkLayer m_benchmarkLayer;
+};
@@ -0,0 +1,234 @@
+#include "BenchmarkLayer.h"
+#include "../Game/GameLayer.h"
+#include "../Game/GameSystems.h"
+#include "../Game/ExplosionSystems.h"
+#include "../Game/TurretSystems.h"
+#include "../Game/HomingMissileSystem.h"
+#include "../Game/SimpleAnimationSystems.h"
+#include "../Game/PrefabInstantiatorFunctions.h"
+#include "../Game/PlayerManager/PlayerManager.h"
+#include "../Game/AgentManager/AgentComponents.h"
+using namespace DOG;
+using namespace DirectX::SimpleMath;
+
+BenchmarkLayer::BenchmarkLayer(const BenchmarkSettings& settings) noexcept
+	: Layer("Benchmark layer"), m_settings(settings), m_rng(settings.seed)
+{
+	// Agent behavior falls back on rand(), keep it on the same sequence every run
+	std::srand(m_settings.seed);
+
+	LuaMain::GetScriptManager()->SortOrderScripts();
+	LuaMain::GetScriptManager()->RunLuaFile("LuaStartUp.lua");
+	GameLayer::RegisterLuaInterfaces(m_luaInterfaces);
+
+	RegisterSystems();
+
+	m_frameTimes.reserve(m_settings.frames);
+}
+
+BenchmarkLayer::~BenchmarkLayer()
+{
+}
+
+void BenchmarkLayer::OnAttach()
+{
+	std::cout << "Benchmark: " << m_settings.levelName << ", " << m_settings.playerCount << " players, " << m_settings.agentCount << " agents, "
+		<< m_settings.projectileCount << " projectiles, seed " << m_settings.seed << ", " << m_settings.frames << " frames, "
+		<< (m_settings.nullRenderer ? "null renderer" : "no renderer") << std::endl;
+
+	m_scene = std::make_unique<BenchmarkScene>(m_settings);
+	m_scene->SetUpScene();
+	LuaMain::GetScriptManager()->StartScripts();
+
+	m_lastAllocations = AllocationCounter::Read();
+}
+
+void BenchmarkLayer::OnDetach()
+{
+	m_scene.reset();
+}
+
+void BenchmarkLayer::OnUpdate()
+{
+	MINIPROFILE;
+
+	// The profiler was drained at the start of this frame, so everything recorded now belongs to the previous one
+	RecordFrame();
+
+	if (m_frameTimes.size() == m_settings.frames)
+	{
+		WriteReport();
+		Window::CloseWindow();
+		return;
+	}
+
+	LuaGlobal* global = LuaMain::GetGlobal();
+	global->SetNumber("DeltaTime", Time::DeltaTime());
+	global->SetNumber("ElapsedTime", Time::ElapsedTime());
+
+	SpawnProjectiles();
+
+	LuaMain::GetScriptManager()->UpdateScripts();
+}
+
+void BenchmarkLayer::RegisterSystems()
+{
+	// Same order as GameLayer, minus everything that draws UI or needs a window
+	EntityManager& em = EntityManager::Get();
+	em.RegisterSystem(std::make_unique<ScuffedSceneGraphSystem>());
+	em.RegisterSystem(std::make_unique<SetFlashLightToBoneSystem>());
+	em.RegisterSystem(std::make_unique<SetGunToBoneSystem>());
+	em.RegisterSystem(std::make_unique<DoorOpeningSystem>());
+	em.RegisterSystem(std::make_unique<LerpAnimationSystem>());
+	em.RegisterSystem(std::make_unique<LerpColorSystem>());
+	em.RegisterSystem(std::make_unique<HomingMissileTargetingSystem>());
+	em.RegisterSystem(std::make_unique<HomingMissileSystem>());
+	em.RegisterSystem(std::make_unique<HomingMissileImpacteSystem>());
+	em.RegisterSystem(std::make_unique<TurretProjectileSystem>());
+	em.RegisterSystem(std::make_unique<TurretProjectileHitSystem>());
+
+	em.RegisterSystem(std::make_unique<DespawnSystem>());
+	em.RegisterSystem(std::make_unique<TimedDestructionSystem>());
+	em.RegisterSystem(std::make_unique<ExplosionSystem>());
+	em.RegisterSystem(std::make_unique<ExplosionEffectSystem>());
+	em.RegisterSystem(std::make_unique<PickupLerpAnimationSystem>());
+	em.RegisterSystem(std::make_unique<PlayerJumpRefreshSystem>());
+
+	em.RegisterSystem(std::make_unique<CleanupPlayerStateSystem>());
+	em.RegisterSystem(std::make_unique<PlayerHit>());
+	em.RegisterSystem(std::make_unique<DeferredSetIgnoreCollisionCheckSystem>());
+	em.RegisterSystem(std::make_unique<RemoveBulletComponentSystem>());
+
+	em.RegisterSystem(std::make_unique<WeaponPointLightSystem>());
+	em.RegisterSystem(std::make_unique<SetPointLightDirtySystem>());
+}
+
+void BenchmarkLayer::SpawnProjectiles()
+{
+	u32 alive = 0;
+	EntityManager::Get().Collect<TurretProjectileComponent>().Do([&](TurretProjectileComponent&) { ++alive; });
+	if (alive >= m_settings.projectileCount)
+		return;
+
+	std::vector<entity> shooters;
+	for (entity player : m_scene->GetPlayers())
+	{
+		if (EntityManager::Get().Exists(player) && EntityManager::Get().HasComponent<PlayerAliveComponent>(player))
+			shooters.push_back(player);
+	}
+	if (shooters.empty())
+		return;
+
+	// Spread the spawns over a projectile lifetime so the population stays level instead of arriving in waves
+	const u32 perFrame = std::max(1u, static_cast<u32>(std::ceil(m_settings.projectileCount * m_settings.timeStep / PROJECTILE_LIFETIME)));
+	const u32 toSpawn = std::min(perFrame, m_settings.projectileCount - alive);
+
+	std::uniform_real_distribution<f32> yaw(-DirectX::XM_PI, DirectX::XM_PI);
+	std::uniform_real_distribution<f32> pitch(-0.2f, 0.2f);
+	for (u32 i = 0; i < toSpawn; ++i)
+	{
+		entity shooter = shooters[i % shooters.size()];
+		Vector3 position = EntityManager::Get().GetComponent<TransformComponent>(shooter).GetPosition();
+
+		Matrix transform = Matrix::CreateFromYawPitchRoll(yaw(m_rng), pitch(m_rng), 0.0f);
+		transform.Translation(position + Vector3(0.0f, 1.0f, 0.0f) + Vector3(transform._31, transform._32, transform._33));
+
+		SpawnTurretProjectile(transform, PROJECTILE_SPEED, 0.0f, PROJECTILE_LIFETIME, shooter, shooter);
+	}
+}
+
+void BenchmarkLayer::RecordFrame()
+{
+	AllocationCounter::Snapshot allocations = AllocationCounter::Read();
+	AllocationCounter::Snapshot frameAllocations = allocations - m_lastAllocations;
+	m_lastAllocations = allocations;
+
+	// Frame 0 is the setup frame
+	if (m_frame++ <= m_settings.warmupFrames)
+		return;
+
+	m_measuredAllocations.allocations += frameAllocations.allocations;
+	m_measuredAllocations.frees += frameAllocations.frees;
+	m_measuredAllocations.bytes += frameAllocations.bytes;
+
+	m_frameTimes.push_back(Time::FrameTime<TimeType::Nanoseconds, u64>());
+
+	for (auto& [name, time] : MiniProfiler::GetLastFrameTimes())
+	{
+		ScopeTiming& timing = m_scopeTimings[name];
+		timing.total += time;
+		timing.max = std::max(timing.max, time);
+	}
+}
+
+void BenchmarkLayer::WriteReport()
+{
+	const f64 frames = static_cast<f64>(m_frameTimes.size());
+
+	std::vector<u64> sortedFrames = m_frameTimes;
+	std::sort(sortedFrames.begin(), sortedFrames.end());
+	const u64 frameTotal = std::accumulate(sortedFrames.begin(), sortedFrames.end(), 0ull);
+	auto percentile = [&](f64 p) { return sortedFrames[static_cast<size_t>(p * (sortedFrames.size() - 1))]; };
+
+	std::vector<std::pair<std::string_view, ScopeTiming>> scopes(m_scopeTimings.begin(), m_scopeTimings.end());
+	std::sort(scopes.begin(), scopes.end(), [](auto& a, auto& b) { return a.second.total > b.second.total; });
+
+	const u64 checksum = StateChecksum();
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Benchmark: " << m_frameTimes.size() << " frames, frame time avg " << 1E-6 * frameTotal / frames << "ms, median " << 1E-6 * percentile(0.5)
+		<< "ms, p95 " << 1E-6 * percentile(0.95) << "ms, max " << 1E-6 * sortedFrames.back() << "ms" << std::endl;
+	std::cout << "Benchmark: " << m_measuredAllocations.allocations / frames << " allocations and " << m_measuredAllocations.bytes / frames << " bytes per frame" << std::endl;
+	for (auto& [name, timing] : scopes)
+	{
+		std::cout << "\t" << std::setw(10) << 1E-6 * timing.total / frames << "ms avg " << std::setw(10) << 1E-6 * timing.max << "ms max  " << name << std::endl;
+	}
+	std::cout << "Benchmark: state checksum " << std::hex << checksum << std::dec << std::endl;
+
+	std::ofstream out(m_settings.reportPath);
+	if (!out)
+	{
+		std::cout << "Benchmark: failed to open " << m_settings.reportPath << " for writing" << std::endl;
+		return;
+	}
+
+	out << std::fixed << std::setprecision(6);
+	out << "name,unit,avg,max,total\n";
+	out << "\"frame\",ms," << 1E-6 * frameTotal / frames << "," << 1E-6 * sortedFrames.back() << "," << 1E-6 * frameTotal << "\n";
+	out << "\"allocations\",count," << m_measuredAllocations.allocations / frames << ",," << m_measuredAllocations.allocations << "\n";
+	out << "\"allocated bytes\",bytes," << m_measuredAllocations.bytes / frames << ",," << m_measuredAllocations.bytes << "\n";
+	for (auto& [name, timing] : scopes)
+	{
+		out << "\"" << name << "\",ms," << 1E-6 * timing.total / frames << "," << 1E-6 * timing.max << "," << 1E-6 * timing.total << "\n";
+	}
+	out << "\"state checksum\",hash,,," << std::hex << checksum << std::dec << "\n";
+
+	std::cout << "Benchmark: wrote " << m_settings.reportPath << std::endl;
+}
+
+u64 BenchmarkLayer::StateChecksum()
+{
+	// FNV-1a over the quantized positions of every player and agent, equal between runs with the same seed if the simulation is deterministic
+	u64 hash = 14695981039346656037ull;
+	auto add = [&hash](f32 value)
+	{
+		i32 quantized = static_cast<i32>(std::lround(value * 1000.0f));
+		for (u32 i = 0; i < sizeof(quantized); ++i)
+		{
+			hash ^= static_cast<u8>(quantized >> (8 * i));
+			hash *= 1099511628211ull;
+		}
+	};
+
+	EntityManager::Get().Collect<TransformComponent>().Do([&](entity e, TransformComponent& transform)
+		{
+			if (EntityManager::Get().HasComponent<AgentIdComponent>(e) || EntityManager::Get().HasComponent<PlayerAliveComponent>(e))
+			{
+				Vector3 p = transform.GetPosition();
+				add(p.x);
+				add(p.y);
+				add(p.z);
+			}
+		});
+	return hash;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <DOGEngine.h>
+#include "BenchmarkScene.h"
+#include "AllocationCounter.h"
+#include "../Game/LuaInterfaces.h"
+
+// Steps the gameplay systems on a fixed time step and reports where the CPU time and allocations went.
+// Closes the application once settings.frames frames have been measured.
+class BenchmarkLayer : public DOG::Layer
+{
+public:
+	BenchmarkLayer(const BenchmarkSettings& settings) noexcept;
+	virtual ~BenchmarkLayer() override final;
+	virtual void OnAttach() override final;
+	virtual void OnDetach() override final;
+	virtual void OnUpdate() override final;
+
+private:
+	struct ScopeTiming
+	{
+		u64 total = 0;
+		u64 max = 0;
+	};
+
+	void RegisterSystems();
+	void SpawnProjectiles();
+	void RecordFrame();
+	void WriteReport();
+	u64 StateChecksum();
+
+private:
+	static constexpr f32 PROJECTILE_SPEED = 30.0f;
+	static constexpr f32 PROJECTILE_LIFETIME = 2.0f;
+
+	BenchmarkSettings m_settings;
+	std::unique_ptr<BenchmarkScene> m_scene;
+	std::vector<std::shared_ptr<LuaInterface>> m_luaInterfaces;
+	std::mt19937 m_rng;
+
+	u32 m_frame = 0;
+	AllocationCounter::Snapshot m_lastAllocations;
+	AllocationCounter::Snapshot m_measuredAllocations;
+	std::vector<u64> m_frameTimes;
+	std::unordered_map<std::string_view, ScopeTiming> m_scopeTimings;
+};
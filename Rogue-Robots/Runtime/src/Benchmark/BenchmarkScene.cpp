@@ -0,0 +1,65 @@
+#include "BenchmarkScene.h"
+#include "../Game/PrefabInstantiatorFunctions.h"
+#include "../Game/PCG/PcgLevelLoader.h"
+#include "../Game/AgentManager/AgentManager.h"
+#include "../Pathfinder/Pathfinder.h"
+using namespace DOG;
+using namespace DirectX::SimpleMath;
+
+BenchmarkScene::BenchmarkScene(const BenchmarkSettings& settings)
+	: Scene(SceneComponent::Type::PCGLevelScene), m_settings(settings)
+{
+
+}
+
+void BenchmarkScene::SetUpScene(std::vector<std::function<std::vector<DOG::entity>()>> entityCreators)
+{
+	for (auto& func : entityCreators)
+		AddEntities(func());
+
+	AddEntities(LoadLevel("Assets\\Levels\\" + m_settings.levelName));
+
+	Pathfinder::Get().BuildNavScene(m_sceneType);
+
+	Vector3 spawnblockPos = Vector3(20.0f, 20.0f, 20.0f);
+	EntityManager::Get().Collect<SpawnBlockComponent>().Do([&](entity e, SpawnBlockComponent&)
+		{
+			spawnblockPos = EntityManager::Get().GetComponent<TransformComponent>(e).GetPosition();
+		});
+	spawnblockPos += Vector3(2.5f, 7.0f, 2.5f);
+
+	u8 playerCount = static_cast<u8>(std::clamp(m_settings.playerCount, 1u, static_cast<u32>(MAX_PLAYER_COUNT)));
+	m_players = SpawnPlayers(spawnblockPos, playerCount, 5.f);
+	AddEntities(m_players);
+	AddEntities(AddFlashlightsToPlayers(m_players));
+	AddEntities(AddGunsToPlayers(m_players));
+
+	// Collection order only depends on the level file, so the seed alone decides where agents end up
+	constexpr f32 safeZone = 20.0f;
+	std::vector<Vector3> spawnPoints;
+	EntityManager::Get().Collect<FloorBlockComponent>().Do([&](entity e, FloorBlockComponent&)
+		{
+			Vector3 pos = EntityManager::Get().GetComponent<TransformComponent>(e).GetPosition();
+			if (Vector3::Distance(pos, spawnblockPos) > safeZone)
+				spawnPoints.push_back(pos);
+		});
+
+	if (spawnPoints.empty())
+	{
+		std::cout << "Benchmark: " << m_settings.levelName << " has no floor blocks to spawn agents on" << std::endl;
+		return;
+	}
+
+	constexpr u32 agentsPerGroup = 4;
+	std::mt19937 rng(m_settings.seed);
+	std::uniform_int_distribution<size_t> pickSpawn(0, spawnPoints.size() - 1);
+	u32 groupID = 0;
+	for (u32 i = 0; i < m_settings.agentCount; ++i)
+	{
+		if (i % agentsPerGroup == 0)
+			groupID = AgentManager::Get().GroupID();
+
+		Vector3 pos = spawnPoints[pickSpawn(rng)];
+		AgentManager::Get().CreateAgent(EntityTypes::Scorpio, groupID, Vector3(pos.x, pos.y + 2.5f, pos.z), m_sceneType);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <DOGEngine.h>
+#include "../Game/Scene.h"
+
+struct BenchmarkSettings
+{
+	std::string levelName = "Cave.txt";
+	u32 frames = 1000;
+	u32 warmupFrames = 60;
+	u32 playerCount = 4;
+	u32 agentCount = 64;
+	u32 projectileCount = 128;
+	u32 seed = 1;
+	f32 timeStep = 1.0f / 60.0f;
+	std::string reportPath = "BenchmarkReport.csv";
+	// Renders every frame on the null graphics backend, measures the CPU side of the renderer
+	bool nullRenderer = false;
+};
+
+// Loads a PCG level and places a fixed number of players and agents, every random choice comes from the seed
+class BenchmarkScene : public Scene
+{
+public:
+	BenchmarkScene(const BenchmarkSettings& settings);
+	void SetUpScene(std::vector<std::function<std::vector<DOG::entity>()>> entityCreators = {}) override;
+
+	const std::vector<DOG::entity>& GetPlayers() const noexcept { return m_players; }
+
+private:
+	BenchmarkSettings m_settings;
+	std::vector<DOG::entity> m_players;
+};
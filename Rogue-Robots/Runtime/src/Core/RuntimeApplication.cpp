@@ -176,6 +176,7 @@ void SaveRuntimeSettings(const ApplicationSpecification& spec, const GameSetting
 	outFile << "\nSettings =\n{";
 
 	outFile << "\n\t" << "masterVolume = " << spec.audioSettings.masterVolume;
+	outFile << ",\n\t" << "audioBackend = " << static_cast<int>(spec.audioSettings.backend);
 	outFile << ",\n\t" << "mouseSensitivity = " << gameSettings.mouseSensitivity;
 	outFile << ",\n\t" << "fullscreen = " << static_cast<int>(spec.graphicsSettings.windowMode);
 	outFile << ",\n\t" << "clientWidth = " << spec.windowDimensions.x;
@@ -219,6 +220,10 @@ void SaveRuntimeSettings(const ApplicationSpecification& spec, const GameSetting
 	outFile << ",\n\t" << "maxHeapUploadSizeDefault = " << spec.graphicsSettings.maxHeapUploadSizeDefault;
 	outFile << ",\n\t" << "maxHeapUploadSizeTextures = " << spec.graphicsSettings.maxHeapUploadSizeTextures;
 	outFile << ",\n\t" << "maxConstantsPerFrame = " << spec.graphicsSettings.maxConstantsPerFrame;
+
+	outFile << ",\n\n\t--Asset residency budgets in MiB";
+	outFile << "\n\t" << "assetCpuBudgetMB = " << spec.assetSettings.cpuBudgetMB;
+	outFile << ",\n\t" << "assetGpuBudgetMB = " << spec.assetSettings.gpuBudgetMB;
 	
 	outFile << "\n}\n";
 }
@@ -247,6 +252,7 @@ void SaveRuntimeSettings(const ApplicationSpecification& spec, const GameSetting
 		bool err = false;
 		err |= !tryGetSpec("masterVolume", appSpec.audioSettings.masterVolume);
 		appSpec.audioSettings.masterVolume = std::clamp(appSpec.audioSettings.masterVolume, 0.0f, 1.0f);
+		err |= !tryGetSpec("audioBackend", (int&)appSpec.audioSettings.backend);
 		err |= !tryGetSpec("mouseSensitivity", gameSettings.mouseSensitivity);
 		err |= !tryGetSpec("clientWidth", appSpec.windowDimensions.x);
 		err |= !tryGetSpec("clientHeight", appSpec.windowDimensions.y);
@@ -277,6 +283,10 @@ void SaveRuntimeSettings(const ApplicationSpecification& spec, const GameSetting
 		err |= !tryGetSpec("maxHeapUploadSizeTextures", appSpec.graphicsSettings.maxHeapUploadSizeTextures);
 		err |= !tryGetSpec("maxConstantsPerFrame", appSpec.graphicsSettings.maxConstantsPerFrame);
 
+		// Asset residency
+		err |= !tryGetSpec("assetCpuBudgetMB", appSpec.assetSettings.cpuBudgetMB);
+		err |= !tryGetSpec("assetGpuBudgetMB", appSpec.assetSettings.gpuBudgetMB);
+
 		bool modeErr = false;
 		appSpec.graphicsSettings.displayMode = DXGI_MODE_DESC{};
 		modeErr |= !tryGetSpec("scanLine", (int&)appSpec.graphicsSettings.displayMode->ScanlineOrdering);
@@ -8,60 +8,33 @@ using namespace DirectX::SimpleMath;
 
 void FakeCompute::Dispatch(int groupCountX, int groupCountY, int groupCountZ)
 {
-	m_data.localLightBuffers.clear();
-	m_data.localLightBuffers.resize(groupCountX * groupCountY * groupCountZ);
-	for (int groupX = 0; groupX < groupCountX; groupX++)
+	assert(groupCountZ == 1);
+
+	gfx::TiledLightCuller::Setup setup;
+	setup.view = m_data.view;
+	setup.proj = m_data.proj;
+	setup.width = (u32)m_data.res.x;
+	setup.height = (u32)m_data.res.y;
+	setup.tileSize = m_groupSizeX;
+	setup.nearClip = NEAR_CLIP;
+	setup.farClip = FAR_CLIP;
+	assert(gfx::TiledLightCuller::GetTileCount(setup).x == (u32)groupCountX && gfx::TiledLightCuller::GetTileCount(setup).y == (u32)groupCountY);
+
+	m_lights.Clear();
+	for (u32 i = 0; i < m_data.spheres.size(); ++i)
 	{
-		for (int groupY = 0; groupY < groupCountY; groupY++)
-		{
-			for (int groupZ = 0; groupZ < groupCountZ; groupZ++)
-			{
-				for (int threadX = 0; threadX < m_groupSizeX; threadX++)
-				{
-					for (int threadY = 0; threadY < m_groupSizeY; threadY++)
-					{
-						for (int threadZ = 0; threadZ < m_groupSizeZ; threadZ++)
-						{
-							MainCS(threadX, threadY, threadZ, groupX, groupY, groupZ);
-						}
-					}
-				}
-			}
-		}
+		const auto& sphere = m_data.spheres[i];
+		m_lights.Push({ sphere.center.x, sphere.center.y, sphere.center.z }, sphere.radius, i);
 	}
-}
 
+	m_culler.Cull(setup, m_lights, {}, m_data.localLightBuffers);
 
-void FakeCompute::MainCS(int tidX, int tidY, int tidZ, int gidX, int gidY, int gidZ)
-{
-	Vector2i tile{ gidX, gidY };
-	auto frustumPlanes = m_lightScene->ExtractPlanes(m_data.proj, m_data.view, (int)m_data.res.x, (int)m_data.res.y, m_groupSizeX, tile);
-	if (tidX == 0 && tidY == 0)
+	for (int groupY = 0; groupY < groupCountY; groupY++)
 	{
-		if (frustumPlanes.size() == 6)
-		{
-			m_lightScene->AddFrustum(frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3], frustumPlanes[4], frustumPlanes[5]);
-		}
-	}
-
-
-	int tid = tidX + m_groupSizeX * tidY + m_groupSizeX * m_groupSizeZ * tidZ;
-	if (tid >= m_data.spheres.size()) return;
-
-	int gid = gidX + m_data.groupCountX * gidY + m_data.groupCountX * m_data.groupCountY * gidZ;
-	int threadCount = m_groupSizeX * m_groupSizeY * m_groupSizeZ;
-	for (int i = tid; i < m_data.spheres.size(); i += threadCount)
-	{
-		auto& sphere = m_data.spheres[i];
-		bool culled = false;
-		for (int j = 0; j < 6; j++)
-		{
-			float d = sphere.center.Dot(frustumPlanes[j]);
-			culled |= d < -sphere.radius;
-		}
-		if (!culled)
+		for (int groupX = 0; groupX < groupCountX; groupX++)
 		{
-			m_data.localLightBuffers[gid].push_back(i);
+			auto planes = gfx::TiledLightCuller::GetTilePlanes(setup, groupX, groupY, NEAR_CLIP, FAR_CLIP);
+			m_lightScene->AddFrustum(planes[0], planes[1], planes[2], planes[3], planes[4], planes[5]);
 		}
 	}
 }
@@ -24,9 +24,10 @@ public:
 		int groupCountZ = 0;
 
 		std::vector<Sphere> spheres;
-		std::vector<std::vector<u64>> localLightBuffers;
+		std::vector<DOG::gfx::TiledLightCuller::TileLights> localLightBuffers;
 	};
 
+	// One group per tile, the tiles are culled by the engine's CPU light culler
 	void Dispatch(int groupCountX, int groupCountY, int groupCountZ);
 
 	int m_groupSizeX = 4;
@@ -39,5 +40,10 @@ public:
 
 
 private:
-	void MainCS(int tidX, int tidY, int tidZ, int gidX, int gidY, int gidZ);
-};
\ No newline at end of file
+	// Depth range of ExtractPlanes
+	static constexpr float NEAR_CLIP = 1.0f;
+	static constexpr float FAR_CLIP = 10.0f;
+
+	DOG::gfx::TiledLightCuller m_culler;
+	DOG::gfx::TiledLightCuller::Lights m_lights;
+};
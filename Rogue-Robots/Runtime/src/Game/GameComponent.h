@@ -371,6 +371,17 @@ struct CheckForLightsComponent
 {
 };
 
+//A chunk of the level where the blocks are merged into one StaticBatchComponent and one StaticMeshColliderComponent.
+struct LevelChunkComponent
+{
+	struct Block
+	{
+		DirectX::SimpleMath::Vector3 position;
+		DOG::BoundingBoxComponent bounds;
+	};
+	std::vector<Block> blocks;
+};
+
 struct LaserBeamVFXComponent
 {
 	DirectX::SimpleMath::Vector3 startPos;
@@ -28,6 +28,7 @@ NetworkStatus GameLayer::s_networkStatus = NetworkStatus::Offline;
 GameState GameLayer::m_gameState = GameState::Initializing;
 bool GameLayer::s_connectedPlayersLobby[MAX_PLAYER_COUNT] = { false, false, false, false };
 u16 GameLayer::s_levelIndex = 0;
+u64 GameLayer::s_levelSeed = 0;
 std::unique_ptr<WFC> GameLayer::s_WFC = nullptr;
 
 GameLayer::GameLayer() noexcept
@@ -37,7 +38,7 @@ GameLayer::GameLayer() noexcept
 	//Do startup of lua
 	LuaMain::GetScriptManager()->RunLuaFile("LuaStartUp.lua");
 	//Register Lua interfaces
-	RegisterLuaInterfaces();
+	RegisterLuaInterfaces(m_luaInterfaces);
 	
 	InGameMenu::Initialize(
 		[]() {
@@ -390,6 +391,15 @@ void GameLayer::OnUpdate()
 
 void GameLayer::GenerateLevel()
 {
+	std::random_device rd;
+	GenerateLevel((static_cast<u64>(rd()) << 32) | rd());
+}
+
+void GameLayer::GenerateLevel(u64 seed)
+{
+	s_levelSeed = seed;
+	LOG_INFO("Generating level from seed {}.", seed);
+
 	//Number of rooms to generate.
 	uint32_t nrOfRooms = 4;
 
@@ -399,46 +409,23 @@ void GameLayer::GenerateLevel()
 	uint32_t minDepth = 13;
 
 	//The generation has a certain amount of chances to succeed.
+	//Every attempt gets its own seed derived from the level seed, so the whole sequence can be reproduced.
 	unsigned chances = 100;
-	while (!s_WFC->GenerateLevel(nrOfRooms, minWidth, minHeight, minDepth) && chances > 0)
+	while (!s_WFC->GenerateLevel(nrOfRooms, minWidth, minHeight, minDepth, DeriveSeed(seed, 100 - chances)) && chances > 0)
 	{
 		chances--;
-		std::cout << chances << std::endl;
 	}
 	if (chances != 0)
 	{
-		//Output the generated level to a textfile.
-		std::vector<std::string> generatedLevel = s_WFC->GetGeneratedLevel();
-		std::vector<Room> generatedRooms = s_WFC->GetGeneratedRoomsData();
-
-		std::ofstream output("Assets\\Levels\\Generate.txt");
-
-		//Write the data about the rooms
-		for (auto& r : generatedRooms)
+		//Output the generated level in the binary level format.
+		std::vector<PcgRoomData> rooms;
+		for (auto& r : s_WFC->GetGeneratedRoomsData())
 		{
-			output << r.globalPos[0] << "," << r.globalPos[1] << "," << r.globalPos[2] << "," << r.width << "," << r.height << "," << r.depth << "\n";
+			rooms.push_back({ { r.globalPos[0], r.globalPos[1], r.globalPos[2] }, r.width, r.height, r.depth });
 		}
 
-		output << "\n";
-
-		//Write the level data.
-		uint32_t d = s_WFC->GetDepth();
-		uint32_t h = s_WFC->GetHeight();
-		uint32_t w = s_WFC->GetWidth();
-
-		for (uint32_t i{ 0u }; i < d; ++i)
-		{
-			for (uint32_t j{ 0u }; j < h; ++j)
-			{
-				for (uint32_t k{ 0u }; k < w; ++k)
-				{
-					output << generatedLevel[i * h * w + j * w + k] << " ";
-				}
-				output << "\n";
-			}
-			output << "-\n";
-		}
-		output.close();
+		PcgLevel level = BuildPcgLevel(s_WFC->GetGeneratedLevel(), s_WFC->GetWidth(), s_WFC->GetHeight(), s_WFC->GetDepth(), rooms);
+		SavePcgLevel(pcgLevelNames::generated, level);
 	}
 	else
 	{
@@ -848,41 +835,63 @@ void GameLayer::UpdateGame()
 		});
 
 	//Check if assets should create lights
-	EntityManager::Get().Collect<CheckForLightsComponent>().Do([](entity e, CheckForLightsComponent&)
+	auto addLights = [](entity e, ModelAsset* asset, const Matrix& world)
+	{
+		for (uint32_t i{ 0u }; i < asset->lights.size(); ++i)
 		{
-			ModelAsset* asset = AssetManager::Get().GetAsset<ModelAsset>(EntityManager::Get().GetComponent<ModelComponent>(e).id);
-			if (asset)
-			{
-				Vector3 assetPosition = EntityManager::Get().GetComponent<TransformComponent>(e).GetPosition();
-				for (uint32_t i{ 0u }; i < asset->lights.size(); ++i)
-				{
-					ImportedLight& currentLight = asset->lights[i];
+			ImportedLight& currentLight = asset->lights[i];
 
-					entity newLightEntity = EntityManager::Get().CreateEntity();
-					Vector3 globalPosition;
-					if (EntityManager::Get().HasComponent<TransformComponent>(e))
-					{
-						globalPosition = Vector3::Transform(Vector3(currentLight.translation), EntityManager::Get().GetComponent<TransformComponent>(e).worldMatrix);
-					}
-					EntityManager::Get().AddComponent<TransformComponent>(newLightEntity).SetPosition(globalPosition);
+			entity newLightEntity = EntityManager::Get().CreateEntity();
+			Vector3 globalPosition = Vector3::Transform(Vector3(currentLight.translation), world);
+			EntityManager::Get().AddComponent<TransformComponent>(newLightEntity).SetPosition(globalPosition);
 
-					PointLightDesc desc;
-					desc.color = Vector3(currentLight.color[0], currentLight.color[1], currentLight.color[2]);
-					desc.position = globalPosition;
-					desc.radius = currentLight.radius;
-					desc.strength = 1.0f;
+			PointLightDesc desc;
+			desc.color = Vector3(currentLight.color[0], currentLight.color[1], currentLight.color[2]);
+			desc.position = globalPosition;
+			desc.radius = currentLight.radius;
+			desc.strength = 1.0f;
 
-					LightHandle handle = LightManager::Get().AddPointLight(desc, LightUpdateFrequency::Never);
+			LightHandle handle = LightManager::Get().AddPointLight(desc, LightUpdateFrequency::Never);
 
-					PointLightComponent& pointLightComp = EntityManager::Get().AddComponent<PointLightComponent>(newLightEntity);
-					pointLightComp.handle = handle;
-					pointLightComp.dirty = false;
+			PointLightComponent& pointLightComp = EntityManager::Get().AddComponent<PointLightComponent>(newLightEntity);
+			pointLightComp.handle = handle;
+			pointLightComp.dirty = false;
 
-					if (EntityManager::Get().HasComponent<SceneComponent>(e))
-					{
-						EntityManager::Get().AddComponent<SceneComponent>(newLightEntity, EntityManager::Get().GetComponent<SceneComponent>(e).scene);
-					}
+			if (EntityManager::Get().HasComponent<SceneComponent>(e))
+			{
+				EntityManager::Get().AddComponent<SceneComponent>(newLightEntity, EntityManager::Get().GetComponent<SceneComponent>(e).scene);
+			}
+		}
+	};
+
+	EntityManager::Get().Collect<CheckForLightsComponent>().Do([&](entity e, CheckForLightsComponent&)
+		{
+			//Merged level chunks create the lights of every block once all of their models are loaded.
+			if (EntityManager::Get().HasComponent<StaticBatchComponent>(e))
+			{
+				auto& instances = EntityManager::Get().GetComponent<StaticBatchComponent>(e).instances;
+				for (auto& instance : instances)
+				{
+					if (!AssetManager::Get().GetAsset<ModelAsset>(instance.modelID))
+						return;
+				}
+				for (auto& instance : instances)
+				{
+					addLights(e, AssetManager::Get().GetAsset<ModelAsset>(instance.modelID), instance.world);
+				}
+				EntityManager::Get().RemoveComponent<CheckForLightsComponent>(e);
+				return;
+			}
+
+			ModelAsset* asset = AssetManager::Get().GetAsset<ModelAsset>(EntityManager::Get().GetComponent<ModelComponent>(e).id);
+			if (asset)
+			{
+				Matrix world = Matrix::Identity;
+				if (EntityManager::Get().HasComponent<TransformComponent>(e))
+				{
+					world = EntityManager::Get().GetComponent<TransformComponent>(e).worldMatrix;
 				}
+				addLights(e, asset, world);
 
 				EntityManager::Get().RemoveComponent<CheckForLightsComponent>(e);
 			}
@@ -1303,7 +1312,7 @@ void GameLayer::UpdateLobby()
 	m_nrOfPlayers = NetCode::Get().GetNrOfPlayers();
 }
 
-void GameLayer::RegisterLuaInterfaces()
+void GameLayer::RegisterLuaInterfaces(std::vector<std::shared_ptr<LuaInterface>>& luaInterfaces)
 {
 	LuaGlobal* global = LuaMain::GetGlobal();
 
@@ -1313,7 +1322,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//Input
 	//Create a luaInterface variable that holds the interface object (is reused for all interfaces)
 	std::shared_ptr<LuaInterface> luaInterfaceObject = std::make_shared<InputInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject); //Add it to the gamelayer's interfaces.
+	luaInterfaces.push_back(luaInterfaceObject); //Add it to the owner's interfaces.
 
 	auto luaInterface = global->CreateLuaInterface("InputInterface"); //Register a new interface in lua.
 	//Add all functions that are needed from the interface class.
@@ -1328,7 +1337,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Entities
 	luaInterfaceObject = std::make_shared<EntityInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("EntityInterface");
 	luaInterface.AddFunction<EntityInterface, &EntityInterface::CreateEntity>("CreateEntity");
@@ -1377,7 +1386,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Scene
 	luaInterfaceObject = std::make_shared<SceneInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("SceneInterface");
 
@@ -1390,7 +1399,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Assets
 	luaInterfaceObject = std::make_shared<AssetInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("AssetInterface");
 	luaInterface.AddFunction<AssetInterface, &AssetInterface::LoadModel>("LoadModel");
@@ -1403,7 +1412,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//Host
 
 	luaInterfaceObject = std::make_shared<HostInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("HostInterface");
 	luaInterface.AddFunction<HostInterface, &HostInterface::DistanceToPlayers>("DistanceToPlayers");
@@ -1414,7 +1423,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Physics
 	luaInterfaceObject = std::make_shared<PhysicsInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("PhysicsInterface");
 	luaInterface.AddFunction<PhysicsInterface, &PhysicsInterface::RBSetVelocity>("RBSetVelocity");
@@ -1429,7 +1438,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Render
 	luaInterfaceObject = std::make_shared<RenderInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("RenderInterface");
 	luaInterface.AddFunction<RenderInterface, &RenderInterface::CreateMaterial>("CreateMaterial");
@@ -1440,7 +1449,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//Game
 	luaInterfaceObject = std::make_shared<GameInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("GameInterface");
 	luaInterface.AddFunction<GameInterface, &GameInterface::ExplosionEffect>("ExplosionEffect");
@@ -1456,7 +1465,7 @@ void GameLayer::RegisterLuaInterfaces()
 	//-----------------------------------------------------------------------------------------------
 	//UI
 	luaInterfaceObject = std::make_shared<UIInterface>();
-	m_luaInterfaces.push_back(luaInterfaceObject);
+	luaInterfaces.push_back(luaInterfaceObject);
 
 	luaInterface = global->CreateLuaInterface("UIInterface");
 	luaInterface.AddFunction<UIInterface, &UIInterface::ChangeVertBarValue>("ChangeVertBarValue");
@@ -57,8 +57,14 @@ public:
 	static NetworkStatus GetNetworkStatus() { return s_networkStatus; }
 	static u16 s_levelIndex;
 
+	//Generates a level from a new random seed, or from the given one to reproduce a level.
 	static void GenerateLevel();
+	static void GenerateLevel(u64 seed);
+	static u64 s_levelSeed; //Seed of the last generated level.
 	static std::unique_ptr<WFC> s_WFC;
+
+	// The interfaces must be kept alive for as long as scripts can call them
+	static void RegisterLuaInterfaces(std::vector<std::shared_ptr<LuaInterface>>& luaInterfaces);
 private:
 	void UpdateLobby();
 	void UpdateGame();
@@ -71,7 +77,6 @@ private:
 	void RespawnDeadPlayer(DOG::entity e);
 	void KillPlayer(DOG::entity e);
 
-	void RegisterLuaInterfaces();
 	void Input(DOG::Key key);
 	void Release(DOG::Key key);
 	std::vector<DOG::entity> SpawnAgents(const EntityTypes type, SceneComponent::Type scene, const DirectX::SimpleMath::Vector3& pos, u8 agentCount, f32 spread = 10.f);
@@ -438,7 +438,7 @@ public:
 		{
 			if (idx++ == colComp.entitiesCount) break;
 
-			if (EntityManager::Get().HasComponent<DOG::ModularBlockComponent>(colEntity))
+			if (EntityManager::Get().HasComponent<DOG::ModularBlockComponent>(colEntity) || EntityManager::Get().HasComponent<LevelChunkComponent>(colEntity))
 			{
 				playerController.jumping = false;
 			}
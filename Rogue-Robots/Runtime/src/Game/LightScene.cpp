@@ -496,7 +496,7 @@ void LightScene::CullingResultWindow()
 						ImGui::TableSetColumnIndex(x);
 						int index = x + m_compute.m_data.groupCountX * y;
 						assert(index < m_compute.m_data.localLightBuffers.size());
-						ImGui::Text("%d", m_compute.m_data.localLightBuffers[index].size());
+						ImGui::Text("%u", m_compute.m_data.localLightBuffers[index].count);
 					}
 				}
 				ImGui::EndTable();
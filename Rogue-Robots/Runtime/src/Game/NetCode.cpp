@@ -1,6 +1,7 @@
 #include "NetCode.h"
 #include "ItemManager/ItemManager.h"
 #include "PlayerManager/PlayerManager.h"
+#include "PCG/PcgLevelLoader.h"
 
 using namespace DOG;
 
@@ -200,7 +201,7 @@ void NetCode::Receive()
 			
 			if (m_receiveBuffer == nullptr || m_numberOfPackets == 0)
 			{
-				std::cout << "NetCode:: Bad tcp packet, Number of packets: " << m_numberOfPackets << std::endl;
+				LOG_WARNING("NetCode:: Bad tcp packet, Number of packets: {}", m_numberOfPackets);
 				if (m_inputTcp.lobbyAlive)
 					m_netCodeAlive = false;
 			}
@@ -211,7 +212,7 @@ void NetCode::Receive()
 		}
 			
 	}
-	std::cout << "Client: stopped reciving packets \n";
+	LOG_INFO("Client: stopped reciving packets");
 }
 	
 void NetCode::ReceiveUdp()
@@ -258,7 +259,7 @@ bool NetCode::Host()
 		std::string ip = m_serverHost->GetIpAddress();
 		if (ip != "")
 		{
-			std::cout << "Hosting at: " << ip << std::endl;
+			LOG_INFO("Hosting at: {}", ip);
 			m_inputTcp.playerId = m_client->ConnectTcpServer(ip);
 			if (m_inputTcp.playerId > -1)
 			{
@@ -421,7 +422,7 @@ void NetCode::ReceiveDataTcp()
 		if (header.playerId > MAX_PLAYER_COUNT || header.playerId < 0)
 		{
 
-			std::cout << "Error: header is corrupt, Nr of packets left: " << m_numberOfPackets << std::endl;
+			LOG_WARNING("Error: header is corrupt, Nr of packets left: {}", m_numberOfPackets);
 			m_numberOfPackets = 0;
 			m_dataIsReadyToBeReceivedTcp = false;
 		}
@@ -567,14 +568,15 @@ void NetCode::ReceiveDataTcp()
 			{
 				memcpy(&m_lobbyData, m_receiveBuffer + m_bufferReceiveSize, sizeof(LobbyData));
 				m_bufferReceiveSize += sizeof(LobbyData);
-				if(m_inputTcp.playerId != 0)
-					memcpy(m_levelData + m_lobbyData.levelDataIndex, m_lobbyData.data, 4096);
+				if(m_inputTcp.playerId != 0 && m_lobbyData.levelDataIndex + sizeof(m_lobbyData.data) <= sizeof(m_levelData))
+					memcpy(m_levelData + m_lobbyData.levelDataIndex, m_lobbyData.data, sizeof(m_lobbyData.data));
 				if (m_inputTcp.playerId != 0 && m_lobbyData.levelDataIndex == 0)
 				{
-					std::ofstream levelfile("Assets\\Levels\\Generate.txt");
+					//The level is binary, so exactly levelSize bytes are written.
+					std::ofstream levelfile(pcgLevelNames::generated, std::ios::binary);
 					if (levelfile.is_open())
 					{
-						levelfile << m_levelData;
+						levelfile.write(m_levelData, std::min<size_t>(m_lobbyData.levelSize, sizeof(m_levelData)));
 						levelfile.close();
 					}
 				}
@@ -15,6 +15,28 @@
 #include <thread>
 */
 
+//Derives an independent seed from a seed and a stream number (SplitMix64).
+inline uint64_t DeriveSeed(uint64_t seed, uint64_t stream)
+{
+	uint64_t z = seed + (stream + 1u) * 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+//The std distributions differ between standard libraries, these give the same numbers for a seed everywhere.
+//Inclusive range.
+inline uint32_t RandomRange(std::mt19937_64& gen, uint32_t min, uint32_t max)
+{
+	return min + static_cast<uint32_t>(gen() % (static_cast<uint64_t>(max) - min + 1u));
+}
+
+//In [0, max).
+inline float RandomFloat(std::mt19937_64& gen, float max)
+{
+	return static_cast<float>(static_cast<double>(gen() >> 11) * (1.0 / 9007199254740992.0)) * max;
+}
+
 //Used to save data read from the input.
 struct Block
 {
@@ -30,14 +52,6 @@ struct EntropyBlock
 	std::vector<unsigned int> possibilities;
 };
 
-//Used in the PriorityQueue. Points to an entryblock and has a calculated Shannon Entropy.
-struct QueueBlock
-{
-	EntropyBlock* m_block = nullptr;
-	float m_entropy = 0.0f;
-	std::shared_ptr<QueueBlock> m_next;
-};
-
 struct Box
 {
 	Box(std::vector<uint32_t>& minIn, std::vector<uint32_t>& maxIn)
@@ -47,7 +61,7 @@ struct Box
 	}
 
 	//Returns true if the Box it was called on is to be put in viable. If false then the childs "viable" is to be taken instead.
-	bool Divide(const uint32_t& maxWidth, const uint32_t& maxHeight, const uint32_t& maxDepth, std::default_random_engine& gen)
+	bool Divide(const uint32_t& maxWidth, const uint32_t& maxHeight, const uint32_t& maxDepth, std::mt19937_64& gen)
 	{
 		uint32_t diffX = max[0] - min[0];
 		uint32_t diffY = max[1] - min[1];
@@ -1,168 +1,182 @@
 #include "PQ.h"
 
-int PriorityQueue::Pop()
+PriorityQueue::PriorityQueue(std::vector<EntropyBlock>& blockList, const std::vector<float>& frequencies, uint32_t width, uint32_t height, uint32_t depth, uint64_t seed) noexcept
+	: m_blocks{ blockList }
 {
-	if (!m_first)
+	//Make the frequencies into percentages, since log will be used.
+	m_weight.assign(frequencies.size(), 0.0);
+	m_weightLogWeight.assign(frequencies.size(), 0.0);
+	for (size_t id{ 0u }; id < frequencies.size(); ++id)
 	{
-		return -1; //When all blocks have been handled.
+		double f = frequencies[id] * 100.0;
+		m_weight[id] = f;
+		m_weightLogWeight[id] = f > 0.0 ? f * log(f) : 0.0;
 	}
-	else
-	{
-		//Go through the first few elements and see how many there are that share lowest entropy.
-		uint32_t count = 1;
-		float lowestVal = m_first->m_entropy;
-		std::shared_ptr<QueueBlock> current = m_first->m_next;
-		while (current && current->m_entropy == lowestVal)
-		{
-			++count;
-			current = current->m_next;
-		}
 
-		//If only the first element have the lowest entropy.
-		//Set 2nd element as first and return the removed element's index.
-		if (count == 1)
-		{
-			current = m_first;
-			m_first = m_first->m_next;
-
-			uint32_t returnIndex = current->m_block->id;
-			current->m_block = nullptr;
-			current->m_next = nullptr;
+	std::mt19937_64 gen(seed);
 
-			return returnIndex;
-		}
-		//Otherwise we randomize one of the elements with the lowest entropy and remove it from the PQ.
-		else
+	const uint32_t count = width * height * depth;
+	m_sumWeights.assign(count, 0.0);
+	m_sumWeightLogWeights.assign(count, 0.0);
+	m_entropy.assign(count, 0.0f);
+	m_tieBreak.resize(count);
+	m_position.resize(count);
+	m_heap.resize(count);
+	for (uint32_t i{ 0u }; i < count; ++i)
+	{
+		for (auto c : m_blocks[i].possibilities)
 		{
-			std::default_random_engine gen;
-			gen.seed(static_cast<unsigned int>(time(NULL)));
-			std::uniform_int_distribution<uint32_t> dist(1, count);
-			uint32_t val = dist(gen);
-
-			//Go to the randomized element.
-			count = 1;
-			current = m_first;
-			std::shared_ptr<QueueBlock> prev = nullptr;
-			while (count != val)
-			{
-				prev = current;
-				current = current->m_next;
-				++count;
-			}
-			if (current)
-			{
-				//If it's the first element.
-				if (!prev)
-				{
-					m_first = m_first->m_next;
-				}
-				else
-				{
-					//If it's the last element.
-					if (!current->m_next)
-					{
-						prev->m_next = nullptr;
-					}
-					else
-					{
-						prev->m_next = current->m_next;
-					}
-				}
-				uint32_t returnIndex = current->m_block->id;
-				current->m_block = nullptr;
-				current->m_next = nullptr;
-
-				return returnIndex;
-			}
-			else
-			{
-				return -1; //Should never happen.
-			}
+			m_sumWeights[i] += m_weight[c];
+			m_sumWeightLogWeights[i] += m_weightLogWeight[c];
 		}
+		m_entropy[i] = CalculateEntropy(i);
+		m_tieBreak[i] = static_cast<uint32_t>(gen() >> 32);
+		m_heap[i] = i;
+		m_position[i] = i;
+	}
+
+	//Heapify bottom up, O(n).
+	for (uint32_t i{ count / 2u }; i > 0u; --i)
+	{
+		SiftDown(i - 1u);
 	}
 }
 
-bool PriorityQueue::Rearrange(uint32_t index, std::unordered_map<unsigned int, Block>& blockPossibilities)
+int PriorityQueue::Pop()
 {
-	std::shared_ptr<QueueBlock> current = m_first;
-	std::shared_ptr<QueueBlock> prev = nullptr;
-	//Go to the element in question.
-	while (current && current->m_block->id != index)
+	if (m_heap.empty())
 	{
-		prev = current;
-		current = current->m_next;
+		return -1; //When all blocks have been handled.
 	}
 
-	if (!current)
+	uint32_t returnIndex = m_heap[0];
+	Swap(0u, static_cast<uint32_t>(m_heap.size()) - 1u);
+	m_heap.pop_back();
+	m_position[returnIndex] = NOT_QUEUED;
+	if (!m_heap.empty())
 	{
-		return true; //If the index has already been popped. (Could occur because of recursiveness)
+		SiftDown(0u);
 	}
-	else
-	{
-		if (current->m_block->possibilities.size() == 0)
-		{
-			return false; //This means the generation failed, because a block ended up not having any valid block.
-		}
 
-		//Recalculate the entropy of the element.
-		current->m_entropy = CalculateEntropy(current->m_block->possibilities, blockPossibilities);
+	return returnIndex;
+}
 
-		//If it's not the first element it might have to be moved.
-		if (prev)
-		{
-			//Remove it from the PQ.
-			prev->m_next = current->m_next;
-			current->m_next = nullptr;
-
-			//Find the spot where it is supposed to go.
-			std::shared_ptr<QueueBlock> stepper = m_first;
-			prev = nullptr;
-			while (stepper && stepper->m_entropy < current->m_entropy)
-			{
-				prev = stepper;
-				stepper = stepper->m_next;
-			}
-
-			//If the spot where it is supposed to go is the front of the queue.
-			if (!prev)
-			{
-				current->m_next = m_first;
-				m_first = current;
-			}
-			else
-			{
-				//If it is not the last spot.
-				if (stepper)
-				{
-					current->m_next = prev->m_next;
-				}
-
-				prev->m_next = current;
-			}
-		}
-		return true;
+void PriorityQueue::RemovePossibility(uint32_t index, unsigned int possibility)
+{
+	m_sumWeights[index] -= m_weight[possibility];
+	m_sumWeightLogWeights[index] -= m_weightLogWeight[possibility];
+}
+
+void PriorityQueue::AddPossibility(uint32_t index, unsigned int possibility)
+{
+	m_sumWeights[index] += m_weight[possibility];
+	m_sumWeightLogWeights[index] += m_weightLogWeight[possibility];
+}
+
+void PriorityQueue::Push(uint32_t index)
+{
+	if (m_position[index] != NOT_QUEUED)
+	{
+		return;
 	}
+
+	m_entropy[index] = CalculateEntropy(index);
+	m_position[index] = static_cast<uint32_t>(m_heap.size());
+	m_heap.push_back(index);
+	SiftUp(m_position[index]);
 }
 
-float PriorityQueue::CalculateEntropy(std::vector<unsigned int>& currentPossibilities, std::unordered_map<unsigned int, Block>& blockPossibilities)
+bool PriorityQueue::Rearrange(uint32_t index)
 {
-	//Shannon entropy.
+	if (m_position[index] == NOT_QUEUED)
+	{
+		return true; //If the index has already been popped. (Could occur because of recursiveness)
+	}
 
-	float sumWeights = 0.0f;
-	float sumWeightxLogWeight = 0.0f;
+	if (m_blocks[index].possibilities.size() == 0)
+	{
+		return false; //This means the generation failed, because a block ended up not having any valid block.
+	}
 
-	//Go through each possibility of the block and sum up the frequencies.
-	for (auto c : currentPossibilities)
+	//Removing an unlikely possibility lowers the entropy, removing a likely one can raise it.
+	m_entropy[index] = CalculateEntropy(index);
+	SiftUp(m_position[index]);
+	SiftDown(m_position[index]);
+	return true;
+}
+
+float PriorityQueue::CalculateEntropy(uint32_t index) const
+{
+	//A decided block is exactly 0, so rounding in the running sums can never put it behind an undecided one.
+	if (m_blocks[index].possibilities.size() <= 1)
 	{
-		float f = blockPossibilities[c].frequency * 100.0f; //Make the frequency into percentage, since log will be used.
-		sumWeights += f;
-		sumWeightxLogWeight += (f * log(f));
+		return 0.0f;
 	}
 
-	return log(sumWeights) - (sumWeightxLogWeight / sumWeights);
+	double sumWeights = m_sumWeights[index];
+	if (sumWeights <= 0.0)
+	{
+		return 0.0f;
+	}
+	return static_cast<float>(std::max(log(sumWeights) - (m_sumWeightLogWeights[index] / sumWeights), 0.0));
 
 	//Normal entropy
 	/*
-	return currentPossibilities.size();
+	return m_blocks[index].possibilities.size();
 	*/
 }
+
+bool PriorityQueue::Less(uint32_t a, uint32_t b) const
+{
+	if (m_entropy[a] != m_entropy[b])
+	{
+		return m_entropy[a] < m_entropy[b];
+	}
+	return m_tieBreak[a] < m_tieBreak[b];
+}
+
+void PriorityQueue::Swap(uint32_t a, uint32_t b)
+{
+	std::swap(m_heap[a], m_heap[b]);
+	m_position[m_heap[a]] = a;
+	m_position[m_heap[b]] = b;
+}
+
+void PriorityQueue::SiftUp(uint32_t position)
+{
+	while (position > 0u)
+	{
+		uint32_t parent = (position - 1u) / 2u;
+		if (!Less(m_heap[position], m_heap[parent]))
+		{
+			break;
+		}
+		Swap(position, parent);
+		position = parent;
+	}
+}
+
+void PriorityQueue::SiftDown(uint32_t position)
+{
+	const uint32_t size = static_cast<uint32_t>(m_heap.size());
+	while (true)
+	{
+		uint32_t smallest = position;
+		uint32_t left = 2u * position + 1u;
+		uint32_t right = left + 1u;
+		if (left < size && Less(m_heap[left], m_heap[smallest]))
+		{
+			smallest = left;
+		}
+		if (right < size && Less(m_heap[right], m_heap[smallest]))
+		{
+			smallest = right;
+		}
+		if (smallest == position)
+		{
+			break;
+		}
+		Swap(position, smallest);
+		position = smallest;
+	}
+}
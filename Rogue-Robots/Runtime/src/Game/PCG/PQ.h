@@ -1,84 +1,54 @@
 #pragma once
 #include "PCGHelper.h"
 
+//Indexed binary min-heap of the cells of a room, keyed by Shannon entropy.
+//Every cell keeps running sums of its possibilities' weights, so removing a possibility updates the entropy in O(1) and moves the cell in O(log n).
 class PriorityQueue
 {
 public:
 	PriorityQueue() noexcept = delete;
 
-	PriorityQueue(std::vector<EntropyBlock>& blockList, std::unordered_map<unsigned int, Block>& blockPossibilities, uint32_t width, uint32_t height, uint32_t depth) noexcept
-	{
-		m_first = std::make_shared<QueueBlock>();
-		//m_first = new QueueBlock();
-		m_first->m_block = &blockList[0];
-		m_first->m_entropy = CalculateEntropy(m_first->m_block->possibilities, blockPossibilities);
-		m_first->m_next = nullptr;
+	//Seed decides the order of cells with the same entropy.
+	PriorityQueue(std::vector<EntropyBlock>& blockList, const std::vector<float>& frequencies, uint32_t width, uint32_t height, uint32_t depth, uint64_t seed) noexcept;
+	~PriorityQueue() noexcept = default;
 
-		//For all entropyblocks except first calculate the entropy and place it in the correct location in the PQ.
-		for (uint32_t i{ 1u }; i < width * height * depth; ++i)
-		{
-			std::shared_ptr<QueueBlock> newBlock = std::make_shared<QueueBlock>();
-			newBlock->m_block = &blockList[i];
-			newBlock->m_entropy = CalculateEntropy(newBlock->m_block->possibilities, blockPossibilities);
-			newBlock->m_next = nullptr;
-
-			//If the entropy of the new block is lower or the same as the first block.
-			if (newBlock->m_entropy <= m_first->m_entropy)
-			{
-				newBlock->m_next = m_first;
-				m_first = newBlock;
-			}
-			else
-			{
-				std::shared_ptr<QueueBlock> prevBlock = m_first;
-				std::shared_ptr<QueueBlock> nextBlock = m_first->m_next;
-				bool placed = false;
-				//Find the spot where the new block is supposed to go.
-				while (nextBlock && !placed)
-				{
-					//If the new blocks entropy is lower or the same as the next block to check we put the new block into the queue here.
-					if (newBlock->m_entropy <= nextBlock->m_entropy)
-					{
-						newBlock->m_next = nextBlock;
-						prevBlock->m_next = newBlock;
-						placed = true;
-					}
-					else //Otherwise we go to the next block.
-					{
-						prevBlock = nextBlock;
-						nextBlock = nextBlock->m_next;
-					}
-				}
-				//If it did not get placed during the loop it gets placed at the end of the queue.
-				if (!placed)
-				{
-					prevBlock->m_next = newBlock;
-				}
-			}
-		}
-	}
+	//Returns the index of the block with the lowest entropy and removes it from the PQ, -1 when it is empty.
+	int Pop();
 
-	~PriorityQueue() noexcept
-	{
-		//This prevents a stack overflow when the generation is done.
-		QueueBlock* temp = m_first.get();
-		while (temp)
-		{
-			m_first = temp->m_next;
-			temp->m_next = nullptr;
-			temp = m_first.get();
-		}
-	};
+	//Has to be called before a possibility is erased from a block. Only updates the weight sums, Rearrange moves the block.
+	void RemovePossibility(uint32_t index, unsigned int possibility);
 
-	//Returns the index of one of the first blocks in the PQ (decided randomly)
-	int Pop();
+	//Is called everytime the entropy for a block is reduced, moves the item in question to its new place in the PQ.
+	//Returns false if the block has no possibilities left.
+	bool Rearrange(uint32_t index);
 
-	//Is called everytime the entropy for a block is reduced, goes to the item in question and rearrages it in the PQ.
-	bool Rearrange(uint32_t index, std::unordered_map<unsigned int, Block>& blockPossibilities);
+	//Used when backtracking. AddPossibility is the inverse of RemovePossibility and Push puts a popped block back in the PQ.
+	void AddPossibility(uint32_t index, unsigned int possibility);
+	void Push(uint32_t index);
 
 private:
-	//Calculates the Shannon entropy of the block. Used as prio.
-	float CalculateEntropy(std::vector<unsigned int>& currentPossibilities, std::unordered_map<unsigned int, Block>& blockPossibilities);
+	static constexpr uint32_t NOT_QUEUED = (uint32_t)-1;
+
+	//Shannon entropy from the running sums.
+	float CalculateEntropy(uint32_t index) const;
+
+	bool Less(uint32_t a, uint32_t b) const;
+	void Swap(uint32_t a, uint32_t b);
+	void SiftUp(uint32_t position);
+	void SiftDown(uint32_t position);
+
+	std::vector<EntropyBlock>& m_blocks;
+
+	//Weight and weight * log(weight) per possibility id.
+	std::vector<double> m_weight;
+	std::vector<double> m_weightLogWeight;
+
+	//Per cell.
+	std::vector<double> m_sumWeights;
+	std::vector<double> m_sumWeightLogWeights;
+	std::vector<float> m_entropy;
+	std::vector<uint32_t> m_tieBreak; //Random order between cells with the same entropy.
+	std::vector<uint32_t> m_position; //Where the cell is in the heap, NOT_QUEUED when popped.
 
-	std::shared_ptr<QueueBlock> m_first = nullptr;
-};
\ No newline at end of file
+	std::vector<uint32_t> m_heap; //Cell indices.
+};
@@ -0,0 +1,333 @@
+#include "PcgLevelFormat.h"
+#include <charconv>
+
+namespace
+{
+	constexpr u32 MAGIC = 0x4C474350u; //"PCGL"
+	constexpr u16 VERSION = 1u;
+	constexpr u32 MAX_CELLS = 1u << 24; //Guards against allocating for a corrupt header.
+
+	template<typename T>
+	void Write(std::vector<u8>& out, const T& value)
+	{
+		const u8* bytes = reinterpret_cast<const u8*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	struct Reader
+	{
+		const u8* data;
+		size_t size;
+		size_t offset = 0u;
+
+		template<typename T>
+		bool Read(T& value)
+		{
+			if (size - offset < sizeof(T))
+				return false;
+			memcpy(&value, data + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(std::string& value, size_t length)
+		{
+			if (size - offset < length)
+				return false;
+			value.assign(reinterpret_cast<const char*>(data + offset), length);
+			offset += length;
+			return true;
+		}
+	};
+
+	u32 ParseU32(std::string_view text)
+	{
+		u32 value = 0u;
+		std::from_chars(text.data(), text.data() + text.size(), value);
+		return value;
+	}
+}
+
+u16 PcgLevel::AddBlock(std::string_view block, std::unordered_map<std::string, u16>& lookup)
+{
+	if (block == "Void")
+		return VOID_CELL;
+
+	//"Name_rN_f", anything without a rotation (like "Empty") is a name on its own.
+	size_t firstUnderscore = block.find('_');
+	std::string_view name = block.substr(0, firstUnderscore);
+	u16 cell = 0u;
+	if (firstUnderscore != std::string_view::npos && block.size() > firstUnderscore + 2u && block[firstUnderscore + 1u] == 'r')
+	{
+		size_t secondUnderscore = block.find('_', firstUnderscore + 1u);
+		cell |= ParseU32(block.substr(firstUnderscore + 2u, secondUnderscore - firstUnderscore - 2u)) & ROTATION_MASK;
+		if (secondUnderscore != std::string_view::npos)
+		{
+			std::string_view flip = block.substr(secondUnderscore + 1u);
+			if (flip.find('x') != std::string_view::npos)
+				cell |= FLIP_X;
+			if (flip.find('y') != std::string_view::npos)
+				cell |= FLIP_Y;
+		}
+	}
+
+	auto it = lookup.find(std::string(name));
+	u16 index = 0u;
+	if (it != lookup.end())
+	{
+		index = it->second;
+	}
+	else
+	{
+		assert(palette.size() < MAX_PALETTE_SIZE);
+		index = static_cast<u16>(palette.size());
+		palette.emplace_back(name);
+		lookup.emplace(std::string(name), index);
+	}
+	return cell | static_cast<u16>(index << PALETTE_SHIFT);
+}
+
+PcgLevel BuildPcgLevel(const std::vector<std::string>& blocks, u32 width, u32 height, u32 depth, const std::vector<PcgRoomData>& rooms)
+{
+	assert(blocks.size() == static_cast<size_t>(width) * height * depth);
+
+	PcgLevel level;
+	level.width = width;
+	level.height = height;
+	level.depth = depth;
+	level.rooms = rooms;
+	level.cells.resize(blocks.size());
+
+	std::unordered_map<std::string, u16> lookup;
+	for (size_t i{ 0u }; i < blocks.size(); ++i)
+	{
+		level.cells[i] = level.AddBlock(blocks[i], lookup);
+	}
+	return level;
+}
+
+void SerializePcgLevel(const PcgLevel& level, std::vector<u8>& out)
+{
+	//Runs of { count, cell }.
+	std::vector<std::pair<u16, u16>> runs;
+	for (u16 cell : level.cells)
+	{
+		if (!runs.empty() && runs.back().second == cell && runs.back().first < std::numeric_limits<u16>::max())
+			++runs.back().first;
+		else
+			runs.push_back({ 1u, cell });
+	}
+
+	out.clear();
+	Write(out, MAGIC);
+	Write(out, VERSION);
+	Write(out, static_cast<u16>(level.palette.size()));
+	Write(out, level.width);
+	Write(out, level.height);
+	Write(out, level.depth);
+	Write(out, static_cast<u32>(level.rooms.size()));
+	Write(out, static_cast<u32>(runs.size()));
+
+	for (auto& room : level.rooms)
+	{
+		Write(out, room);
+	}
+
+	for (auto& name : level.palette)
+	{
+		assert(name.size() <= std::numeric_limits<u8>::max());
+		Write(out, static_cast<u8>(name.size()));
+		out.insert(out.end(), name.begin(), name.end());
+	}
+
+	for (auto& [count, cell] : runs)
+	{
+		Write(out, count);
+		Write(out, cell);
+	}
+}
+
+bool DeserializePcgLevel(const u8* data, size_t size, PcgLevel& out)
+{
+	Reader reader{ data, size };
+
+	u32 magic = 0u;
+	u16 version = 0u;
+	u16 paletteSize = 0u;
+	u32 roomCount = 0u;
+	u32 runCount = 0u;
+	if (!reader.Read(magic) || magic != MAGIC || !reader.Read(version) || version != VERSION)
+		return false;
+
+	PcgLevel level;
+	if (!reader.Read(paletteSize) || !reader.Read(level.width) || !reader.Read(level.height) || !reader.Read(level.depth) ||
+		!reader.Read(roomCount) || !reader.Read(runCount))
+		return false;
+
+	const u64 cellCount = static_cast<u64>(level.width) * level.height * level.depth;
+	if (paletteSize == 0u || paletteSize > PcgLevel::MAX_PALETTE_SIZE || cellCount > MAX_CELLS || runCount > cellCount)
+		return false;
+
+	for (u32 i{ 0u }; i < roomCount; ++i)
+	{
+		if (!reader.Read(level.rooms.emplace_back()))
+			return false;
+	}
+
+	level.palette.resize(paletteSize);
+	for (auto& name : level.palette)
+	{
+		u8 length = 0u;
+		if (!reader.Read(length) || !reader.ReadString(name, length))
+			return false;
+	}
+
+	level.cells.reserve(cellCount);
+	for (u32 i{ 0u }; i < runCount; ++i)
+	{
+		u16 count = 0u;
+		u16 cell = 0u;
+		if (!reader.Read(count) || !reader.Read(cell))
+			return false;
+		if (PcgLevel::GetPaletteIndex(cell) >= paletteSize || level.cells.size() + count > cellCount)
+			return false;
+		level.cells.insert(level.cells.end(), count, cell);
+	}
+	if (level.cells.size() != cellCount)
+		return false;
+
+	out = std::move(level);
+	return true;
+}
+
+bool ParsePcgLevelText(std::string_view text, PcgLevel& out)
+{
+	PcgLevel level;
+	std::unordered_map<std::string, u16> lookup;
+
+	//Every row of the grid with the slice it belongs to.
+	std::vector<std::pair<u32, std::vector<u16>>> rows;
+	u32 slice = 0u;
+	u32 sliceRows = 0u;
+	bool readingRooms = true;
+
+	size_t lineStart = 0u;
+	while (lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos)
+			lineEnd = text.size();
+		std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1u;
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1u);
+
+		//The room data comes first, one room per line until an empty line.
+		if (readingRooms)
+		{
+			if (line.empty())
+			{
+				readingRooms = false;
+				continue;
+			}
+
+			PcgRoomData room;
+			u32* values[6] = { &room.pos[0], &room.pos[1], &room.pos[2], &room.width, &room.height, &room.depth };
+			size_t valueStart = 0u;
+			for (u32 i{ 0u }; i < 6u && valueStart <= line.size(); ++i)
+			{
+				size_t comma = line.find(',', valueStart);
+				*values[i] = ParseU32(line.substr(valueStart, comma - valueStart));
+				valueStart = comma == std::string_view::npos ? line.size() + 1u : comma + 1u;
+			}
+			level.rooms.push_back(room);
+			continue;
+		}
+
+		if (line.empty())
+			continue;
+
+		//A dash ends a slice.
+		if (line[0] == '-')
+		{
+			++slice;
+			sliceRows = 0u;
+			continue;
+		}
+
+		auto& row = rows.emplace_back(slice, std::vector<u16>()).second;
+		++sliceRows;
+		size_t tokenStart = line.find_first_not_of(' ');
+		while (tokenStart != std::string_view::npos)
+		{
+			size_t tokenEnd = line.find(' ', tokenStart);
+			row.push_back(level.AddBlock(line.substr(tokenStart, tokenEnd - tokenStart), lookup));
+			tokenStart = tokenEnd == std::string_view::npos ? tokenEnd : line.find_first_not_of(' ', tokenEnd);
+		}
+	}
+
+	if (rows.empty())
+		return false;
+
+	//A file that does not end with a dash still has its last slice.
+	level.depth = slice + (sliceRows > 0u ? 1u : 0u);
+	std::unordered_map<u32, u32> rowsInSlice;
+	for (auto& [rowSlice, row] : rows)
+	{
+		level.width = std::max(level.width, static_cast<u32>(row.size()));
+		level.height = std::max(level.height, ++rowsInSlice[rowSlice]);
+	}
+
+	level.cells.assign(static_cast<size_t>(level.width) * level.height * level.depth, PcgLevel::VOID_CELL);
+	rowsInSlice.clear();
+	for (auto& [rowSlice, row] : rows)
+	{
+		u32 y = rowsInSlice[rowSlice]++;
+		std::copy(row.begin(), row.end(), level.cells.begin() + (static_cast<size_t>(rowSlice) * level.height + y) * level.width);
+	}
+
+	out = std::move(level);
+	return true;
+}
+
+bool LoadPcgLevel(const std::string& file, PcgLevel& out)
+{
+	std::ifstream inputFile(file, std::ios::binary | std::ios::ate);
+	if (!inputFile.is_open())
+	{
+		LOG_WARNING("Could not open level {}.", file);
+		return false;
+	}
+
+	std::vector<u8> data(static_cast<size_t>(inputFile.tellg()));
+	inputFile.seekg(0);
+	inputFile.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	u32 magic = 0u;
+	if (data.size() >= sizeof(magic))
+		memcpy(&magic, data.data(), sizeof(magic));
+
+	bool loaded = magic == MAGIC ?
+		DeserializePcgLevel(data.data(), data.size(), out) :
+		ParsePcgLevelText(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()), out);
+	if (!loaded)
+	{
+		LOG_WARNING("Level {} is corrupt.", file);
+	}
+	return loaded;
+}
+
+bool SavePcgLevel(const std::string& file, const PcgLevel& level)
+{
+	std::vector<u8> data;
+	SerializePcgLevel(level, data);
+
+	std::ofstream output(file, std::ios::binary);
+	if (!output.is_open())
+	{
+		LOG_WARNING("Could not write level {}.", file);
+		return false;
+	}
+	output.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <DOGEngine.h>
+
+//Room metadata, the same numbers the text format writes on its first lines.
+struct PcgRoomData
+{
+	u32 pos[3] = { 0u, 0u, 0u };
+	u32 width = 0u;
+	u32 height = 0u;
+	u32 depth = 0u;
+};
+
+//A level as a palette of block names and a grid of cells indexing into it.
+//Blocks are written "Name_rN_f" in the text format, the name goes into the palette and the rotation and flip go into the cell.
+struct PcgLevel
+{
+	//Cell layout: bits 0-1 rotation, bit 2 flip x, bit 3 flip y, bits 4-15 palette index.
+	static constexpr u16 ROTATION_MASK = 0x3;
+	static constexpr u16 FLIP_X = 0x4;
+	static constexpr u16 FLIP_Y = 0x8;
+	static constexpr u32 PALETTE_SHIFT = 4u;
+	static constexpr u32 MAX_PALETTE_SIZE = 1u << (16u - PALETTE_SHIFT);
+
+	//Palette entry 0 is always Void, so an empty grid is all zeroes.
+	static constexpr u16 VOID_CELL = 0u;
+
+	u32 width = 0u;
+	u32 height = 0u;
+	u32 depth = 0u;
+	std::vector<PcgRoomData> rooms;
+	std::vector<std::string> palette{ "Void" };
+	std::vector<u16> cells; //Index is x + y * width + z * width * height, the order of the WFC output.
+
+	static u16 GetPaletteIndex(u16 cell) { return cell >> PALETTE_SHIFT; }
+	static u32 GetRotation(u16 cell) { return cell & ROTATION_MASK; }
+
+	//Adds a block written in the text format ("Void", "Empty" or "Name_rN_f[x][y]") and returns its cell.
+	//The lookup maps block names to palette indices while a level is being built.
+	u16 AddBlock(std::string_view block, std::unordered_map<std::string, u16>& lookup);
+};
+
+//Builds a level from the output of the WFC, blocks holds width * height * depth text blocks.
+PcgLevel BuildPcgLevel(const std::vector<std::string>& blocks, u32 width, u32 height, u32 depth, const std::vector<PcgRoomData>& rooms);
+
+//The binary format. The grid is run length encoded, most of a level is Void.
+void SerializePcgLevel(const PcgLevel& level, std::vector<u8>& out);
+bool DeserializePcgLevel(const u8* data, size_t size, PcgLevel& out);
+
+//Parses the old whitespace separated text format.
+bool ParsePcgLevelText(std::string_view text, PcgLevel& out);
+
+//Loads either format, binary files are recognized by their header.
+bool LoadPcgLevel(const std::string& file, PcgLevel& out);
+bool SavePcgLevel(const std::string& file, const PcgLevel& level);
@@ -1,111 +1,198 @@
 #include "PcgLevelLoader.h"
 #include <DOGEngine.h>
 #include "../GameComponent.h"
+#include <map>
 using namespace DOG;
 using namespace DirectX::SimpleMath;
 
+namespace
+{
+	//What a palette entry turns into, resolved once per level instead of once per block.
+	struct PaletteBlock
+	{
+		enum class Kind { Void, Empty, Block } kind = Kind::Void;
+		enum class Tag { None, Spawn, Exit, Floor } tag = Tag::None;
+		u32 model = 0u;
+		u32 collider = 0u;
+	};
+
+	PaletteBlock ResolvePaletteBlock(const std::string& blockName)
+	{
+		PaletteBlock block;
+		if (blockName == "Void")
+		{
+			return block;
+		}
+		if (blockName == "Empty")
+		{
+			block.kind = PaletteBlock::Kind::Empty;
+			return block;
+		}
+
+		AssetManager& aManager = AssetManager::Get();
+		block.kind = PaletteBlock::Kind::Block;
+		//The vertices are needed on the CPU to merge the blocks into chunks.
+		block.model = aManager.LoadModelAsset("Assets/Models/ModularBlocks/" + blockName + ".gltf",
+			(DOG::AssetLoadFlag)(DOG::AssetLoadFlag::CPUMemory | DOG::AssetLoadFlag::GPUMemory | DOG::AssetLoadFlag::Async));
+		block.collider = aManager.LoadModelAsset("Assets/Models/ModularBlocks/" + blockName + "_Col.gltf", (DOG::AssetLoadFlag)((DOG::AssetLoadFlag)(DOG::AssetLoadFlag::CPUMemory | DOG::AssetLoadFlag::GPUMemory)));
+
+		if (blockName.find("Spawn") != std::string::npos)
+		{
+			block.tag = PaletteBlock::Tag::Spawn;
+		}
+		else if (blockName.find("Exit") != std::string::npos)
+		{
+			block.tag = PaletteBlock::Tag::Exit;
+		}
+		else if (blockName == "Floor1" || blockName == "Riverbed1" || blockName.find("Connector") != std::string::npos)
+		{
+			block.tag = PaletteBlock::Tag::Floor;
+		}
+		return block;
+	}
+
+	//Blocks of a chunk, merged into one render batch and one collider.
+	struct LevelChunk
+	{
+		std::vector<StaticBatchComponent::Instance> renderInstances;
+		std::vector<StaticMeshColliderComponent::Instance> colliderInstances;
+		std::vector<LevelChunkComponent::Block> blocks;
+	};
+}
+
 std::vector<DOG::entity> LoadLevel(std::string file)
+{
+	PcgLevel level;
+	if (!LoadPcgLevel(file, level))
+	{
+		return {};
+	}
+	return LoadLevel(level);
+}
+
+std::vector<DOG::entity> LoadLevel(const PcgLevel& level)
 {
 	auto& em = EntityManager::Get();
 
 	constexpr float blockDim = pcgBlock::DIMENSION;
 	constexpr float half = blockDim / 2.0f;
 	constexpr Vector3 extents{ half, half, half };
+	float piDiv2 = DirectX::XM_PIDIV2;
 
-	std::string line;
-
-	std::ifstream inputFile(file);
+	//Read every block model of the level in one go instead of one file at a time.
+	std::vector<std::filesystem::path> blockFiles;
+	for (auto& blockName : level.palette)
+	{
+		if (blockName != "Void" && blockName != "Empty")
+		{
+			for (const char* file : { ".gltf", ".bin", "_Col.gltf", "_Col.bin" })
+			{
+				blockFiles.emplace_back("Assets/Models/ModularBlocks/" + blockName + file);
+			}
+		}
+	}
+	AssetManager::Get().PrefetchFiles(blockFiles);
 
-	AssetManager& aManager = AssetManager::Get();
+	std::vector<PaletteBlock> palette;
+	palette.reserve(level.palette.size());
+	for (auto& blockName : level.palette)
+	{
+		palette.push_back(ResolvePaletteBlock(blockName));
+	}
 
 	std::vector<entity> levelBlocks;
 
-	unsigned x = 0;
-	unsigned y = 0;
-	unsigned z = 0;
-	float piDiv2 = DirectX::XM_PIDIV2;
-	if (inputFile.is_open())
+	//Ordered so the chunk entities are created in the same order every time.
+	std::map<std::pair<uint32_t, uint32_t>, LevelChunk> chunks;
+
+	//The grid is in WFC order, its depth is laid out along world x and its width along world z.
+	for (uint32_t z{ 0u }; z < level.depth; ++z)
 	{
-		//Read the room data
-		do
-		{
-			std::getline(inputFile, line);
-			//Do stuff with room data here.
-		} while (line != "");
-		//Read the level
-		while (std::getline(inputFile, line))
+		for (uint32_t y{ 0u }; y < level.height; ++y)
 		{
-			if (line[0] != '-')
+			for (uint32_t x{ 0u }; x < level.width; ++x)
 			{
-				while (line.find(' ') != std::string::npos)
+				u16 cell = level.cells[x + y * level.width + z * level.width * level.height];
+				const PaletteBlock& block = palette[PcgLevel::GetPaletteIndex(cell)];
+				if (block.kind == PaletteBlock::Kind::Void)
 				{
-					size_t delimPos = line.find(' ');
-					std::string block = line.substr(0, delimPos);
-					line.erase(0, delimPos + 1);
-					if (block == "Empty")
-					{
-						entity blockEntity = levelBlocks.emplace_back(em.CreateEntity());
-						em.AddComponent<EmptySpaceComponent>(blockEntity, Vector3(x * blockDim, y * blockDim, z * blockDim));
-						// Add BoundingBox to modular block
-						em.AddComponent<BoundingBoxComponent>(blockEntity,
-							Vector3{ x * blockDim, y * blockDim + blockDim / 2, z * blockDim }, extents);
-					}
-					else if (block != "Void")
-					{
-						size_t firstUnderscore = block.find('_');
-						size_t secondUnderscore = block.find('_', firstUnderscore + 1);
-						std::string blockName = block.substr(0, firstUnderscore);
-						int blockRot = std::stoi(block.substr(firstUnderscore + 2, secondUnderscore - firstUnderscore - 2));
-						Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
-
-						entity blockEntity = levelBlocks.emplace_back(em.CreateEntity());
-						em.AddComponent<ModelComponent>(blockEntity, aManager.LoadModelAsset("Assets/Models/ModularBlocks/" + blockName + ".gltf"));
-						em.AddComponent<TransformComponent>(blockEntity,
-							Vector3(x * blockDim, y * blockDim, z * blockDim),
-							Vector3(0.0f, -blockRot * piDiv2, 0.0f),
-							scale);
-						em.AddComponent<CheckForLightsComponent>(blockEntity);
-
-						// Add BoundingBox to modular block
-						em.AddComponent<BoundingBoxComponent>(blockEntity, 
-							Vector3{ x * blockDim, y * blockDim + blockDim / 2, z * blockDim }, extents);
-						
-						em.AddComponent<ModularBlockComponent>(blockEntity);
-
-						em.AddComponent<MeshColliderComponent>(blockEntity,
-							blockEntity,
-							aManager.LoadModelAsset("Assets/Models/ModularBlocks/" + blockName + "_Col.gltf", (DOG::AssetLoadFlag)((DOG::AssetLoadFlag)(DOG::AssetLoadFlag::CPUMemory | DOG::AssetLoadFlag::GPUMemory))),
-							scale,
-							false);		// Set this to true if you want to see colliders only in wireframe
-						
-						em.AddComponent<ShadowReceiverComponent>(blockEntity);
-
-						if (blockName.find("Spawn") != std::string::npos)
-						{
-							em.AddComponent<SpawnBlockComponent>(blockEntity);
-						}
-						else if (blockName.find("Exit") != std::string::npos)
-						{
-							em.AddComponent<ExitBlockComponent>(blockEntity);
-						}
-						else if (blockName == "Floor1" || blockName == "Riverbed1" || blockName.find("Connector") != std::string::npos)
-						{
-							em.AddComponent<FloorBlockComponent>(blockEntity);
-						}
-					}
-					++z;
+					continue;
 				}
-				z = 0;
-				++y;
-			}
-			else
-			{
-				z = 0;
-				y = 0;
-				++x;
+
+				Vector3 position = Vector3(z * blockDim, y * blockDim, x * blockDim);
+				if (block.kind == PaletteBlock::Kind::Empty)
+				{
+					entity blockEntity = levelBlocks.emplace_back(em.CreateEntity());
+					em.AddComponent<EmptySpaceComponent>(blockEntity, position);
+					// Add BoundingBox to modular block
+					em.AddComponent<BoundingBoxComponent>(blockEntity,
+						Vector3{ position.x, position.y + blockDim / 2, position.z }, extents);
+					continue;
+				}
+
+				float blockRot = static_cast<float>(PcgLevel::GetRotation(cell));
+				Vector3 scale = Vector3(1.0f, 1.0f, 1.0f);
+				TransformComponent transform(position, Vector3(0.0f, -blockRot * piDiv2, 0.0f), scale);
+
+				//Spawn and exit blocks are looked up as entities by gameplay, the goal radar outlines the exit model.
+				if (block.tag == PaletteBlock::Tag::Spawn || block.tag == PaletteBlock::Tag::Exit)
+				{
+					entity blockEntity = levelBlocks.emplace_back(em.CreateEntity());
+					em.AddComponent<ModelComponent>(blockEntity, block.model);
+					em.AddComponent<TransformComponent>(blockEntity, transform);
+					em.AddComponent<CheckForLightsComponent>(blockEntity);
+
+					// Add BoundingBox to modular block
+					em.AddComponent<BoundingBoxComponent>(blockEntity,
+						Vector3{ position.x, position.y + blockDim / 2, position.z }, extents);
+
+					em.AddComponent<ModularBlockComponent>(blockEntity);
+
+					em.AddComponent<MeshColliderComponent>(blockEntity,
+						blockEntity,
+						block.collider,
+						scale,
+						false);		// Set this to true if you want to see colliders only in wireframe
+
+					em.AddComponent<ShadowReceiverComponent>(blockEntity);
+
+					if (block.tag == PaletteBlock::Tag::Spawn)
+						em.AddComponent<SpawnBlockComponent>(blockEntity);
+					else
+						em.AddComponent<ExitBlockComponent>(blockEntity);
+					continue;
+				}
+
+				//Floor blocks only need a position for the enemy and item spawning.
+				if (block.tag == PaletteBlock::Tag::Floor)
+				{
+					entity floorEntity = levelBlocks.emplace_back(em.CreateEntity());
+					em.AddComponent<TransformComponent>(floorEntity, transform);
+					em.AddComponent<FloorBlockComponent>(floorEntity);
+				}
+
+				LevelChunk& chunk = chunks[{ z / pcgBlock::CHUNK_SIZE, x / pcgBlock::CHUNK_SIZE }];
+				chunk.renderInstances.push_back({ block.model, transform.worldMatrix });
+				chunk.colliderInstances.push_back({ block.collider, transform.worldMatrix });
+				chunk.blocks.push_back({ position, BoundingBoxComponent(Vector3{ position.x, position.y + blockDim / 2, position.z }, extents) });
 			}
 		}
 	}
 
+	for (auto& [key, chunk] : chunks)
+	{
+		entity chunkEntity = levelBlocks.emplace_back(em.CreateEntity());
+		em.AddComponent<TransformComponent>(chunkEntity);
+
+		StaticBatchComponent& batch = em.AddComponent<StaticBatchComponent>(chunkEntity);
+		batch.instances = std::move(chunk.renderInstances);
+		batch.doubleSided = true;
+
+		em.AddComponent<StaticMeshColliderComponent>(chunkEntity, chunkEntity, chunk.colliderInstances);
+		em.AddComponent<ShadowReceiverComponent>(chunkEntity);
+		em.AddComponent<CheckForLightsComponent>(chunkEntity);
+		em.AddComponent<LevelChunkComponent>(chunkEntity).blocks = std::move(chunk.blocks);
+	}
+
 	return levelBlocks;
 }
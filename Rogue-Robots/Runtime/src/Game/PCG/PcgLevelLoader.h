@@ -1,8 +1,10 @@
 #pragma once
 #include <DOGEngine.h>
+#include "PcgLevelFormat.h"
 namespace pcgBlock
 {
 	constexpr float DIMENSION = 5.0f;
+	constexpr uint32_t CHUNK_SIZE = 8u; //Blocks along world x and z merged into one chunk, the chunks span the whole height.
 }
 namespace pcgLevelNames
 {
@@ -10,7 +12,7 @@ namespace pcgLevelNames
 	constexpr const char* tunnels = "Assets\\Levels\\Tunnels_generatedLevel.txt";
 	constexpr const uint32_t nrLevels = 10;
 	constexpr const char pcgLevels[nrLevels][128] = {
-		"Generate.txt",
+		"Generate.pcg",
 		"Cave.txt",
 		"Bridge.txt",
 		"Tunnels.txt",
@@ -21,5 +23,7 @@ namespace pcgLevelNames
 		"Abyss.txt",
 		"Impossible.txt"
 	};
+	constexpr const char* generated = "Assets\\Levels\\Generate.pcg";
 }
-std::vector<DOG::entity> LoadLevel(std::string file); //Loads a PCG generated level.
+std::vector<DOG::entity> LoadLevel(std::string file); //Loads a PCG generated level, binary or text.
+std::vector<DOG::entity> LoadLevel(const PcgLevel& level);
@@ -1,3 +1,4 @@
+#include <DOGEngine.h>
 #include "WFC.h"
 
 bool WFC::EdgeConstrain(uint32_t cellIndex, uint32_t dir, Room& room)
@@ -6,17 +7,16 @@ bool WFC::EdgeConstrain(uint32_t cellIndex, uint32_t dir, Room& room)
 	for (uint32_t j{ 0u }; j < m_entropy[room.i][cellIndex].possibilities.size(); ++j) //Go through all the current possibilities in the cell
 	{
 		unsigned int possibility = m_entropy[room.i][cellIndex].possibilities[j];
-		if (m_idToStringMap[possibility].find("Door") != std::string::npos)
+		if (m_idToString[possibility].find("Door") != std::string::npos)
 		{
 			continue;
 		}
 		//Check if the possibility cannot have a boundary in the direction.
-		if (!std::count(m_blockPossibilities[possibility].dirPossibilities[dir].begin(), m_blockPossibilities[possibility].dirPossibilities[dir].end(), m_stringToIdMap["Edge"]) &&
-			!std::count(m_blockPossibilities[possibility].dirPossibilities[dir].begin(), m_blockPossibilities[possibility].dirPossibilities[dir].end(), m_stringToIdMap["Void"])) //This has to be tested. Might fuck everything
+		if (!Allowed(possibility, dir, m_edgeId) && !Allowed(possibility, dir, m_voidId)) //This has to be tested. Might fuck everything
 		{
 			if (m_entropy[room.i][cellIndex].possibilities.size() == 1)
 			{
-				m_failed[room.i] = true;
+				m_failed[room.i] = 1u;
 				break;
 			}
 
@@ -51,15 +51,7 @@ bool WFC::EdgeConstrain(uint32_t cellIndex, uint32_t dir, Room& room)
 bool WFC::IntroduceConstraints(Room& room)
 {
 	//First we set up the entropy.
-	//A vector with all unique id's.
-	std::vector<unsigned int> allBlocks;
-	for (auto& possibility : m_blockPossibilities)
-	{
-		if (m_idToStringMap[possibility.first].find("Door") == std::string::npos && m_idToStringMap[possibility.first].find("Spawn") == std::string::npos) //Dont add special blocks.
-		{
-			allBlocks.push_back(possibility.first);
-		}
-	}
+	std::mt19937_64& gen = m_random[room.i];
 
 	m_entropy[room.i].clear();
 	//Create an entropy block for each cell.
@@ -68,7 +60,7 @@ bool WFC::IntroduceConstraints(Room& room)
 	{
 		EntropyBlock temp;
 		temp.id = i;
-		temp.possibilities = allBlocks;
+		temp.possibilities = m_generationBlocks;
 		m_entropy[room.i].push_back(temp);
 	}
 
@@ -79,16 +71,9 @@ bool WFC::IntroduceConstraints(Room& room)
 			//Place a spawnblock if its the first block.
 			if (room.i == 0)
 			{
-				std::default_random_engine gen;
-				gen.seed(static_cast<unsigned int>(time(NULL)));
-				std::uniform_int_distribution<uint32_t> distWidth(2u, room.width - 3u);
-				std::uniform_int_distribution<uint32_t> distDepth(2u, room.depth - 3u);
-
-				std::uniform_int_distribution<size_t> distSpawn(0u, m_spawnBlocksSize - 1u);
-
-				uint32_t x = distWidth(gen);
+				uint32_t x = RandomRange(gen, 2u, room.width - 3u);
 				uint32_t y = 1u;
-				uint32_t z = distDepth(gen);
+				uint32_t z = RandomRange(gen, 2u, room.depth - 3u);
 
 				m_spawnCoords[0] = x;
 				m_spawnCoords[1] = y;
@@ -96,8 +81,8 @@ bool WFC::IntroduceConstraints(Room& room)
 
 				uint32_t index = x + y * room.width + z * room.width * room.height;
 				m_entropy[room.i][index].possibilities.clear();
-				std::string spawnBlock = m_spawnBlocks[distSpawn(gen)];
-				m_entropy[room.i][index].possibilities.push_back(m_stringToIdMap[spawnBlock]);
+				std::string spawnBlock = m_spawnBlocks[RandomRange(gen, 0u, m_spawnBlocksSize - 1u)];
+				m_entropy[room.i][index].possibilities.push_back(GetId(spawnBlock));
 
 				//Push the index onto the stack and then loop through the stack until it is empty.
 				//(A call to Propogate can put more information on the stack.)
@@ -113,15 +98,8 @@ bool WFC::IntroduceConstraints(Room& room)
 
 		//Doors
 		{
-			std::default_random_engine gen;
-			gen.seed(static_cast<unsigned int>(time(NULL)) * (room.i + 1u));
-			std::uniform_int_distribution<uint32_t> dist(0u, 3u);
-
-			std::uniform_int_distribution<uint32_t> widthDist(1u, room.width - 2u);
-			std::uniform_int_distribution<uint32_t> depthDist(1u, room.depth - 2u);
-
 			//There will always be atleast 1 door.
-			uint32_t chosenDoor = dist(gen);
+			uint32_t chosenDoor = RandomRange(gen, 0u, 3u);
 			room.doors[chosenDoor].placed = true;
 
 			uint32_t x = 0;
@@ -132,24 +110,24 @@ bool WFC::IntroduceConstraints(Room& room)
 			case 0:
 			{
 				x = room.width - 1;
-				z = depthDist(gen);
+				z = RandomRange(gen, 1u, room.depth - 2u);
 				break;
 			}
 			case 1:
 			{
-				x = widthDist(gen);
+				x = RandomRange(gen, 1u, room.width - 2u);
 				z = room.depth - 1;
 				break;
 			}
 			case 2:
 			{
 				x = 0u;
-				z = depthDist(gen);
+				z = RandomRange(gen, 1u, room.depth - 2u);
 				break;
 			}
 			case 3:
 			{
-				x = widthDist(gen);
+				x = RandomRange(gen, 1u, room.width - 2u);
 				z = 0u;
 				break;
 			}
@@ -167,13 +145,12 @@ bool WFC::IntroduceConstraints(Room& room)
 			uint32_t index = x + y * room.width + z * room.width * room.height;
 			m_entropy[room.i][index].possibilities.clear();
 			//Randomize a door block to use.
-			std::uniform_int_distribution<size_t> distDoorBlocks(0u, m_doorBlocks.size() - 1u);
-			std::string doorBlock = m_doorBlocks[distDoorBlocks(gen)];
+			std::string doorBlock = m_doorBlocks[RandomRange(gen, 0u, static_cast<uint32_t>(m_doorBlocks.size()) - 1u)];
 			std::string name = doorBlock.substr(0u, doorBlock.find("_"));
 			size_t startFlip = doorBlock.find("_", doorBlock.find("_") + 1);
 			std::string doorFlip = doorBlock.substr(startFlip + 1u, doorBlock.size() - startFlip);
 			std::string doorCorrectRotation = name + "_r" + std::to_string(room.doors[chosenDoor].rot) + "_" + doorFlip;
-			m_entropy[room.i][index].possibilities.push_back(m_stringToIdMap[doorCorrectRotation]);
+			m_entropy[room.i][index].possibilities.push_back(GetId(doorCorrectRotation));
 
 			//Push the index onto the stack and then loop through the stack until it is empty.
 			//(A call to Propogate can put more information on the stack.)
@@ -190,7 +167,6 @@ bool WFC::IntroduceConstraints(Room& room)
 			uint32_t placedCount = 1u;
 			if (room.i != 0)
 			{
-				std::uniform_int_distribution<uint32_t> distDoorDecider(0u, 1u);
 				for (uint32_t i{ 0u }; i < 3u; i++)
 				{
 					++chosenDoor;
@@ -201,7 +177,7 @@ bool WFC::IntroduceConstraints(Room& room)
 
 					//If we roll that the door should be generated, OR we get to the last direction and still only have 1 door.
 					//This guarantees that we will have atleast 2 doors per room.
-					if (distDoorDecider(gen) == 1u || (placedCount == 1u && i == 2))
+					if (RandomRange(gen, 0u, 1u) == 1u || (placedCount == 1u && i == 2))
 					{
 						++placedCount;
 						room.doors[chosenDoor].placed = true;
@@ -214,24 +190,24 @@ bool WFC::IntroduceConstraints(Room& room)
 						case 0:
 						{
 							x = room.width - 1;
-							z = depthDist(gen);
+							z = RandomRange(gen, 1u, room.depth - 2u);
 							break;
 						}
 						case 1:
 						{
-							x = widthDist(gen);
+							x = RandomRange(gen, 1u, room.width - 2u);
 							z = room.depth - 1;
 							break;
 						}
 						case 2:
 						{
 							x = 0u;
-							z = depthDist(gen);
+							z = RandomRange(gen, 1u, room.depth - 2u);
 							break;
 						}
 						case 3:
 						{
-							x = widthDist(gen);
+							x = RandomRange(gen, 1u, room.width - 2u);
 							z = 0u;
 							break;
 						}
@@ -249,13 +225,12 @@ bool WFC::IntroduceConstraints(Room& room)
 						uint32_t index2 = x + y * room.width + z * room.width * room.height;
 						m_entropy[room.i][index2].possibilities.clear();
 						//Randomize a door block to use.
-						std::uniform_int_distribution<size_t> distDoorBlocks2(0u, m_doorBlocks.size() - 1u);
-						std::string doorBlock2 = m_doorBlocks[distDoorBlocks2(gen)];
+						std::string doorBlock2 = m_doorBlocks[RandomRange(gen, 0u, static_cast<uint32_t>(m_doorBlocks.size()) - 1u)];
 						std::string name2 = doorBlock2.substr(0u, doorBlock2.find("_"));
 						size_t startFlip2 = doorBlock2.find("_", doorBlock2.find("_") + 1);
 						std::string doorFlip2 = doorBlock2.substr(startFlip2 + 1u, doorBlock2.size() - startFlip2);
 						std::string doorCorrectRotation2 = name2 + "_r" + std::to_string(room.doors[chosenDoor].rot) + "_" + doorFlip2;
-						m_entropy[room.i][index2].possibilities.push_back(m_stringToIdMap[doorCorrectRotation2]);
+						m_entropy[room.i][index2].possibilities.push_back(GetId(doorCorrectRotation2));
 
 						//Push the index onto the stack and then loop through the stack until it is empty.
 						//(A call to Propogate can put more information on the stack.)
@@ -327,7 +302,7 @@ bool WFC::IntroduceConstraints(Room& room)
 
 	if (m_failed[room.i]) //If we fail here it means that the contraints imposed can not generate any output.
 	{
-		m_failed[room.i] = false;
+		m_failed[room.i] = 0u;
 		m_entropy[room.i].clear();
 		return false;
 	}
@@ -335,10 +310,10 @@ bool WFC::IntroduceConstraints(Room& room)
 	return true;
 }
 
-void WFC::t_GenerateRoom(unsigned int i, std::shared_ptr<Box> chosenBox)
+void WFC::t_GenerateRoom(unsigned int i, std::shared_ptr<Box> chosenBox, uint64_t seed)
 {
-	std::default_random_engine gen;
-	gen.seed(static_cast<unsigned int>(time(NULL)) * (i + 1u));
+	//Everything random in the room is drawn from its own generator, so the room only depends on its seed.
+	m_random[i].seed(seed);
 
 	Room newRoom;
 	newRoom.i = i;
@@ -359,40 +334,33 @@ void WFC::t_GenerateRoom(unsigned int i, std::shared_ptr<Box> chosenBox)
 	temp.rot = 1u;
 	newRoom.doors[3] = temp;
 
-	std::cout << "Block count for this next room: " << newRoom.width * newRoom.height * newRoom.depth << std::endl;
-
 	//Introduce the constraints.
 	if (IntroduceConstraints(newRoom))
 	{
-		std::cout << "Done introducing constraints." << std::endl;
-
 		uint32_t chances = 100;
 
 		while ((!GenerateRoom(newRoom) && chances != 0) || !newRoom.generationSuccess)
 		{
-			std::cout << "FAILED!" << std::endl;
+			++m_roomStats[i].restarts;
 			--chances;
 		}
 
 		if (chances != 0)
 		{
-			std::cout << "Done with 1 room, id: " << i << std::endl;
-			std::cout << "Count of voids:" << std::count(newRoom.generatedRoom.begin(), newRoom.generatedRoom.end(), "Void") << std::endl;
-
 			m_generatedRooms[i] = newRoom;
 		}
 		else
 		{
-			std::cout << "Ran out of chances to generate a room." << std::endl;
+			LOG_WARNING("Ran out of chances to generate a room.");
 		}
 	}
 	else
 	{
-		std::cout << "Failed to introduce constraints." << std::endl;
+		LOG_WARNING("Failed to introduce constraints.");
 	}
 }
 
-bool WFC::GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeight, uint32_t maxDepth)
+bool WFC::GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeight, uint32_t maxDepth, uint64_t seed)
 {
 	m_generatedLevel.assign(m_width * m_height * m_depth, "Void");
 
@@ -401,8 +369,7 @@ bool WFC::GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeigh
 	std::vector<uint32_t> max = { m_width - 2, m_height - 2, m_depth - 2 };
 	std::shared_ptr<Box> base = std::make_shared<Box>(min, max);
 
-	std::default_random_engine gen;
-	gen.seed(static_cast<unsigned int>(time(NULL)));
+	std::mt19937_64 gen(seed);
 
 	std::vector<std::shared_ptr<Box>> viableOptions;
 	if (base->Divide(maxWidth, maxHeight, maxDepth, gen))
@@ -418,11 +385,9 @@ bool WFC::GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeigh
 	nrOfRooms = std::min(static_cast<uint32_t>(viableOptions.size()), nrOfRooms);
 	if (nrOfRooms < 2)
 	{
-		std::cout << "Too few viable rooms." << std::endl;
+		LOG_WARNING("Too few viable rooms.");
 		return false;
 	}
-	std::cout << "Possible options for room generation was " << viableOptions.size() << "." << std::endl;
-	std::cout << "Will generate " << nrOfRooms << " rooms." << std::endl;
 
 	m_generatedRooms.reserve(nrOfRooms);
 	m_generatedRooms.assign(nrOfRooms, Room());
@@ -435,24 +400,58 @@ bool WFC::GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeigh
 	m_priorityQueue.reserve(nrOfRooms);
 	m_priorityQueue.assign(nrOfRooms, nullptr);
 	m_failed.reserve(nrOfRooms);
-	m_failed.assign(nrOfRooms, false);
+	m_failed.assign(nrOfRooms, 0u);
+	m_trail.assign(nrOfRooms, std::vector<TrailEntry>());
+	m_popped.assign(nrOfRooms, std::vector<uint32_t>());
+	m_decisions.assign(nrOfRooms, std::vector<Decision>());
+	m_roomStats.assign(nrOfRooms, GenerationStats());
+	m_random.assign(nrOfRooms, std::mt19937_64());
+
 	//For each room to generate.
-	std::vector<std::thread> threads;
+	std::vector<std::shared_ptr<Box>> chosenBoxes;
+	std::vector<uint64_t> roomSeeds;
 	for (uint32_t i{ 0u }; i < nrOfRooms; i++)
 	{
 		//Now we need to choose nrOfRooms from the viable rooms.
-		std::uniform_int_distribution<size_t> roomID(0u, viableOptions.size() - 1u);
-		uint32_t index = static_cast<uint32_t>(roomID(gen));
-		std::shared_ptr<Box> chosenBox = viableOptions[index];
+		uint32_t index = RandomRange(gen, 0u, static_cast<uint32_t>(viableOptions.size()) - 1u);
+		chosenBoxes.push_back(viableOptions[index]);
 		//Remove the option from the vector.
 		viableOptions.erase(viableOptions.begin() + index);
 
-		threads.push_back(std::thread(&WFC::t_GenerateRoom, this, i, chosenBox));
+		roomSeeds.push_back(DeriveSeed(seed, i));
 	}
 
+	//The rooms are spread over a bounded number of workers. Which worker takes a room does not matter, since it only depends on its seed.
+	std::atomic<uint32_t> nextRoom{ 0u };
+	auto worker = [&]()
+	{
+		for (uint32_t i{ nextRoom++ }; i < nrOfRooms; i = nextRoom++)
+		{
+			t_GenerateRoom(i, chosenBoxes[i], roomSeeds[i]);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	uint32_t workerCount = std::min(nrOfRooms, m_maxWorkers);
+	for (uint32_t i{ 1u }; i < workerCount; i++)
+	{
+		workers.push_back(std::thread(worker));
+	}
+	worker();
+	for (auto& thread : workers)
+	{
+		thread.join();
+	}
+
+	m_stats = GenerationStats();
 	for (uint32_t i{ 0u }; i < nrOfRooms; i++)
 	{
-		threads[i].join();
+		const GenerationStats& stats = m_roomStats[i];
+		LOG_TRACE("Room {}: {} decisions, {} contradictions, {} backtracks, {} restarts.", i, stats.decisions, stats.contradictions, stats.backtracks, stats.restarts);
+		m_stats.decisions += stats.decisions;
+		m_stats.contradictions += stats.contradictions;
+		m_stats.backtracks += stats.backtracks;
+		m_stats.restarts += stats.restarts;
 	}
 
 	for (Room& room : m_generatedRooms) //For each generated room.
@@ -623,7 +622,8 @@ bool WFC::GenerateRoom(Room& room)
 
 	//The priority queue is not needed for the constraints. As they do not use a priority.
 	//All the entropy blocks should now be placed in a priority queue based on their Shannon entropy.
-	m_priorityQueue[room.i] = new PriorityQueue(m_currentEntropy[room.i], m_blockPossibilities, room.width, room.height, room.depth);
+	std::mt19937_64& gen = m_random[room.i];
+	m_priorityQueue[room.i] = new PriorityQueue(m_currentEntropy[room.i], m_frequencies, room.width, room.height, room.depth, gen());
 
 	room.generatedRoom.assign(room.width * room.height * room.depth, "Void");
 	room.generationSuccess = false;
@@ -634,7 +634,7 @@ bool WFC::GenerateRoom(Room& room)
 #ifdef _DEBUG
 	if (index == -1)
 	{
-		std::cout << "MEGA FAIL! SHOULD NEVER HAPPEN!!!" << std::endl;
+		LOG_ERROR("MEGA FAIL! SHOULD NEVER HAPPEN!!!");
 		delete m_priorityQueue[room.i];
 		m_priorityQueue[room.i] = nullptr;
 		m_currentEntropy[room.i].clear();
@@ -646,7 +646,7 @@ bool WFC::GenerateRoom(Room& room)
 	while (m_currentEntropy[room.i][index].possibilities.size() == 1)
 	{
 		unsigned int possibility = m_currentEntropy[room.i][index].possibilities[0]; //It only has 1 possibility.
-		room.generatedRoom[index] = m_idToStringMap[possibility]; //Put the block in the generated room.
+		room.generatedRoom[index] = m_idToString[possibility]; //Put the block in the generated room.
 		room.generationSuccess = true;
 
 		index = m_priorityQueue[room.i]->Pop();
@@ -660,7 +660,7 @@ bool WFC::GenerateRoom(Room& room)
 			//If the generation failed.
 			if (m_failed[room.i])
 			{
-				m_failed[room.i] = false;
+				m_failed[room.i] = 0u;
 				m_currentEntropy[room.i].clear();
 				return false;
 			}
@@ -669,92 +669,84 @@ bool WFC::GenerateRoom(Room& room)
 	}
 
 	//Here we only have blocks with a possibility count of 2 or higher left.
-	std::default_random_engine gen;
-	gen.seed(static_cast<unsigned int>(time(NULL)) * (room.i + 1u));
+
+	m_trail[room.i].clear();
+	m_popped[room.i].clear();
+	m_decisions[room.i].clear();
+	m_popped[room.i].push_back(index);
+	uint32_t backtracks = 0u;
 
 	//While blocks exist within the PQ and the count of possibilities is not 0.
 	while (index != -1 && m_currentEntropy[room.i][index].possibilities.size() != 0)
 	{
-		//calculate the total frequency of the possibilities of the current cell.
-		float total = 0.0f;
-		for (auto& c : m_currentEntropy[room.i][index].possibilities)
-		{
-			total += m_blockPossibilities[c].frequency;
-		}
+		unsigned int chosenBlock = m_currentEntropy[room.i][index].possibilities[0];
+		bool consistent = true;
 
-		//We then randomize a value between 0 and that total value.
-		std::uniform_real_distribution<float> dist(0.0f, total);
-		float val = dist(gen);
-
-		unsigned int chosenBlock = 0u;
-		float count = 0.0f;
-		//Go through all possibilities and if the generated value is less than the frequency counter that possibility is chosen.
-		for (auto& current : m_currentEntropy[room.i][index].possibilities)
+		//Blocks that got down to 1 possibility while propagating need no decision.
+		if (m_currentEntropy[room.i][index].possibilities.size() > 1)
 		{
-			count += m_blockPossibilities[current].frequency;
-			if (val < count)
+			//calculate the total frequency of the possibilities of the current cell.
+			float total = 0.0f;
+			for (auto& c : m_currentEntropy[room.i][index].possibilities)
 			{
-				chosenBlock = current;
-				break;
+				total += m_frequencies[c];
 			}
-		}
 
-		//Now that a single possibility is chosen the rest of the possibilities have to be removed.
-		bool removed = false;
-		for (uint32_t i{ 0u }; i < m_currentEntropy[room.i][index].possibilities.size(); ++i)
-		{
-			unsigned int current = m_currentEntropy[room.i][index].possibilities[i];
-			if (current != chosenBlock)
+			//We then randomize a value between 0 and that total value.
+			float val = RandomFloat(gen, total);
+
+			float count = 0.0f;
+			//Go through all possibilities and if the generated value is less than the frequency counter that possibility is chosen.
+			for (auto& current : m_currentEntropy[room.i][index].possibilities)
 			{
-				if (m_currentEntropy[room.i][index].possibilities.size() == 1)
+				count += m_frequencies[current];
+				if (val < count)
 				{
-					m_failed[room.i] = true;
+					chosenBlock = current;
 					break;
 				}
-
-				m_currentEntropy[room.i][index].possibilities.erase(m_currentEntropy[room.i][index].possibilities.begin() + i);
-				i--;
-				removed = true;
 			}
-		}
-		if (m_failed[room.i])
-		{
-			break;
-		}
 
-		//The information that possibilities have been removed is then propogated out to the neighboring cells.
-		if (removed)
-		{
-			//We now have to rearrange the PQ since possibilities were removed.
-			if (!m_priorityQueue[room.i]->Rearrange(index, m_blockPossibilities))
-			{
-				m_failed[room.i] = false;
-				m_currentEntropy[room.i].clear();
-				delete m_priorityQueue[room.i];
-				m_priorityQueue[room.i] = nullptr;
-				return false;
-			}
+			//Remember the decision so that it can be undone if it leads to a contradiction.
+			m_decisions[room.i].push_back({ m_trail[room.i].size(), m_popped[room.i].size() - 1u, index, chosenBlock });
+			++m_roomStats[room.i].decisions;
 
-			m_recursiveStack[room.i].push(index);
-			while (!m_recursiveStack[room.i].empty())
+			//Now that a single possibility is chosen the rest of the possibilities have to be removed.
+			for (uint32_t i{ 0u }; i < m_currentEntropy[room.i][index].possibilities.size(); ++i)
 			{
-				uint32_t data = m_recursiveStack[room.i].front();
-				Propogate(data, room);
-				m_recursiveStack[room.i].pop();
-
-				if (m_failed[room.i])
+				unsigned int current = m_currentEntropy[room.i][index].possibilities[i];
+				if (current != chosenBlock)
 				{
-					m_failed[room.i] = false;
-					m_currentEntropy[room.i].clear();
-					return false;
+					RemovePossibility(index, i, room.i);
+					i--;
 				}
 			}
+			m_priorityQueue[room.i]->Rearrange(index);
+
+			//The information that possibilities have been removed is then propogated out to the neighboring cells.
+			m_recursiveStack[room.i].push(index);
+			consistent = PropogateAll(room);
+		}
+
+		if (consistent)
+		{
+			//We then set the chosen value in the generated level.
+			room.generatedRoom[index] = m_idToString[chosenBlock];
+			room.generationSuccess = true;
+		}
+		else if (!Backtrack(room, backtracks)) //A contradiction undoes the latest decisions instead of starting the room over.
+		{
+			m_currentEntropy[room.i].clear();
+			delete m_priorityQueue[room.i];
+			m_priorityQueue[room.i] = nullptr;
+			return false;
 		}
-		//We then set the chosen value in the generated level.
-		room.generatedRoom[index] = m_idToStringMap[chosenBlock];
-		room.generationSuccess = true;
 
 		index = m_priorityQueue[room.i]->Pop();
+		if (index != -1)
+		{
+			m_popped[room.i].push_back(index);
+		}
 	}
 
 	//We are now done and can delete our priorityqueue.
@@ -764,7 +756,7 @@ bool WFC::GenerateRoom(Room& room)
 	//If the generation failed we return false.
 	if (m_failed[room.i])
 	{
-		m_failed[room.i] = false;
+		m_failed[room.i] = 0u;
 		m_currentEntropy[room.i].clear();
 		return false;
 	}
@@ -2204,6 +2196,7 @@ bool WFC::SetInput(std::string input)
 	{
 		return false;
 	}
+	CompileRules();
 	return true;
 }
 
@@ -2295,6 +2288,142 @@ bool WFC::ReadInput(std::string input)
 	return true;
 }
 
+void WFC::CompileRules()
+{
+	m_blockCount = m_uniqueIdCounter;
+
+	m_idToString.assign(m_blockCount, "");
+	for (auto& [id, name] : m_idToStringMap)
+	{
+		m_idToString[id] = name;
+	}
+
+	m_frequencies.assign(m_blockCount, 0.0f);
+	for (uint32_t dir{ 0u }; dir < 6u; ++dir)
+	{
+		m_rules[dir].assign(m_blockCount * m_blockCount, 0u);
+	}
+	for (auto& [id, block] : m_blockPossibilities)
+	{
+		m_frequencies[id] = block.frequency;
+		for (uint32_t dir{ 0u }; dir < 6u; ++dir)
+		{
+			for (unsigned int neighbor : block.dirPossibilities[dir])
+			{
+				m_rules[dir][id * m_blockCount + neighbor] = 1u;
+			}
+		}
+	}
+
+	//In id order, so the possibilities of a cell do not depend on the hash map.
+	m_generationBlocks.clear();
+	for (unsigned int id{ 0u }; id < m_blockCount; ++id)
+	{
+		bool special = m_idToString[id].find("Door") != std::string::npos || m_idToString[id].find("Spawn") != std::string::npos;
+		if (m_blockPossibilities.find(id) != m_blockPossibilities.end() && !special) //Dont add special blocks.
+		{
+			m_generationBlocks.push_back(id);
+		}
+	}
+
+	m_edgeId = GetId("Edge");
+	m_voidId = GetId("Void");
+}
+
+unsigned int WFC::GetId(const std::string& name) const
+{
+	auto it = m_stringToIdMap.find(name);
+	return it != m_stringToIdMap.end() ? it->second : NO_BLOCK;
+}
+
+void WFC::RemovePossibility(uint32_t cellIndex, uint32_t position, unsigned int roomi)
+{
+	std::vector<unsigned int>& possibilities = m_currentEntropy[roomi][cellIndex].possibilities;
+	m_trail[roomi].push_back({ cellIndex, possibilities[position], position });
+	m_priorityQueue[roomi]->RemovePossibility(cellIndex, possibilities[position]);
+	possibilities.erase(possibilities.begin() + position);
+}
+
+bool WFC::PropogateAll(Room& room)
+{
+	while (!m_recursiveStack[room.i].empty())
+	{
+		uint32_t data = m_recursiveStack[room.i].front();
+		Propogate(data, room);
+		m_recursiveStack[room.i].pop();
+
+		if (m_failed[room.i])
+		{
+			m_failed[room.i] = 0u;
+			m_recursiveStack[room.i] = {};
+			return false;
+		}
+	}
+	return true;
+}
+
+void WFC::UndoTo(unsigned int roomi, size_t trailSize, size_t poppedCount)
+{
+	//Put the removed possibilities back in reverse order, so every one of them goes back to where it was.
+	std::vector<uint32_t> restored;
+	while (m_trail[roomi].size() > trailSize)
+	{
+		TrailEntry entry = m_trail[roomi].back();
+		m_trail[roomi].pop_back();
+
+		std::vector<unsigned int>& possibilities = m_currentEntropy[roomi][entry.cell].possibilities;
+		possibilities.insert(possibilities.begin() + entry.position, entry.possibility);
+		m_priorityQueue[roomi]->AddPossibility(entry.cell, entry.possibility);
+		restored.push_back(entry.cell);
+	}
+
+	while (m_popped[roomi].size() > poppedCount)
+	{
+		m_priorityQueue[roomi]->Push(m_popped[roomi].back());
+		m_popped[roomi].pop_back();
+	}
+
+	for (uint32_t cell : restored)
+	{
+		m_priorityQueue[roomi]->Rearrange(cell);
+	}
+}
+
+bool WFC::Backtrack(Room& room, uint32_t& backtracks)
+{
+	++m_roomStats[room.i].contradictions;
+
+	while (!m_decisions[room.i].empty() && backtracks < MAX_BACKTRACKS)
+	{
+		Decision decision = m_decisions[room.i].back();
+		m_decisions[room.i].pop_back();
+		UndoTo(room.i, decision.trailSize, decision.poppedCount);
+		++backtracks;
+		++m_roomStats[room.i].backtracks;
+
+		//If the chosen block was the only one left the decision before this one is to blame.
+		std::vector<unsigned int>& possibilities = m_currentEntropy[room.i][decision.cell].possibilities;
+		if (possibilities.size() == 1)
+		{
+			continue;
+		}
+
+		//The choice led to a contradiction, so it is removed. This belongs to the previous decision and is undone with it.
+		uint32_t position = static_cast<uint32_t>(std::find(possibilities.begin(), possibilities.end(), decision.block) - possibilities.begin());
+		RemovePossibility(decision.cell, position, room.i);
+		m_priorityQueue[room.i]->Rearrange(decision.cell);
+
+		m_recursiveStack[room.i].push(decision.cell);
+		if (PropogateAll(room))
+		{
+			return true;
+		}
+		++m_roomStats[room.i].contradictions;
+	}
+
+	return false;
+}
+
 void WFC::Propogate(uint32_t index, Room& room)
 {
 	//If the index is not z = 0 we can propogate in the negative z direction.
@@ -2346,7 +2475,7 @@ void WFC::CheckForPropogation(uint32_t currentIndex, uint32_t neighborIndex, uns
 
 		for (auto& possibility : m_currentEntropy[roomi][currentIndex].possibilities) //Check every possibility still left in the current cell and make sure "r" matches with atleast one of them.
 		{
-			if (std::count(m_blockPossibilities[neighborPossibility].dirPossibilities[dir].begin(), m_blockPossibilities[neighborPossibility].dirPossibilities[dir].end(), possibility))
+			if (Allowed(neighborPossibility, dir, possibility))
 			{
 				matched = true;
 				break;
@@ -2356,11 +2485,11 @@ void WFC::CheckForPropogation(uint32_t currentIndex, uint32_t neighborIndex, uns
 		{
 			if (m_currentEntropy[roomi][neighborIndex].possibilities.size() == 1)
 			{
-				m_failed[roomi] = true;
+				m_failed[roomi] = 1u;
 				break;
 			}
 
-			m_currentEntropy[roomi][neighborIndex].possibilities.erase(m_currentEntropy[roomi][neighborIndex].possibilities.begin() + i);
+			RemovePossibility(neighborIndex, i, roomi);
 			i--;
 			removed = true;
 		}
@@ -2371,9 +2500,9 @@ void WFC::CheckForPropogation(uint32_t currentIndex, uint32_t neighborIndex, uns
 		//We now have to rearrange the PQ since possibilities were removed. (Is not done during contraints.)
 		if (m_priorityQueue[roomi])
 		{
-			if (!m_priorityQueue[roomi]->Rearrange(neighborIndex, m_blockPossibilities))
+			if (!m_priorityQueue[roomi]->Rearrange(neighborIndex))
 			{
-				m_failed[roomi] = true; //Mark generation as failed if it fails to rearrange.
+				m_failed[roomi] = 1u; //Mark generation as failed if it fails to rearrange.
 			}
 		}
 
@@ -2432,7 +2561,7 @@ void WFC::CheckForPropogationConstrain(uint32_t currentIndex, uint32_t neighborI
 
 		for (auto& possibility : m_entropy[roomi][currentIndex].possibilities) //Check every possibility still left in the current cell and make sure "r" matches with atleast one of them.
 		{
-			if (std::count(m_blockPossibilities[neighborPossibility].dirPossibilities[dir].begin(), m_blockPossibilities[neighborPossibility].dirPossibilities[dir].end(), possibility))
+			if (Allowed(neighborPossibility, dir, possibility))
 			{
 				matched = true;
 				break;
@@ -2442,7 +2571,7 @@ void WFC::CheckForPropogationConstrain(uint32_t currentIndex, uint32_t neighborI
 		{
 			if (m_entropy[roomi][neighborIndex].possibilities.size() == 1)
 			{
-				m_failed[roomi] = true;
+				m_failed[roomi] = 1u;
 				break;
 			}
 
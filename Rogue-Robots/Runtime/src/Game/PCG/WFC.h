@@ -14,8 +14,8 @@ public:
 	~WFC() noexcept = default;
 
 	//Generates a level from the read input in the constructor or SetInput.
-	//Can be called multiple times for different results each time.
-	bool GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeight, uint32_t maxDepth);
+	//The same input, dimensions and seed always give the same level.
+	bool GenerateLevel(uint32_t nrOfRooms, uint32_t maxWidth, uint32_t maxHeight, uint32_t maxDepth, uint64_t seed);
 	const std::vector<std::string>& GetGeneratedLevel() const
 	{
 		return m_generatedLevel;
@@ -26,6 +26,20 @@ public:
 		return m_generatedRooms;
 	}
 
+	//Counters for the last call to GenerateLevel, summed over all rooms.
+	struct GenerationStats
+	{
+		uint32_t decisions = 0u; //Blocks chosen at random.
+		uint32_t contradictions = 0u;
+		uint32_t backtracks = 0u; //Decisions undone.
+		uint32_t restarts = 0u; //Rooms started over after running out of backtracks.
+	};
+
+	const GenerationStats& GetGenerationStats() const
+	{
+		return m_stats;
+	}
+
 	const uint32_t& GetWidth() const
 	{
 		return m_width;
@@ -47,6 +61,12 @@ public:
 	//Changes the dimensions of the output.
 	void SetDimensions(uint32_t width, uint32_t height, uint32_t depth);
 
+	//Maximum number of threads generating rooms, the calling thread included.
+	void SetMaxWorkers(uint32_t maxWorkers)
+	{
+		m_maxWorkers = std::max(maxWorkers, 1u);
+	}
+
 private:
 
 	//PRINT FOR DEBUGGING.
@@ -61,6 +81,15 @@ private:
 	//Reads input from a file and adds it to the block possibilities.
 	bool ReadInput(std::string input);
 
+	//Builds the read-only tables the generation threads use from the read input.
+	void CompileRules();
+	unsigned int GetId(const std::string& name) const;
+	//If neighbor can be placed next to block in direction dir.
+	bool Allowed(unsigned int block, unsigned int dir, unsigned int neighbor) const
+	{
+		return block < m_blockCount && neighbor < m_blockCount && m_rules[dir][block * m_blockCount + neighbor];
+	}
+
 	//The constrain functions are only used on startup for constraints, same code but uses m_entropy or m_currentEntropy.
 	//Propogates information to neighboring cells after a possibility is removed.
 	void Propogate(uint32_t index, Room& room);
@@ -70,20 +99,43 @@ private:
 	void CheckForPropogation(uint32_t currentIndex, uint32_t neighborIndex, unsigned dir, unsigned int roomi);
 	void CheckForPropogationConstrain(uint32_t currentIndex, uint32_t neighborIndex, unsigned dir, unsigned int roomi);
 
+	//BACKTRACKING-FUNCTIONS
+	//Erases a possibility from a cell during generation and records it on the trail.
+	void RemovePossibility(uint32_t cellIndex, uint32_t position, unsigned int roomi);
+	//Propogates everything on the recursive stack, returns false on a contradiction.
+	bool PropogateAll(Room& room);
+	//Restores the possibilities removed and the blocks popped after the given points.
+	void UndoTo(unsigned int roomi, size_t trailSize, size_t poppedCount);
+	//Undoes decisions until the room is consistent again, returns false if it has to be started over.
+	bool Backtrack(Room& room, uint32_t& backtracks);
+
 	//Post processing functions.
 	std::string ReplaceBlock(std::string& currentBlock, std::string& nextBlock, int prevDir, int nextDir, bool prevWasVoid, bool doorConnected);
 
 private:
-	void t_GenerateRoom(unsigned int i, std::shared_ptr<Box> chosenBox);
+	void t_GenerateRoom(unsigned int i, std::shared_ptr<Box> chosenBox, uint64_t seed);
 
 	uint32_t m_totalCount = 0u; //Total number of blocks read during input.
 	std::unordered_map<unsigned int, Block> m_blockPossibilities; //The possibilities for each block-id.
+
+	//Compiled from the input by CompileRules, indexed by block id. Only read during generation.
+	static constexpr unsigned int NO_BLOCK = (unsigned int)-1;
+	unsigned int m_blockCount = 0u;
+	std::vector<std::string> m_idToString;
+	std::vector<float> m_frequencies;
+	std::vector<uint8_t> m_rules[6]; //m_rules[dir][block * m_blockCount + neighbor]
+	std::vector<unsigned int> m_generationBlocks; //The blocks every cell starts with.
+	unsigned int m_edgeId = NO_BLOCK;
+	unsigned int m_voidId = NO_BLOCK;
+
+	uint32_t m_maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<std::mt19937_64> m_random; //Per room.
 	std::vector<std::string> m_spawnBlocks;
 	unsigned int m_spawnBlocksSize = 0u;
 	std::vector<std::string> m_doorBlocks;
 	std::vector<std::string> m_connectorBlocks;
 
-	std::vector<bool> m_failed; //If the generation fails.
+	std::vector<uint8_t> m_failed; //If the generation fails. Not vector<bool>, rooms on different workers write their own flag.
 
 	//Dimensions of the output level.
 	uint32_t m_width = 0;
@@ -100,6 +152,31 @@ private:
 
 	std::vector<std::queue<uint32_t>> m_recursiveStack; //Used to circumvent recursiveness. Saves us from stack overflows.
 
+	//A possibility removed from a cell during generation. Position is where it was in the cell's possibilities.
+	struct TrailEntry
+	{
+		uint32_t cell = 0u;
+		unsigned int possibility = 0u;
+		uint32_t position = 0u;
+	};
+
+	//A block chosen for a cell. Undoing it rolls the trail and the popped blocks back to the sizes they had before the choice.
+	struct Decision
+	{
+		size_t trailSize = 0u;
+		size_t poppedCount = 0u;
+		uint32_t cell = 0u;
+		unsigned int block = 0u;
+	};
+
+	static constexpr uint32_t MAX_BACKTRACKS = 64u; //Per attempt at a room, after that the room is started over.
+
+	std::vector<std::vector<TrailEntry>> m_trail;
+	std::vector<std::vector<uint32_t>> m_popped; //Blocks popped from the PQ during generation, in order.
+	std::vector<std::vector<Decision>> m_decisions;
+	std::vector<GenerationStats> m_roomStats;
+	GenerationStats m_stats;
+
 	unsigned int m_uniqueIdCounter = 0u;
 	std::unordered_map<unsigned int, std::string> m_idToStringMap;
 	std::unordered_map<std::string, unsigned int> m_stringToIdMap;
@@ -161,6 +161,7 @@ std::vector<entity> AddFlashlightsToPlayers(const std::vector<entity>& players)
 		slc.direction = tc.GetForward();
 		slc.strength = dd.strength;
 		slc.cutoffAngle = dd.cutoffAngle;
+		slc.range = dd.range;
 		slc.handle = lh;
 		slc.owningPlayer = players[i];
 
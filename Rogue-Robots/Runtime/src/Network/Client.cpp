@@ -39,14 +39,14 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 	check = WSAStartup(0x202, &socketStart);
 	if (check != 0)
 	{
-		std::cout << "Client: Failed to start WSA on client, ErrorCode: " << check << std::endl;
+		LOG_ERROR("Client: Failed to start WSA on client, ErrorCode: {}", check);
 		return -1;
 	}
 
 	check = getaddrinfo(m_hostIp, PORTNUMBER_OUT, &client, &addrOutput);
 	if (check != 0)
 	{
-		std::cout << "Client: Failed to get address on client, ErrorCode: " << check << std::endl;
+		LOG_ERROR("Client: Failed to get address on client, ErrorCode: {}", check);
 		return -1;
 	}
 
@@ -56,7 +56,7 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 		m_connectSocket = socket(ptr->ai_family, ptr->ai_socktype, ptr->ai_protocol);
 		if (m_connectSocket == INVALID_SOCKET)
 		{
-			std::cout << "Client: Failed to create connectSocket on client, ErrorCode: " << WSAGetLastError() << std::endl;
+			LOG_ERROR("Client: Failed to create connectSocket on client, ErrorCode: {}", WSAGetLastError());
 			return -1;
 		}
 
@@ -68,12 +68,12 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 		}
 		break;
 	}
-	std::cout << "CLient: Connected to server" << std::endl;
+	LOG_INFO("Client: Connected to server");
 
 	freeaddrinfo(addrOutput);
 	if (m_connectSocket == INVALID_SOCKET)
 	{
-		std::cout << "Client: Failed to connect connectSocket on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to connect connectSocket on client, ErrorCode: {}", WSAGetLastError());
 		return -1;
 	}
 
@@ -81,7 +81,7 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 	check = setsockopt(m_connectSocket, SOL_SOCKET, TCP_NODELAY, (char*)&turn, sizeof(bool));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to set socket to tcp_nodelay on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to set socket to tcp_nodelay on client, ErrorCode: {}", WSAGetLastError());
 		return -1;
 	}
 
@@ -90,7 +90,7 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 	check = setsockopt(m_connectSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&ttl, sizeof(DWORD));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to set time to live to tcp_nodelay on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to set time to live to tcp_nodelay on client, ErrorCode: {}", WSAGetLastError());
 		return -1;
 	}
 
@@ -101,12 +101,12 @@ INT8 Client::ConnectTcpServer(std::string ipAdress)
 	SetUpUdp();
 	if (returnValue == -1)
 	{
-		std::cout << "\nCLient: Server Full: " << returnValue << std::endl;
+		LOG_WARNING("Client: Server Full: {}", returnValue);
 		return -1;
 	}
 	else
 	{
-		std::cout << "\nCLient: Player nr: " << returnValue + 1 << std::endl;
+		LOG_INFO("Client: Player nr: {}", returnValue + 1);
 		return returnValue;
 	}
 }
@@ -188,18 +188,18 @@ u8 Client::ReceiveCharArrayTcp(char* reciveBuffer)
 			}
 			else
 			{
-				std::cout << "Client: Faulty packet" << std::endl;
+				LOG_WARNING("Client: Faulty packet");
 				return 0;
 			}
 		}
 		else if (bytesRecived == -1)
 		{
-			std::cout << "Client: Error reciving tcp packet: " << WSAGetLastError() << std::endl;
+			LOG_ERROR("Client: Error reciving tcp packet: {}", WSAGetLastError());
 			return 0;
 		}
 		else
 		{
-			std::cout << "Client: Empty packet" << std::endl;
+			LOG_WARNING("Client: Empty packet");
 			return 0;
 		}
 	}
@@ -213,7 +213,7 @@ void Client::SetUpUdp()
 	m_udpSendSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (m_udpSendSocket == INVALID_SOCKET)
 	{
-		std::cout << "Client: Failed to create udpSocket on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to create udpSocket on client, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -228,14 +228,14 @@ void Client::SetUpUdp()
 	m_udpReciveSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (m_udpReciveSocket == INVALID_SOCKET)
 	{
-		std::cout << "Client: Failed to create udpSocket on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to create udpSocket on client, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
 	check = setsockopt(m_udpReciveSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&turn, sizeof(bool));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to set udpsocket to reusabale adress to unblocking on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to set udpsocket to reusabale adress to unblocking on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -247,7 +247,7 @@ void Client::SetUpUdp()
 	check = bind(m_udpReciveSocket, (struct sockaddr*)&m_reciveAddressUdp, sizeof(m_reciveAddressUdp));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to bind udpsocket on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to bind udpsocket on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -256,14 +256,14 @@ void Client::SetUpUdp()
 	check = setsockopt(m_udpReciveSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char*)&setMulticast, sizeof(setMulticast));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to set assign multicast on udp on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to set assign multicast on udp on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
 	check = setsockopt(m_udpReciveSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&ttl, sizeof(ttl));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Client: Failed to set ttl on udp on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Client: Failed to set ttl on udp on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 }
@@ -1,5 +1,6 @@
 #include "Server.h"
 #include "..\Game\NetCode.h"
+#include "..\Game\PCG\PcgLevelLoader.h"
 
 Server::Server()
 {
@@ -24,7 +25,7 @@ Server::Server()
 	int check = WSAStartup(0x202, &socketStart);
 	if (check != 0)
 	{
-		std::cout << "Server: Failed to start WSA on server, ErrorCode: " << check << std::endl;
+		LOG_ERROR("Server: Failed to start WSA on server, ErrorCode: {}", check);
 	}
 	m_reciveConnections = true;
 	m_enablePlay = 0;
@@ -48,7 +49,7 @@ Server::~Server()
 
 		for (UINT8 socketIndex = 0; socketIndex < m_holdPlayerIds.size(); socketIndex++)
 		{
-			std::cout << "Server: Closes socket for player" << m_holdPlayerIds.at(socketIndex) + 1 << std::endl;
+			LOG_INFO("Server: Closes socket for player {}", m_holdPlayerIds.at(socketIndex) + 1);
 			m_playerIds.push_back(m_holdPlayerIds.at(socketIndex));
 			m_holdPlayerIds.erase(m_holdPlayerIds.begin() + socketIndex);
 			m_clientsSocketsTcp.erase(m_clientsSocketsTcp.begin() + socketIndex);
@@ -60,7 +61,7 @@ Server::~Server()
 
 bool Server::StartTcpServer()
 {
-	std::cout << "Server: Starting server..." << std::endl;
+	LOG_INFO("Server: Starting server...");
 
 	int check;
 	unsigned long setUnblocking = 1;
@@ -79,7 +80,7 @@ bool Server::StartTcpServer()
 	check = getaddrinfo(NULL, PORTNUMBER_OUT, &addrInput, &addrOutput);
 	if (check != 0)
 	{
-		std::cout << "Server: Failed to getaddrinfo on server, ErrorCode: " << check << std::endl;
+		LOG_ERROR("Server: Failed to getaddrinfo on server, ErrorCode: {}", check);
 		return FALSE;
 	}
 
@@ -87,7 +88,7 @@ bool Server::StartTcpServer()
 	listenSocket = socket(addrOutput->ai_family, addrOutput->ai_socktype, addrOutput->ai_protocol);
 	if (listenSocket == INVALID_SOCKET)
 	{
-		std::cout << "Server: Failed to create listensocket on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to create listensocket on server, ErrorCode: {}", WSAGetLastError());
 		return FALSE;
 	}
 
@@ -95,21 +96,21 @@ bool Server::StartTcpServer()
 	check = ioctlsocket(listenSocket, FIONBIO, (unsigned long*)&setUnblocking);
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to set listensocket to unblocking on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to set listensocket to unblocking on server, ErrorCode: {}", WSAGetLastError());
 		return FALSE;
 	}
 
 	check = bind(listenSocket, addrOutput->ai_addr, (int)addrOutput->ai_addrlen);
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to bind listenSocket on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to bind listenSocket on server, ErrorCode: {}", WSAGetLastError());
 		return FALSE;
 	}
 
 	check = listen(listenSocket, SOMAXCONN);
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to SOMAXCONN on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to SOMAXCONN on server, ErrorCode: {}", WSAGetLastError());
 		return FALSE;
 	}
 
@@ -130,7 +131,7 @@ bool Server::StartTcpServer()
 	m_reciveLoopUdp = std::thread(&Server::ReciveLoopUdp, this);
 	m_reciveLoopUdp.detach();
 
-	std::cout << "Server: Server started" << std::endl;
+	LOG_INFO("Server: Server started");
 
 	return TRUE;
 }
@@ -153,11 +154,11 @@ void Server::ServerReciveConnectionsTCP(SOCKET listenSocket)
 			{
 				{
 					bool turn = true;
-					std::cout << "Server: Connection Accepted" << std::endl;
+					LOG_INFO("Server: Connection Accepted");
 					setsockopt(clientSocket, SOL_SOCKET, TCP_NODELAY, (char*)&turn, sizeof(bool));
 					WSAPOLLFD clientPoll;
 					TcpHeader input;
-					std::cout << "\nServer: Accept a connection from clientSocket: " << clientSocket << ", From player: " << m_playerIds.front() + 1 << std::endl;
+					LOG_INFO("Server: Accept a connection from clientSocket: {}, From player: {}", clientSocket, m_playerIds.front() + 1);
 					//give connections a player id
 					UINT8 playerId = m_playerIds.front();
 					input.playerId = playerId;
@@ -195,7 +196,7 @@ float Server::TickTimeLeftTCP(LARGE_INTEGER t, LARGE_INTEGER frequency)
 #pragma warning( disable : 6385 )
 void Server::ServerPollTCP()
 {
-	std::cout << "Server: Started to tick" << std::endl;
+	LOG_INFO("Server: Started to tick");
 
 	LARGE_INTEGER tickStartTime;
 	TcpHeader holdClientsData;
@@ -324,7 +325,7 @@ void Server::ServerPollTCP()
 					}
 					else if (bytesRecived == -1)
 					{
-						std::cout << "Server: Error reciving tcp packet: " << WSAGetLastError() << std::endl;
+						LOG_ERROR("Server: Error reciving tcp packet: {}", WSAGetLastError());
 					}
 				}
 			}
@@ -398,13 +399,13 @@ void Server::ServerPollTCP()
 		}
 
 	} while (m_gameAlive);
-	std::cout << "Server: server loop closed" << std::endl;
+	LOG_INFO("Server: server loop closed");
 }
 
 void Server::CloseSocketTCP(int socketIndex)
 {
 	m_lobbyData.playersSlotConnected[m_holdPlayerIds.at(socketIndex)] = false;
-	std::cout << "Server: Closes socket for player" << m_holdPlayerIds.at(socketIndex) + 1 << std::endl;
+	LOG_INFO("Server: Closes socket for player {}", m_holdPlayerIds.at(socketIndex) + 1);
 	DOG::EntityManager::Get().Collect<DOG::NetworkPlayerComponent>().Do([&](DOG::entity id, DOG::NetworkPlayerComponent& networkC)
 		{
 			if(networkC.playerId == m_holdPlayerIds.at(socketIndex))
@@ -425,13 +426,13 @@ std::string Server::GetIpAddress()
 	check = gethostname(hold, sizeof(hold));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "GetIpAddress: gethostname failed, error code: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("GetIpAddress: gethostname failed, error code: {}", WSAGetLastError());
 		return ip;
 	}
 	check = getaddrinfo(hold, NULL, NULL, &result);
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "GetIpAddress: getaddrinfo failed, error code: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("GetIpAddress: getaddrinfo failed, error code: {}", WSAGetLastError());
 		return ip;
 	}
 	nextResult = result;
@@ -460,7 +461,7 @@ void Server::GameLoopUdp()
 	SOCKET udpSendSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (udpSendSocket == INVALID_SOCKET)
 	{
-		std::cout << "Server: Failed to create udpSocket on client, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to create udpSocket on client, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 	struct sockaddr_in clientAddressUdp;
@@ -468,7 +469,7 @@ void Server::GameLoopUdp()
 	clientAddressUdp.sin_family = AF_INET;
 
 	inet_pton(AF_INET, m_multicastAdress, &clientAddressUdp.sin_addr.s_addr);
-	std::cout << WSAGetLastError() << std::endl;
+	LOG_TRACE("Server: Multicast address set, ErrorCode: {}", WSAGetLastError());
 	clientAddressUdp.sin_port = htons(PORTNUMBER_OUT_INT);
 
 	LARGE_INTEGER tickStartTime;
@@ -513,7 +514,7 @@ void Server::GameLoopUdp()
 		}
 	}
 
-	std::cout << "Server: udp loop closed" << std::endl;
+	LOG_INFO("Server: udp loop closed");
 }
 
 void Server::ReciveLoopUdp()
@@ -530,14 +531,14 @@ void Server::ReciveLoopUdp()
 	udpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (udpSocket == INVALID_SOCKET)
 	{
-		std::cout << "Server: Failed to create udpSocket on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to create udpSocket on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
 	check = setsockopt(udpSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&turn, sizeof(bool));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to set udpsocket to reusabale adress to unblocking on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to set udpsocket to reusabale adress to unblocking on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -549,7 +550,7 @@ void Server::ReciveLoopUdp()
 	check = bind(udpSocket, (struct sockaddr*)&hostAddress, sizeof(hostAddress));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to bind udpsocket on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to bind udpsocket on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -558,14 +559,14 @@ void Server::ReciveLoopUdp()
 	check = setsockopt(udpSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char*)&setMulticast, sizeof(setMulticast));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to set assign multicast on udp on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to set assign multicast on udp on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
 	check = setsockopt(udpSocket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&ttl, sizeof(ttl));
 	if (check == SOCKET_ERROR)
 	{
-		std::cout << "Server: Failed to set socket to ttl on server, ErrorCode: " << WSAGetLastError() << std::endl;
+		LOG_ERROR("Server: Failed to set socket to ttl on server, ErrorCode: {}", WSAGetLastError());
 		return;
 	}
 
@@ -609,15 +610,19 @@ void Server::SetLevelIndex(u16 levelIndex)
 
 void Server::ReadInGeneratedLevel()
 {
-	std::string line;
-	std::ifstream inputFile("Assets\\Levels\\Generate.txt");
-
-	
+	//The level is sent in the binary level format, as the file is.
+	std::ifstream inputFile(pcgLevelNames::generated, std::ios::binary | std::ios::ate);
 	if (inputFile.is_open())
 	{
-		std::getline(inputFile, line, '\0');
-		memset(m_level, '\0', 4096);
-		memcpy(m_level, line.c_str(), line.length());
-		m_lobbyData.levelSize = (u32)line.length();
+		size_t size = static_cast<size_t>(inputFile.tellg());
+		if (size > sizeof(m_level))
+		{
+			LOG_ERROR("Server: Generated level is too large to send, {} bytes", size);
+			size = 0;
+		}
+		inputFile.seekg(0);
+		memset(m_level, '\0', sizeof(m_level));
+		inputFile.read(m_level, size);
+		m_lobbyData.levelSize = (u32)size;
 	}
 }
@@ -209,21 +209,19 @@ void Pathfinder::BuildNavScene(SceneComponent::Type sceneType)
 	em.AddComponent<SceneComponent>(navSceneID, sceneType);
 	NavSceneComponent& navScene = em.AddComponent<NavSceneComponent>(navSceneID);
 
-	em.Collect<ModularBlockComponent, TransformComponent>().Do(
-		[&](entity e, ModularBlockComponent&, TransformComponent& trans)
-		{		
+	auto addNavMesh = [&](const Vector3& pos, const BoundingBoxComponent& bounds)
+		{
 			// find x, y and z coordinates
-			Vector3 pos = trans.GetPosition();
 			size_t x = static_cast<size_t>(pos.x / blockDim);
 			size_t y = static_cast<size_t>(pos.y / blockDim);
 			size_t z = static_cast<size_t>(pos.z / blockDim);
-			
+
 			// create NavMesh and add to navScene
 			entity newMesh = em.CreateEntity();
 			navScene.AddIdAt(x, y, z, newMesh);
 			em.AddComponent<NavMeshComponent>(newMesh);
 			em.AddComponent<SceneComponent>(newMesh, sceneType);
-			BoundingBoxComponent& bb = em.AddComponent<BoundingBoxComponent>(newMesh, em.GetComponent<BoundingBoxComponent>(e));
+			BoundingBoxComponent& bb = em.AddComponent<BoundingBoxComponent>(newMesh, bounds);
 			if (m_vizNavMeshes)
 			{
 				// visualize NavMesh
@@ -235,36 +233,27 @@ void Pathfinder::BuildNavScene(SceneComponent::Type sceneType)
 					comp.color = NAVMESH_COLOR;
 					comp.onlyOutline = true;
 				}
-
 			}
+		};
+
+	em.Collect<ModularBlockComponent, TransformComponent>().Do(
+		[&](entity e, ModularBlockComponent&, TransformComponent& trans)
+		{
+			addNavMesh(trans.GetPosition(), em.GetComponent<BoundingBoxComponent>(e));
+		});
+
+	// blocks merged into level chunks
+	em.Collect<LevelChunkComponent>().Do(
+		[&](LevelChunkComponent& chunk)
+		{
+			for (auto& block : chunk.blocks)
+				addNavMesh(block.position, block.bounds);
 		});
 
 	em.Collect<EmptySpaceComponent>().Do(
 		[&](entity e, EmptySpaceComponent& empty)
 		{
-			// find x, y and z coordinates
-			size_t x = static_cast<size_t>(empty.pos.x / blockDim);
-			size_t y = static_cast<size_t>(empty.pos.y / blockDim);
-			size_t z = static_cast<size_t>(empty.pos.z / blockDim);
-			
-			// create NavMesh and add to navScene
-			entity newMesh = em.CreateEntity();
-			navScene.AddIdAt(x, y, z, newMesh);
-			em.AddComponent<NavMeshComponent>(newMesh);
-			em.AddComponent<SceneComponent>(newMesh, sceneType);
-			BoundingBoxComponent& bb = em.AddComponent<BoundingBoxComponent>(newMesh, em.GetComponent<BoundingBoxComponent>(e));
-			if (m_vizNavMeshes)
-			{
-				// visualize NavMesh
-				em.AddComponent<TransformComponent>(newMesh).SetPosition(bb.Center()).SetScale(NAVMESH_SCALE);
-				em.AddComponent<ModelComponent>(newMesh, AssetManager::Get().LoadShapeAsset(NAVMESH_SHAPE, NAVMESH_TESS));
-				if (m_vizOutlines)
-				{
-					auto& comp = em.AddComponent<OutlineComponent>(newMesh);
-					comp.color = NAVMESH_COLOR;
-					comp.onlyOutline = true;
-				}
-			}
+			addNavMesh(empty.pos, em.GetComponent<BoundingBoxComponent>(e));
 		});
 
 
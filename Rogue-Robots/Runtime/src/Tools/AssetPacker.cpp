@@ -0,0 +1,62 @@
+#include "../../../DOGEngine/src/Core/AssetFileSystem.h"
+
+// Packs asset directories into one archive that the engine mounts at startup.
+// Usage: AssetPacker [--out Assets.dogpak] [directory ...], the default directory is Assets.
+// Paths in the archive start with the directory name, the same paths the game loads them by.
+
+namespace
+{
+	// Formats that are already compressed, XPRESS only costs load time on them.
+	// WAV files are streamed, a compressed entry would be decompressed in full every time a stream is opened.
+	bool ShouldCompress(const std::filesystem::path& file)
+	{
+		std::string extension = file.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+		return extension != ".dds" && extension != ".dog" && extension != ".png" && extension != ".jpg" && extension != ".jpeg" && extension != ".glb"
+			&& extension != ".wav";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::filesystem::path output = DOG::AssetFileSystem::DEFAULT_ARCHIVE;
+	std::vector<std::filesystem::path> directories;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view argument = argv[i];
+		if (argument == "--out" && i + 1 < argc)
+			output = argv[++i];
+		else
+			directories.emplace_back(argument);
+	}
+	if (directories.empty())
+		directories.emplace_back("Assets");
+
+	std::vector<DOG::AssetArchive::Source> sources;
+	for (auto& directory : directories)
+	{
+		if (!std::filesystem::is_directory(directory))
+		{
+			std::cout << "AssetPacker: " << directory.string() << " is not a directory\n";
+			return 1;
+		}
+
+		const auto root = directory.lexically_normal().parent_path();
+		for (auto& file : std::filesystem::recursive_directory_iterator(directory))
+		{
+			if (!file.is_regular_file() || file.path().extension() == ".tmp")
+				continue;
+			sources.push_back({ file.path(), file.path().lexically_relative(root).string(), ShouldCompress(file.path()) });
+		}
+	}
+
+	// Sorted so the same assets always give the same archive, and files from one folder end up next to each other
+	std::sort(sources.begin(), sources.end(), [](const auto& a, const auto& b) { return a.path < b.path; });
+
+	if (!DOG::AssetArchive::Write(output, sources))
+		return 1;
+
+	std::cout << "AssetPacker: packed " << sources.size() << " files into " << output.string()
+		<< " (" << std::filesystem::file_size(output) / (1024 * 1024) << " MiB)\n";
+	return 0;
+}
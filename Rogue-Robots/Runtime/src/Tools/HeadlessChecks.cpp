@@ -0,0 +1,644 @@
+#include "../../../DOGEngine/src/Graphics/RHI/Null/RenderBackend_Null.h"
+#include "../../../DOGEngine/src/Graphics/RHI/Null/RenderDevice_Null.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/GPUGarbageBin.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/LightTable.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/ClusteredLightCuller.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/FrustumCuller.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/TiledLightCuller.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/RenderEffects/TiledLightCullingEffect.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/RenderGraph/RenderGraph.h"
+#include "../../../DOGEngine/src/Graphics/Rendering/RenderGraph/RGResourceManager.h"
+#include "../../../DOGEngine/src/Audio/AudioMixer.h"
+#include "../../../DOGEngine/src/Audio/AudioOutput.h"
+
+// Checks engine systems that run without a GPU, window or audio device.
+// Usage: HeadlessChecks, returns the number of failed checks.
+
+using namespace DOG;
+using namespace DOG::gfx;
+
+namespace
+{
+	u32 s_failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (condition)
+			return;
+		std::cout << "HeadlessChecks: failed " << what << "\n";
+		++s_failures;
+	}
+
+	// Builds and executes a two pass graph on the null device, rebuilding the same topology must reuse its compiled graph
+	void CheckRenderGraphCache()
+	{
+		RenderBackend_Null backend;
+		auto rd = static_cast<RenderDevice_Null*>(backend.CreateDevice(2));
+		GPUGarbageBin bin(2);
+		RGResourceManager resMan(rd, &bin);
+		RenderGraph rg(rd, &resMan, &bin);
+
+		auto buildAndExecute = [&](u32 width)
+		{
+			struct PassData
+			{
+				RGResourceView target;
+			};
+
+			rg.Clear(true);
+			rg.AddPass<PassData>("Write",
+				[&](PassData&, RenderGraph::PassBuilder& builder)
+				{
+					builder.DeclareTexture(RG_RESOURCE(Target), RGTextureDesc::RenderTarget2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, 64));
+					builder.WriteRenderTarget(RG_RESOURCE(Target), RenderPassAccessType::ClearPreserve,
+						TextureViewDesc(ViewType::RenderTarget, TextureViewDimension::Texture2D, DXGI_FORMAT_R8G8B8A8_UNORM));
+				},
+				[](const PassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&)
+				{
+					rd->Cmd_Draw(cmdl, 3, 1, 0, 0);
+				});
+
+			rg.AddPass<PassData>("Read",
+				[&](PassData& passData, RenderGraph::PassBuilder& builder)
+				{
+					passData.target = builder.ReadResource(RG_RESOURCE(Target), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+						TextureViewDesc(ViewType::ShaderResource, TextureViewDimension::Texture2D, DXGI_FORMAT_R8G8B8A8_UNORM));
+				},
+				[](const PassData&, RenderDevice* rd, CommandList cmdl, RenderGraph::PassResources&)
+				{
+					rd->Cmd_Draw(cmdl, 3, 1, 0, 0);
+				});
+
+			rg.Build();
+			rg.Execute();
+			rd->Flush();
+			return rg.GetTopologyHash();
+		};
+
+		const u64 small = buildAndExecute(64);
+		Check(rg.GetCompiledGraphCount() == 1, "render graph: first build compiles");
+
+		Check(buildAndExecute(64) == small, "render graph: equal topologies hash equal");
+		Check(rg.GetCompiledGraphCount() == 1, "render graph: equal topology reuses the compiled graph");
+
+		const u64 large = buildAndExecute(128);
+		Check(large != small, "render graph: resized resource changes the topology");
+		Check(rg.GetCompiledGraphCount() == 2, "render graph: new topology compiles");
+
+		Check(buildAndExecute(64) == small, "render graph: earlier topology hashes as before");
+		Check(rg.GetCompiledGraphCount() == 2, "render graph: earlier topology reuses its compiled graph");
+		Check(rg.GetTopologyCollisionCount() == 0, "render graph: no topology hash collisions");
+
+		const auto& stats = rd->GetSubmissionStats();
+		Check(stats.commands[(size_t)RenderDevice_Null::CommandType::Draw] == 8, "render graph: every pass executed on every build");
+
+		rg.Clear(true);
+		bin.ForceClear();
+	}
+
+	// Fills a light table with random lights and compares the clusters they are assigned to against testing every light with every cluster
+	void CheckLightClusters()
+	{
+		using namespace DirectX::SimpleMath;
+
+		RenderBackend_Null backend;
+		RenderDevice* rd = backend.CreateDevice(2);
+		GPUGarbageBin bin(2);
+		LightTable::StorageSpecification spec;
+		spec.pointLightSpec.maxDynamic = 256;
+		spec.spotLightSpec.maxDynamic = 64;
+		LightTable table(rd, &bin, spec);
+
+		std::mt19937 rng(7);
+		auto random = [&rng](f32 min, f32 max) { return std::uniform_real_distribution<f32>(min, max)(rng); };
+		auto randomPosition = [&random]() { return Vector3(random(-60.0f, 60.0f), random(-20.0f, 20.0f), random(-20.0f, 120.0f)); };
+
+		for (u32 i = 0; i < spec.pointLightSpec.maxDynamic; ++i)
+		{
+			PointLightDesc desc;
+			desc.position = randomPosition();
+			desc.radius = random(0.5f, 20.0f);
+			desc.strength = 1.0f;
+			table.AddPointLight(desc, LightUpdateFrequency::PerFrame);
+		}
+		for (u32 i = 0; i < spec.spotLightSpec.maxDynamic; ++i)
+		{
+			SpotLightDesc desc;
+			desc.position = randomPosition();
+			desc.direction = Vector3(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f)) + Vector3(0.0f, 0.0f, 0.01f);
+			desc.cutoffAngle = random(5.0f, 100.0f);
+			desc.range = random(2.0f, 60.0f);
+			desc.strength = 1.0f;
+			table.AddSpotLight(desc, LightUpdateFrequency::PerFrame);
+		}
+
+		std::vector<ClusteredLightCuller::Light> pointLights, spotLights;
+		ClusteredLightCuller::GatherLights(table, pointLights, spotLights);
+		Check(pointLights.size() == spec.pointLightSpec.maxDynamic, "light clusters: every point light gathered");
+		Check(spotLights.size() == spec.spotLightSpec.maxDynamic, "light clusters: every spot light gathered");
+
+		// The bounds of a spot light have to hold its cone out to the range in the table, and not much more
+		bool conesBounded = true;
+		for (const auto& bounds : spotLights)
+		{
+			const auto& spot = table.GetSpotLights()[bounds.index];
+			const Vector3 apex(spot.position.x, spot.position.y, spot.position.z);
+			Vector3 dir = spot.direction;
+			dir.Normalize();
+			Vector3 side = std::abs(dir.y) < 0.9f ? dir.Cross(Vector3::UnitY) : dir.Cross(Vector3::UnitX);
+			side.Normalize();
+			const Vector3 up = dir.Cross(side);
+
+			const f32 angle = std::min(DirectX::XMConvertToRadians(spot.cutoffAngle), DirectX::XM_PI);
+			const f32 tolerance = 1e-3f * spot.range;
+			conesBounded &= Vector3::Distance(apex, bounds.center) <= bounds.radius + tolerance;
+			conesBounded &= Vector3::Distance(apex + dir * spot.range, bounds.center) <= bounds.radius + tolerance;
+			for (u32 i = 0; i < 8; ++i)
+			{
+				const f32 around = DirectX::XM_2PI * i / 8;
+				const Vector3 rim = dir * std::cos(angle) + (side * std::cos(around) + up * std::sin(around)) * std::sin(angle);
+				conesBounded &= Vector3::Distance(apex + rim * spot.range, bounds.center) <= bounds.radius + tolerance;
+			}
+			conesBounded &= bounds.radius <= spot.range + tolerance;
+		}
+		Check(conesBounded, "light clusters: spot light bounds hold the cone out to its range");
+
+		ClusteredLightCuller::Setup setup;
+		setup.view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 2.0f, -5.0f, 1.0f), DirectX::XMVectorSet(10.0f, 0.0f, 50.0f, 1.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		setup.proj = DirectX::XMMatrixPerspectiveFovLH(DirectX::XMConvertToRadians(80.0f), 16.0f / 9.0f, 1000.0f, 0.1f);
+		setup.width = 1280;
+		setup.height = 720;
+		setup.nearClip = 0.1f;
+		setup.farClip = 1000.0f;
+
+		ClusteredLightCuller culler;
+		ClusteredLightCuller::Result result;
+		culler.Cull(setup, pointLights, spotLights, result);
+
+		const u32 clustersX = (setup.width + setup.tileSize - 1) / setup.tileSize;
+		const u32 clustersY = (setup.height + setup.tileSize - 1) / setup.tileSize;
+		Check(result.clustersX == clustersX && result.clustersY == clustersY && result.clustersZ == setup.depthSlices, "light clusters: cluster grid size");
+		Check(result.clusters.size() == (size_t)clustersX * clustersY * setup.depthSlices, "light clusters: one list per cluster");
+		if (result.clusters.size() != (size_t)clustersX * clustersY * setup.depthSlices)
+			return;
+
+		// Every light reaching a point inside a cluster must be in its list, a listed light must at least touch the bounding box of the cluster.
+		// The box alone is no reference, it is looser than the cluster and the culler also bins lights by their projected extent.
+		u32 mismatches = 0;
+		for (u32 z = 0; z < setup.depthSlices; ++z)
+		{
+			const f32 zNear = ClusteredLightCuller::GetSliceDepth(setup, z);
+			const f32 zFar = ClusteredLightCuller::GetSliceDepth(setup, z + 1);
+			for (u32 y = 0; y < clustersY; ++y)
+			{
+				for (u32 x = 0; x < clustersX; ++x)
+				{
+					const f32 ndcX[2] = { 2.0f * x * setup.tileSize / setup.width - 1.0f, std::min(2.0f * (x + 1) * setup.tileSize / setup.width - 1.0f, 1.0f) };
+					const f32 ndcY[2] = { 1.0f - 2.0f * y * setup.tileSize / setup.height, std::max(1.0f - 2.0f * (y + 1) * setup.tileSize / setup.height, -1.0f) };
+					auto pointInCluster = [&](f32 u, f32 v, f32 w)
+					{
+						const f32 depth = zNear + (zFar - zNear) * w;
+						return Vector3((ndcX[0] + (ndcX[1] - ndcX[0]) * u) * depth / setup.proj._11, (ndcY[0] + (ndcY[1] - ndcY[0]) * v) * depth / setup.proj._22, depth);
+					};
+
+					Vector3 boxMin(FLT_MAX, FLT_MAX, FLT_MAX), boxMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+					for (u32 i = 0; i < 8; ++i)
+					{
+						const Vector3 corner = pointInCluster((f32)(i & 1), (f32)((i >> 1) & 1), (f32)(i >> 2));
+						boxMin = Vector3::Min(boxMin, corner);
+						boxMax = Vector3::Max(boxMax, corner);
+					}
+
+					const auto& cluster = result.clusters[result.GetClusterIndex(x, y, z)];
+					if ((size_t)cluster.offset + cluster.pointCount + cluster.spotCount > result.lightIndices.size())
+					{
+						++mismatches;
+						continue;
+					}
+
+					bool matches = true;
+					auto compare = [&](std::span<const ClusteredLightCuller::Light> lights, u32 first, u32 count)
+					{
+						std::span<const u32> listed(result.lightIndices.data() + first, count);
+						for (const auto& light : lights)
+						{
+							const Vector3 center = Vector3::Transform(light.center, setup.view);
+							Vector3 closest;
+							center.Clamp(boxMin, boxMax, closest);
+							const f32 boxDistance = Vector3::Distance(center, closest);
+
+							if (std::find(listed.begin(), listed.end(), light.index) != listed.end())
+							{
+								matches &= boxDistance <= light.radius * 1.001f + 1e-4f;
+								continue;
+							}
+							if (boxDistance >= light.radius)
+								continue;
+
+							constexpr f32 steps = 4.0f;
+							for (f32 u = 0.0f; u <= steps; ++u)
+								for (f32 v = 0.0f; v <= steps; ++v)
+									for (f32 w = 0.0f; w <= steps; ++w)
+										matches &= Vector3::Distance(center, pointInCluster(u / steps, v / steps, w / steps)) >= light.radius * 0.999f;
+						}
+					};
+					compare(pointLights, cluster.offset, cluster.pointCount);
+					compare(spotLights, cluster.offset + cluster.pointCount, cluster.spotCount);
+					mismatches += !matches;
+				}
+			}
+		}
+		if (mismatches > 0)
+			std::cout << "HeadlessChecks: " << mismatches << " light clusters differ from brute force\n";
+		Check(mismatches == 0, "light clusters: clusters match brute force");
+
+		bin.ForceClear();
+	}
+
+	// Frustum planes built from its corners, volumes are tested against them one corner at a time
+	struct ReferenceFrustum
+	{
+		std::array<DirectX::SimpleMath::Vector4, 6> planes;
+
+		// Bit 0, 1 and 2 of the index pick the x, y and z side of a corner
+		explicit ReferenceFrustum(const std::array<DirectX::SimpleMath::Vector3, 8>& corners)
+		{
+			using namespace DirectX::SimpleMath;
+
+			Vector3 centroid;
+			for (const auto& corner : corners)
+				centroid += corner / 8.0f;
+
+			constexpr u32 faces[6][3] = { { 0, 2, 4 }, { 1, 3, 5 }, { 0, 1, 4 }, { 2, 3, 6 }, { 0, 1, 2 }, { 4, 5, 6 } };
+			for (u32 f = 0; f < 6; ++f)
+			{
+				const Vector3& a = corners[faces[f][0]];
+				Vector3 normal = (corners[faces[f][1]] - a).Cross(corners[faces[f][2]] - a);
+				normal.Normalize();
+				if (normal.Dot(centroid - a) < 0.0f)
+					normal = -normal;
+				planes[f] = Vector4(normal.x, normal.y, normal.z, -normal.Dot(a));
+			}
+		}
+
+		// The clip volume of a view
+		static ReferenceFrustum FromView(const DirectX::SimpleMath::Matrix& view, const DirectX::SimpleMath::Matrix& proj)
+		{
+			using namespace DirectX::SimpleMath;
+
+			const Matrix invViewProj = (view * proj).Invert();
+			std::array<Vector3, 8> corners;
+			for (u32 i = 0; i < 8; ++i)
+				corners[i] = Vector3::Transform(Vector3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : 0.0f), invViewProj);
+			return ReferenceFrustum(corners);
+		}
+
+		// outsideMargin < 0 if every corner is behind one plane, insideMargin >= 0 if every corner is in front of all planes
+		void Classify(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& extents, f32& outsideMargin, f32& insideMargin) const
+		{
+			outsideMargin = FLT_MAX;
+			insideMargin = FLT_MAX;
+			for (const auto& plane : planes)
+			{
+				f32 nearest = FLT_MAX, farthest = -FLT_MAX;
+				for (u32 i = 0; i < 8; ++i)
+				{
+					const f32 x = center.x + (i & 1 ? extents.x : -extents.x);
+					const f32 y = center.y + (i & 2 ? extents.y : -extents.y);
+					const f32 z = center.z + (i & 4 ? extents.z : -extents.z);
+					const f32 distance = plane.x * x + plane.y * y + plane.z * z + plane.w;
+					nearest = std::min(nearest, distance);
+					farthest = std::max(farthest, distance);
+				}
+				outsideMargin = std::min(outsideMargin, farthest);
+				insideMargin = std::min(insideMargin, nearest);
+			}
+		}
+
+		// Negative if the sphere is entirely behind one of the planes
+		f32 SphereMargin(const DirectX::SimpleMath::Vector3& center, f32 radius) const
+		{
+			f32 margin = FLT_MAX;
+			for (const auto& plane : planes)
+				margin = std::min(margin, plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w + radius);
+			return margin;
+		}
+	};
+
+	// Compares the batched SIMD test and the single box test against the reference, boxes too close to a plane to call are skipped
+	void CheckFrustumCuller()
+	{
+		using namespace DirectX::SimpleMath;
+
+		std::vector<std::pair<Matrix, Matrix>> cameras;
+		cameras.emplace_back(DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 2.0f, -5.0f, 1.0f), DirectX::XMVectorSet(10.0f, 0.0f, 50.0f, 1.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+			DirectX::XMMatrixPerspectiveFovLH(DirectX::XMConvertToRadians(80.0f), 16.0f / 9.0f, 1000.0f, 0.1f)); // Reversed depth like the main camera
+		cameras.emplace_back(DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(20.0f, 30.0f, 40.0f, 1.0f), DirectX::XMVectorSet(0.0f, 0.0f, 40.0f, 1.0f), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)),
+			DirectX::XMMatrixPerspectiveFovLH(DirectX::XMConvertToRadians(60.0f), 1.0f, 0.5f, 200.0f));
+		cameras.emplace_back(DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 100.0f, 0.0f, 1.0f), DirectX::XMVectorSet(10.0f, 0.0f, 20.0f, 1.0f), DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)),
+			DirectX::XMMatrixOrthographicLH(120.0f, 120.0f, 1.0f, 300.0f)); // Like a shadow view
+
+		FrustumCuller culler;
+		std::vector<ReferenceFrustum> references;
+		for (auto& [view, proj] : cameras)
+		{
+			culler.AddView(view, proj);
+			references.push_back(ReferenceFrustum::FromView(view, proj));
+		}
+
+		// Three boxes more than a whole number of groups, the last group is padded like the leaves of the BVH
+		constexpr u32 boxCount = 64 * FrustumCuller::GROUP_SIZE + 3;
+		std::mt19937 rng(11);
+		auto random = [&rng](f32 min, f32 max) { return std::uniform_real_distribution<f32>(min, max)(rng); };
+		FrustumCuller::Bounds bounds;
+		for (u32 i = 0; i < boxCount; ++i)
+		{
+			bounds.Push(DirectX::XMFLOAT3(random(-80.0f, 80.0f), random(-40.0f, 40.0f), random(-40.0f, 140.0f)),
+				DirectX::XMFLOAT3(random(0.1f, 15.0f), random(0.1f, 15.0f), random(0.1f, 15.0f)));
+		}
+		const u32 paddedCount = (boxCount + FrustumCuller::GROUP_SIZE - 1) / FrustumCuller::GROUP_SIZE * FrustumCuller::GROUP_SIZE;
+		bounds.Resize(paddedCount);
+
+		for (const FrustumCuller::ViewMask viewMask : { culler.GetAllViews(), FrustumCuller::ViewMask(0b101) })
+		{
+			std::vector<FrustumCuller::ViewMask> touched(paddedCount, 0);
+			for (u32 first = 0; first < paddedCount; first += FrustumCuller::GROUP_SIZE)
+				culler.TestGroup(bounds, first, viewMask, &touched[first]);
+
+			u32 mismatches = 0, inside = 0, outside = 0, straddling = 0;
+			for (u32 i = 0; i < boxCount; ++i)
+			{
+				const DirectX::XMFLOAT3 center(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]);
+				const DirectX::XMFLOAT3 extents(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]);
+
+				FrustumCuller::ViewMask boxInside = 0;
+				const FrustumCuller::ViewMask boxTouched = culler.TestBox(center, extents, viewMask, boxInside);
+
+				for (u32 view = 0; view < culler.GetViewCount(); ++view)
+				{
+					const FrustumCuller::ViewMask bit = 1u << view;
+					if (!(viewMask & bit))
+					{
+						mismatches += (touched[i] & bit) || (boxTouched & bit) || (boxInside & bit);
+						continue;
+					}
+
+					f32 outsideMargin, insideMargin;
+					references[view].Classify(center, extents, outsideMargin, insideMargin);
+					constexpr f32 epsilon = 1e-2f;
+					if (std::abs(outsideMargin) < epsilon || std::abs(insideMargin) < epsilon)
+						continue;
+
+					const bool expectTouched = outsideMargin > 0.0f;
+					const bool expectInside = insideMargin > 0.0f;
+					mismatches += ((touched[i] & bit) != 0) != expectTouched;
+					mismatches += ((boxTouched & bit) != 0) != expectTouched;
+					mismatches += ((boxInside & bit) != 0) != expectInside;
+
+					inside += expectInside;
+					outside += !expectTouched;
+					straddling += expectTouched && !expectInside;
+				}
+			}
+			if (mismatches > 0)
+				std::cout << "HeadlessChecks: " << mismatches << " frustum tests differ from the reference\n";
+			Check(mismatches == 0, "frustum culler: batched and single box tests match the reference");
+			Check(inside > 0 && outside > 0 && straddling > 0, "frustum culler: boxes inside, outside and straddling were tested");
+		}
+	}
+
+	// Compares the per tile light lists of the CPU tiled culler against testing every light with the frustum of every tile
+	void CheckTiledLightCuller()
+	{
+		using namespace DirectX::SimpleMath;
+
+		TiledLightCuller::Setup setup;
+		setup.view = DirectX::XMMatrixLookAtLH(DirectX::XMVectorSet(0.0f, 2.0f, -5.0f, 1.0f), DirectX::XMVectorSet(10.0f, 0.0f, 50.0f, 1.0f), DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		setup.proj = DirectX::XMMatrixPerspectiveFovLH(DirectX::XMConvertToRadians(80.0f), 1000.0f / 600.0f, 200.0f, 0.1f);
+		setup.width = 1000; // Not a multiple of the tile size, the last column and row of tiles are partial
+		setup.height = 600;
+		setup.nearClip = 0.1f;
+		setup.farClip = 200.0f;
+
+		// Three lights more than a whole number of groups, the last group gets radius -inf padding lanes with index 0
+		constexpr u32 lightCount = 64 * TiledLightCuller::GROUP_SIZE + 3;
+		constexpr u32 firstIndex = 1000;
+		std::mt19937 rng(13);
+		auto random = [&rng](f32 min, f32 max) { return std::uniform_real_distribution<f32>(min, max)(rng); };
+		TiledLightCuller::Lights lights;
+		std::vector<std::pair<Vector3, f32>> spheres;
+		for (u32 i = 0; i < lightCount; ++i)
+		{
+			spheres.emplace_back(Vector3(random(-60.0f, 60.0f), random(-20.0f, 20.0f), random(-20.0f, 120.0f)), random(0.5f, 8.0f));
+			lights.Push(spheres.back().first, spheres.back().second, firstIndex + i);
+		}
+
+		const Vector2u tileCount = TiledLightCuller::GetTileCount(setup);
+		const u32 tiles = tileCount.x * tileCount.y;
+		Check(tileCount.x == 63 && tileCount.y == 38, "tiled lights: tile count rounds up");
+
+		std::vector<TiledLightCuller::TileDepth> tileDepths(tiles);
+		for (auto& depth : tileDepths)
+		{
+			depth.minDepth = random(0.1f, 60.0f);
+			depth.maxDepth = depth.minDepth + random(1.0f, 100.0f);
+		}
+
+		const Matrix invView = setup.view.Invert();
+		TiledLightCuller culler;
+		for (const bool withDepth : { false, true })
+		{
+			std::vector<TiledLightCuller::TileLights> culled;
+			culler.Cull(setup, lights, withDepth ? std::span<const TiledLightCuller::TileDepth>(tileDepths) : std::span<const TiledLightCuller::TileDepth>(), culled);
+			Check(culled.size() == tiles, "tiled lights: one list per tile");
+			if (culled.size() != tiles)
+				return;
+
+			// Read back as the buffer the GPU culling writes
+			std::vector<TiledLightCullingEffect::LocalLightBufferLayout> buffer(tiles);
+			std::memcpy(buffer.data(), culled.data(), tiles * sizeof(TiledLightCullingEffect::LocalLightBufferLayout));
+
+			u32 mismatches = 0, listed = 0;
+			std::vector<u32> expected, actual;
+			for (u32 tile = 0; tile < tiles; ++tile)
+			{
+				const u32 tileX = tile % tileCount.x;
+				const u32 tileY = tile / tileCount.x;
+				const f32 minDepth = withDepth ? tileDepths[tile].minDepth : setup.nearClip;
+				const f32 maxDepth = withDepth ? tileDepths[tile].maxDepth : setup.farClip;
+
+				// Tiles split clip space evenly like the compute shader, tile row 0 is at the top of the screen
+				const f32 left = -1.0f + 2.0f * tileX / tileCount.x;
+				const f32 right = -1.0f + 2.0f * (tileX + 1) / tileCount.x;
+				const f32 bottom = 1.0f - 2.0f * (tileY + 1) / tileCount.y;
+				const f32 top = 1.0f - 2.0f * tileY / tileCount.y;
+
+				std::array<Vector3, 8> corners;
+				for (u32 i = 0; i < 8; ++i)
+				{
+					const f32 depth = i & 4 ? maxDepth : minDepth;
+					const Vector3 viewPos((i & 1 ? right : left) * depth / setup.proj._11, (i & 2 ? top : bottom) * depth / setup.proj._22, depth);
+					corners[i] = Vector3::Transform(viewPos, invView);
+				}
+				const ReferenceFrustum frustum(corners);
+
+				// Lights too close to a plane to call are left out of both lists
+				expected.clear();
+				std::vector<bool> ambiguous(lightCount, false);
+				for (u32 i = 0; i < lightCount; ++i)
+				{
+					const f32 margin = frustum.SphereMargin(spheres[i].first, spheres[i].second);
+					if (std::abs(margin) < 1e-2f)
+						ambiguous[i] = true;
+					else if (margin > 0.0f)
+						expected.push_back(firstIndex + i);
+				}
+
+				const auto& tileLights = buffer[tile];
+				mismatches += tileLights.count > TiledLightCuller::MAX_LIGHTS_PER_TILE;
+				actual.clear();
+				for (u32 i = 0; i < std::min(tileLights.count, TiledLightCuller::MAX_LIGHTS_PER_TILE); ++i)
+				{
+					const u32 index = tileLights.lightIndices[i];
+					if (index < firstIndex || index >= firstIndex + lightCount)
+					{
+						++mismatches; // A padding lane or garbage
+						continue;
+					}
+					if (!ambiguous[index - firstIndex])
+						actual.push_back(index);
+				}
+
+				mismatches += actual != expected;
+				listed += static_cast<u32>(expected.size());
+			}
+
+			if (mismatches > 0)
+				std::cout << "HeadlessChecks: " << mismatches << " light tiles differ from brute force\n";
+			Check(mismatches == 0, withDepth ? "tiled lights: tiles with depth ranges match brute force" : "tiled lights: tiles match brute force");
+			Check(listed > 0, "tiled lights: lights reach the tiles");
+		}
+	}
+
+	// 16-bit mono sine, written at half the mixer rate so the voices are resampled
+	void WriteToneWAV(const std::filesystem::path& path, u32 sampleRate, u32 frames)
+	{
+		std::ofstream file(path, std::ios::binary);
+		auto write = [&file](const auto& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+		const u32 dataBytes = frames * (u32)sizeof(i16);
+		file.write("RIFF", 4);
+		write(u32(4 + (8 + 16) + (8 + dataBytes)));
+		file.write("WAVE", 4);
+		file.write("fmt ", 4);
+		write(u32(16));
+		write(u16(WAVE_FORMAT_PCM));
+		write(u16(1));
+		write(sampleRate);
+		write(u32(sampleRate * sizeof(i16)));
+		write(u16(sizeof(i16)));
+		write(u16(16));
+		file.write("data", 4);
+		write(dataBytes);
+		for (u32 i = 0; i < frames; ++i)
+			write(i16(8192.0f * std::sin(DirectX::XM_2PI * 440.0f * i / sampleRate)));
+	}
+
+	// Mixes the same file streamed from disk and from memory through the null and WAV file outputs, both have to sound the same
+	void CheckAudioMixer()
+	{
+		constexpr u32 sourceRate = MixerAudioDevice::SAMPLE_RATE / 2;
+		constexpr u32 blockFrames = MixerAudioDevice::BLOCK_FRAMES;
+		const std::filesystem::path tonePath = std::filesystem::temp_directory_path() / "HeadlessChecks_tone.wav";
+		const std::filesystem::path mixPath = std::filesystem::temp_directory_path() / "HeadlessChecks_mix.wav";
+		WriteToneWAV(tonePath, sourceRate, sourceRate / 2);
+
+		AudioAsset asset;
+		{
+			WAVFileReader reader(tonePath);
+			asset.filePath = tonePath.string();
+			asset.properties = reader.ReadWFXProperties();
+			asset.audioData = reader.ReadFull();
+		}
+		Check(asset.audioData.size() == sourceRate / 2 * sizeof(i16), "audio mixer: tone read back");
+
+		// Returns true if both voices finished
+		auto run = [&](bool loop, u32 blocks, AudioOutput& output, std::vector<f32>& streamed, std::vector<f32>& fromMemory)
+		{
+			AudioMixer streamMixer(output.SampleRate());
+			AudioMixer memoryMixer(output.SampleRate());
+			const u32 streamVoice = streamMixer.PlayStream(asset.properties, asset.filePath);
+			const u32 memoryVoice = memoryMixer.PlayMemory(0, asset);
+			Check(streamVoice != AudioMixer::INVALID_VOICE && memoryVoice != AudioMixer::INVALID_VOICE, "audio mixer: voices started");
+			if (streamVoice == AudioMixer::INVALID_VOICE || memoryVoice == AudioMixer::INVALID_VOICE)
+				return false;
+
+			if (loop)
+			{
+				streamMixer.SetLoop(streamVoice, 0.1f, 0.4f);
+				memoryMixer.SetLoop(memoryVoice, 0.1f, 0.4f);
+			}
+			streamMixer.Spatialize();
+			memoryMixer.Spatialize();
+
+			// Same loop as the mixer thread of MixerAudioDevice, the in-memory mix is only kept for comparison
+			std::vector<f32> block(blockFrames * AudioMixer::OUTPUT_CHANNELS);
+			for (u32 i = 0; i < blocks; ++i)
+			{
+				while (!output.WaitForSpace(std::chrono::milliseconds(20))) {}
+
+				streamMixer.Mix(block);
+				streamed.insert(streamed.end(), block.begin(), block.end());
+				output.Submit(block);
+
+				memoryMixer.Mix(block);
+				fromMemory.insert(fromMemory.end(), block.begin(), block.end());
+			}
+			return streamMixer.HasFinished(streamVoice) && memoryMixer.HasFinished(memoryVoice);
+		};
+
+		// The tone lasts 50 blocks at the mixer rate
+		std::vector<f32> streamed, fromMemory;
+		NullAudioOutput nullOutput(MixerAudioDevice::SAMPLE_RATE, AudioMixer::OUTPUT_CHANNELS, blockFrames, false);
+		Check(run(false, 60, nullOutput, streamed, fromMemory), "audio mixer: voices finish");
+		Check(streamed == fromMemory, "audio mixer: streamed voice matches the in-memory voice");
+		Check(nullOutput.FramesSubmitted() == 60 * blockFrames, "audio mixer: null output received every block");
+		Check(nullOutput.PeakSample() > 0.1f, "audio mixer: null output is not silent");
+
+		// Loops well past the end of the file, the stream has to wrap without falling behind
+		streamed.clear();
+		fromMemory.clear();
+		bool finished = true;
+		{
+			WAVFileAudioOutput fileOutput(mixPath, MixerAudioDevice::SAMPLE_RATE, AudioMixer::OUTPUT_CHANNELS);
+			finished = run(true, 200, fileOutput, streamed, fromMemory);
+		}
+		Check(!finished, "audio mixer: looping voices keep playing");
+		Check(streamed == fromMemory, "audio mixer: looping streamed voice matches the in-memory voice");
+
+		{
+			WAVFileReader mixReader(mixPath);
+			const WAVEFORMATEX mixFormat = mixReader.ReadWFXProperties();
+			const std::vector<u8> mixData = mixReader.ReadFull();
+			Check(mixFormat.wFormatTag == WAVE_FORMAT_IEEE_FLOAT && mixFormat.nChannels == AudioMixer::OUTPUT_CHANNELS && mixFormat.nSamplesPerSec == MixerAudioDevice::SAMPLE_RATE,
+				"audio mixer: WAV output format");
+			Check(mixData.size() == streamed.size() * sizeof(f32) && std::memcmp(mixData.data(), streamed.data(), mixData.size()) == 0,
+				"audio mixer: WAV output holds the mix");
+		}
+
+		std::filesystem::remove(tonePath);
+		std::filesystem::remove(mixPath);
+	}
+}
+
+int main()
+{
+	CheckRenderGraphCache();
+	CheckLightClusters();
+	CheckFrustumCuller();
+	CheckTiledLightCuller();
+	CheckAudioMixer();
+
+	std::cout << "HeadlessChecks: " << (s_failures == 0 ? "all checks passed" : "failures found") << "\n";
+	return (int)s_failures;
+}